@@ -18,10 +18,13 @@
  *
  */
 
+#include <linux/mempolicy.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "s3_memory_pool.h"
 
@@ -29,6 +32,20 @@ struct memory_pool_element {
   struct memory_pool_element *next;
 };
 
+/* Sits right behind the item of ENABLE_BUFFER_OWNER pools, may be unaligned */
+struct memory_pool_buffer_trailer {
+  struct mempool *owner;
+};
+
+/* Per-thread magazine of free buffers, see ENABLE_THREAD_CACHE */
+struct mempool_tcache {
+  struct mempool *pool;
+  int count; /* Number of valid entries in items */
+  void *items[MEMPOOL_TCACHE_MAX_ITEMS];
+  struct mempool_tcache *next; /* Linked in pool->tcaches, under pool->lock */
+  struct mempool_tcache *prev;
+};
+
 struct mempool {
   int flags;                 /* Buffer Bitflags */
   int free_bufs_in_pool;     /* Number of items on free list */
@@ -54,12 +71,41 @@ struct mempool {
   size_t max_memory_threshold; /* Maximum memory that the system can have from
                                   pool */
   size_t mempool_item_size; /* Size of items managed by this pool */
+  size_t trailer_size; /* Bytes reserved behind each item, see
+                          ENABLE_BUFFER_OWNER */
   size_t expandable_size;   /* pool expansion rate when free list is empty */
   pthread_mutex_t lock;     /* lock, in case of synchronous operation */
   struct memory_pool_element *free_list; /* list of free items available for
                                             reuse */
+  pthread_key_t tcache_key;         /* Per-thread magazine of this pool */
+  struct mempool_tcache *tcaches;   /* All live magazines, under lock */
+  int tcache_capacity;              /* Max buffers held by one magazine */
+  int tcache_batch; /* Buffers moved per refill/drain of a magazine */
+  int bufs_in_tcaches; /* Free buffers parked in magazines, atomic */
+  int numa_node;       /* Preferred NUMA node for pool memory, -1 if none */
 };
 
+/**
+ * Best effort: prefer NUMA node pool->numa_node for the pages of buf, moving
+ * already faulted pages. Buffer must be page aligned.
+ */
+static void pool_bind_to_node(struct mempool *pool, void *buf) {
+  unsigned long nodemask;
+
+  if (pool->numa_node < 0 || (pool->flags & CREATE_ALIGNED_MEMORY) == 0 ||
+      pool->numa_node >= (int)(sizeof(nodemask) * 8)) {
+    return;
+  }
+  nodemask = 1UL << pool->numa_node;
+  syscall(SYS_mbind, buf, pool->mempool_item_size, MPOL_PREFERRED, &nodemask,
+          sizeof(nodemask) * 8, MPOL_MF_MOVE);
+}
+
+/* Memory taken by one item, including its trailer */
+static size_t pool_item_footprint(struct mempool *pool) {
+  return pool->mempool_item_size + pool->trailer_size;
+}
+
 /**
  * Return the number of buffers we can allocate w.r.t max threshold and
  * available memory space.
@@ -75,16 +121,16 @@ static int pool_can_expand_by(struct mempool *pool) {
     available_space = pool->mem_get_free_space_func();
   } else {
     const size_t allocated_space =
-        pool->total_bufs_allocated_by_pool * pool->mempool_item_size;
+        pool->total_bufs_allocated_by_pool * pool_item_footprint(pool);
 
     if (pool->max_memory_threshold > allocated_space) {
       available_space = pool->max_memory_threshold - allocated_space;
     }
   }
 
-  // We can expand by at least (available_space / pool->mempool_item_size)
+  // We can expand by at least (available_space / item footprint)
   // buffer count
-  return available_space / pool->mempool_item_size;
+  return available_space / pool_item_footprint(pool);
 }
 
 /**
@@ -113,9 +159,9 @@ int freelist_allocate(struct mempool *pool, int items_count_to_allocate) {
     if (pool->flags & CREATE_ALIGNED_MEMORY) {
       buf = NULL;
       rc = posix_memalign((void **)&buf, pool->alignment,
-                          pool->mempool_item_size);
+                          pool_item_footprint(pool));
     } else {
-      buf = malloc(pool->mempool_item_size);
+      buf = malloc(pool_item_footprint(pool));
     }
     if (pool->log_callback_func) {
       if (pool->flags & CREATE_ALIGNED_MEMORY) {
@@ -132,9 +178,14 @@ int freelist_allocate(struct mempool *pool, int items_count_to_allocate) {
     if (buf == NULL || rc != 0) {
       return S3_MEMPOOL_ERROR;
     }
+    if (pool->trailer_size > 0) {
+      struct memory_pool_buffer_trailer trailer = {pool};
+      memcpy((char *)buf + pool->mempool_item_size, &trailer, sizeof(trailer));
+    }
 
     /* exclude this buffer while geneating core dump*/
     madvise(buf, pool->mempool_item_size, MADV_DONTDUMP);
+    pool_bind_to_node(pool, buf);
 
     if ((pool->flags & ZEROED_BUFFER) != 0) {
       memset(buf, 0, pool->mempool_item_size);
@@ -151,12 +202,163 @@ int freelist_allocate(struct mempool *pool, int items_count_to_allocate) {
     /* Increase the free list count */
     pool->free_bufs_in_pool++;
     if (pool->mem_mark_used_space_func) {
-      pool->mem_mark_used_space_func(pool->mempool_item_size);
+      pool->mem_mark_used_space_func(pool_item_footprint(pool));
     }
   }
   return 0;
 }
 
+/**
+ * Expand the pool's free list by expandable_size, capped by max threshold.
+ * Must be called with pool lock held (if locking is enabled).
+ * returns:
+ * 0 on success, otherwise an error
+ */
+static int pool_expand(struct mempool *pool) {
+  int bufs_to_allocate = pool->expandable_size / pool->mempool_item_size;
+  int bufs_that_can_be_allocated = pool_can_expand_by(pool);
+
+  if (bufs_that_can_be_allocated <= 0) {
+    /* We cannot allocate any more buffers, reached max threshold */
+    return S3_MEMPOOL_THRESHOLD_EXCEEDED;
+  }
+  /* We can at least allocate
+     min(bufs_that_can_be_allocated, bufs_to_allocate) */
+  bufs_to_allocate = ((bufs_to_allocate > bufs_that_can_be_allocated)
+                          ? bufs_that_can_be_allocated
+                          : bufs_to_allocate);
+  return freelist_allocate(pool, bufs_to_allocate);
+}
+
+static void pool_log_stats(struct mempool *pool, const char *operation) {
+  char log_mem_stats[1024];
+  char *log_memool_stats =
+      "S3 Mempool stats after %s:"
+      "mempool_item_size = %zu "
+      "free_bufs_in_pool = %d "
+      "number_of_bufs_shared = %d "
+      "total_bufs_allocated_by_pool = %d\n";
+
+  snprintf(log_mem_stats, sizeof(log_mem_stats), log_memool_stats, operation,
+           pool->mempool_item_size,
+           pool->free_bufs_in_pool +
+               __atomic_load_n(&pool->bufs_in_tcaches, __ATOMIC_RELAXED),
+           __atomic_load_n(&pool->number_of_bufs_shared, __ATOMIC_RELAXED),
+           pool->total_bufs_allocated_by_pool);
+  pool->log_callback_func(MEMPOOL_LOG_DEBUG, log_mem_stats);
+}
+
+/**
+ * Move up to 'count' buffers from the magazine back to the shared free list.
+ * Takes the pool lock.
+ */
+static void tcache_drain(struct mempool *pool, struct mempool_tcache *tc,
+                         int count) {
+  struct memory_pool_element *pool_item;
+  int moved = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  while (moved < count && tc->count > 0) {
+    pool_item = (struct memory_pool_element *)tc->items[--tc->count];
+    pool_item->next = pool->free_list;
+    pool->free_list = pool_item;
+    pool->free_bufs_in_pool++;
+    moved++;
+  }
+  __atomic_sub_fetch(&pool->bufs_in_tcaches, moved, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Move up to tcache_batch buffers from the shared free list into the
+ * magazine, expanding the pool if the shared list is empty.
+ * Takes the pool lock.
+ * returns:
+ * 0 on success, otherwise an error
+ */
+static int tcache_refill(struct mempool *pool, struct mempool_tcache *tc) {
+  struct memory_pool_element *pool_item;
+  int moved = 0;
+  int rc = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  if (pool->free_bufs_in_pool == 0) {
+    rc = pool_expand(pool);
+  }
+  while (moved < pool->tcache_batch && pool->free_list != NULL) {
+    pool_item = pool->free_list;
+    pool->free_list = pool_item->next;
+    pool_item->next = (struct memory_pool_element *)NULL;
+    pool->free_bufs_in_pool--;
+    tc->items[tc->count++] = pool_item;
+    moved++;
+  }
+  __atomic_add_fetch(&pool->bufs_in_tcaches, moved, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&pool->lock);
+
+  /* A partial expansion still counts as success if we got something */
+  return moved > 0 ? 0 : (rc != 0 ? rc : S3_MEMPOOL_ERROR);
+}
+
+static void tcache_unlink(struct mempool *pool, struct mempool_tcache *tc) {
+  if (tc->prev != NULL) {
+    tc->prev->next = tc->next;
+  } else {
+    pool->tcaches = tc->next;
+  }
+  if (tc->next != NULL) {
+    tc->next->prev = tc->prev;
+  }
+  tc->next = tc->prev = NULL;
+}
+
+/* pthread key destructor, returns a exiting thread's magazine to the pool */
+static void tcache_thread_exit(void *arg) {
+  struct mempool_tcache *tc = (struct mempool_tcache *)arg;
+  struct mempool *pool = tc->pool;
+
+  tcache_drain(pool, tc, tc->count);
+  pthread_mutex_lock(&pool->lock);
+  tcache_unlink(pool, tc);
+  pthread_mutex_unlock(&pool->lock);
+  free(tc);
+}
+
+/**
+ * Returns calling thread's magazine for the pool, creating it on first use.
+ * NULL if it could not be created, callers then use the shared free list.
+ */
+static struct mempool_tcache *tcache_get(struct mempool *pool) {
+  struct mempool_tcache *tc =
+      (struct mempool_tcache *)pthread_getspecific(pool->tcache_key);
+
+  if (tc != NULL) {
+    return tc;
+  }
+  tc = (struct mempool_tcache *)calloc(1, sizeof(struct mempool_tcache));
+  if (tc == NULL) {
+    return NULL;
+  }
+  tc->pool = pool;
+
+  pthread_mutex_lock(&pool->lock);
+  tc->next = pool->tcaches;
+  if (pool->tcaches != NULL) {
+    pool->tcaches->prev = tc;
+  }
+  pool->tcaches = tc;
+  pthread_mutex_unlock(&pool->lock);
+
+  if (pthread_setspecific(pool->tcache_key, tc) != 0) {
+    pthread_mutex_lock(&pool->lock);
+    tcache_unlink(pool, tc);
+    pthread_mutex_unlock(&pool->lock);
+    free(tc);
+    return NULL;
+  }
+  return tc;
+}
+
 int mempool_create(size_t pool_item_size, size_t pool_initial_size,
                    size_t pool_expansion_size, size_t pool_max_threshold_size,
                    func_log_callback_type log_callback_func, int flags,
@@ -184,10 +386,18 @@ int mempool_create(size_t pool_item_size, size_t pool_initial_size,
   }
 
   pool->flags |= flags;
+  pool->numa_node = -1;
+  if ((pool->flags & ENABLE_THREAD_CACHE) != 0) {
+    /* Magazines are refilled/drained under the pool lock */
+    pool->flags |= ENABLE_LOCKING;
+  }
   pool->mempool_item_size = pool_item_size;
   if (flags & CREATE_ALIGNED_MEMORY) {
     pool->alignment = MEMORY_ALIGNMENT;
   }
+  if (flags & ENABLE_BUFFER_OWNER) {
+    pool->trailer_size = sizeof(struct memory_pool_buffer_trailer);
+  }
 
   if ((pool->flags & ENABLE_LOCKING) != 0) {
     rc = pthread_mutex_init(&pool->lock, NULL);
@@ -197,6 +407,22 @@ int mempool_create(size_t pool_item_size, size_t pool_initial_size,
     }
   }
 
+  if ((pool->flags & ENABLE_THREAD_CACHE) != 0) {
+    rc = pthread_key_create(&pool->tcache_key, tcache_thread_exit);
+    if (rc != 0) {
+      pthread_mutex_destroy(&pool->lock);
+      free(pool);
+      return S3_MEMPOOL_ERROR;
+    }
+    pool->tcache_capacity = MEMPOOL_TCACHE_MAX_BYTES / pool_item_size;
+    if (pool->tcache_capacity > MEMPOOL_TCACHE_MAX_ITEMS) {
+      pool->tcache_capacity = MEMPOOL_TCACHE_MAX_ITEMS;
+    } else if (pool->tcache_capacity < 2) {
+      pool->tcache_capacity = 2;
+    }
+    pool->tcache_batch = pool->tcache_capacity / 2;
+  }
+
   *handle = (MemoryPoolHandle)pool;
 
   pool->log_callback_func = log_callback_func;
@@ -254,16 +480,14 @@ int mempool_create_with_shared_mem(
   /* Explicitly mark used space, since mempool_create -> freelist_allocate
      dont have the function callbacks set. */
   pool->mem_mark_used_space_func(pool->total_bufs_allocated_by_pool *
-                                 pool->mempool_item_size);
+                                 pool_item_footprint(pool));
 
   return 0;
 }
 
 void *mempool_getbuffer(MemoryPoolHandle handle, size_t expected_buffer_size) {
-  int rc;
-  int bufs_to_allocate;
-  int bufs_that_can_be_allocated = 0;
   struct memory_pool_element *pool_item = NULL;
+  struct mempool_tcache *tc = NULL;
   struct mempool *pool = (struct mempool *)handle;
   char *log_msg_fmt =
       "mempool(%p): mempool_getbuffer called for invalid "
@@ -285,35 +509,32 @@ void *mempool_getbuffer(MemoryPoolHandle handle, size_t expected_buffer_size) {
     }
   }
 
+  if ((pool->flags & ENABLE_THREAD_CACHE) != 0 &&
+      (tc = tcache_get(pool)) != NULL) {
+    /* Lock free fast path, the magazine is only touched by this thread */
+    if (tc->count == 0 && tcache_refill(pool, tc) != 0) {
+      return NULL;
+    }
+    pool_item = (struct memory_pool_element *)tc->items[--tc->count];
+    pool_item->next = (struct memory_pool_element *)NULL;
+    __atomic_sub_fetch(&pool->bufs_in_tcaches, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pool->number_of_bufs_shared, 1, __ATOMIC_RELAXED);
+    if (pool->log_callback_func) {
+      pool_log_stats(pool, "allocation");
+    }
+    return (void *)pool_item;
+  }
+
   if ((pool->flags & ENABLE_LOCKING) != 0) {
     pthread_mutex_lock(&pool->lock);
   }
 
   /* If the free list is empty then expand the pool's free list */
-  if (pool->free_bufs_in_pool == 0) {
-    bufs_to_allocate = pool->expandable_size / pool->mempool_item_size;
-    bufs_that_can_be_allocated = pool_can_expand_by(pool);
-    if (bufs_that_can_be_allocated > 0) {
-      /* We can at least allocate
-         min(bufs_that_can_be_allocated, bufs_to_allocate) */
-      bufs_to_allocate = ((bufs_to_allocate > bufs_that_can_be_allocated)
-                              ? bufs_that_can_be_allocated
-                              : bufs_to_allocate);
-
-      rc = freelist_allocate(pool, bufs_to_allocate);
-      if (rc != 0) {
-        if ((pool->flags & ENABLE_LOCKING) != 0) {
-          pthread_mutex_unlock(&pool->lock);
-        }
-        return NULL;
-      }
-    } else {
-      /* We cannot allocate any more buffers, reached max threshold */
-      if ((pool->flags & ENABLE_LOCKING) != 0) {
-        pthread_mutex_unlock(&pool->lock);
-      }
-      return NULL;
+  if (pool->free_bufs_in_pool == 0 && pool_expand(pool) != 0) {
+    if ((pool->flags & ENABLE_LOCKING) != 0) {
+      pthread_mutex_unlock(&pool->lock);
     }
+    return NULL;
   }
 
   /* Done with expansion of pool in case of pre allocated pools */
@@ -328,21 +549,11 @@ void *mempool_getbuffer(MemoryPoolHandle handle, size_t expected_buffer_size) {
   }
 
   if (pool_item) {
-    pool->number_of_bufs_shared++;
+    __atomic_add_fetch(&pool->number_of_bufs_shared, 1, __ATOMIC_RELAXED);
   }
 
   if (pool->log_callback_func) {
-    char log_mem_stats[1024];
-    char *log_memool_stats =
-        "S3 Mempool stats after allocation:"
-        "mempool_item_size = %zu "
-        "free_bufs_in_pool = %d "
-        "number_of_bufs_shared = %d "
-        "total_bufs_allocated_by_pool = %d\n";
-    snprintf(log_mem_stats, sizeof(log_mem_stats), log_memool_stats,
-             pool->mempool_item_size, pool->free_bufs_in_pool,
-             pool->number_of_bufs_shared, pool->total_bufs_allocated_by_pool);
-    pool->log_callback_func(MEMPOOL_LOG_DEBUG, log_mem_stats);
+    pool_log_stats(pool, "allocation");
   }
 
   if ((pool->flags & ENABLE_LOCKING) != 0) {
@@ -354,6 +565,7 @@ void *mempool_getbuffer(MemoryPoolHandle handle, size_t expected_buffer_size) {
 
 int mempool_releasebuffer(MemoryPoolHandle handle, void *buf,
                           size_t released_buffer_size) {
+  struct mempool_tcache *tc = NULL;
   struct mempool *pool = (struct mempool *)handle;
   struct memory_pool_element *pool_item = (struct memory_pool_element *)buf;
   char *log_msg_fmt =
@@ -376,6 +588,23 @@ int mempool_releasebuffer(MemoryPoolHandle handle, void *buf,
     }
   }
 
+  if ((pool->flags & ENABLE_THREAD_CACHE) != 0 &&
+      (tc = tcache_get(pool)) != NULL) {
+    if ((pool->flags & ZEROED_BUFFER) != 0) {
+      memset(pool_item, 0, pool->mempool_item_size);
+    }
+    if (tc->count >= pool->tcache_capacity) {
+      tcache_drain(pool, tc, pool->tcache_batch);
+    }
+    tc->items[tc->count++] = pool_item;
+    __atomic_add_fetch(&pool->bufs_in_tcaches, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&pool->number_of_bufs_shared, 1, __ATOMIC_RELAXED);
+    if (pool->log_callback_func) {
+      pool_log_stats(pool, "de-allocation");
+    }
+    return 0;
+  }
+
   if ((pool->flags & ENABLE_LOCKING) != 0) {
     pthread_mutex_lock(&pool->lock);
   }
@@ -392,20 +621,10 @@ int mempool_releasebuffer(MemoryPoolHandle handle, void *buf,
   pool->free_bufs_in_pool++;
   pool_item = NULL;
 
-  pool->number_of_bufs_shared--;
+  __atomic_sub_fetch(&pool->number_of_bufs_shared, 1, __ATOMIC_RELAXED);
 
   if (pool->log_callback_func) {
-    char log_mem_stats[1024];
-    char *log_memool_stats =
-        "S3 Mempool stats after de-allocation:"
-        "mempool_item_size = %zu "
-        "free_bufs_in_pool = %d "
-        "number_of_bufs_shared = %d "
-        "total_bufs_allocated_by_pool = %d\n";
-    snprintf(log_mem_stats, sizeof(log_mem_stats), log_memool_stats,
-             pool->mempool_item_size, pool->free_bufs_in_pool,
-             pool->number_of_bufs_shared, pool->total_bufs_allocated_by_pool);
-    pool->log_callback_func(MEMPOOL_LOG_DEBUG, log_mem_stats);
+    pool_log_stats(pool, "de-allocation");
   }
 
   if ((pool->flags & ENABLE_LOCKING) != 0) {
@@ -426,8 +645,11 @@ int mempool_getinfo(MemoryPoolHandle handle, struct pool_info *poolinfo) {
   }
 
   poolinfo->mempool_item_size = pool->mempool_item_size;
-  poolinfo->free_bufs_in_pool = pool->free_bufs_in_pool;
-  poolinfo->number_of_bufs_shared = pool->number_of_bufs_shared;
+  poolinfo->free_bufs_in_pool =
+      pool->free_bufs_in_pool +
+      __atomic_load_n(&pool->bufs_in_tcaches, __ATOMIC_RELAXED);
+  poolinfo->number_of_bufs_shared =
+      __atomic_load_n(&pool->number_of_bufs_shared, __ATOMIC_RELAXED);
   poolinfo->expandable_size = pool->expandable_size;
   poolinfo->total_bufs_allocated_by_pool = pool->total_bufs_allocated_by_pool;
   poolinfo->flags = pool->flags;
@@ -449,7 +671,9 @@ int mempool_reserved_space(MemoryPoolHandle handle, size_t *free_bytes) {
     pthread_mutex_lock(&pool->lock);
   }
 
-  *free_bytes = pool->mempool_item_size * pool->free_bufs_in_pool;
+  *free_bytes = pool->mempool_item_size *
+                (pool->free_bufs_in_pool +
+                 __atomic_load_n(&pool->bufs_in_tcaches, __ATOMIC_RELAXED));
 
   if ((pool->flags & ENABLE_LOCKING) != 0) {
     pthread_mutex_unlock(&pool->lock);
@@ -466,7 +690,8 @@ int mempool_available_space(MemoryPoolHandle p_pool, size_t *p_avail_bytes) {
     pthread_mutex_lock(&p_pool->lock);
   }
   const size_t used_space =
-      p_pool->number_of_bufs_shared * p_pool->mempool_item_size;
+      __atomic_load_n(&p_pool->number_of_bufs_shared, __ATOMIC_RELAXED) *
+      p_pool->mempool_item_size;
   const size_t max_memory_threshold = p_pool->max_memory_threshold;
 
   *p_avail_bytes =
@@ -537,7 +762,7 @@ int mempool_downsize(MemoryPoolHandle handle, size_t mem_to_free) {
       pool_item = pool->free_list;
     }
     if (pool->mem_mark_free_space_func) {
-      pool->mem_mark_free_space_func(bufs_to_free * pool->mempool_item_size);
+      pool->mem_mark_free_space_func(bufs_to_free * pool_item_footprint(pool));
     }
   }
 
@@ -547,6 +772,38 @@ int mempool_downsize(MemoryPoolHandle handle, size_t mem_to_free) {
   return 0;
 }
 
+int mempool_set_numa_node(MemoryPoolHandle handle, int numa_node) {
+  struct mempool *pool = (struct mempool *)handle;
+  struct memory_pool_element *pool_item;
+
+  if (pool == NULL || numa_node < -1) {
+    return S3_MEMPOOL_INVALID_ARG;
+  }
+
+  if ((pool->flags & ENABLE_LOCKING) != 0) {
+    pthread_mutex_lock(&pool->lock);
+  }
+
+  pool->numa_node = numa_node;
+  /* Migrate what is already preallocated */
+  for (pool_item = pool->free_list; pool_item != NULL;
+       pool_item = pool_item->next) {
+    pool_bind_to_node(pool, pool_item);
+  }
+
+  if ((pool->flags & ENABLE_LOCKING) != 0) {
+    pthread_mutex_unlock(&pool->lock);
+  }
+  return 0;
+}
+
+int mempool_buffer_numa_node(void *buf, size_t item_size) {
+  struct memory_pool_buffer_trailer trailer;
+
+  memcpy(&trailer, (char *)buf + item_size, sizeof(trailer));
+  return trailer.owner->numa_node;
+}
+
 int mempool_destroy(MemoryPoolHandle *handle) {
   struct mempool *pool = NULL;
   struct memory_pool_element *pool_item;
@@ -562,6 +819,11 @@ int mempool_destroy(MemoryPoolHandle *handle) {
     return S3_MEMPOOL_INVALID_ARG;
   }
 
+  if ((pool->flags & ENABLE_THREAD_CACHE) != 0) {
+    /* No more thread exit destructors for this pool after this */
+    pthread_key_delete(pool->tcache_key);
+  }
+
   if ((pool->flags & ENABLE_LOCKING) != 0) {
     pthread_mutex_lock(&pool->lock);
   }
@@ -575,6 +837,17 @@ int mempool_destroy(MemoryPoolHandle *handle) {
 
   /* reset the handle */
   *handle = NULL;
+  /* Return the buffers parked in per-thread magazines to the free list */
+  while (pool->tcaches != NULL) {
+    struct mempool_tcache *tc = pool->tcaches;
+    while (tc->count > 0) {
+      pool_item = (struct memory_pool_element *)tc->items[--tc->count];
+      pool_item->next = pool->free_list;
+      pool->free_list = pool_item;
+    }
+    tcache_unlink(pool, tc);
+    free(tc);
+  }
   /* Free the items in free list */
   pool_item = pool->free_list;
   while (pool_item != NULL) {
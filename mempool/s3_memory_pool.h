@@ -34,6 +34,21 @@ extern "C" {
 #define CREATE_ALIGNED_MEMORY 0x0001
 #define ENABLE_LOCKING 0x0002
 #define ZEROED_BUFFER 0x0004
+/* Front the shared free list with per-thread magazines so that most
+   mempool_getbuffer/mempool_releasebuffer calls do not take the pool lock.
+   Magazines are refilled from and drained to the shared free list in
+   batches. Implies ENABLE_LOCKING. */
+#define ENABLE_THREAD_CACHE 0x0008
+/* Reserve a pointer sized trailer behind every buffer recording the pool that
+   owns it, see mempool_buffer_numa_node(). The trailer is accounted as used
+   memory; buffers keep their alignment. */
+#define ENABLE_BUFFER_OWNER 0x0010
+
+/* Upper bound on buffers cached per thread, per pool */
+#define MEMPOOL_TCACHE_MAX_ITEMS 64
+/* Upper bound on bytes cached per thread, per pool. Pools with large items
+   get proportionally shallower magazines (minimum of 2 items). */
+#define MEMPOOL_TCACHE_MAX_BYTES (1024 * 1024)
 
 #define MEMORY_ALIGNMENT 4096
 #define S3_MEMPOOL_ERROR -1
@@ -122,7 +137,8 @@ struct pool_info {
  * pool_max_threshold_size (in) maximum allowed memory utilization(Consumed by
  * app. + free list in pool)
  * when done via the pool
- * flags (in) if ENABLE_LOCKING then pool synchronization with lock
+ * flags (in) if ENABLE_LOCKING then pool synchronization with lock,
+ * if ENABLE_THREAD_CACHE then per-thread magazines in front of the lock
  * p_handle (out) On success pool handle is returned here
  * returns:
  * 0 on success, otherwise an error
@@ -165,6 +181,8 @@ int mempool_releasebuffer(MemoryPoolHandle handle, void *buf,
 
 /**
  * Returns info about the memory pool
+ * With ENABLE_THREAD_CACHE, free_bufs_in_pool includes buffers parked in
+ * per-thread magazines, so the numbers are aggregate for the whole pool.
  * args:
  * handle (in) Pool handle as returned by mempool_create
  * poolinfo (out) information about the pool
@@ -231,6 +249,31 @@ int mempool_downsize(MemoryPoolHandle handle, size_t mem_to_free);
  */
 int mempool_resize(MemoryPoolHandle handle, int new_max_threshold);
 
+/**
+ * Prefer allocating this pool's memory on the given NUMA node. Buffers already
+ * on the free list are migrated, later expansions are bound as they are
+ * allocated. Binding is best effort and only done for pools created with
+ * CREATE_ALIGNED_MEMORY.
+ * args:
+ * handle (in) Pool handle as returned by mempool_create
+ * numa_node (in) NUMA node id, -1 to not bind (default)
+ * returns:
+ * 0 on success, otherwise an error
+ */
+int mempool_set_numa_node(MemoryPoolHandle handle, int numa_node);
+
+/**
+ * Returns the NUMA node set with mempool_set_numa_node() on the pool that
+ * allocated the buffer, read from the buffer trailer without any locking.
+ * args:
+ * buf (in) item allocated via mempool_getbuffer() of a pool created with
+ * ENABLE_BUFFER_OWNER
+ * item_size (in) item size of that pool
+ * returns:
+ * NUMA node id, -1 if the owning pool is not bound to a node
+ */
+int mempool_buffer_numa_node(void *buf, size_t item_size);
+
 /**
  * Destroy mem pool object along with all memories in its free list
  * Call this api when the application is shutting down, Api will assert in case
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "s3_memory_pool.h"
+
+#define MT_BUF_SIZE 16384
+#define MT_THREADS 8
+#define MT_ITERATIONS 200000
+#define MT_BUFS_HELD 8
+
+// Multi-threaded alloc/free throughput, shared free list vs per-thread
+// magazines. Throughput is printed for comparison; only pool accounting is
+// asserted so the test is stable on loaded build machines.
+class MempoolMultiThreadTestSuite : public testing::Test {
+ protected:
+  void SetUp() { handle = NULL; }
+
+  void TearDown() {
+    if (handle != NULL) {
+      mempool_destroy(&handle);
+    }
+  }
+
+  static void worker(MemoryPoolHandle pool, int iterations, int *failures) {
+    void *bufs[MT_BUFS_HELD];
+    for (int i = 0; i < iterations; i += MT_BUFS_HELD) {
+      for (int j = 0; j < MT_BUFS_HELD; j++) {
+        bufs[j] = mempool_getbuffer(pool, MT_BUF_SIZE);
+        if (bufs[j] == NULL) {
+          ++*failures;
+        } else {
+          *(char *)bufs[j] = 'x';
+        }
+      }
+      for (int j = 0; j < MT_BUFS_HELD; j++) {
+        if (bufs[j] != NULL) {
+          mempool_releasebuffer(pool, bufs[j], MT_BUF_SIZE);
+        }
+      }
+    }
+  }
+
+  // Returns alloc+free operations per second across all threads
+  double run(int flags, const char *name) {
+    std::vector<std::thread> threads;
+    std::vector<int> failures(MT_THREADS, 0);
+
+    EXPECT_EQ(0, mempool_create(MT_BUF_SIZE, MT_BUF_SIZE * 64,
+                                MT_BUF_SIZE * 64, MT_BUF_SIZE * 4096,
+                                (func_log_callback_type)NULL, flags, &handle));
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < MT_THREADS; t++) {
+      threads.emplace_back(worker, handle, MT_ITERATIONS, &failures[t]);
+    }
+    for (auto &th : threads) {
+      th.join();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    for (int t = 0; t < MT_THREADS; t++) {
+      EXPECT_EQ(0, failures[t]);
+    }
+
+    // Exited threads returned their magazines, totals must add up
+    EXPECT_EQ(0, mempool_getinfo(handle, &pool_details));
+    EXPECT_EQ(0, pool_details.number_of_bufs_shared);
+    EXPECT_EQ(pool_details.total_bufs_allocated_by_pool,
+              pool_details.free_bufs_in_pool);
+
+    double ops = 2.0 * MT_THREADS * MT_ITERATIONS / elapsed.count();
+    printf("[ mempool  ] %-14s %d threads: %.0f ops/sec\n", name, MT_THREADS,
+           ops);
+    mempool_destroy(&handle);
+    return ops;
+  }
+
+  MemoryPoolHandle handle;
+  struct pool_info pool_details;
+};
+
+TEST_F(MempoolMultiThreadTestSuite, ThroughputLockedVsThreadCache) {
+  double locked = run(ENABLE_LOCKING, "locked");
+  double cached = run(ENABLE_LOCKING | ENABLE_THREAD_CACHE, "thread-cache");
+  printf("[ mempool  ] thread-cache speedup: %.2fx\n", cached / locked);
+}
+
+TEST_F(MempoolMultiThreadTestSuite, ThreadCacheAggregateInfo) {
+  void *buf;
+  size_t reserved = 0;
+
+  EXPECT_EQ(0, mempool_create(MT_BUF_SIZE, MT_BUF_SIZE * 4, MT_BUF_SIZE * 4,
+                              MT_BUF_SIZE * 16, (func_log_callback_type)NULL,
+                              ENABLE_THREAD_CACHE | ZEROED_BUFFER, &handle));
+  EXPECT_EQ(0, mempool_getinfo(handle, &pool_details));
+  // ENABLE_THREAD_CACHE implies locking
+  EXPECT_NE(0, pool_details.flags & ENABLE_LOCKING);
+  EXPECT_EQ(4, pool_details.free_bufs_in_pool);
+
+  // Refill moves a batch into this thread's magazine, still counted as free
+  buf = mempool_getbuffer(handle, MT_BUF_SIZE);
+  ASSERT_NE((void *)NULL, buf);
+  EXPECT_EQ(0, mempool_getinfo(handle, &pool_details));
+  EXPECT_EQ(1, pool_details.number_of_bufs_shared);
+  EXPECT_EQ(3, pool_details.free_bufs_in_pool);
+  EXPECT_EQ(0, mempool_reserved_space(handle, &reserved));
+  EXPECT_EQ((size_t)(3 * MT_BUF_SIZE), reserved);
+
+  memset(buf, 0xab, MT_BUF_SIZE);
+  EXPECT_EQ(0, mempool_releasebuffer(handle, buf, MT_BUF_SIZE));
+  EXPECT_EQ(0, mempool_getinfo(handle, &pool_details));
+  EXPECT_EQ(0, pool_details.number_of_bufs_shared);
+  EXPECT_EQ(4, pool_details.free_bufs_in_pool);
+
+  // Released buffer comes back zeroed from the magazine
+  buf = mempool_getbuffer(handle, MT_BUF_SIZE);
+  ASSERT_NE((void *)NULL, buf);
+  EXPECT_EQ(0, ((char *)buf)[MT_BUF_SIZE - 1]);
+  EXPECT_EQ(0, mempool_releasebuffer(handle, buf, MT_BUF_SIZE));
+}
+
+TEST_F(MempoolMultiThreadTestSuite, ThreadCacheHonoursMaxThreshold) {
+  std::vector<void *> bufs;
+  void *buf;
+
+  EXPECT_EQ(0, mempool_create(MT_BUF_SIZE, 0, MT_BUF_SIZE * 2,
+                              MT_BUF_SIZE * 6, (func_log_callback_type)NULL,
+                              ENABLE_THREAD_CACHE, &handle));
+  while ((buf = mempool_getbuffer(handle, MT_BUF_SIZE)) != NULL) {
+    bufs.push_back(buf);
+  }
+  EXPECT_EQ(6u, bufs.size());
+  for (void *b : bufs) {
+    EXPECT_EQ(0, mempool_releasebuffer(handle, b, MT_BUF_SIZE));
+  }
+  EXPECT_EQ(0, mempool_getinfo(handle, &pool_details));
+  EXPECT_EQ(6, pool_details.total_bufs_allocated_by_pool);
+  EXPECT_EQ(6, pool_details.free_bufs_in_pool);
+}
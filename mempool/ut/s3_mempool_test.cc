@@ -232,6 +232,44 @@ TEST_F(MempoolSelfCreateTestSuite, PoolExpansionTest) {
   mempool_destroy(&first_handle);
 }
 
+// Buffers of ENABLE_BUFFER_OWNER pools know the node of their pool
+TEST_F(MempoolSelfCreateTestSuite, BufferOwnerTest) {
+  EXPECT_EQ(0, mempool_create(FOUR_KB, FOUR_KB, FOUR_KB, TWENTYFOUR_KB,
+                              (func_log_callback_type)NULL,
+                              CREATE_ALIGNED_MEMORY | ENABLE_BUFFER_OWNER,
+                              &first_handle));
+  EXPECT_EQ(0, mempool_create(FOUR_KB, 0, FOUR_KB, TWENTYFOUR_KB,
+                              (func_log_callback_type)NULL, ENABLE_BUFFER_OWNER,
+                              &second_handle));
+  EXPECT_EQ(0, mempool_set_numa_node(first_handle, 1));
+
+  void *first_buf = mempool_getbuffer(first_handle, FOUR_KB);
+  void *second_buf = mempool_getbuffer(second_handle, FOUR_KB);
+  EXPECT_TRUE(first_buf != NULL);
+  EXPECT_TRUE(second_buf != NULL);
+  // Trailer does not break the alignment
+  EXPECT_TRUE(((uint64_t)first_buf & 4095) == 0);
+  EXPECT_EQ(1, mempool_buffer_numa_node(first_buf, FOUR_KB));
+  EXPECT_EQ(-1, mempool_buffer_numa_node(second_buf, FOUR_KB));
+
+  // Trailer takes a pointer per buffer, so 5 buffers fit instead of 6
+  void *bufs[5];
+  for (int i = 0; i < 5; i++) {
+    bufs[i] = mempool_getbuffer(first_handle, FOUR_KB);
+  }
+  EXPECT_TRUE(bufs[3] != NULL);
+  EXPECT_TRUE(bufs[4] == NULL);
+  EXPECT_EQ(1, mempool_buffer_numa_node(bufs[3], FOUR_KB));
+
+  for (int i = 0; i < 4; i++) {
+    mempool_releasebuffer(first_handle, bufs[i], FOUR_KB);
+  }
+  mempool_releasebuffer(first_handle, first_buf, FOUR_KB);
+  mempool_releasebuffer(second_handle, second_buf, FOUR_KB);
+  mempool_destroy(&first_handle);
+  mempool_destroy(&second_handle);
+}
+
 TEST_F(MempoolTestSuite, MemPoolFreeTest) {
   EXPECT_EQ(0, mempool_getinfo(handle, &firstpass_pool_details));
 
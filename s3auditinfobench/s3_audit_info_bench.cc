@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/*
+   Measures heap allocations and time per audit record.
+
+   "json_value" builds the record the way S3AuditInfo::to_string() used to,
+   a Json::Value written by Json::FastWriter. "format" fills S3AuditInfo as
+   S3RequestObject does and formats it into a buffer reused across records,
+   like S3AuditInfoLoggerBase::save_record(). "format_new_buffer" formats
+   into a fresh string per record, like the Kafka Web logger. Setting the
+   fields is counted in each case.
+
+   Usage example:
+   ./s3auditinfobench -records 1000000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <new>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <json/json.h>
+
+#include "s3_audit_info.h"
+
+DEFINE_int64(records, 100000, "Number of records formatted per case");
+
+static size_t allocations;
+
+void* operator new(size_t size) {
+  ++allocations;
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+// Strings a request owns or builds for its audit record
+struct SampleRequest {
+  std::string bucket_owner = "c0f6b7a3d4e24d1e8f6a9b2c3d4e5f60";
+  std::string bucket = "seagatebucket";
+  std::string remote_ip = "192.168.10.25";
+  std::string requester = "a5e6b7c8d9e04f1a2b3c4d5e6f708192";
+  std::string request_id = "b1a2c3d4-e5f6-4789-8abc-def012345678";
+  std::string object_key = "/seagatebucket/dir/OneMBfile";
+  std::string request_uri = "PUT /seagatebucket/dir/OneMBfile HTTP/1.1";
+  std::string authorization = "AWS4-HMAC-SHA256 Credential=AKIA/20201016";
+  std::string user_agent = "aws-cli/1.18.69 Python/3.6.8 botocore/1.16.19";
+  std::string host = "s3.seagate.com";
+};
+
+static void fill(S3AuditInfo& audit_info, const SampleRequest& request) {
+  audit_info.set_authentication_type("AuthHeader");
+  audit_info.set_time_of_request_arrival(1602806400);
+  audit_info.set_bucket_owner_canonical_id(request.bucket_owner);
+  audit_info.set_turn_around_time(12);
+  audit_info.set_total_time(15);
+  audit_info.set_bytes_sent(0);
+  audit_info.set_bucket_name(request.bucket);
+  // Header values and built strings are temporaries in S3RequestObject
+  audit_info.set_remote_ip(std::string(request.remote_ip));
+  audit_info.set_bytes_received(1048576);
+  audit_info.set_requester(request.requester);
+  audit_info.set_request_id(request.request_id);
+  audit_info.set_operation(std::string("REST.PUT.OBJECT"));
+  audit_info.set_object_key(std::string(request.object_key));
+  audit_info.set_request_uri(std::string(request.request_uri));
+  audit_info.set_http_status(200);
+  audit_info.set_signature_version(request.authorization);
+  audit_info.set_user_agent(std::string(request.user_agent));
+  audit_info.set_version_id(std::string());
+  audit_info.set_object_size(1048576);
+  audit_info.set_host_header(std::string(request.host));
+}
+
+// Previous S3AuditInfo::to_string() for JSON, with the fields it held
+static std::string json_value_record(const SampleRequest& request,
+                                     const std::string& request_time) {
+  Json::Value audit;
+
+  audit["bucket_owner"] = request.bucket_owner;
+  audit["bucket"] = request.bucket;
+  audit["time"] = request_time;
+  audit["remote_ip"] = request.remote_ip;
+  audit["requester"] = request.requester;
+  audit["request_id"] = request.request_id;
+  audit["operation"] = "REST.PUT.OBJECT";
+  audit["key"] = request.object_key;
+  audit["request_uri"] = request.request_uri;
+  audit["http_status"] = 200;
+  audit["error_code"] = "-";
+  audit["bytes_sent"] = (Json::UInt64)0;
+  audit["object_size"] = (Json::UInt64)1048576;
+  audit["bytes_received"] = (Json::UInt64)1048576;
+  audit["total_time"] = (Json::UInt64)15;
+  audit["turn_around_time"] = (Json::UInt64)12;
+  audit["referrer"] = "-";
+  audit["user_agent"] = request.user_agent;
+  audit["version_id"] = "";
+  audit["host_id"] = "-";
+  audit["signature_version"] = "SigV4";
+  audit["cipher_suite"] = "-";
+  audit["authentication_type"] = "AuthHeader";
+  audit["host_header"] = request.host;
+
+  Json::FastWriter fastWriter;
+  return fastWriter.write(audit);
+}
+
+template <typename F>
+static void run(const char* name, F format_record) {
+  size_t bytes = 0;
+  size_t start_allocations = allocations;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int64_t i = 0; i < FLAGS_records; ++i) {
+    bytes += format_record();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+
+  printf("%-18s %8.2f allocations/record %8.1f ns/record %zu bytes\n", name,
+         (double)(allocations - start_allocations) / FLAGS_records,
+         ns / FLAGS_records, bytes);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_records <= 0) {
+    fprintf(stderr, "-records must be positive\n");
+    return 1;
+  }
+
+  const SampleRequest request;
+  std::string request_time;
+  {
+    // Previous S3AuditInfo formatted the time once, on arrival
+    S3AuditInfo audit_info;
+    audit_info.set_time_of_request_arrival(1602806400);
+    std::string record = audit_info.to_string(AuditFormatType::S3_FORMAT);
+    size_t begin = record.find('[');
+    request_time = record.substr(begin, record.find(']') - begin + 1);
+  }
+
+  S3AuditInfo sample;
+  fill(sample, request);
+  if (sample.to_string(AuditFormatType::JSON) !=
+      json_value_record(request, request_time)) {
+    fprintf(stderr, "Formatted record differs from Json::FastWriter's\n");
+    return 1;
+  }
+
+  run("json_value", [&]() {
+    S3AuditInfo audit_info;
+    fill(audit_info, request);
+    return json_value_record(request, request_time).size();
+  });
+
+  std::string buffer;
+  run("format", [&]() {
+    S3AuditInfo audit_info;
+    fill(audit_info, request);
+    buffer.clear();
+    audit_info.format(AuditFormatType::JSON, buffer);
+    return buffer.size();
+  });
+
+  run("format_new_buffer", [&]() {
+    S3AuditInfo audit_info;
+    fill(audit_info, request);
+    std::string msg;
+    audit_info.format(AuditFormatType::JSON, msg);
+    return msg.size();
+  });
+
+  run("format_s3", [&]() {
+    S3AuditInfo audit_info;
+    fill(audit_info, request);
+    buffer.clear();
+    audit_info.format(AuditFormatType::S3_FORMAT, buffer);
+    return buffer.size();
+  });
+  return 0;
+}
@@ -265,18 +265,24 @@ class ObjectRecoveryValidator:
 
         # Assumption: Key = <current oid>-<new oid> for
         # an old object of PUT overwrite request
+        # Key = <data oid>-<copy oid> for a copy sharing data of another object
+        # (S3_COPY_OBJECT_BY_REFERENCE), so old object key of such a copy is
+        # <current oid>-<data oid>-<copy oid>
+        oil_list = self.object_leak_id.split("-")
         if (self.object_leak_info["old_oid"] == NULL_OBJ_OID):
             # In general, this record is for old object
             # For old object of PUT overwrite request, the key of probable leak record contains 4 '-'
             #   Each object oid has 1 '-', seperating high and low values
             # e.g., variable 'probable_delete_oid' contains: "Tgj8AgAAAAA=-kwAAAAAABCY=-Tgj8AgAAAAA=-lgAAAAAABCY="
             # where old obj id is "Tgj8AgAAAAA=-kwAAAAAABCY=" and new obj id is "Tgj8AgAAAAA=-lgAAAAAABCY="
-            oil_list = self.object_leak_id.split("-")
-            if (oil_list is None or (len(oil_list) not in [2, 4])):
+            if (oil_list is None or (len(oil_list) not in [2, 4, 6])):
                 self._logger.error("The key for old object " + str(self.object_leak_id) +
                                    " is not in the required format 'oldoid-newoid'")
                 return
             self.object_leak_id = oil_list[0] + "-" + oil_list[1]
+        elif (len(oil_list) == 4):
+            # New object of a copy sharing data
+            self.object_leak_id = oil_list[0] + "-" + oil_list[1]
 
         # Determine object leak using information in metadata
         # Below is the implementaion of leak algorithm
@@ -44,6 +44,7 @@ struct s3_motr_idx_layout global_bucket_list_index_layout;
 struct s3_motr_idx_layout bucket_metadata_list_index_layout;
 struct s3_motr_idx_layout global_instance_list_index_layout;
 struct s3_motr_idx_layout global_probable_dead_object_list_index_layout;
+struct s3_motr_idx_layout global_object_data_ref_index_layout;
 
 struct m0_uint128 global_instance_id;
 pthread_t global_tid_indexop;
@@ -249,6 +250,45 @@ TEST_F(S3MempoolManagerTestSuite, PoolShouldGrowByDownsizingUnusedPool) {
   EXPECT_TRUE(S3MempoolManager::instance == NULL);
 }
 
+TEST_F(S3MempoolManagerTestSuite, NumaAwarePoolPerNode) {
+  std::vector<int> unit_sizes{FOUR_KB, EIGHT_KB};
+
+  EXPECT_EQ(0, S3MempoolManager::free_space);
+  EXPECT_TRUE(S3MempoolManager::instance == NULL);
+
+  int rc = S3MempoolManager::create_pool(
+      TWENTYFOUR_KB * 4,      // max threshold
+      unit_sizes,             // supported unit_sizes
+      1,                      // initial_buffer_count_per_pool
+      1,                      // expandable_count
+      CREATE_ALIGNED_MEMORY,  // Flags
+      true);                  // numa_aware
+  EXPECT_EQ(0, rc);
+
+  S3MempoolManager *mgr = S3MempoolManager::get_instance();
+  int numa_nodes = mgr->get_numa_nodes();
+  EXPECT_LE(1, numa_nodes);
+  EXPECT_EQ(2, mgr->pool_of_mem_pool.size());
+  EXPECT_EQ(numa_nodes, mgr->pool_of_mem_pool[FOUR_KB].size());
+  EXPECT_EQ(numa_nodes, mgr->pool_of_mem_pool[EIGHT_KB].size());
+
+  void *buffer_1 = mgr->get_buffer_for_unit_size(FOUR_KB);
+  EXPECT_TRUE(buffer_1 != NULL);
+  EXPECT_EQ(0, mgr->release_buffer_for_unit_size(buffer_1, FOUR_KB));
+
+  // Served from some node, local unless the thread migrated in between
+  uint64_t allocs = 0;
+  for (int node = 0; node < numa_nodes; ++node) {
+    allocs += mgr->get_numa_node_stats(node).local_allocs +
+              mgr->get_numa_node_stats(node).remote_allocs;
+  }
+  EXPECT_EQ(1, allocs);
+
+  S3MempoolManager::destroy_instance();
+  EXPECT_EQ(0, S3MempoolManager::free_space);
+  EXPECT_TRUE(S3MempoolManager::instance == NULL);
+}
+
 int main(int argc, char **argv) {
   int rc = 0;
 
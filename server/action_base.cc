@@ -25,6 +25,7 @@
 #include "s3_stats.h"
 
 std::map<std::string, uint64_t> Action::s3_task_name_to_addb_task_id_map;
+std::vector<S3LatencyPhase> Action::s3_addb_task_id_to_latency_phase;
 
 void Action::s3_task_name_to_addb_task_id_map_init() {
   if (s3_task_name_to_addb_task_id_map.size() ==
@@ -32,10 +33,15 @@ void Action::s3_task_name_to_addb_task_id_map_init() {
     return;
   }
 
+  s3_addb_task_id_to_latency_phase.clear();
+
   uint64_t idx = 0;
   for (; idx < g_s3_to_addb_idx_func_name_map_size; ++idx) {
     s3_task_name_to_addb_task_id_map[g_s3_to_addb_idx_func_name_map[idx]] =
         idx + ADDB_TASK_LIST_OFFSET;
+    s3_addb_task_id_to_latency_phase.push_back(
+        S3LatencyHistograms::get_task_phase(
+            g_s3_to_addb_idx_func_name_map[idx]));
   }
 }
 
@@ -49,6 +55,9 @@ Action::Action(std::shared_ptr<RequestObject> req, bool check_shutdown,
       invalid_request(false),
       skip_auth(skip_auth),
       skip_authorization(skip_authorization),
+      latency_phase(S3LatencyPhase::other),
+      latency_started(false),
+      latency_recorded(false),
       action_uses_cleanup(false),
       cleanup_started(false) {
 
@@ -147,10 +156,21 @@ void Action::start() {
     return;
   }
 
+  if (!latency_started) {
+    latency_started = true;
+    latency_start = latency_phase_start = std::chrono::steady_clock::now();
+    // Taken now, some actions rename the API while running
+    latency_api_name = get_latency_api_name();
+  } else {
+    // Started again for cleanup, the response has been sent
+    record_latency();
+  }
+
   task_iteration_index = 0;
   if (task_list.size() > 0) {
     ADDB(get_addb_action_type_id(), addb_request_id,
          task_addb_id_list[task_iteration_index]);
+    set_latency_phase(task_latency_phase_list[task_iteration_index]);
 
     task_list[task_iteration_index++]();
   }
@@ -174,6 +194,7 @@ void Action::next() {
       // independent of S3 client connection.
       ADDB(get_addb_action_type_id(), addb_request_id,
            task_addb_id_list[task_iteration_index]);
+      set_latency_phase(task_latency_phase_list[task_iteration_index]);
 
       task_list[task_iteration_index++]();
     } else {
@@ -189,12 +210,40 @@ void Action::next() {
 }
 
 void Action::done() {
+  record_latency();
   task_iteration_index = 0;
   state = ACTS_COMPLETE;
   ADDB(get_addb_action_type_id(), addb_request_id, (uint64_t)state);
   i_am_done();
 }
 
+void Action::set_latency_phase(S3LatencyPhase phase) {
+  if (!latency_started || latency_recorded) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+
+  latency_sample.phase_usec[(unsigned)latency_phase] +=
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          now - latency_phase_start).count();
+  latency_sample.phases_seen |= 1U << (unsigned)phase;
+  latency_phase = phase;
+  latency_phase_start = now;
+}
+
+void Action::record_latency() {
+  if (!latency_started || latency_recorded) {
+    return;
+  }
+  set_latency_phase(latency_phase);
+  latency_sample.total_usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          latency_phase_start - latency_start).count();
+  latency_recorded = true;
+
+  S3LatencyHistograms::record(latency_api_name, latency_sample);
+}
+
 void Action::pause() {
   // Set state as Paused.
   state = ACTS_PAUSED;
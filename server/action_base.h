@@ -23,6 +23,7 @@
 #ifndef __S3_SERVER_ACTION_BASE_H__
 #define __S3_SERVER_ACTION_BASE_H__
 
+#include <chrono>
 #include <utility>
 #include <functional>
 #include <memory>
@@ -31,6 +32,7 @@
 #include "s3_auth_client.h"
 #include "s3_factory.h"
 #include "s3_fi_common.h"
+#include "s3_latency_histograms.h"
 #include "s3_log.h"
 #include "s3_memory_profile.h"
 #include "request_object.h"
@@ -91,6 +93,8 @@ class Action {
  private:
   // Holds mapping from action's task name to addb idx
   static std::map<std::string, uint64_t> s3_task_name_to_addb_task_id_map;
+  // Latency phase of each task, by addb idx - ADDB_TASK_LIST_OFFSET
+  static std::vector<S3LatencyPhase> s3_addb_task_id_to_latency_phase;
   static void s3_task_name_to_addb_task_id_map_init();
 
  private:
@@ -101,6 +105,8 @@ class Action {
   std::vector<std::function<void()>> task_list;
   // Holds task's addb index
   std::vector<uint64_t> task_addb_id_list;
+  // Holds task's latency phase
+  std::vector<S3LatencyPhase> task_latency_phase_list;
   size_t task_iteration_index;
 
   // Hold member functions that will rollback
@@ -127,7 +133,18 @@ class Action {
 
   S3Timer auth_timer;
 
+  // Time spent in each phase, recorded in S3LatencyHistograms once the
+  // response is sent
+  S3LatencySample latency_sample;
+  S3LatencyPhase latency_phase;
+  std::chrono::steady_clock::time_point latency_start;
+  std::chrono::steady_clock::time_point latency_phase_start;
+  std::string latency_api_name;
+  bool latency_started;
+  bool latency_recorded;
+
   bool is_date_header_present_in_request() const;
+  void record_latency();
 
  protected:
   std::string request_id;
@@ -181,18 +198,30 @@ class Action {
              "Regenerate code with addb-codegen.py",
              func_name);
     }
+    uint64_t addb_id = s3_task_name_to_addb_task_id_map[func_name];
+
     task_list.push_back(std::move(task));
-    task_addb_id_list.push_back(s3_task_name_to_addb_task_id_map[func_name]);
+    task_addb_id_list.push_back(addb_id);
+    task_latency_phase_list.push_back(
+        s3_addb_task_id_to_latency_phase[addb_id - ADDB_TASK_LIST_OFFSET]);
   }
 
   void clear_tasks() {
     task_list.clear();
     task_addb_id_list.clear();
+    task_latency_phase_list.clear();
     task_iteration_index = 0;
   }
 
   std::shared_ptr<S3AuthClient>& get_auth_client() { return auth_client; }
 
+  // Charges time from now on to the phase. Tasks are charged to the phase
+  // of their name, see S3LatencyHistograms::get_task_phase(); steps which
+  // are not tasks of their own can mark their phase with this.
+  void set_latency_phase(S3LatencyPhase phase);
+  // Name latency of the request is recorded under, empty to not record it
+  virtual std::string get_latency_api_name() { return ""; }
+
   virtual void check_authorization_header();
 
   // Add tasks to list after each successful operation that needs rollback.
@@ -301,6 +330,7 @@ class Action {
   FRIEND_TEST(ActionTest, SkipAuthTest);
   FRIEND_TEST(ActionTest, EnableAuthTest);
   FRIEND_TEST(ActionTest, SetSkipAuthFlagAndSetS3OptionDisableAuthFlag);
+  FRIEND_TEST(ActionTest, TasksAreChargedToTheirLatencyPhase);
   FRIEND_TEST(S3APIHandlerTest, DispatchActionTest);
   FRIEND_TEST(MotrAPIHandlerTest, DispatchActionTest);
 };
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include "motr_helpers.h"
+#include "s3_motr_context.h"
 #include "s3_log.h"
 #include "s3_option.h"
 #include "s3_m0_uint128_helper.h"
@@ -205,6 +206,7 @@ void *thread_teardown_obj_ops(void *arg) {
 }
 
 void *teardown_obj_ops(void *) {
+  std::lock_guard<std::mutex> guard(global_motr_obj_lists_mutex);
   pthread_t tids[MAX_THREAD];
   if (global_motr_object_ops_list.size() != 0) {
     size_t count = 0;
@@ -239,6 +241,7 @@ void *teardown_obj_ops(void *) {
 }
 
 void *teardown_index_ops(void *) {
+  std::lock_guard<std::mutex> guard(global_motr_idx_lists_mutex);
   s3_log(S3_LOG_INFO, "", "Calling teardown of index operations...\n");
   for (auto idx_op_ctx : global_motr_idx_ops_list) {
     for (size_t i = 0; i < idx_op_ctx->op_count; i++) {
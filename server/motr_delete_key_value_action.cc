@@ -21,6 +21,7 @@
 #include "motr_delete_key_value_action.h"
 #include "s3_error_codes.h"
 #include "s3_m0_uint128_helper.h"
+#include "s3_object_metadata_cache.h"
 
 MotrDeleteKeyValueAction::MotrDeleteKeyValueAction(
     std::shared_ptr<MotrRequestObject> req, std::shared_ptr<MotrAPI> motr_api,
@@ -69,6 +70,7 @@ void MotrDeleteKeyValueAction::delete_key_value() {
       motr_kv_writer = motr_kvs_writer_factory_ptr->create_motr_kvs_writer(
           request, s3_motr_api);
     }
+    invalidate_cached_object_metadata();
     motr_kv_writer->delete_keyval(
         {index_id}, request->get_key_name(),
         std::bind(&MotrDeleteKeyValueAction::delete_key_value_successful, this),
@@ -80,12 +82,14 @@ void MotrDeleteKeyValueAction::delete_key_value() {
 
 void MotrDeleteKeyValueAction::delete_key_value_successful() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  invalidate_cached_object_metadata();
   next();
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
 void MotrDeleteKeyValueAction::delete_key_value_failed() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  invalidate_cached_object_metadata();
   if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::missing) {
     next();
   } else {
@@ -95,6 +99,15 @@ void MotrDeleteKeyValueAction::delete_key_value_failed() {
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+void MotrDeleteKeyValueAction::invalidate_cached_object_metadata() {
+  auto* p_cache = S3ObjectMetadataCache::get_instance();
+
+  if (p_cache) {
+    p_cache->invalidate(S3ObjectMetadataCache::make_key(
+        S3M0Uint128Helper::to_string(index_id), request->get_key_name()));
+  }
+}
+
 void MotrDeleteKeyValueAction::send_response_to_s3_client() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   if (is_error_state() && !get_s3_error_code().empty()) {
@@ -38,6 +38,9 @@ class MotrDeleteKeyValueAction : public MotrAction {
   std::shared_ptr<S3MotrKVSReaderFactory> motr_kvs_reader_factory_ptr;
   std::shared_ptr<S3MotrKVSWriterFactory> motr_kvs_writer_factory_ptr;
 
+  // The index may be object list index of a bucket
+  void invalidate_cached_object_metadata();
+
  public:
   MotrDeleteKeyValueAction(
       std::shared_ptr<MotrRequestObject> req,
@@ -21,6 +21,7 @@
 #include "motr_get_key_value_action.h"
 #include "s3_error_codes.h"
 #include "s3_m0_uint128_helper.h"
+#include "s3_metadata_record.h"
 
 MotrGetKeyValueAction::MotrGetKeyValueAction(
     std::shared_ptr<MotrRequestObject> req, std::shared_ptr<MotrAPI> motr_api,
@@ -111,7 +112,9 @@ void MotrGetKeyValueAction::send_response_to_s3_client() {
     }
     request->send_response(error.get_http_status_code(), response_xml);
   } else {
-    request->send_response(S3HttpSuccess200, motr_kv_reader->get_value());
+    request->send_response(
+        S3HttpSuccess200,
+        S3MetadataRecord::to_json(motr_kv_reader->get_value()));
   }
   done();
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
@@ -23,6 +23,7 @@
 #include "motr_kv_list_response.h"
 #include "s3_common_utilities.h"
 #include "s3_log.h"
+#include "s3_metadata_record.h"
 
 MotrKVListResponse::MotrKVListResponse(const std::string& encoding_type)
     : encoding_type(encoding_type),
@@ -83,7 +84,8 @@ void MotrKVListResponse::set_next_marker_key(const std::string& next) {
 
 void MotrKVListResponse::add_kv(const std::string& key,
                                 const std::string& value) {
-  kv_list[key] = value;
+  // Binary metadata records are given to clients as JSON
+  kv_list[key] = S3MetadataRecord::to_json(value);
 }
 
 unsigned int MotrKVListResponse::size() { return kv_list.size(); }
@@ -22,6 +22,7 @@
 #include "motr_put_key_value_action.h"
 #include "s3_error_codes.h"
 #include "s3_m0_uint128_helper.h"
+#include "s3_object_metadata_cache.h"
 
 MotrPutKeyValueAction::MotrPutKeyValueAction(
     std::shared_ptr<MotrRequestObject> req, std::shared_ptr<MotrAPI> motr_api,
@@ -85,6 +86,7 @@ void MotrPutKeyValueAction::read_and_validate_key_value() {
 void MotrPutKeyValueAction::put_key_value() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
+  invalidate_cached_object_metadata();
   motr_kv_writer->put_keyval(
       {index_id}, request->get_key_name(), json_value,
       std::bind(&MotrPutKeyValueAction::put_key_value_successful, this),
@@ -95,12 +97,14 @@ void MotrPutKeyValueAction::put_key_value() {
 
 void MotrPutKeyValueAction::put_key_value_successful() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  invalidate_cached_object_metadata();
   next();
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
 void MotrPutKeyValueAction::put_key_value_failed() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  invalidate_cached_object_metadata();
   if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::failed_to_launch) {
     s3_log(S3_LOG_ERROR, request_id,
            "Failed to retrive the key, due to pre launch failure\n");
@@ -146,6 +150,15 @@ bool MotrPutKeyValueAction::is_valid_json(std::string json_str) {
   return true;
 }
 
+void MotrPutKeyValueAction::invalidate_cached_object_metadata() {
+  auto* p_cache = S3ObjectMetadataCache::get_instance();
+
+  if (p_cache) {
+    p_cache->invalidate(S3ObjectMetadataCache::make_key(
+        S3M0Uint128Helper::to_string(index_id), request->get_key_name()));
+  }
+}
+
 void MotrPutKeyValueAction::send_response_to_s3_client() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
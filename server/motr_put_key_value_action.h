@@ -38,6 +38,9 @@ class MotrPutKeyValueAction : public MotrAction {
 
   bool is_valid_json(std::string);
 
+  // The index may be object list index of a bucket
+  void invalidate_cached_object_metadata();
+
  public:
   MotrPutKeyValueAction(
       std::shared_ptr<MotrRequestObject> req,
@@ -37,7 +37,8 @@
 
 extern S3Option* g_option_instance;
 
-uint64_t RequestObject::addb_request_id_gc = S3_ADDB_FIRST_GENERIC_REQUESTS_ID;
+std::atomic<uint64_t> RequestObject::addb_request_id_gc{
+    S3_ADDB_FIRST_GENERIC_REQUESTS_ID};
 
 // evhttp Helpers
 /* evhtp_kvs_iterator */
@@ -818,7 +819,27 @@ void RequestObject::send_response(int code, std::string body) {
     s3_log(S3_LOG_INFO, stripped_request_id,
            "Sending response as: [code:%d] [%s]\n", code, body.c_str());
   }
+  // If body not empty, write to response body.
+  if (!body.empty() && client_connected()) {
+    evbuffer_add(ev_req->buffer_out, body.c_str(), body.length());
+  }
+  finish_response(code, !body.empty());
+}
+
+void RequestObject::send_response_buffer(int code, struct evbuffer* p_body) {
+  assert(p_body != nullptr);
+  const size_t body_len = evbuffer_get_length(p_body);
 
+  s3_log(S3_LOG_INFO, stripped_request_id,
+         "Sending response as: [code:%d] [%zu bytes]\n", code, body_len);
+  if (body_len && client_connected()) {
+    // Chains are moved, not copied
+    evbuffer_add_buffer(ev_req->buffer_out, p_body);
+  }
+  finish_response(code, body_len != 0);
+}
+
+void RequestObject::finish_response(int code, bool has_body) {
   http_status = code;
   turn_around_time.stop();
 
@@ -830,15 +851,10 @@ void RequestObject::send_response(int code, std::string body) {
     request_timer.stop();
     return;
   }
-  // If body not empty, write to response body.
-  if (!body.empty()) {
-    evbuffer_add(ev_req->buffer_out, body.c_str(), body.length());
-
-  } else if (out_headers_copy.find("Content-Length") ==
-             out_headers_copy.end()) {  // Content-Length was already set for
-                                        // this request, which could be. case
-                                        // like HEAD object request, so dont
-                                        // add/update again
+  // Content-Length could be already set for this request, case like HEAD
+  // object request, so dont add/update again
+  if (!has_body &&
+      out_headers_copy.find("Content-Length") == out_headers_copy.end()) {
     set_out_header_value("Content-Length", "0");
   }
   set_out_header_value("x-amz-request-id", request_id);
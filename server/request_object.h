@@ -23,6 +23,7 @@
 #ifndef __S3_SERVER_REQUEST_OBJECT_H__
 #define __S3_SERVER_REQUEST_OBJECT_H__
 
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -304,6 +305,7 @@ class RequestObject {
   void stop_processing_incoming_data() {
     stop_client_read_timer();
     ignore_incoming_data = true;
+    chunk_parser.set_chunk_ready_callback(nullptr);
   }
 
   bool client_connected() const { return is_client_connected; }
@@ -324,6 +326,11 @@ class RequestObject {
     return chunk_parser.pop_chunk_detail();
   }
 
+  // Chunk hashes may complete after their data was consumed
+  virtual void set_chunk_detail_ready_callback(std::function<void()> callback) {
+    chunk_parser.set_chunk_ready_callback(std::move(callback));
+  }
+
   // Streaming
   // Note: Call this only if request object has to still receive from socket
   // Setup listeners for input data (data coming from s3 clients)
@@ -352,16 +359,21 @@ class RequestObject {
   }
   // See detailed comment in Action::addb_request_id.
   const uint64_t addb_request_id;
-  // Helper counter for assigning unique addb_request_id's for each request.
-  static uint64_t addb_request_id_gc;
+  // Helper counter for assigning unique addb_request_id's for each request,
+  // shared by all reactor threads.
+  static std::atomic<uint64_t> addb_request_id_gc;
 
   // Response Helpers
  private:
   struct evbuffer* reply_buffer;
   size_t used_mempool_buffer_count;
 
+  void finish_response(int code, bool has_body);
+
  public:
   virtual void send_response(int code, std::string body = "");
+  // Moves the content of p_body into the response, p_body is left empty
+  virtual void send_response_buffer(int code, struct evbuffer* p_body);
   virtual void send_reply_start(int code);
   virtual void send_reply_body(const char* data, int length);
   virtual void send_reply_body(struct evbuffer*);
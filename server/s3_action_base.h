@@ -78,6 +78,10 @@ class S3Action : public Action {
   // delay timer expires
   virtual void resume_action_step();
 
+  std::string get_latency_api_name() override {
+    return request->get_action_str();
+  }
+
   FRIEND_TEST(S3ActionTest, Constructor);
   FRIEND_TEST(S3ActionTest, ClientReadTimeoutCallBackRollback);
   FRIEND_TEST(S3ActionTest, ClientReadTimeoutCallBack);
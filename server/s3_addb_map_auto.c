@@ -25,7 +25,7 @@
 
 #include "s3_addb_map.h"
 
-const uint64_t g_s3_to_addb_idx_func_name_map_size = 210;
+const uint64_t g_s3_to_addb_idx_func_name_map_size = 217;
 
 const char* g_s3_to_addb_idx_func_name_map[] = {
     "Action::check_authentication",
@@ -78,7 +78,7 @@ const char* g_s3_to_addb_idx_func_name_map[] = {
     "S3BucketActionTest::func_callback_one",
     "S3CopyObjectAction::check_source_bucket_authorization",
     "S3CopyObjectAction::copy_object",
-    "S3CopyObjectAction::create_object",
+    "S3CopyObjectAction::create_destination_object",
     "S3CopyObjectAction::save_metadata",
     "S3CopyObjectAction::send_response_to_s3_client",
     "S3CopyObjectAction::set_source_bucket_authorization_metadata",
@@ -122,6 +122,7 @@ const char* g_s3_to_addb_idx_func_name_map[] = {
     "S3GetBucketTaggingAction::send_response_to_s3_client",
     "S3GetBucketlocationAction::fetch_bucket_info",
     "S3GetBucketlocationAction::send_response_to_s3_client",
+    "S3GetLatencyHistogramsAction::send_response_to_s3_client",
     "S3GetMultipartBucketAction::get_next_objects",
     "S3GetMultipartBucketAction::send_response_to_s3_client",
     "S3GetMultipartPartAction::get_key_object",
@@ -200,26 +201,32 @@ const char* g_s3_to_addb_idx_func_name_map[] = {
     "S3PutChunkUploadObjectActionTestBase::func_callback_one",
     "S3PutFiAction::send_response_to_s3_client",
     "S3PutFiAction::set_fault_injection",
+    "S3PutMultiObjectAction::check_copy_source_authorization",
     "S3PutMultiObjectAction::check_part_details",
     "S3PutMultiObjectAction::compute_part_offset",
+    "S3PutMultiObjectAction::copy_part_data",
+    "S3PutMultiObjectAction::fetch_copy_source",
     "S3PutMultiObjectAction::fetch_firstpart_info",
     "S3PutMultiObjectAction::fetch_multipart_metadata",
     "S3PutMultiObjectAction::initiate_data_streaming",
     "S3PutMultiObjectAction::save_metadata",
     "S3PutMultiObjectAction::save_multipart_metadata",
     "S3PutMultiObjectAction::send_response_to_s3_client",
+    "S3PutMultiObjectAction::validate_copy_source",
     "S3PutMultiObjectAction::validate_multipart_request",
     "S3PutMultipartObjectActionTest::func_callback_one",
     "S3PutObjectACLAction::send_response_to_s3_client",
     "S3PutObjectACLAction::setacl",
     "S3PutObjectACLAction::validate_acl_with_auth",
     "S3PutObjectACLAction::validate_request",
+    "S3PutObjectAction::create_inline_object",
     "S3PutObjectAction::create_object",
     "S3PutObjectAction::delete_new_object",
     "S3PutObjectAction::delete_old_object",
     "S3PutObjectAction::initiate_data_streaming",
     "S3PutObjectAction::mark_new_oid_for_deletion",
     "S3PutObjectAction::mark_old_oid_for_deletion",
+    "S3PutObjectAction::read_inline_data",
     "S3PutObjectAction::remove_new_oid_probable_record",
     "S3PutObjectAction::remove_old_oid_probable_record",
     "S3PutObjectAction::save_metadata",
@@ -58,6 +58,7 @@
 #include "s3_get_bucket_location_action.h"
 #include "s3_get_bucket_policy_action.h"
 #include "s3_get_bucket_tagging_action.h"
+#include "s3_get_latency_histograms_action.h"
 #include "s3_get_multipart_bucket_action.h"
 #include "s3_get_multipart_part_action.h"
 #include "s3_get_object_acl_action.h"
@@ -132,6 +133,8 @@ int s3_addb_init() {
       S3_ADDB_S3_GET_BUCKET_TAGGING_ACTION_ID;
   gs_addb_map[std::type_index(typeid(S3GetBucketlocationAction))] =
       S3_ADDB_S3_GET_BUCKETLOCATION_ACTION_ID;
+  gs_addb_map[std::type_index(typeid(S3GetLatencyHistogramsAction))] =
+      S3_ADDB_S3_GET_LATENCY_HISTOGRAMS_ACTION_ID;
   gs_addb_map[std::type_index(typeid(S3GetMultipartBucketAction))] =
       S3_ADDB_S3_GET_MULTIPART_BUCKET_ACTION_ID;
   gs_addb_map[std::type_index(typeid(S3GetMultipartPartAction))] =
@@ -313,6 +316,12 @@ int s3_addb_init() {
          (uint64_t)S3_ADDB_S3_GET_BUCKETLOCATION_ACTION_ID,
          (int64_t)S3_ADDB_S3_GET_BUCKETLOCATION_ACTION_ID);
 
+  s3_log(S3_LOG_DEBUG, "",
+         "  * id 0x%" PRIx64 "/%" PRId64  // suppress clang warning
+         ": class S3GetLatencyHistogramsAction\n",
+         (uint64_t)S3_ADDB_S3_GET_LATENCY_HISTOGRAMS_ACTION_ID,
+         (int64_t)S3_ADDB_S3_GET_LATENCY_HISTOGRAMS_ACTION_ID);
+
   s3_log(S3_LOG_DEBUG, "",
          "  * id 0x%" PRIx64 "/%" PRId64  // suppress clang warning
          ": class S3GetMultipartBucketAction\n",
@@ -111,6 +111,8 @@ enum S3AddbActionTypeId {
   S3_ADDB_S3_GET_BUCKET_TAGGING_ACTION_ID,
   /* S3GetBucketlocationAction: */
   S3_ADDB_S3_GET_BUCKETLOCATION_ACTION_ID,
+  /* S3GetLatencyHistogramsAction: */
+  S3_ADDB_S3_GET_LATENCY_HISTOGRAMS_ACTION_ID,
   /* S3GetMultipartBucketAction: */
   S3_ADDB_S3_GET_MULTIPART_BUCKET_ACTION_ID,
   /* S3GetMultipartPartAction: */
@@ -118,29 +118,42 @@ S3BufferSequence S3AsyncBufferOptContainer::get_buffers(
   s3_log(S3_LOG_DEBUG, "", "get_buffers with expected_content_size = %zu\n",
          expected_content_size);
 
-  S3BufferSequence buffer_sequence;
-
   // previously returned bufs should be marked consumed
   if (!processing_q.empty()) {
     flush_used_buffers();
   }
-  count_bufs_shared_for_read = 0;
+  return share_buffers(expected_content_size);
+}
+
+S3BufferSequence S3AsyncBufferOptContainer::get_more_buffers(
+    size_t expected_content_size) {
+  s3_log(S3_LOG_DEBUG, "", "%s Entry with expected_content_size = %zu\n",
+         __func__, expected_content_size);
+  return share_buffers(expected_content_size);
+}
+
+S3BufferSequence S3AsyncBufferOptContainer::share_buffers(
+    size_t expected_content_size) {
+  S3BufferSequence buffer_sequence;
+  size_t bufs_to_share = 0;
 
   size_t size_we_can_share = get_content_length();
   s3_log(S3_LOG_DEBUG, "", "get_buffers with size_we_can_share = %zu\n",
          size_we_can_share);
   if (size_we_can_share >= expected_content_size || !(is_expecting_more)) {
     // Count how many bufs to return.
-    count_bufs_shared_for_read = expected_content_size / size_of_each_evbuf;
+    bufs_to_share = expected_content_size / size_of_each_evbuf;
     if (!is_expecting_more &&
         (expected_content_size % size_of_each_evbuf != 0)) {
       // We have all data, so if last chunk is present it can be less than
       // size_of_each_evbuf, share all
-      count_bufs_shared_for_read++;
+      bufs_to_share++;
     }
-    assert(ready_q.size() >= count_bufs_shared_for_read);
+    assert(ready_q.size() >= bufs_to_share);
+    count_bufs_shared_for_read += bufs_to_share;
+    processing_batches.push_back(bufs_to_share);
 
-    for (size_t i = 0; i < count_bufs_shared_for_read; ++i) {
+    for (size_t i = 0; i < bufs_to_share; ++i) {
       evbuf_t* p_ev_buf = ready_q.front();
       assert(p_ev_buf != nullptr);
 
@@ -193,12 +206,35 @@ void S3AsyncBufferOptContainer::flush_used_buffers() {
     evbuffer_free(buf);
     --count_bufs_shared_for_read;
   }
+  processing_batches.clear();
   s3_log(S3_LOG_DEBUG, "", "Freed evbuffer of len = %zu\n", size_consumed);
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return;
 }
 
+void S3AsyncBufferOptContainer::flush_oldest_used_buffers() {
+  s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
+
+  if (processing_batches.empty()) {
+    flush_used_buffers();
+    return;
+  }
+  size_t bufs_to_free = processing_batches.front();
+  processing_batches.pop_front();
+
+  size_t size_consumed = 0;
+  while (bufs_to_free > 0 && !processing_q.empty()) {
+    evbuf_t* buf = processing_q.front();
+    processing_q.pop_front();
+    size_consumed += evbuffer_get_length(buf);
+    evbuffer_free(buf);
+    --count_bufs_shared_for_read;
+    --bufs_to_free;
+  }
+  s3_log(S3_LOG_DEBUG, "", "Freed evbuffer of len = %zu\n", size_consumed);
+}
+
 std::string S3AsyncBufferOptContainer::get_content_as_string() {
   s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
   std::string content = "";
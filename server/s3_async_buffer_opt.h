@@ -45,6 +45,9 @@ class S3AsyncBufferOptContainer {
   std::deque<evbuf_t *> ready_q;
   // buf given out for consumption
   std::deque<evbuf_t *> processing_q;
+  // Number of bufs in processing_q per get_buffers/get_more_buffers call,
+  // oldest first
+  std::deque<size_t> processing_batches;
 
   // Actual content within buffer
   size_t content_length;
@@ -54,6 +57,8 @@ class S3AsyncBufferOptContainer {
   // Manages read state. stores count of bufs shared outside for consumption.
   size_t count_bufs_shared_for_read;
 
+  S3BufferSequence share_buffers(size_t expected_content_size);
+
  public:
   const size_t size_of_each_evbuf;  // ideally 4k/8k/16k
 
@@ -77,12 +82,23 @@ class S3AsyncBufferOptContainer {
   // expected_content_size should be multiple of libevent read mempool item size
   virtual S3BufferSequence get_buffers(size_t expected_content_size);
 
+  // Same as get_buffers() but keeps buffers returned by earlier calls in use,
+  // for callers having several writes in flight.
+  // Call flush_oldest_used_buffers() as each of them completes, in order.
+  virtual S3BufferSequence get_more_buffers(size_t expected_content_size);
+
   // Pull up all the data in contiguous memory and releases internal buffers
   // only if all data is in and its freezed. Use check is_freezed()
   std::string get_content_as_string();
 
   // flush buffers received using get_buffers
   void flush_used_buffers();
+
+  // flush buffers received by the oldest get_buffers/get_more_buffers call
+  // not yet flushed
+  void flush_oldest_used_buffers();
+
+  FRIEND_TEST(S3AsyncBufferOptContainerTest, GetMoreBuffersKeepsBatchesInUse);
 };
 
 #endif
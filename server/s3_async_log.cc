@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <glog/logging.h>
+
+#include "s3_async_log.h"
+#include "s3_log.h"
+
+S3AsyncLog* S3AsyncLog::p_instance;
+std::atomic<uint64_t> S3AsyncLog::last_generation(0);
+thread_local uint64_t S3AsyncLog::thread_generation;
+thread_local S3LogRing* S3AsyncLog::p_thread_ring;
+
+const unsigned S3AsyncLog::idle_wait_msec;
+
+// Thread id as glog shows it
+static int32_t get_tid() {
+  static thread_local int32_t tid = (int32_t)syscall(SYS_gettid);
+  return tid;
+}
+
+static size_t record_size(size_t msg_len) {
+  // Keep headers aligned, messages are stored with their '\0'
+  return (sizeof(S3LogRecord) + msg_len + 1 + 7) & ~(size_t)7;
+}
+
+S3LogRing::S3LogRing(size_t min_size) : size(1024), head(0), tail(0) {
+  while (size < min_size) {
+    size <<= 1;
+  }
+  buffer.reset(new char[size]);
+}
+
+size_t S3LogRing::get_max_msg_len() const {
+  // A record must fit whatever the free space is split into
+  return size / 4 - sizeof(S3LogRecord) - 8;
+}
+
+bool S3LogRing::push(int level, const char* file, int line, const char* msg,
+                     size_t msg_len) {
+  if (msg_len > get_max_msg_len()) {
+    msg_len = get_max_msg_len();
+  }
+  size_t pos = head.load(std::memory_order_relaxed);
+  size_t used = pos - tail.load(std::memory_order_acquire);
+  size_t offset = pos & (size - 1);
+  size_t to_end = size - offset;
+  size_t needed = record_size(msg_len);
+  size_t padding = to_end < needed ? to_end : 0;
+
+  if (size - used < padding + needed) {
+    return false;
+  }
+  if (padding) {
+    S3LogRecord* pad = reinterpret_cast<S3LogRecord*>(&buffer[offset]);
+    // Only the first 8 bytes of a padding record are used
+    pad->size = padding;
+    pad->level = padding_level;
+    offset = 0;
+  }
+  S3LogRecord* record = reinterpret_cast<S3LogRecord*>(&buffer[offset]);
+  char* record_msg = reinterpret_cast<char*>(record + 1);
+
+  record->size = needed;
+  record->level = level;
+  record->line = line;
+  record->msg_len = msg_len;
+  record->file = file;
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  record->time_sec = now.tv_sec;
+  record->time_usec = (int32_t)(now.tv_nsec / 1000);
+  record->tid = get_tid();
+  memcpy(record_msg, msg, msg_len);
+  record_msg[msg_len] = '\0';
+
+  head.store(pos + padding + needed, std::memory_order_release);
+  return true;
+}
+
+S3AsyncLog::S3AsyncLog(size_t ring_size)
+    : ring_size(ring_size), generation(++last_generation), dropped(0) {
+  if (pthread_create(&thread, NULL, &S3AsyncLog::log_thread, this) == 0) {
+    started = true;
+  }
+}
+
+S3AsyncLog::~S3AsyncLog() {
+  if (!started) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake_cond.notify_one();
+  pthread_join(thread, NULL);
+}
+
+void S3AsyncLog::create_instance(size_t ring_size) {
+  if (p_instance) {
+    return;
+  }
+  S3AsyncLog* instance = new S3AsyncLog(ring_size);
+
+  if (!instance->started) {
+    delete instance;
+    s3_log(S3_LOG_ERROR, "", "Failed to create log thread\n");
+    return;
+  }
+  p_instance = instance;
+}
+
+void S3AsyncLog::destroy_instance() {
+  S3AsyncLog* instance = p_instance;
+
+  p_instance = nullptr;
+  delete instance;
+}
+
+S3LogRing* S3AsyncLog::get_thread_ring() {
+  if (thread_generation != generation) {
+    std::unique_ptr<S3LogRing> ring(new S3LogRing(ring_size));
+    std::lock_guard<std::mutex> lock(mutex);
+
+    p_thread_ring = ring.get();
+    thread_generation = generation;
+    rings.push_back(std::move(ring));
+  }
+  return p_thread_ring;
+}
+
+bool S3AsyncLog::write(int level, const char* file, int line,
+                       const char* msg) {
+  if (level >= S3_LOG_FATAL) {
+    // Caller terminates the process next, write it with all before it
+    flush();
+    return false;
+  }
+  if (get_thread_ring()->push(level, file, line, msg, strlen(msg))) {
+    return true;
+  }
+  if (level >= S3_LOG_WARN) {
+    return false;
+  }
+  dropped.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void S3AsyncLog::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  // The pass running now may have visited this thread's ring already
+  uint64_t target = passes + 2;
+
+  wake_cond.notify_one();
+  pass_cond.wait(lock, [&] { return passes >= target || stopping; });
+}
+
+void* S3AsyncLog::log_thread(void* arg) {
+  static_cast<S3AsyncLog*>(arg)->run();
+  return NULL;
+}
+
+void S3AsyncLog::run() {
+  std::vector<S3LogRing*> thread_rings;
+  std::unique_lock<std::mutex> lock(mutex);
+
+  for (;;) {
+    thread_rings.clear();
+    for (auto& ring : rings) {
+      thread_rings.push_back(ring.get());
+    }
+    bool stop = stopping;
+    lock.unlock();
+
+    size_t records = 0;
+    for (auto ring : thread_rings) {
+      records += ring->pop_all(
+          [](const S3LogRecord& record) { write_record(record); });
+    }
+    uint64_t dropped_now = dropped.load(std::memory_order_relaxed);
+    if (dropped_now != dropped_reported) {
+      LOG(WARNING) << dropped_now - dropped_reported
+                   << " log records dropped, log thread is behind";
+      dropped_reported = dropped_now;
+    }
+
+    lock.lock();
+    ++passes;
+    pass_cond.notify_all();
+    if (records == 0) {
+      // Rings were empty after stopping was set, nothing is left
+      if (stop) {
+        break;
+      }
+      wake_cond.wait_for(lock, std::chrono::milliseconds(idle_wait_msec));
+    }
+  }
+}
+
+static google::LogSeverity get_severity(int level) {
+  google::LogSeverity severity;
+
+  switch (level) {
+    case S3_LOG_WARN:
+      severity = google::GLOG_WARNING;
+      break;
+    case S3_LOG_ERROR:
+    case S3_LOG_FATAL:
+      // Logging a FATAL message terminates the program in glog
+      severity = google::GLOG_ERROR;
+      break;
+    default:
+      // glog has no DEBUG level
+      severity = google::GLOG_INFO;
+  }
+  return severity;
+}
+
+void S3AsyncLog::write_record(int level, const char* file, int line,
+                              const char* msg, size_t msg_len) {
+  google::LogMessage(file, line, get_severity(level))
+      .stream()
+      .write(msg, msg_len);
+}
+
+void S3AsyncLog::write_record(const S3LogRecord& record) {
+  // Same fields as in glog prefix: mmdd hh:mm:ss.uuuuuu threadid
+  const time_t time_sec = (time_t)record.time_sec;
+  struct tm tm_time;
+  char prefix[64];
+
+  localtime_r(&time_sec, &tm_time);
+  int len = snprintf(prefix, sizeof(prefix),
+                     "[Time: %02d%02d %02d:%02d:%02d.%06d] [TID: %d] ",
+                     tm_time.tm_mon + 1, tm_time.tm_mday, tm_time.tm_hour,
+                     tm_time.tm_min, tm_time.tm_sec, (int)record.time_usec,
+                     (int)record.tid);
+  google::LogMessage message(record.file, record.line,
+                             get_severity(record.level));
+
+  message.stream().write(prefix, len);
+  message.stream().write(record.get_msg(), record.msg_len);
+}
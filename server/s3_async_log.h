@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_ASYNC_LOG_H__
+#define __S3_SERVER_S3_ASYNC_LOG_H__
+
+#include <pthread.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Log record as kept in S3LogRing, the message follows the header
+struct S3LogRecord {
+  uint32_t size;  // Of the header, message and padding
+  int32_t level;  // S3_LOG_*, or padding up to the end of the ring
+  int32_t line;
+  uint32_t msg_len;
+  const char* file;  // __FILE__ of the caller, never freed
+  // When and by which thread the record was pushed, glog would give the
+  // time and thread of writing it
+  int64_t time_sec;
+  int32_t time_usec;
+  int32_t tid;
+
+  const char* get_msg() const {
+    return reinterpret_cast<const char*>(this + 1);
+  }
+};
+
+// Ring of log records with one writing and one reading thread. Records are
+// never split at the end of the buffer, the space left is skipped instead.
+class S3LogRing {
+  std::unique_ptr<char[]> buffer;
+  size_t size;  // Power of 2
+  // Free running byte positions, only the writer moves head, only the
+  // reader moves tail
+  std::atomic<size_t> head;
+  std::atomic<size_t> tail;
+
+  static const int32_t padding_level = -1;
+
+ public:
+  // size is rounded up to a power of 2
+  explicit S3LogRing(size_t size);
+
+  // Longest message push() keeps, longer ones are cut
+  size_t get_max_msg_len() const;
+
+  // Returns false, keeping nothing, if the record does not fit. Time and
+  // thread of the record are taken here.
+  bool push(int level, const char* file, int line, const char* msg,
+            size_t msg_len);
+
+  // Calls write(const S3LogRecord&) for each record pushed so far, returns
+  // the number of records
+  template <typename F>
+  size_t pop_all(F write) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    size_t end = head.load(std::memory_order_acquire);
+    size_t records = 0;
+
+    while (pos != end) {
+      const S3LogRecord* record =
+          reinterpret_cast<const S3LogRecord*>(&buffer[pos & (size - 1)]);
+
+      if (record->level != padding_level) {
+        write(*record);
+        ++records;
+      }
+      pos += record->size;
+      // Space is given back per record, the writer may be waiting for it
+      tail.store(pos, std::memory_order_release);
+    }
+    return records;
+  }
+};
+
+// Writes s3_log records on a background thread. Each logging thread gets a
+// ring of its own on first use, so the hot path only copies the formatted
+// message, with no lock and no file I/O. If the log thread falls behind and
+// a ring is full, DEBUG and INFO records are dropped and counted, others are
+// written inline through glog.
+//
+// Single instance, created after the process has daemonized.
+class S3AsyncLog {
+  static S3AsyncLog* p_instance;
+
+  size_t ring_size;
+
+  // Tells threads their ring belongs to a deleted instance
+  const uint64_t generation;
+  static std::atomic<uint64_t> last_generation;
+  static thread_local uint64_t thread_generation;
+  static thread_local S3LogRing* p_thread_ring;
+
+  std::mutex mutex;
+  std::condition_variable wake_cond;
+  std::condition_variable pass_cond;
+  std::vector<std::unique_ptr<S3LogRing>> rings;
+  // Passes of the log thread over all rings
+  uint64_t passes = 0;
+  bool stopping = false;
+  bool started = false;
+  pthread_t thread;
+
+  std::atomic<uint64_t> dropped;
+  uint64_t dropped_reported = 0;
+
+  S3LogRing* get_thread_ring();
+  static void* log_thread(void* arg);
+  void run();
+
+ public:
+  // Milliseconds the log thread sleeps when there is nothing to write
+  static const unsigned idle_wait_msec = 1;
+
+  explicit S3AsyncLog(size_t ring_size);
+
+  S3AsyncLog(const S3AsyncLog&) = delete;
+  S3AsyncLog& operator=(const S3AsyncLog&) = delete;
+
+  // Writes what is queued, then stops the log thread
+  ~S3AsyncLog();
+
+  // No instance is made if the log thread cannot be started
+  static void create_instance(size_t ring_size);
+  // Callers must make sure nothing logs anymore, Motr and S3HashWorkers
+  // threads included. Threads logging later get a ring of a new instance.
+  static void destroy_instance();
+  // Returns nullptr if records are written inline
+  static S3AsyncLog* get_instance() { return p_instance; }
+
+  // Returns false if the record was neither queued nor dropped and the
+  // caller has to write it
+  bool write(int level, const char* file, int line, const char* msg);
+  // Returns once records queued before the call are written
+  void flush();
+
+  uint64_t get_dropped_count() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+  // Writes a record through glog
+  static void write_record(int level, const char* file, int line,
+                           const char* msg, size_t msg_len);
+  // Writes a queued record through glog, with its own time and thread in
+  // the message
+  static void write_record(const S3LogRecord& record);
+};
+
+#endif  // __S3_SERVER_S3_ASYNC_LOG_H__
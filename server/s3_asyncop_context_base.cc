@@ -23,6 +23,7 @@
 #include "s3_perf_logger.h"
 #include "s3_stats.h"
 #include "s3_log.h"
+#include "s3_option.h"
 
 S3AsyncOpContextBase::S3AsyncOpContextBase(std::shared_ptr<RequestObject> req,
                                            std::function<void(void)> success,
@@ -40,6 +41,7 @@ S3AsyncOpContextBase::S3AsyncOpContextBase(std::shared_ptr<RequestObject> req,
   request_id = request->get_request_id();
   stripped_request_id = request->get_stripped_request_id();
   ops_response.resize(ops_count);
+  event_base = S3Option::get_instance()->get_eventbase();
 }
 
 void S3AsyncOpContextBase::reset_callbacks(std::function<void(void)> success,
@@ -19,15 +19,13 @@
  */
 
 #include "s3_audit_info.h"
-#include "s3_audit_info_logger.h"
-#include "s3_log.h"
-#include "s3_option.h"
 
-#include <json/json.h>
 #include <time.h>
-#include <regex>
+#include <stdint.h>
+#include <string.h>
+#include <initializer_list>
 #include <string>
-#include <algorithm>
+#include <utility>
 #include <stdio.h>
 
 std::string audit_format_type_to_string(enum AuditFormatType type) {
@@ -44,7 +42,7 @@ std::string audit_format_type_to_string(enum AuditFormatType type) {
 S3AuditInfo::S3AuditInfo()
     : bucket_owner_canonical_id("-"),
       bucket("-"),
-      time_of_request_arrival("-"),
+      time_of_request_arrival(0),
       remote_ip("-"),
       requester("-"),
       request_id("-"),
@@ -55,6 +53,7 @@ S3AuditInfo::S3AuditInfo()
       error_code("-"),
       bytes_sent(0),
       object_size(0),
+      bytes_received(0),
       total_time(0),
       turn_around_time(0),
       referrer("-"),
@@ -66,7 +65,7 @@ S3AuditInfo::S3AuditInfo()
       authentication_type("-"),
       host_header("-") {}
 
-UInt64 S3AuditInfo::convert_to_unsigned(size_t audit_member) {
+UInt64 S3AuditInfo::convert_to_unsigned(size_t audit_member) const {
   if (audit_member > SIZE_MAX) {
     // Error case. Returning default values.
     return 0;
@@ -74,122 +73,297 @@ UInt64 S3AuditInfo::convert_to_unsigned(size_t audit_member) {
   return static_cast<UInt64>(audit_member);
 }
 
-const std::string S3AuditInfo::to_string() {
-  if (!S3AuditInfoLogger::is_enabled()) {
-    return "";
+// Formats the arrival time into buf, which must hold REQUEST_TIME_SIZE bytes.
+// Returns length of the text.
+static size_t format_request_time(time_t request_time, char* buf) {
+  struct tm request_time_struct;
+
+  if (!request_time || !localtime_r(&request_time, &request_time_struct)) {
+    buf[0] = '-';
+    buf[1] = '\0';
+    return 1;
   }
 
-  AuditFormatType audit_format_type =
-      S3Option::get_instance()->get_s3_audit_format_type();
-  if (audit_format_type == AuditFormatType::S3_FORMAT) {
+  // Format specifiers required for strftime() as per
+  // https://docs.aws.amazon.com/AmazonS3/latest/dev/LogFormat.html :
+  //   %d = Day of the month (01-31)
+  //   %b = Abbreviated month name
+  //   %Y = The year as a decimal number including the century.
+  //   %H = Hour in 24h format (00-23)
+  //   %M = Minutes in decimal ranging from 00 to 59.
+  //   %S = The second as a decimal number (range 00 to 60).
+  //   %z = The +hhmm or -hhmm numeric timezone
+
+  return strftime(buf, REQUEST_TIME_SIZE, "[%d/%b/%Y:%H:%M:%S %z]",
+                  &request_time_struct);
+}
+
+static void append_number(std::string& out, UInt64 value) {
+  char buf[24];
+  int len = snprintf(buf, sizeof(buf), "%llu", value);
+  out.append(buf, len);
+}
+
+static void append_number(std::string& out, int value) {
+  char buf[16];
+  int len = snprintf(buf, sizeof(buf), "%d", value);
+  out.append(buf, len);
+}
+
+// Quotes and escapes the way jsoncpp does: '/' and non-ASCII bytes are
+// written as they are, control characters other than the named ones become
+// \u00XX.
+static void append_json_string(std::string& out, const char* str,
+                               size_t len) {
+  static const char hex_digits[] = "0123456789ABCDEF";
+  const char* end = str + len;
+  const char* plain = str;
+
+  out += '"';
+  for (const char* p = str; p != end; ++p) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    const char* escaped;
+
+    switch (c) {
+      case '"':
+        escaped = "\\\"";
+        break;
+      case '\\':
+        escaped = "\\\\";
+        break;
+      case '\b':
+        escaped = "\\b";
+        break;
+      case '\f':
+        escaped = "\\f";
+        break;
+      case '\n':
+        escaped = "\\n";
+        break;
+      case '\r':
+        escaped = "\\r";
+        break;
+      case '\t':
+        escaped = "\\t";
+        break;
+      default:
+        if (c >= 0x20) {
+          continue;
+        }
+        escaped = nullptr;
+    }
+    out.append(plain, p - plain);
+    plain = p + 1;
+    if (escaped) {
+      out += escaped;
+    } else {
+      char code[] = "\\u00XX";
+      code[4] = hex_digits[c >> 4];
+      code[5] = hex_digits[c & 0xf];
+      out.append(code, 6);
+    }
+  }
+  out.append(plain, end - plain);
+  out += '"';
+}
+
+static void append_json_string(std::string& out, const std::string& str) {
+  append_json_string(out, str.data(), str.size());
+}
+
+static void append_json_string(std::string& out, const char* str) {
+  append_json_string(out, str, strlen(str));
+}
+
+size_t S3AuditInfo::get_formatted_size_hint() const {
+  // JSON keys, quotes and numbers, more than the S3 format needs
+  size_t size = 512;
+
+  for (const std::string* field :
+       {&bucket_owner_canonical_id, &bucket, &remote_ip, &requester,
+        &request_id, &operation, &object_key, &request_uri, &error_code,
+        &referrer, &user_agent, &version_id, &host_id, &cipher_suite,
+        &host_header}) {
+    size += field->size();
+  }
+  return size;
+}
+
+void S3AuditInfo::format_json(std::string& out) const {
+  char request_time[REQUEST_TIME_SIZE];
+  size_t request_time_len =
+      format_request_time(time_of_request_arrival, request_time);
+
+  // Keys in the order Json::Value keeps them, sorted
+  out += "{\"authentication_type\":";
+  append_json_string(out, authentication_type);
+  out += ",\"bucket\":";
+  append_json_string(out, bucket);
+  out += ",\"bucket_owner\":";
+  append_json_string(out, bucket_owner_canonical_id);
+  out += ",\"bytes_received\":";
+  append_number(out, convert_to_unsigned(bytes_received));
+  out += ",\"bytes_sent\":";
+  append_number(out, convert_to_unsigned(bytes_sent));
+  out += ",\"cipher_suite\":";
+  append_json_string(out, cipher_suite);
+  out += ",\"error_code\":";
+  append_json_string(out, error_code);
+  out += ",\"host_header\":";
+  append_json_string(out, host_header);
+  out += ",\"host_id\":";
+  append_json_string(out, host_id);
+  out += ",\"http_status\":";
+  append_number(out, http_status);
+  out += ",\"key\":";
+  append_json_string(out, object_key);
+  out += ",\"object_size\":";
+  append_number(out, convert_to_unsigned(object_size));
+  out += ",\"operation\":";
+  append_json_string(out, operation);
+  out += ",\"referrer\":";
+  append_json_string(out, referrer);
+  out += ",\"remote_ip\":";
+  append_json_string(out, remote_ip);
+  out += ",\"request_id\":";
+  append_json_string(out, request_id);
+  out += ",\"request_uri\":";
+  append_json_string(out, request_uri);
+  out += ",\"requester\":";
+  append_json_string(out, requester);
+  out += ",\"signature_version\":";
+  append_json_string(out, signature_version);
+  out += ",\"time\":";
+  append_json_string(out, request_time, request_time_len);
+  out += ",\"total_time\":";
+  append_number(out, convert_to_unsigned(total_time));
+  out += ",\"turn_around_time\":";
+  append_number(out, convert_to_unsigned(turn_around_time));
+  out += ",\"user_agent\":";
+  append_json_string(out, user_agent);
+  out += ",\"version_id\":";
+  append_json_string(out, version_id);
+  out += "}\n";
+}
+
+void S3AuditInfo::format_s3(std::string& out) const {
+  char request_time[REQUEST_TIME_SIZE];
+  size_t request_time_len =
+      format_request_time(time_of_request_arrival, request_time);
+
+  out += bucket_owner_canonical_id;
+  out += ' ';
+  out += bucket;
+  out += ' ';
+  out.append(request_time, request_time_len);
+  out += ' ';
+  out += remote_ip;
+  out += ' ';
+  out += requester;
+  out += ' ';
+  out += request_id;
+  out += ' ';
+  out += operation;
+  out += ' ';
+  out += object_key;
+  out += " \"";
+  out += request_uri;
+  out += "\" ";
+  append_number(out, http_status);
+  out += ' ';
+  out += error_code;
+  out += ' ';
+  append_number(out, convert_to_unsigned(bytes_sent));
+  out += ' ';
+  append_number(out, convert_to_unsigned(object_size));
+  out += ' ';
+  append_number(out, convert_to_unsigned(bytes_received));
+  out += ' ';
+  append_number(out, convert_to_unsigned(total_time));
+  out += ' ';
+  append_number(out, convert_to_unsigned(turn_around_time));
+  out += " \"";
+  out += referrer;
+  out += "\" \"";
+  out += user_agent;
+  out += "\" ";
+  out += version_id;
+  out += ' ';
+  out += host_id;
+  out += ' ';
+  out += signature_version;
+  out += ' ';
+  out += cipher_suite;
+  out += ' ';
+  out += authentication_type;
+  out += ' ';
+  out += host_header;
+}
+
+void S3AuditInfo::format(AuditFormatType format_type, std::string& out) const {
+  out.reserve(out.size() + get_formatted_size_hint());
+
+  if (format_type == AuditFormatType::S3_FORMAT) {
     // Logs audit information in S3 format.
-    const std::string formatted_log =
-        bucket_owner_canonical_id + " " + bucket + " " +
-        time_of_request_arrival + " " + remote_ip + " " + requester + " " +
-        request_id + " " + operation + " " + object_key + " \"" + request_uri +
-        "\" " + std::to_string(http_status) + " " + error_code + " " +
-        std::to_string(bytes_sent) + " " + std::to_string(object_size) + " " +
-        std::to_string(bytes_received) + " " + std::to_string(total_time) +
-        " " + std::to_string(turn_around_time) + " \"" + referrer + "\" \"" +
-        user_agent + "\" " + version_id + " " + host_id + " " +
-        signature_version + " " + cipher_suite + " " + authentication_type +
-        " " + host_header;
-    return formatted_log;
-  } else if (audit_format_type == AuditFormatType::JSON) {
+    format_s3(out);
+  } else if (format_type == AuditFormatType::JSON) {
     // Logs audit information in Json format.
-    Json::Value audit;
-
-    audit["bucket_owner"] = bucket_owner_canonical_id;
-    audit["bucket"] = bucket;
-    audit["time"] = time_of_request_arrival;
-    audit["remote_ip"] = remote_ip;
-    audit["requester"] = requester;
-    audit["request_id"] = request_id;
-    audit["operation"] = operation;
-    audit["key"] = object_key;
-    audit["request_uri"] = request_uri;
-    audit["http_status"] = http_status;
-    audit["error_code"] = error_code;
-    audit["bytes_sent"] = convert_to_unsigned(bytes_sent);
-    audit["object_size"] = convert_to_unsigned(object_size);
-    audit["bytes_received"] = convert_to_unsigned(bytes_received);
-    audit["total_time"] = convert_to_unsigned(total_time);
-    audit["turn_around_time"] = convert_to_unsigned(turn_around_time);
-    audit["referrer"] = referrer;
-    audit["user_agent"] = user_agent;
-    audit["version_id"] = version_id;
-    audit["host_id"] = host_id;
-    audit["signature_version"] = signature_version;
-    audit["cipher_suite"] = cipher_suite;
-    audit["authentication_type"] = authentication_type;
-    audit["host_header"] = host_header;
-
-    Json::FastWriter fastWriter;
-    return fastWriter.write(audit);
+    format_json(out);
   }
+}
 
-  return "";
+std::string S3AuditInfo::to_string(AuditFormatType format_type) const {
+  std::string formatted_log;
+
+  format(format_type, formatted_log);
+  return formatted_log;
 }
 
 void S3AuditInfo::set_bucket_owner_canonical_id(
-    const std::string& bucket_owner_canonical_id_str) {
-  bucket_owner_canonical_id = bucket_owner_canonical_id_str;
+    std::string bucket_owner_canonical_id_str) {
+  bucket_owner_canonical_id = std::move(bucket_owner_canonical_id_str);
 }
 
-void S3AuditInfo::set_bucket_name(const std::string& bucket_str) {
-  bucket = bucket_str;
+void S3AuditInfo::set_bucket_name(std::string bucket_str) {
+  bucket = std::move(bucket_str);
 }
 
 void S3AuditInfo::set_time_of_request_arrival() {
-  time_t request_time;
-  struct tm* request_time_struct;
-  char time_of_request[REQUEST_TIME_SIZE];
-  time(&request_time);
-  request_time_struct = localtime(&request_time);
-
-  // Format specifiers required for strftime() as per
-  // https://docs.aws.amazon.com/AmazonS3/latest/dev/LogFormat.html :
-  //   %d = Day of the month (01-31)
-  //   %b = Abbreviated month name
-  //   %Y = The year as a decimal number including the century.
-  //   %H = Hour in 24h format (00-23)
-  //   %M = Minutes in decimal ranging from 00 to 59.
-  //   %S = The second as a decimal number (range 00 to 60).
-  //   %z = The +hhmm or -hhmm numeric timezone
+  set_time_of_request_arrival(time(NULL));
+}
 
-  strftime(time_of_request, sizeof(time_of_request), "[%d/%b/%Y:%H:%M:%S %z]",
-           request_time_struct);
-  time_of_request_arrival = time_of_request;
+void S3AuditInfo::set_time_of_request_arrival(time_t request_time) {
+  time_of_request_arrival = request_time;
 }
 
-void S3AuditInfo::set_remote_ip(const std::string& remote_ip_str) {
-  remote_ip = remote_ip_str;
+void S3AuditInfo::set_remote_ip(std::string remote_ip_str) {
+  remote_ip = std::move(remote_ip_str);
 }
 
-void S3AuditInfo::set_requester(const std::string& requester_str) {
-  requester = requester_str;
+void S3AuditInfo::set_requester(std::string requester_str) {
+  requester = std::move(requester_str);
 }
 
-void S3AuditInfo::set_request_id(const std::string& request_id_str) {
-  request_id = request_id_str;
+void S3AuditInfo::set_request_id(std::string request_id_str) {
+  request_id = std::move(request_id_str);
 }
 
-void S3AuditInfo::set_operation(const std::string& operation_str) {
-  operation = operation_str;
+void S3AuditInfo::set_operation(std::string operation_str) {
+  operation = std::move(operation_str);
 }
 
-void S3AuditInfo::set_object_key(const std::string& key_str) {
-  object_key = key_str;
+void S3AuditInfo::set_object_key(std::string key_str) {
+  object_key = std::move(key_str);
 }
 
-void S3AuditInfo::set_request_uri(const std::string& request_uri_str) {
-  request_uri = request_uri_str;
+void S3AuditInfo::set_request_uri(std::string request_uri_str) {
+  request_uri = std::move(request_uri_str);
 }
 
 void S3AuditInfo::set_http_status(int httpstatus) { http_status = httpstatus; }
 
-void S3AuditInfo::set_error_code(const std::string& error_code_str) {
-  error_code = error_code_str;
+void S3AuditInfo::set_error_code(std::string error_code_str) {
+  error_code = std::move(error_code_str);
 }
 
 void S3AuditInfo::set_bytes_sent(size_t total_bytes_sent) {
@@ -210,20 +384,20 @@ void S3AuditInfo::set_turn_around_time(size_t request_turn_around_time) {
   turn_around_time = request_turn_around_time;
 }
 
-void S3AuditInfo::set_referrer(const std::string& referrer_str) {
-  referrer = referrer_str;
+void S3AuditInfo::set_referrer(std::string referrer_str) {
+  referrer = std::move(referrer_str);
 }
 
-void S3AuditInfo::set_user_agent(const std::string& user_agent_str) {
-  user_agent = user_agent_str;
+void S3AuditInfo::set_user_agent(std::string user_agent_str) {
+  user_agent = std::move(user_agent_str);
 }
 
-void S3AuditInfo::set_version_id(const std::string& version_id_str) {
-  version_id = version_id_str;
+void S3AuditInfo::set_version_id(std::string version_id_str) {
+  version_id = std::move(version_id_str);
 }
 
-void S3AuditInfo::set_host_id(const std::string& host_id_str) {
-  host_id = host_id_str;
+void S3AuditInfo::set_host_id(std::string host_id_str) {
+  host_id = std::move(host_id_str);
 }
 
 void S3AuditInfo::set_publish_flag(bool publish_flag) {
@@ -232,11 +406,9 @@ void S3AuditInfo::set_publish_flag(bool publish_flag) {
 
 void S3AuditInfo::set_signature_version(const std::string& authorization) {
   if (!authorization.empty()) {
-    std::regex auth_v2("(AWS )(.*)");
-    std::regex auth_v4("(AWS4-HMAC-SHA256)(.*)");
-    if (regex_match(authorization, auth_v2)) {
+    if (authorization.compare(0, 4, "AWS ") == 0) {
       signature_version = "SigV2";
-    } else if (regex_match(authorization, auth_v4)) {
+    } else if (authorization.compare(0, 16, "AWS4-HMAC-SHA256") == 0) {
       signature_version = "SigV4";
     } else {
       signature_version = "Unknown_Signature";
@@ -244,17 +416,17 @@ void S3AuditInfo::set_signature_version(const std::string& authorization) {
   }
 }
 
-void S3AuditInfo::set_cipher_suite(const std::string& cipher_suite_str) {
-  cipher_suite = cipher_suite_str;
+void S3AuditInfo::set_cipher_suite(std::string cipher_suite_str) {
+  cipher_suite = std::move(cipher_suite_str);
 }
 
 void S3AuditInfo::set_authentication_type(
-    const std::string& authentication_type_str) {
+    const char* authentication_type_str) {
   authentication_type = authentication_type_str;
 }
 
-void S3AuditInfo::set_host_header(const std::string& host_header_str) {
-  host_header = host_header_str;
+void S3AuditInfo::set_host_header(std::string host_header_str) {
+  host_header = std::move(host_header_str);
 }
 
 bool S3AuditInfo::get_publish_flag() { return publish_log; }
@@ -25,6 +25,7 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <ctime>
 #include <stdio.h>
 #include <string>
 #include <stdlib.h>
@@ -40,6 +41,10 @@ enum class AuditFormatType {
 
 std::string audit_format_type_to_string(enum AuditFormatType type);
 
+// Audit record of one request. Setters take ownership of strings built for
+// the record, numbers and the arrival time are kept as they are and only
+// turned into text by format(), which appends the whole record to a
+// caller's buffer sized once up front.
 class S3AuditInfo {
  private:
   // S3 Audit log format :
@@ -50,8 +55,8 @@ class S3AuditInfo {
                                           // bucket.
   std::string bucket;  // The name of the bucket that the request was processed
                        // against.
-  std::string time_of_request_arrival;  // The time at which the request was
-                                        // received.
+  time_t time_of_request_arrival;  // The time at which the request was
+                                   // received, 0 if not set.
   std::string remote_ip;   // The apparent internet address of s3 client.
   std::string requester;   // The canonical user ID of the requester
   std::string request_id;  // A string generated by S3 to uniquely identify each
@@ -74,48 +79,59 @@ class S3AuditInfo {
   std::string user_agent;  // The value of the HTTP User-Agent header.
   std::string version_id;  // The version ID in the request
   std::string host_id;     // The x-amz-id-2 or S3 extended request ID.
-  std::string signature_version;  // The signature version, SigV2 or SigV4, that
-                                  // was used to authenticate the request.
+  const char* signature_version;  // The signature version, SigV2 or SigV4,
+                                  // that was used to authenticate the request.
   std::string cipher_suite;  // The Secure Sockets Layer (SSL) cipher that was
                              // negotiated for HTTPS request.
-  std::string authentication_type;  // The type of request authentication used,
+  const char* authentication_type;  // The type of request authentication used,
                                     // AuthHeader for authentication headers,
                                     // QueryString for query string.
   std::string host_header;          // The endpoint used to connect to S3
 
   bool publish_log = true;  // Flag to disable audit log for healthchecks.
 
+  void format_json(std::string& out) const;
+  void format_s3(std::string& out) const;
+
  public:
   S3AuditInfo();
   // Setter methods for Audit Logger
-  void set_bucket_owner_canonical_id(const std::string& bucket_owner_str);
-  void set_bucket_name(const std::string& bucket_str);
+  void set_bucket_owner_canonical_id(std::string bucket_owner_str);
+  void set_bucket_name(std::string bucket_str);
   void set_time_of_request_arrival();
-  void set_remote_ip(const std::string& remote_ip_str);
-  void set_requester(const std::string& requester_str);
-  void set_request_id(const std::string& request_id_str);
-  void set_operation(const std::string& operation_str);
-  void set_object_key(const std::string& key_str);
-  void set_request_uri(const std::string& request_uri_str);
+  void set_time_of_request_arrival(time_t request_time);
+  void set_remote_ip(std::string remote_ip_str);
+  void set_requester(std::string requester_str);
+  void set_request_id(std::string request_id_str);
+  void set_operation(std::string operation_str);
+  void set_object_key(std::string key_str);
+  void set_request_uri(std::string request_uri_str);
   void set_http_status(int httpstatus);
-  void set_error_code(const std::string& error_code);
+  void set_error_code(std::string error_code);
   void set_bytes_sent(size_t total_bytes_sent);
   void set_object_size(size_t obj_size);
   void set_bytes_received(size_t total_bytes_received);
   void set_total_time(size_t total_request_time);
   void set_turn_around_time(size_t request_turn_around_time);
-  void set_referrer(const std::string& referrer_str);
-  void set_user_agent(const std::string& user_agent_str);
-  void set_version_id(const std::string& version_id_str);
-  void set_host_id(const std::string& host_id_str);
+  void set_referrer(std::string referrer_str);
+  void set_user_agent(std::string user_agent_str);
+  void set_version_id(std::string version_id_str);
+  void set_host_id(std::string host_id_str);
   void set_signature_version(const std::string& authorization);
-  void set_cipher_suite(const std::string& cipher_suite_str);
-  void set_authentication_type(const std::string& authentication_type_str);
-  void set_host_header(const std::string& host_header_str);
+  void set_cipher_suite(std::string cipher_suite_str);
+  // Must be a string literal, it is not copied
+  void set_authentication_type(const char* authentication_type_str);
+  void set_host_header(std::string host_header_str);
   void set_publish_flag(bool publish_flag);
   bool get_publish_flag();
-  const std::string to_string();
-  UInt64 convert_to_unsigned(size_t audit_member);
+
+  // Bytes format() is expected to need, escaping aside
+  size_t get_formatted_size_hint() const;
+  // Appends the record to out. JSON is the same text Json::FastWriter makes
+  // of it, newline included.
+  void format(AuditFormatType format_type, std::string& out) const;
+  std::string to_string(AuditFormatType format_type) const;
+  UInt64 convert_to_unsigned(size_t audit_member) const;
 };
 
 #endif
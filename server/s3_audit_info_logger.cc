@@ -20,6 +20,7 @@
 
 #include "s3_option.h"
 #include "s3_log.h"
+#include "s3_post_to_main_loop.h"
 #include "s3_audit_info_logger.h"
 #include "s3_audit_info_logger_rsyslog_tcp.h"
 #include "s3_audit_info_logger_log4cxx.h"
@@ -105,14 +106,51 @@ int S3AuditInfoLogger::init() {
   return ret;
 }
 
+// Sinks are bound to the main event base, records saved on additional
+// reactors are handed over to the main loop. Failures are reported there.
+static bool is_on_main_loop() {
+  S3Option* option_instance = S3Option::get_instance();
+  return option_instance->get_eventbase() ==
+         option_instance->get_main_eventbase();
+}
+
+static void save_msg_on_main_loop(std::string request_id, std::string msg) {
+  s3_run_on_main_loop([request_id, msg]() {
+    if (S3AuditInfoLogger::save_msg(request_id, msg) < 0) {
+      s3_log(S3_LOG_FATAL, request_id, "Audit Logger Error. STOP Server\n");
+    }
+  });
+}
+
 int S3AuditInfoLogger::save_msg(std::string const& cur_request_id,
                                 std::string const& audit_logging_msg) {
   if (audit_info_logger) {
+    if (!is_on_main_loop()) {
+      save_msg_on_main_loop(cur_request_id, audit_logging_msg);
+      return 0;
+    }
     return audit_info_logger->save_msg(cur_request_id, audit_logging_msg);
   }
   return 1;
 }
 
+int S3AuditInfoLogger::save_record(std::string const& cur_request_id,
+                                   S3AuditInfo const& audit_info) {
+  if (audit_info_logger) {
+    if (!is_on_main_loop()) {
+      std::string msg;
+      audit_info.format(S3Option::get_instance()->get_s3_audit_format_type(),
+                        msg);
+      save_msg_on_main_loop(cur_request_id, std::move(msg));
+      return 0;
+    }
+    return audit_info_logger->save_record(
+        cur_request_id, audit_info,
+        S3Option::get_instance()->get_s3_audit_format_type());
+  }
+  return 1;
+}
+
 bool S3AuditInfoLogger::is_enabled() { return audit_info_logger_enabled; }
 
 void S3AuditInfoLogger::finalize() {
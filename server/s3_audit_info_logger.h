@@ -37,6 +37,8 @@ class S3AuditInfoLogger {
   static void finalize();
   static bool is_enabled();
   static int save_msg(std::string const&, std::string const&);
+  // Formats the record as configured by S3_AUDIT_LOG_FORMAT_TYPE
+  static int save_record(std::string const&, S3AuditInfo const&);
   S3AuditInfoLogger() = delete;
 
  private:
@@ -25,10 +25,24 @@
 
 #include <string>
 
+#include "s3_audit_info.h"
+
 class S3AuditInfoLoggerBase {
  public:
   virtual ~S3AuditInfoLoggerBase() = default;
   virtual int save_msg(std::string const&, std::string const&) = 0;
+
+  // Formats the record into a buffer reused by the calling thread, sinks
+  // which keep the message override this to format into their own buffer.
+  virtual int save_record(std::string const& request_id,
+                          S3AuditInfo const& audit_info,
+                          AuditFormatType format_type) {
+    static thread_local std::string msg;
+
+    msg.clear();
+    audit_info.format(format_type, msg);
+    return save_msg(request_id, msg);
+  }
 };
 
 #endif
@@ -24,6 +24,7 @@
 #include "s3_log.h"
 #include "s3_audit_info_logger_kafka_web.h"
 #include "s3_http_post_queue.h"
+#include "s3_option.h"
 
 S3AuditInfoLoggerKafkaWeb::S3AuditInfoLoggerKafkaWeb(evbase_t* p_base,
                                                      std::string host_ip,
@@ -34,8 +35,22 @@ S3AuditInfoLoggerKafkaWeb::S3AuditInfoLoggerKafkaWeb(evbase_t* p_base,
   std::map<std::string, std::string> headers;
   headers["Content-Type"] = "application/vnd.kafka.json.v2+json";
 
+  // One Kafka REST produce request carries many records
+  S3HttpPostQueueConfig config;
+  S3Option* option_instance = S3Option::get_instance();
+
+  config.batch_prefix = "{\"records\":[";
+  config.batch_separator = ",";
+  config.batch_suffix = "]}";
+  config.max_batch_size = option_instance->get_audit_logger_post_batch_size();
+  config.max_posts_in_flight =
+      option_instance->get_audit_logger_posts_in_flight();
+  config.max_queued_bytes =
+      (size_t)option_instance->get_audit_logger_post_queue_size_mb() << 20;
+
   p_s3_post_queue.reset(create_http_post_queue(
-      p_base, std::move(host_ip), port, std::move(path), std::move(headers)));
+      p_base, std::move(host_ip), port, std::move(path), std::move(headers),
+      std::move(config)));
 }
 
 S3AuditInfoLoggerKafkaWeb::~S3AuditInfoLoggerKafkaWeb() = default;
@@ -45,8 +60,28 @@ int S3AuditInfoLoggerKafkaWeb::save_msg(std::string const& request_id,
   s3_log(S3_LOG_INFO, request_id, "%s Entry", __func__);
   s3_log(S3_LOG_DEBUG, request_id, "%s", msg.c_str());
 
-  std::string fmt_msg =
-      "{\"records\":[{\"key\":\"s3server\",\"value\":" + msg + "}]}";
+  std::string fmt_msg = "{\"key\":\"s3server\",\"value\":" + msg + "}";
+  const bool fSucc = p_s3_post_queue->post(std::move(fmt_msg));
+
+  s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
+  return !fSucc;
+}
+
+int S3AuditInfoLoggerKafkaWeb::save_record(std::string const& request_id,
+                                           S3AuditInfo const& audit_info,
+                                           AuditFormatType format_type) {
+  s3_log(S3_LOG_INFO, request_id, "%s Entry", __func__);
+
+  // The record is formatted straight into the message handed to the queue
+  static const char record_prefix[] = "{\"key\":\"s3server\",\"value\":";
+  std::string fmt_msg;
+
+  fmt_msg.reserve(sizeof(record_prefix) + audit_info.get_formatted_size_hint());
+  fmt_msg += record_prefix;
+  audit_info.format(format_type, fmt_msg);
+  fmt_msg += '}';
+  s3_log(S3_LOG_DEBUG, request_id, "%s", fmt_msg.c_str());
+
   const bool fSucc = p_s3_post_queue->post(std::move(fmt_msg));
 
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
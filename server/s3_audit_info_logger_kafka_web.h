@@ -43,6 +43,8 @@ class S3AuditInfoLoggerKafkaWeb : public S3AuditInfoLoggerBase {
       delete;
 
   int save_msg(std::string const&, std::string const&) override;
+  int save_record(std::string const&, S3AuditInfo const&,
+                  AuditFormatType) override;
 
  private:
   std::unique_ptr<S3HttpPostQueue> p_s3_post_queue;
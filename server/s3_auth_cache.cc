@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <iterator>
+
+#include "s3_auth_cache.h"
+#include "s3_log.h"
+#include "s3_stats.h"
+
+thread_local S3AuthCache* S3AuthCache::p_instance;
+
+S3AuthCache::S3AuthCache(unsigned max_cache_size, unsigned ttl_sec)
+    : max_cache_size(max_cache_size), ttl_sec(ttl_sec) {
+  p_instance = this;
+}
+
+S3AuthCache::~S3AuthCache() { p_instance = nullptr; }
+
+S3AuthCache* S3AuthCache::get_instance() { return p_instance; }
+
+void S3AuthCache::remove_entry(Entries::iterator it) {
+  index.erase(it->key);
+  entries.erase(it);
+}
+
+bool S3AuthCache::get(const std::string& key, std::string& response) {
+  auto map_it = index.find(key);
+
+  if (index.end() == map_it) {
+    s3_stats_inc("auth_cache_miss_count");
+    return false;
+  }
+  auto it = map_it->second;
+
+  if (Clock::now() >= it->expire_time) {
+    s3_log(S3_LOG_DEBUG, "", "Auth cache entry has expired");
+    remove_entry(it);
+    s3_stats_inc("auth_cache_miss_count");
+    return false;
+  }
+  entries.splice(entries.begin(), entries, it);
+  response = it->response;
+
+  s3_stats_inc("auth_cache_hit_count");
+  return true;
+}
+
+void S3AuthCache::put(const std::string& key, const std::string& bucket_name,
+                      std::string response) {
+  if (!is_enabled()) {
+    return;
+  }
+  auto map_it = index.find(key);
+
+  if (index.end() != map_it) {
+    remove_entry(map_it->second);
+  } else if (entries.size() >= max_cache_size) {
+    remove_entry(std::prev(entries.end()));
+  }
+  entries.push_front({key, bucket_name, std::move(response),
+                      Clock::now() + std::chrono::seconds(ttl_sec)});
+  index[key] = entries.begin();
+}
+
+void S3AuthCache::invalidate_bucket(const std::string& bucket_name) {
+  if (bucket_name.empty()) {
+    return;
+  }
+  size_t n_removed = 0;
+
+  for (auto it = entries.begin(); it != entries.end();) {
+    auto cur = it++;
+
+    if (cur->bucket_name == bucket_name) {
+      remove_entry(cur);
+      ++n_removed;
+    }
+  }
+  s3_log(S3_LOG_DEBUG, "", "%zu auth cache entries of \"%s\" bucket dropped",
+         n_removed, bucket_name.c_str());
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_AUTH_CACHE_H__
+#define __S3_SERVER_S3_AUTH_CACHE_H__
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Successful authorization responses of Auth server, so that the same
+// principal repeating the same operation doesn't need a round trip.
+// Authentication is never cached, see S3AuthClient::get_auth_cache_key().
+//
+// The key is a digest of the authenticated principal and everything Auth
+// server bases its decision on, so a changed ACL or policy makes a different
+// key. Entries live at most ttl_sec, which bounds how long a changed user
+// policy can still be honoured. Only successful responses are cached,
+// failures always go to Auth server.
+//
+// One instance per reactor thread, like S3BucketMetadataCache.
+class S3AuthCache {
+
+  // The class should have single instance per reactor thread
+  static thread_local S3AuthCache* p_instance;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string key;
+    std::string bucket_name;
+    std::string response;
+    Clock::time_point expire_time;
+  };
+  using Entries = std::list<Entry>;
+
+  // Most recently used entry is at the front
+  Entries entries;
+  std::unordered_map<std::string, Entries::iterator> index;
+
+  unsigned max_cache_size;
+  unsigned ttl_sec;
+
+  void remove_entry(Entries::iterator it);
+
+ public:
+  S3AuthCache(unsigned max_cache_size, unsigned ttl_sec);
+
+  S3AuthCache(const S3AuthCache&) = delete;
+  S3AuthCache& operator=(const S3AuthCache&) = delete;
+
+  ~S3AuthCache();
+
+  // Returns nullptr if the cache isn't created on the calling thread
+  static S3AuthCache* get_instance();
+
+  bool is_enabled() const { return max_cache_size > 0; }
+
+  // Returns false if there is no fresh response for the key
+  bool get(const std::string& key, std::string& response);
+
+  void put(const std::string& key, const std::string& bucket_name,
+           std::string response);
+
+  // Drops authorization results for the bucket, called when bucket ACL or
+  // policy is changed through this instance.
+  void invalidate_bucket(const std::string& bucket_name);
+
+  size_t size() const { return entries.size(); }
+};
+
+#endif  // __S3_SERVER_S3_AUTH_CACHE_H__
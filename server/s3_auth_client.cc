@@ -23,13 +23,17 @@
 #include <unistd.h>
 #include <string>
 
+#include "s3_auth_cache.h"
 #include "s3_auth_client.h"
+#include "s3_auth_conn_pool.h"
 #include "s3_auth_fake.h"
 #include "s3_common.h"
 #include "s3_error_codes.h"
 #include "s3_fi_common.h"
 #include "s3_iem.h"
 #include "s3_option.h"
+#include "s3_request_object.h"
+#include "s3_sha256.h"
 #include "s3_common_utilities.h"
 #include "atexit.h"
 
@@ -459,6 +463,10 @@ void S3AuthClientOpContext::handle_response(const char *sz_resp,
     f_success = false;
     return;
   }
+  if (!auth_cache_key.empty() && S3AuthCache::get_instance()) {
+    S3AuthCache::get_instance()->put(auth_cache_key, auth_cache_bucket_name,
+                                     s_resp);
+  }
   if (S3AuthClientOpType::combo_auth == op_type ||
       S3AuthClientOpType::authentication == op_type) {
 
@@ -883,6 +891,60 @@ bool S3AuthClient::setup_auth_request_body() {
   return !auth_request_body.empty();
 }
 
+std::string S3AuthClient::get_auth_cache_key() const {
+  std::string key_data;
+
+  auto append = [&key_data](const std::string &key, const std::string &val) {
+    key_data += key;
+    key_data += '\0';
+    key_data += val;
+    key_data += '\0';
+  };
+  auto value_of = [this](const std::string &key) {
+    auto it = data_key_val.find(key);
+    return data_key_val.end() != it ? it->second : std::string();
+  };
+  switch (op_type) {
+    case S3AuthClientOpType::authorization: {
+      // ACL in the response is built from request headers, and policy
+      // conditions may refer to them too
+      if (value_of("Request-ACL") == "true" ||
+          policy_str.find("Condition") != std::string::npos) {
+        return "";
+      }
+      static const char *const authz_keys[] = {
+          "Method", "RequestorAccountId", "RequestorUserId",
+          "RequestorCanonicalId", "S3Action", "S3ActionList", "Policy",
+          "Auth-ACL", "Bucket-ACL"};
+
+      key_data = "AuthorizeUser";
+      for (const char *key : authz_keys) {
+        append(key, value_of(key));
+      }
+      // Policy statements are matched against the resource, ACLs are not
+      if (!policy_str.empty()) {
+        append("ClientAbsoluteUri", value_of("ClientAbsoluteUri"));
+        append("ClientQueryParams", value_of("ClientQueryParams"));
+      }
+      break;
+    }
+    // A signed request is a bearer token: if its verdict was cached, the
+    // same captured request could be replayed for as long as the entry
+    // lives, even after the access key is disabled. So authentication is
+    // always done by Auth server and only authorization, whose inputs are
+    // the already authenticated principal, is cached.
+    default:
+      return "";
+  }
+  S3sha256 key_hash;
+
+  if (!key_hash.Update(key_data.c_str(), key_data.length()) ||
+      !key_hash.Finalize()) {
+    return "";
+  }
+  return key_hash.get_hex_hash();
+}
+
 void S3AuthClient::set_acl_and_policy(const std::string &acl,
                                       const std::string &policy) {
   policy_str = policy;
@@ -922,15 +984,17 @@ void S3AuthClient::setup_auth_request_headers() {
 
   evhtp_headers_add_header(p_evhtp_req->headers_out,
                            evhtp_header_new("User-Agent", "s3server", 1, 1));
-  /* Using a new connection per request, all types of requests like
-  *   authenticarion, authorization, validateacl, validatepolicy open
-  *   a connection and it will be closed by Authserver.
-  *   TODO : Evaluate performance and change this approach to reuse
-  *   connections
+  /* Without connection pool all types of requests like authentication,
+  *   authorization, validateacl, validatepolicy open a new connection
+  *   and it will be closed by Authserver. With the pool the connection is
+  *   kept open and reused by the next request, see S3AuthConnPool.
   */
+  S3AuthConnPool *conn_pool = S3AuthConnPool::get_instance();
+  const char *connection =
+      conn_pool && conn_pool->is_enabled() ? "keep-alive" : "close";
 
   evhtp_headers_add_header(p_evhtp_req->headers_out,
-                           evhtp_header_new("Connection", "close", 1, 1));
+                           evhtp_header_new("Connection", connection, 1, 1));
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
@@ -972,8 +1036,6 @@ void S3AuthClient::trigger_request() {
     state = S3AuthClientOpState::failed;
     handler_on_failed();
   });
-  auth_context->init_auth_op_ctx();
-
   // Setup the body to be sent to auth service
   if (!setup_auth_request_body()) {
     state = S3AuthClientOpState::failed;
@@ -984,6 +1046,38 @@ void S3AuthClient::trigger_request() {
     }
     return;
   }
+  S3AuthCache *auth_cache = S3AuthCache::get_instance();
+
+  if (auth_cache && auth_cache->is_enabled()) {
+    std::string cache_key = get_auth_cache_key();
+    std::string cached_response;
+
+    if (!cache_key.empty() && auth_cache->get(cache_key, cached_response)) {
+      s3_log(S3_LOG_DEBUG, request_id, "Using cached Auth server response\n");
+
+      evbuffer_free(req_body_buffer);
+      req_body_buffer = NULL;
+
+      at_exit_on_error.cancel();
+      state = S3AuthClientOpState::started;
+
+      auth_context->handle_response(cached_response.c_str(),
+                                    S3HttpSuccess200);
+      if (auth_context->is_success()) {
+        auth_context->on_success_handler()();
+      } else {
+        auth_context->on_failed_handler()();
+      }
+      return;
+    }
+    std::shared_ptr<S3RequestObject> s3_request =
+        std::dynamic_pointer_cast<S3RequestObject>(request);
+
+    auth_context->set_auth_cache_key(
+        std::move(cache_key),
+        s3_request ? s3_request->get_bucket_name() : std::string());
+  }
+  auth_context->init_auth_op_ctx();
   setup_auth_request_headers();
 
   if (S3Option::get_instance()->get_log_level() == "DEBUG") {
@@ -57,6 +57,10 @@ class S3AuthClientOpContext : public S3AsyncOpContextBase {
   long content_length = -1;
   bool f_success = false;
 
+  // Successful response is put to S3AuthCache under this key if not empty
+  std::string auth_cache_key;
+  std::string auth_cache_bucket_name;
+
  public:
   const S3AuthClientOpType op_type;
 
@@ -83,6 +87,11 @@ class S3AuthClientOpContext : public S3AsyncOpContextBase {
 
   void handle_response(const char* sz_resp, int http_status);
 
+  void set_auth_cache_key(std::string key, std::string bucket_name) {
+    auth_cache_key = std::move(key);
+    auth_cache_bucket_name = std::move(bucket_name);
+  }
+
   bool is_success() const { return f_success; }
 
   std::string get_signature_sha256() const {
@@ -248,6 +257,12 @@ class S3AuthClient {
   void set_bucket_acl(const std::string& bucket_acl);
   void set_event_with_retry_interval();
 
+  // Digest of the principal and the request body parts Auth server
+  // authorization decision depends on, empty if the response of this request
+  // must not be cached (always for authentication). Call after
+  // setup_auth_request_body().
+  std::string get_auth_cache_key() const;
+
   void set_entity_path(std::string entity_path) {
     this->entity_path = std::move(entity_path);
   }
@@ -264,6 +279,11 @@ class S3AuthClient {
   FRIEND_TEST(S3AuthClientTest, SetUpAuthRequestBodyForChunkedAuth);
   FRIEND_TEST(S3AuthClientTest, SetUpAuthRequestBodyForChunkedAuth1);
   FRIEND_TEST(S3AuthClientTest, SetUpAuthRequestBodyForChunkedAuth2);
+  FRIEND_TEST(S3AuthClientTest, AuthCacheKeyNotForAuthentication);
+  FRIEND_TEST(S3AuthClientTest, AuthorizationCacheKeyIgnoresRequestId);
+  FRIEND_TEST(S3AuthClientTest, AuthorizationCacheKeyDependsOnPrincipal);
+  FRIEND_TEST(S3AuthClientTest, AuthorizationCacheKeyDependsOnPathWithPolicy);
+  FRIEND_TEST(S3AuthClientTest, AuthorizationCacheKeyNotForRequestACL);
   FRIEND_TEST(S3BucketActionTest, SetAuthorizationMeta);
 };
 
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cassert>
+#include <strings.h>
+
+#include "s3_auth_conn_pool.h"
+#include "s3_log.h"
+#include "s3_option.h"
+#include "s3_stats.h"
+
+extern evhtp_ssl_ctx_t *g_ssl_auth_ctx;
+
+thread_local S3AuthConnPool *S3AuthConnPool::p_instance;
+
+S3AuthConnPool::S3AuthConnPool(evbase_t *p_evbase, unsigned max_idle_conns,
+                               unsigned idle_timeout_sec)
+    : p_evbase(p_evbase),
+      max_idle_conns(max_idle_conns),
+      idle_timeout_sec(idle_timeout_sec) {
+  p_instance = this;
+}
+
+S3AuthConnPool::~S3AuthConnPool() {
+  while (!idle_conns.empty()) {
+    evhtp_connection_t *p_conn = idle_conns.front().p_conn;
+    idle_conns.pop_front();
+    close(p_conn);
+  }
+  p_instance = nullptr;
+}
+
+S3AuthConnPool *S3AuthConnPool::get_instance() { return p_instance; }
+
+evhtp_connection_t *S3AuthConnPool::new_connection(evbase_t *p_evbase) {
+  S3Option *option_instance = S3Option::get_instance();
+
+  if (option_instance->is_s3_ssl_auth_enabled()) {
+    return evhtp_connection_ssl_new(
+        p_evbase, option_instance->get_auth_ip_addr().c_str(),
+        option_instance->get_auth_port(), g_ssl_auth_ctx);
+  }
+  return evhtp_connection_new(p_evbase,
+                              option_instance->get_auth_ip_addr().c_str(),
+                              option_instance->get_auth_port());
+}
+
+evhtp_connection_t *S3AuthConnPool::get_connection() {
+  if (!is_enabled()) {
+    return new_connection(p_evbase);
+  }
+  // Auth server may drop connections idle for long, don't race with it
+  const time_t now = time(nullptr);
+  while (!idle_conns.empty() &&
+         now - idle_conns.back().idle_since > (time_t)idle_timeout_sec) {
+    evhtp_connection_t *p_conn = idle_conns.back().p_conn;
+    idle_conns.pop_back();
+    s3_log(S3_LOG_DEBUG, "", "Closing expired Auth server connection %p",
+           (void *)p_conn);
+    close(p_conn);
+  }
+  if (idle_conns.empty()) {
+    s3_stats_inc("auth_conn_new_count");
+    return new_connection(p_evbase);
+  }
+  evhtp_connection_t *p_conn = idle_conns.front().p_conn;
+  idle_conns.pop_front();
+  evhtp_unset_all_hooks(&p_conn->hooks);
+
+  s3_log(S3_LOG_DEBUG, "", "Reusing Auth server connection %p",
+         (void *)p_conn);
+  s3_stats_inc("auth_conn_reused_count");
+  return p_conn;
+}
+
+void S3AuthConnPool::put_connection(evhtp_connection_t *p_conn) {
+  assert(p_conn != nullptr);
+
+  if (idle_conns.size() >= max_idle_conns) {
+    evhtp_connection_t *p_lru = idle_conns.back().p_conn;
+    idle_conns.pop_back();
+    close(p_lru);
+  }
+  evhtp_unset_all_hooks(&p_conn->hooks);
+  evhtp_set_hook(&p_conn->hooks, evhtp_hook_on_conn_error,
+                 (evhtp_hook)on_conn_err_cb, this);
+  evhtp_set_hook(&p_conn->hooks, evhtp_hook_on_connection_fini,
+                 (evhtp_hook)on_conn_fini_cb, this);
+
+  idle_conns.push_front({p_conn, time(nullptr)});
+  s3_log(S3_LOG_DEBUG, "", "Auth server connection %p is idle, %zu in pool",
+         (void *)p_conn, idle_conns.size());
+}
+
+void S3AuthConnPool::forget(evhtp_connection_t *p_conn) {
+  for (auto it = idle_conns.begin(); it != idle_conns.end(); ++it) {
+    if (it->p_conn == p_conn) {
+      idle_conns.erase(it);
+      return;
+    }
+  }
+}
+
+// Connection must not be in idle_conns
+void S3AuthConnPool::close(evhtp_connection_t *p_conn) {
+  evhtp_unset_all_hooks(&p_conn->hooks);
+  evhtp_connection_free(p_conn);
+}
+
+evhtp_res S3AuthConnPool::on_conn_err_cb(evhtp_connection_t *p_conn,
+                                         evhtp_error_flags errtype,
+                                         void *p_arg) noexcept {
+  assert(p_conn != nullptr);
+  assert(p_arg != nullptr);
+
+  s3_log(S3_LOG_DEBUG, "", "Idle Auth server connection %p is closed",
+         (void *)p_conn);
+  // libevhtp frees the connection after this hook
+  evhtp_unset_all_hooks(&p_conn->hooks);
+  static_cast<S3AuthConnPool *>(p_arg)->forget(p_conn);
+
+  return EVHTP_RES_OK;
+}
+
+evhtp_res S3AuthConnPool::on_conn_fini_cb(evhtp_connection_t *p_conn,
+                                          void *p_arg) noexcept {
+  assert(p_conn != nullptr);
+  assert(p_arg != nullptr);
+
+  static_cast<S3AuthConnPool *>(p_arg)->forget(p_conn);
+
+  return EVHTP_RES_OK;
+}
+
+void S3AuthConnPool::on_response_complete(evhtp_request_t *p_req,
+                                          void *p_arg) {
+  S3AuthConnPool *p_pool = get_instance();
+
+  if (!p_pool || !p_pool->is_enabled() || !p_req || !p_req->conn) {
+    return;
+  }
+  const char *connection_hdr =
+      evhtp_header_find(p_req->headers_in, "Connection");
+  if (connection_hdr && !strcasecmp(connection_hdr, "close")) {
+    s3_log(S3_LOG_DEBUG, "", "Auth server closes connection %p",
+           (void *)p_req->conn);
+    return;
+  }
+  // Response hooks of the auth request context are already unset by now
+  p_pool->put_connection(p_req->conn);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_AUTH_CONN_POOL_H__
+#define __S3_SERVER_S3_AUTH_CONN_POOL_H__
+
+#include <ctime>
+#include <list>
+
+#include <gtest/gtest_prod.h>
+
+#include "s3_common.h"
+
+EXTERN_C_BLOCK_BEGIN
+#include <evhtp.h>
+EXTERN_C_BLOCK_END
+
+// Keeps idle keep-alive connections to the Auth server, so that
+// authentication and authorization requests don't pay for TCP (and SSL)
+// setup every time.
+//
+// There is one pool per reactor thread, a connection is used only on the
+// event base it was created on. A connection is taken out of the pool for
+// one request and put back by on_response_complete() once the response has
+// been parsed, unless Auth server asked to close it. A connection failing
+// while in use is freed by libevhtp as before; idle connections closed by
+// Auth server are dropped from the pool by the connection hooks.
+class S3AuthConnPool {
+
+  // The class should have single instance per reactor thread
+  static thread_local S3AuthConnPool* p_instance;
+
+  struct IdleConnection {
+    evhtp_connection_t* p_conn;
+    time_t idle_since;
+  };
+  // Most recently used connection is at the front
+  std::list<IdleConnection> idle_conns;
+
+  evbase_t* p_evbase;
+  unsigned max_idle_conns;
+  unsigned idle_timeout_sec;
+
+  static evhtp_res on_conn_err_cb(evhtp_connection_t* p_conn,
+                                  evhtp_error_flags errtype,
+                                  void* p_arg) noexcept;
+  static evhtp_res on_conn_fini_cb(evhtp_connection_t* p_conn,
+                                   void* p_arg) noexcept;
+
+  void forget(evhtp_connection_t* p_conn);
+  void close(evhtp_connection_t* p_conn);
+
+ public:
+  S3AuthConnPool(evbase_t* p_evbase, unsigned max_idle_conns,
+                 unsigned idle_timeout_sec);
+
+  S3AuthConnPool(const S3AuthConnPool&) = delete;
+  S3AuthConnPool& operator=(const S3AuthConnPool&) = delete;
+
+  ~S3AuthConnPool();
+
+  // Returns nullptr if the pool isn't created on the calling thread
+  static S3AuthConnPool* get_instance();
+
+  // Opens a new connection to Auth server, not tracked by any pool
+  static evhtp_connection_t* new_connection(evbase_t* p_evbase);
+
+  // Completion callback for auth requests, see evhtp_request_new()
+  static void on_response_complete(evhtp_request_t* p_req, void* p_arg);
+
+  // With pool size 0 every request gets a new connection, which Auth server
+  // closes after the response ("Connection: close").
+  bool is_enabled() const { return max_idle_conns > 0; }
+
+  // Returns the most recently used idle connection or a new one
+  evhtp_connection_t* get_connection();
+
+  // Puts connection with no request in progress back to the pool. If the
+  // pool is full the least recently used connection is closed.
+  void put_connection(evhtp_connection_t* p_conn);
+
+  size_t get_idle_count() const { return idle_conns.size(); }
+
+  FRIEND_TEST(S3AuthConnPoolTest, IdleConnectionClosedByServerIsForgotten);
+};
+
+#endif  // __S3_SERVER_S3_AUTH_CONN_POOL_H__
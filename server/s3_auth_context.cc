@@ -21,30 +21,25 @@
 #include <event2/thread.h>
 
 #include "s3_auth_context.h"
+#include "s3_auth_conn_pool.h"
 #include "s3_log.h"
-#include "s3_option.h"
-
-extern evhtp_ssl_ctx_t *g_ssl_auth_ctx;
 
 struct s3_auth_op_context *create_basic_auth_op_ctx(
     struct event_base *eventbase) {
   s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
-  S3Option *option_instance = S3Option::get_instance();
+  S3AuthConnPool *conn_pool = S3AuthConnPool::get_instance();
   struct s3_auth_op_context *ctx =
       (struct s3_auth_op_context *)calloc(1, sizeof(struct s3_auth_op_context));
   ctx->evbase = eventbase;
-  if (option_instance->is_s3_ssl_auth_enabled()) {
-    ctx->conn = evhtp_connection_ssl_new(
-        ctx->evbase, option_instance->get_auth_ip_addr().c_str(),
-        option_instance->get_auth_port(), g_ssl_auth_ctx);
+  if (conn_pool && conn_pool->is_enabled()) {
+    ctx->conn = conn_pool->get_connection();
+    ctx->auth_request = evhtp_request_new(
+        S3AuthConnPool::on_response_complete, ctx->evbase);
   } else {
-    ctx->conn = evhtp_connection_new(
-        ctx->evbase, option_instance->get_auth_ip_addr().c_str(),
-        option_instance->get_auth_port());
+    ctx->conn = S3AuthConnPool::new_connection(ctx->evbase);
+    ctx->auth_request = evhtp_request_new(NULL, ctx->evbase);
   }
 
-  ctx->auth_request = evhtp_request_new(NULL, ctx->evbase);
-
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return ctx;
 }
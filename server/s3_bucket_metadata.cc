@@ -28,6 +28,7 @@
 #include "s3_iem.h"
 #include "s3_log.h"
 #include "s3_m0_uint128_helper.h"
+#include "s3_metadata_record.h"
 #include "s3_request_object.h"
 #include "s3_uri_to_motr_oid.h"
 
@@ -165,15 +166,13 @@ std::string S3BucketMetadata::to_json() {
   current_time.init_current_time();
   root["create_timestamp"] = current_time.get_isoformat_string();
 
-  Json::FastWriter fastWriter;
-  return fastWriter.write(root);
+  return S3MetadataRecord::serialize(root);
 }
 
 int S3BucketMetadata::from_json(std::string content) {
   s3_log(S3_LOG_DEBUG, request_id, "Called\n");
   Json::Value newroot;
-  Json::Reader reader;
-  bool parsingSuccessful = reader.parse(content.c_str(), newroot);
+  bool parsingSuccessful = S3MetadataRecord::parse(content, newroot);
   if (!parsingSuccessful || s3_fi_is_enabled("bucket_metadata_corrupted")) {
     s3_log(S3_LOG_ERROR, request_id, "Json Parsing failed.\n");
     return -1;
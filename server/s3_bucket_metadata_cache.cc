@@ -23,13 +23,14 @@
 #define S3_BUCKET_METADATA_CACHE_DEFINITION
 #define S3_BUCKET_METADATA_V1_DEFINITION
 
+#include "s3_auth_cache.h"
 #include "s3_bucket_metadata_cache.h"
 #include "s3_bucket_metadata_v1.h"
 #include "s3_factory.h"
 #include "s3_log.h"
 #include "s3_request_object.h"
 
-S3BucketMetadataCache* S3BucketMetadataCache::p_instance;
+thread_local S3BucketMetadataCache* S3BucketMetadataCache::p_instance;
 
 std::unique_ptr<S3BucketMetadataV1>
 S3MotrBucketMetadataFactory::create_motr_bucket_metadata_obj(
@@ -69,6 +70,17 @@ void S3BucketMetadataCache::Item::on_load(S3BucketMetadataState state) {
   if (p_engine_modify) {
     // Wait for modify operation has finished
     p_engine_load.reset();
+  } else if (CurrentOp::fetching != current_op) {
+    // Modify operation has finished while loading (possible with background
+    // refresh), the loaded value is outdated.
+    p_engine_load.reset();
+    notify_waiters(p_value->get_state());
+
+    if (f_remove_pending) {
+      // "this" is destroyed here
+      S3BucketMetadataCache::p_instance->remove_item(
+          p_value->get_bucket_name());
+    }
   } else {
     p_engine_modify = std::move(p_engine_load);
     on_done(state);
@@ -76,6 +88,18 @@ void S3BucketMetadataCache::Item::on_load(S3BucketMetadataState state) {
   s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
 }
 
+void S3BucketMetadataCache::Item::notify_waiters(S3BucketMetadataState state) {
+  while (!fetch_waiters.empty()) {
+
+    auto on_fetch = std::move(fetch_waiters.front());
+    fetch_waiters.pop();
+
+    if (on_fetch) {
+      on_fetch(state, *p_value);
+    }
+  }
+}
+
 void S3BucketMetadataCache::Item::on_done(S3BucketMetadataState state) {
   s3_log(S3_LOG_DEBUG, nullptr, "%s Entry", __func__);
 
@@ -91,15 +115,8 @@ void S3BucketMetadataCache::Item::on_done(S3BucketMetadataState state) {
   update_time = Clock::now();
   S3BucketMetadataCache::p_instance->updated(this);
 
-  while (!fetch_waiters.empty()) {
-
-    auto on_fetch = std::move(fetch_waiters.front());
-    fetch_waiters.pop();
+  notify_waiters(state);
 
-    if (on_fetch) {
-      on_fetch(state, *p_value);
-    }
-  }
   if (CurrentOp::saving == current_op || CurrentOp::deleting == current_op) {
 
     assert(this->on_changed);
@@ -110,7 +127,13 @@ void S3BucketMetadataCache::Item::on_done(S3BucketMetadataState state) {
       S3BucketMetadataState::failed_to_launch == state ||
       CurrentOp::deleting == current_op) {
 
-    S3BucketMetadataCache::p_instance->remove_item(p_value->get_bucket_name());
+    if (p_engine_load) {
+      // Motr operation must not outlive the entry, see on_load()
+      f_remove_pending = true;
+    } else {
+      S3BucketMetadataCache::p_instance->remove_item(
+          p_value->get_bucket_name());
+    }
   }
   s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
 }
@@ -119,44 +142,53 @@ void S3BucketMetadataCache::Item::fetch(const S3BucketMetadata& src,
                                         FetchHandlerType on_fetch) {
   s3_log(S3_LOG_DEBUG, src.get_request_id(), "%s Entry", __func__);
 
+  auto* p_cache = S3BucketMetadataCache::p_instance;
+
   fetch_waiters.push(std::move(on_fetch));
 
   const auto seconds_lasted = std::chrono::duration_cast<std::chrono::seconds>(
       access_time - update_time).count();
 
+  // "Missing" entries have their own, shorter life time
+  const auto state = p_value->get_state();
+  const bool is_cacheable =
+      S3BucketMetadataState::present == state ||
+      (S3BucketMetadataState::missing == state &&
+       p_cache->negative_expire_interval_sec > 0);
   const bool is_expired =
-      seconds_lasted >= S3BucketMetadataCache::p_instance->expire_interval_sec;
+      seconds_lasted >= (S3BucketMetadataState::missing == state
+                             ? p_cache->negative_expire_interval_sec
+                             : p_cache->expire_interval_sec);
 
   if (is_expired) {
     s3_log(S3_LOG_DEBUG, src.get_request_id(),
            "Cache entry for \"%s\" is expired", src.get_bucket_name().c_str());
   }
-  if (!is_expired && !S3BucketMetadataCache::p_instance->disabled &&
-      p_value->get_state() == S3BucketMetadataState::present) {
+  if (!is_expired && !p_cache->disabled && is_cacheable) {
 
     s3_log(S3_LOG_DEBUG, src.get_request_id(),
            "Using cached bucket metadata for \"%s\"",
            src.get_bucket_name().c_str());
 
-    // We have to "retain" one S3 request to avoid a case when number of
-    // requests to Motr exceeds the number of requests to S3server
-    if (seconds_lasted <
-            S3BucketMetadataCache::p_instance->refresh_interval_sec ||
-        fetch_waiters.size() > 1) {
-
-      on_fetch = std::move(fetch_waiters.front());
-      fetch_waiters.pop();
-
-      on_fetch(S3BucketMetadataState::present, *p_value);
+    on_fetch = std::move(fetch_waiters.front());
+    fetch_waiters.pop();
 
-      s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
-      return;
+    // Refresh ahead of expiration so that requests to hot buckets never
+    // wait for a reload. Refresh is started by a request, so the number of
+    // requests to Motr doesn't exceed the number of requests to S3server.
+    if (S3BucketMetadataState::present == state &&
+        seconds_lasted >= p_cache->refresh_interval_sec && !p_engine_modify &&
+        !p_engine_load) {
 
-    } else {
       s3_log(S3_LOG_DEBUG, nullptr,
-             "Cache entry for \"%s\" needs to be refreshed",
+             "Cache entry for \"%s\" is being refreshed in background",
              p_value->get_bucket_name().c_str());
+      start_load();
     }
+    on_fetch(state, *p_value);
+
+    s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
+    return;
   }
   if (p_engine_modify || p_engine_load) {
 
@@ -166,16 +198,20 @@ void S3BucketMetadataCache::Item::fetch(const S3BucketMetadata& src,
            p_value->get_bucket_name().c_str());
 
   } else {
-    p_engine_load = S3BucketMetadataCache::p_instance->create_engine(*p_value);
-
-    p_engine_load->load(*p_value,
-                        std::bind(&S3BucketMetadataCache::Item::on_load, this,
-                                  std::placeholders::_1));
-    current_op = CurrentOp::fetching;
+    start_load();
   }
   s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
 }
 
+void S3BucketMetadataCache::Item::start_load() {
+  p_engine_load = S3BucketMetadataCache::p_instance->create_engine(*p_value);
+
+  p_engine_load->load(*p_value,
+                      std::bind(&S3BucketMetadataCache::Item::on_load, this,
+                                std::placeholders::_1));
+  current_op = CurrentOp::fetching;
+}
+
 void S3BucketMetadataCache::Item::save(const S3BucketMetadata& src,
                                        StateHandlerType on_save) {
   s3_log(S3_LOG_DEBUG, src.get_stripped_request_id(), "%s Entry", __func__);
@@ -189,6 +225,9 @@ void S3BucketMetadataCache::Item::save(const S3BucketMetadata& src,
   } else {
     current_op = CurrentOp::saving;
     on_changed = std::move(on_save);
+    // The bucket is written again, a removal scheduled by a failed or
+    // delete operation no longer applies
+    f_remove_pending = false;
 
     p_engine_modify = S3BucketMetadataCache::p_instance->create_engine(src);
 
@@ -211,6 +250,7 @@ void S3BucketMetadataCache::Item::update(const S3BucketMetadata& src,
   } else {
     current_op = CurrentOp::saving;
     on_changed = std::move(on_update);
+    f_remove_pending = false;
 
     p_engine_modify = S3BucketMetadataCache::p_instance->create_engine(src);
 
@@ -248,11 +288,12 @@ void S3BucketMetadataCache::Item::remove(StateHandlerType on_remove) {
 
 S3BucketMetadataCache::S3BucketMetadataCache(
     unsigned max_cache_size, unsigned expire_interval_sec,
-    unsigned refresh_interval_sec,
+    unsigned refresh_interval_sec, unsigned negative_expire_interval_sec,
     std::shared_ptr<S3MotrBucketMetadataFactory> motr_bucket_metadata_factory)
     : max_cache_size(max_cache_size),
       expire_interval_sec(expire_interval_sec),
-      refresh_interval_sec(refresh_interval_sec) {
+      refresh_interval_sec(refresh_interval_sec),
+      negative_expire_interval_sec(negative_expire_interval_sec) {
 
   if (p_instance) {
     s3_log(S3_LOG_FATAL, "",
@@ -419,6 +460,10 @@ void S3BucketMetadataCache::update(const S3BucketMetadata& src,
 
   s3_log(S3_LOG_DEBUG, src.get_stripped_request_id(), "%s Entry", __func__);
 
+  // Cached authorization results may refer to old ACL or policy
+  if (S3AuthCache::get_instance()) {
+    S3AuthCache::get_instance()->invalidate_bucket(src.get_bucket_name());
+  }
   Item* p_item = get_item(src);
 
   if (p_item) {
@@ -434,6 +479,10 @@ void S3BucketMetadataCache::remove(const S3BucketMetadata& src,
 
   s3_log(S3_LOG_DEBUG, src.get_stripped_request_id(), "%s Entry", __func__);
 
+  // Cached authorization results may refer to old ACL or policy
+  if (S3AuthCache::get_instance()) {
+    S3AuthCache::get_instance()->invalidate_bucket(src.get_bucket_name());
+  }
   Item* p_item = get_item(src);
 
   if (p_item) {
@@ -38,16 +38,20 @@ class S3RequestObject;
 
 class S3BucketMetadataCache {
 
-  // The class should have single instance
-  static S3BucketMetadataCache* p_instance;
+  // The class should have single instance per reactor thread. As with
+  // separate s3server processes, reactors don't share cached entries.
+  static thread_local S3BucketMetadataCache* p_instance;
 
  protected:
   unsigned max_cache_size, expire_interval_sec, refresh_interval_sec;
+  // Life time of entries for absent buckets, 0 - such entries aren't used
+  unsigned negative_expire_interval_sec;
   bool disabled = false;
 
  public:
   S3BucketMetadataCache(unsigned max_cache_size, unsigned expire_interval_sec,
                         unsigned refresh_interval_sec,
+                        unsigned negative_expire_interval_sec,
                         std::shared_ptr<S3MotrBucketMetadataFactory> = {});
 
   S3BucketMetadataCache(const S3BucketMetadataCache&) = delete;
@@ -128,8 +132,12 @@ class S3BucketMetadataCache::Item {
  private:
   void on_done(S3BucketMetadataState state);
   void on_load(S3BucketMetadataState state);
+  void start_load();
+  void notify_waiters(S3BucketMetadataState state);
 
   CurrentOp current_op = CurrentOp::none;
+  // Entry is to be removed once background load has finished
+  bool f_remove_pending = false;
   // For save, update and remove operations
   StateHandlerType on_changed;
   // For fetch operation
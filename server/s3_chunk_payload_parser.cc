@@ -21,6 +21,7 @@
 #include <stdlib.h>
 
 #include "s3_chunk_payload_parser.h"
+#include "s3_hash_workers.h"
 #include "s3_iem.h"
 #include "s3_log.h"
 #include "s3_option.h"
@@ -35,22 +36,38 @@ void S3ChunkDetail::reset() {
   signature = "";
   payload_hash = "";
   hash_ctx.reset();
+  hash_job.reset();
 }
 
 void S3ChunkDetail::debug_dump() {
   s3_log(S3_LOG_DEBUG, "",
          "Chunk Details start: chunk_number = [%d], size = [%zu],\n\
          signature = [%s]\nHash = [%s]\nChunk Details end.\n",
-         chunk_number, chunk_size, signature.c_str(), payload_hash.c_str());
+         chunk_number, chunk_size, signature.c_str(),
+         get_payload_hash().c_str());
 }
 
-bool S3ChunkDetail::is_ready() { return ready; }
+bool S3ChunkDetail::is_ready() {
+  if (hash_job) {
+    return hash_job->done && hash_job->ok;
+  }
+  return ready;
+}
 
 void S3ChunkDetail::add_size(size_t size) { chunk_size = size; }
 
 void S3ChunkDetail::add_signature(const std::string &sign) { signature = sign; }
 
 bool S3ChunkDetail::update_hash(const void *data_ptr, size_t data_len) {
+  if (data_ptr != NULL && (hash_job || S3HashWorkers::get_instance())) {
+    // Copying is much cheaper than hashing, keep the data for a worker
+    if (!hash_job) {
+      hash_job = std::make_shared<S3ChunkHashJob>();
+      hash_job->data.reserve(chunk_size);
+    }
+    hash_job->data.append((const char *)data_ptr, data_len);
+    return true;
+  }
   if (data_ptr == NULL) {
     std::string emptee_string = "";
     return hash_ctx.Update(emptee_string.c_str(), emptee_string.length());
@@ -58,7 +75,31 @@ bool S3ChunkDetail::update_hash(const void *data_ptr, size_t data_len) {
   return hash_ctx.Update((const char *)data_ptr, data_len);
 }
 
-bool S3ChunkDetail::fini_hash() {
+bool S3ChunkDetail::fini_hash(std::function<void()> on_ready) {
+  if (hash_job) {
+    auto job = hash_job;
+    auto work = [job]() {
+      S3sha256 hash;
+      job->ok = hash.Update(job->data.c_str(), job->data.length()) &&
+                hash.Finalize();
+      if (job->ok) {
+        job->payload_hash = hash.get_hex_hash();
+      }
+      std::string().swap(job->data);
+    };
+    S3HashWorkers *workers = S3HashWorkers::get_instance();
+    if (workers && workers->submit(work, [job, on_ready]() {
+          job->done = true;
+          if (on_ready) {
+            on_ready();
+          }
+        })) {
+      return true;
+    }
+    work();
+    job->done = true;
+    return job->ok;
+  }
   bool status = hash_ctx.Finalize();
   if (status) {
     payload_hash = hash_ctx.get_hex_hash();
@@ -71,12 +112,18 @@ size_t S3ChunkDetail::get_size() { return chunk_size; }
 
 const std::string &S3ChunkDetail::get_signature() { return signature; }
 
-std::string S3ChunkDetail::get_payload_hash() { return payload_hash; }
+std::string S3ChunkDetail::get_payload_hash() {
+  if (hash_job) {
+    return hash_job->done ? hash_job->payload_hash : "";
+  }
+  return payload_hash;
+}
 
 S3ChunkPayloadParser::S3ChunkPayloadParser()
     : parser_state(ChunkParserState::c_start),
       chunk_data_size_to_read(0),
       content_length(0),
+      chunk_ready_callback(std::make_shared<std::function<void()>>()),
       chunk_sig_key_q_const(S3_AWS_CHUNK_KEY),
       chunk_sig_key_char_state(S3_AWS_CHUNK_KEY) {
   s3_log(S3_LOG_DEBUG, "", "%s Ctor\n", __func__);
@@ -369,7 +416,14 @@ std::deque<evbuf_t *> S3ChunkPayloadParser::run(evbuf_t *buf) {
           if ((unsigned char)chptr[j] == LF) {
             // CRLF means we are done with data
             parser_state = ChunkParserState::c_start;
-            current_chunk_detail.fini_hash();
+            std::weak_ptr<std::function<void()>> callback =
+                chunk_ready_callback;
+            current_chunk_detail.fini_hash([callback]() {
+              auto on_ready = callback.lock();
+              if (on_ready && *on_ready) {
+                (*on_ready)();
+              }
+            });
             current_chunk_detail.debug_dump();
             chunk_details.push(current_chunk_detail);
           } else {
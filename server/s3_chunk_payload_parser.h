@@ -25,6 +25,7 @@
 
 #include <evhtp.h>
 
+#include <functional>
 #include <memory>
 #include <queue>
 #include <string>
@@ -40,6 +41,16 @@
 #define S3_AWS_CHUNK_KEY \
   { 'c', 'h', 'u', 'n', 'k', '-', 's', 'i', 'g', 'n', 'a', 't', 'u', 'r', 'e' }
 
+// Chunk data hashed by S3HashWorkers, shared by all copies of its
+// S3ChunkDetail. The worker owns data, ok and payload_hash until done is set
+// on the event loop.
+struct S3ChunkHashJob {
+  std::string data;
+  std::string payload_hash;
+  bool ok = false;
+  bool done = false;
+};
+
 class S3ChunkDetail {
   size_t chunk_size;
   std::string signature;
@@ -47,6 +58,8 @@ class S3ChunkDetail {
   S3sha256 hash_ctx;
   bool ready;  // this is true when all the data is updated in hash
   int chunk_number;
+  // Set when chunk data is hashed by S3HashWorkers instead of hash_ctx
+  std::shared_ptr<S3ChunkHashJob> hash_job;
 
  public:
   S3ChunkDetail();
@@ -58,7 +71,8 @@ class S3ChunkDetail {
   void add_size(size_t size);
   void add_signature(const std::string &sign);
   bool update_hash(const void *data_ptr, size_t data_len = 0);
-  bool fini_hash();
+  // on_ready is called if the hash is completed later by S3HashWorkers
+  bool fini_hash(std::function<void()> on_ready = nullptr);
 
   size_t get_size();
   const std::string &get_signature();
@@ -91,6 +105,8 @@ class S3ChunkPayloadParser {
   size_t content_length;  // actual data embedded in chunks
   std::string current_chunk_signature;
   S3ChunkDetail current_chunk_detail;
+  // Shared with pending hash jobs, which must not call it once we are gone
+  std::shared_ptr<std::function<void()>> chunk_ready_callback;
 
   const std::queue<char> chunk_sig_key_q_const;
   std::queue<char> chunk_sig_key_char_state;  // init has val = chunk-signature,
@@ -127,6 +143,10 @@ class S3ChunkPayloadParser {
 
   bool is_chunk_detail_ready();
   S3ChunkDetail pop_chunk_detail();
+  // Called when a chunk detail becomes ready after run() returned
+  void set_chunk_ready_callback(std::function<void()> callback) {
+    *chunk_ready_callback = std::move(callback);
+  }
 
   FRIEND_TEST(S3ChunkPayloadParserTest, HasProperInitState);
   FRIEND_TEST(S3ChunkPayloadParserTest, AddToSpareBufferEqualToSpareSize);
@@ -237,6 +237,8 @@ std::string evhtp_error_flags_description(uint8_t errtype) {
 
 }  // namespace S3CommonUtilities
 
+void (*s3_graceful_shutdown_hook)() = nullptr;
+
 void s3_kickoff_graceful_shutdown(int ignore) {
   extern int global_shutdown_in_progress;
   extern evbase_t *global_evbase_handle;
@@ -249,6 +251,9 @@ void s3_kickoff_graceful_shutdown(int ignore) {
     struct timeval delay = {shutdown_grace_period, 0};
     // trigger rollbacks & stop handling new requests
     option_instance->set_is_s3_shutting_down(true);
+    if (s3_graceful_shutdown_hook) {
+      s3_graceful_shutdown_hook();
+    }
     s3_log(S3_LOG_INFO, "", "Calling event_base_loopexit\n");
     event_base_loopexit(global_evbase_handle, &delay);
   }
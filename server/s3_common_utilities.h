@@ -97,5 +97,8 @@ std::string evhtp_error_flags_description(uint8_t errtype);
 
 // Common graceful shutdown
 void s3_kickoff_graceful_shutdown(int ignore);
+// Called once by s3_kickoff_graceful_shutdown(), s3server sets it to stop
+// additional reactors from accepting new connections.
+extern void (*s3_graceful_shutdown_hook)();
 
 #endif
@@ -29,6 +29,7 @@
 #include "s3_log.h"
 #include "s3_motr_layout.h"
 #include "s3_m0_uint128_helper.h"
+#include "s3_object_data_refs.h"
 #include "s3_probable_delete_record.h"
 #include "s3_uri_to_motr_oid.h"
 
@@ -67,7 +68,7 @@ void S3CopyObjectAction::setup_steps() {
   ACTION_TASK_ADD(S3CopyObjectAction::set_source_bucket_authorization_metadata,
                   this);
   ACTION_TASK_ADD(S3CopyObjectAction::check_source_bucket_authorization, this);
-  ACTION_TASK_ADD(S3CopyObjectAction::create_object, this);
+  ACTION_TASK_ADD(S3CopyObjectAction::create_destination_object, this);
   ACTION_TASK_ADD(S3CopyObjectAction::copy_object, this);
   ACTION_TASK_ADD(S3CopyObjectAction::save_metadata, this);
   ACTION_TASK_ADD(S3CopyObjectAction::send_response_to_s3_client, this);
@@ -130,11 +131,132 @@ void S3CopyObjectAction::validate_copyobject_request() {
     send_response_to_s3_client();
   } else {
     total_data_to_stream = additional_object_metadata->get_content_length();
+    store_data_inline = additional_object_metadata->has_inline_data();
+    copy_by_reference = !store_data_inline && can_copy_by_reference();
     next();
   }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+// Destination metadata must look as if the data was written for it
+bool S3CopyObjectAction::can_copy_by_reference() {
+  return S3ObjectDataRefs::is_enabled() && total_data_to_stream > 0 &&
+         additional_object_metadata->get_layout_id() ==
+             S3MotrLayoutMap::get_instance()->get_layout_for_object_size(
+                 total_data_to_stream);
+}
+
+void S3CopyObjectAction::create_destination_object() {
+  if (store_data_inline) {
+    copy_inline_data();
+  } else if (copy_by_reference) {
+    add_data_ref();
+  } else {
+    create_object();
+  }
+}
+
+void S3CopyObjectAction::add_data_ref() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  // Cleanup deletes the destination through motr_writer, which keeps data
+  // that is still referenced
+  motr_writer = motr_writer_factory->create_motr_writer(request);
+
+  new_object_metadata = object_metadata_factory->create_object_metadata_obj(
+      request, bucket_metadata->get_object_list_index_layout(),
+      bucket_metadata->get_objects_version_list_index_layout());
+  new_object_metadata->regenerate_version_id();
+
+  S3ObjectDataRefs::Ref source;
+  source.object_list_index_layout =
+      additional_bucket_metadata->get_object_list_index_layout();
+  source.object_name = additional_object_name;
+  source.version_id = additional_object_metadata->get_obj_version_id();
+
+  S3ObjectDataRefs::Ref copy;
+  copy.object_list_index_layout =
+      bucket_metadata->get_object_list_index_layout();
+  copy.object_name = request->get_object_name();
+  copy.version_id = new_object_metadata->get_obj_version_id();
+
+  data_refs.reset(new S3ObjectDataRefs(request, s3_motr_api, nullptr,
+                                       mote_kv_writer_factory));
+  data_refs->add(additional_object_metadata->get_oid(), source, copy,
+                 std::bind(&S3CopyObjectAction::add_data_ref_successful, this),
+                 std::bind(&S3CopyObjectAction::add_data_ref_failed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3CopyObjectAction::add_data_ref_successful() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  // The source data OID alone is the key of records made for the source
+  // itself, so the OID this copy would have written with is kept with the
+  // copy and appended to its keys. The data OID stays first, background
+  // delete takes it from the key.
+  new_object_metadata->set_copy_oid(new_object_oid);
+
+  new_object_oid = additional_object_metadata->get_oid();
+  _set_layout_id(additional_object_metadata->get_layout_id());
+
+  new_object_metadata->set_oid(new_object_oid);
+  new_object_metadata->set_layout_id(layout_id);
+  new_object_metadata->set_pvid(additional_object_metadata->get_pvid());
+  new_oid_str = new_object_metadata->get_probable_delete_key();
+
+  // From here on the destination is cleaned up as if it had its own data
+  s3_put_action_state = S3PutObjectActionState::newObjOidCreated;
+  add_object_oid_to_probable_dead_oid_list();
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3CopyObjectAction::add_data_ref_failed() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  s3_put_action_state = S3PutObjectActionState::newObjOidCreationFailed;
+
+  switch (data_refs->get_state()) {
+    case S3ObjectDataRefsOpState::source_missing:
+      set_s3_error("NoSuchKey");
+      break;
+    case S3ObjectDataRefsOpState::failed_to_launch:
+      set_s3_error("ServiceUnavailable");
+      break;
+    default:
+      s3_log(S3_LOG_ERROR, request_id, "Failed to share source object data\n");
+      set_s3_error("InternalError");
+  }
+  send_response_to_s3_client();
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+// Small source object keeps its data in the metadata record, so does the copy
+void S3CopyObjectAction::copy_inline_data() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  _set_layout_id(S3MotrLayoutMap::get_instance()->get_layout_for_object_size(
+      total_data_to_stream));
+
+  new_object_metadata = object_metadata_factory->create_object_metadata_obj(
+      request, bucket_metadata->get_object_list_index_layout(),
+      bucket_metadata->get_objects_version_list_index_layout());
+  new_object_metadata->regenerate_version_id();
+  new_object_metadata->set_layout_id(layout_id);
+  new_object_metadata->set_inline_data(
+      additional_object_metadata->get_inline_data());
+  // Still makes the key of old object probable delete record
+  new_oid_str = S3M0Uint128Helper::to_string(new_object_oid);
+
+  s3_put_action_state = S3PutObjectActionState::writeComplete;
+  add_object_oid_to_probable_dead_oid_list();
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
 const char xml_spaces[] = "        ";
 // Shall be 8 bytes (size of cipher block)
 
@@ -157,6 +279,17 @@ void S3CopyObjectAction::copy_object() {
     next();
     return;
   }
+  if (store_data_inline) {
+    s3_log(S3_LOG_DEBUG, stripped_request_id, "Source data is inline");
+    next();
+    return;
+  }
+  if (copy_by_reference) {
+    s3_log(S3_LOG_DEBUG, stripped_request_id, "Source data is shared");
+    s3_put_action_state = S3PutObjectActionState::writeComplete;
+    next();
+    return;
+  }
   bool f_success = false;
   try {
     object_data_copier.reset(new S3ObjectDataCopier(
@@ -222,7 +355,9 @@ void S3CopyObjectAction::save_metadata() {
   new_object_metadata->set_content_length(std::to_string(total_data_to_stream));
   new_object_metadata->set_content_type(
       additional_object_metadata->get_content_type());
-  new_object_metadata->set_md5(motr_writer->get_content_md5());
+  new_object_metadata->set_md5(copy_by_reference || store_data_inline
+                                   ? additional_object_metadata->get_md5()
+                                   : motr_writer->get_content_md5());
   new_object_metadata->setacl(auth_acl);
 
   // put source object tags on new object
@@ -46,6 +46,7 @@ const char DirectiveValueReplace[] = "REPLACE";
 const char DirectiveValueCOPY[] = "COPY";
 
 class S3ObjectDataCopier;
+class S3ObjectDataRefs;
 
 class S3CopyObjectAction : public S3PutObjectActionBase {
   std::string auth_acl;
@@ -55,6 +56,10 @@ class S3CopyObjectAction : public S3PutObjectActionBase {
 
   bool response_started = false;
 
+  // Destination shares data of the source object, see S3ObjectDataRefs
+  bool copy_by_reference = false;
+  std::unique_ptr<S3ObjectDataRefs> data_refs;
+
   bool if_source_and_destination_same();
 
   void set_authorization_meta();
@@ -80,6 +85,12 @@ class S3CopyObjectAction : public S3PutObjectActionBase {
   std::string get_response_xml();
 
   void validate_copyobject_request();
+  bool can_copy_by_reference();
+  void create_destination_object();
+  void add_data_ref();
+  void add_data_ref_successful();
+  void add_data_ref_failed();
+  void copy_inline_data();
   void copy_object();
   bool copy_object_cb();
   void copy_object_success();
@@ -136,6 +147,10 @@ class S3CopyObjectAction : public S3PutObjectActionBase {
   FRIEND_TEST(S3CopyObjectActionTest, CreateObjectFailedToLaunchTest);
   FRIEND_TEST(S3CopyObjectActionTest, CreateNewOidTest);
   FRIEND_TEST(S3CopyObjectActionTest, ZeroSizeObject);
+  FRIEND_TEST(S3CopyObjectActionTest, CanCopyByReference);
+  FRIEND_TEST(S3CopyObjectActionTest, CopyObjectSkippedWhenCopyByReference);
+  FRIEND_TEST(S3CopyObjectActionTest, AddDataRefSuccessful);
+  FRIEND_TEST(S3CopyObjectActionTest, AddDataRefPutsRefs);
   FRIEND_TEST(S3CopyObjectActionTest, SaveMetadata);
   FRIEND_TEST(S3CopyObjectActionTest, SaveObjectMetadataFailed);
   FRIEND_TEST(S3CopyObjectActionTest, SendResponseWhenShuttingDown);
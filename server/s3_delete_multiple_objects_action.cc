@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "s3_delete_multiple_objects_action.h"
 #include "s3_error_codes.h"
 #include "s3_iem.h"
@@ -31,6 +33,21 @@ extern struct s3_motr_idx_layout global_probable_dead_object_list_index_layout;
 // AWS allows to delete maximum 1000 objects in one call
 #define MAX_OBJS_ALLOWED_TO_DELETE 1000
 
+// Rough size of object metadata record, fetched records of a batch together
+// should fit in one Motr RPC message
+#define OBJECT_METADATA_SIZE_ESTIMATE 2048
+
+// Key of the probable delete record of the object data. Copies sharing data
+// with their source are keyed by their copy OID too.
+static std::string probable_delete_key(S3ObjectMetadata& obj) {
+  std::string key = obj.get_probable_delete_key();
+  // prepending a char depending on the size of the object (size based
+  // bucketing of object)
+  S3CommonUtilities::size_based_bucketing_of_objects(key,
+                                                     obj.get_content_length());
+  return key;
+}
+
 S3DeleteMultipleObjectsAction::S3DeleteMultipleObjectsAction(
     std::shared_ptr<S3RequestObject> req,
     std::shared_ptr<S3BucketMetadataFactory> bucket_md_factory,
@@ -39,6 +56,7 @@ S3DeleteMultipleObjectsAction::S3DeleteMultipleObjectsAction(
     std::shared_ptr<S3MotrKVSReaderFactory> kvs_reader_factory,
     std::shared_ptr<S3MotrKVSWriterFactory> kvs_writer_factory)
     : S3BucketAction(std::move(req), std::move(bucket_md_factory), false),
+      batches_in_flight(0),
       delete_index_in_req(0),
       at_least_one_delete_successful(false) {
   s3_log(S3_LOG_DEBUG, request_id, "%s Ctor\n", __func__);
@@ -71,10 +89,10 @@ S3DeleteMultipleObjectsAction::S3DeleteMultipleObjectsAction(
     motr_kvs_writer_factory = std::make_shared<S3MotrKVSWriterFactory>();
   }
 
-  std::shared_ptr<MotrAPI> s3_motr_api = std::make_shared<ConcreteMotrAPI>();
+  delete_objects_window =
+      std::max(1u, S3Option::get_instance()->get_delete_objects_window());
 
-  motr_kv_reader =
-      motr_kvs_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
+  s3_motr_api = std::make_shared<ConcreteMotrAPI>();
 
   motr_kv_writer =
       motr_kvs_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
@@ -89,7 +107,7 @@ void S3DeleteMultipleObjectsAction::setup_steps() {
   s3_log(S3_LOG_DEBUG, request_id, "Setting up the action\n");
   ACTION_TASK_ADD(S3DeleteMultipleObjectsAction::validate_request, this);
   ACTION_TASK_ADD(S3DeleteMultipleObjectsAction::fetch_objects_info, this);
-  // Delete will be cycling between delete_objects_metadata and delete_objects
+  // Batches of keys are fetched and deleted till all keys are processed
   ACTION_TASK_ADD(S3DeleteMultipleObjectsAction::send_response_to_s3_client,
                   this);
   // ...
@@ -173,60 +191,116 @@ void S3DeleteMultipleObjectsAction::fetch_objects_info() {
   object_list_index_layout = bucket_metadata->get_object_list_index_layout();
 
   if (zero(object_list_index_layout.oid)) {
-    for (const auto& key : keys_to_delete) {
+    // Empty bucket, there is nothing to delete
+    for (const auto& key :
+         delete_request.get_keys(0, delete_request.get_count())) {
       delete_objects_response.add_success(key);
     }
     send_response_to_s3_client();
   } else {
-    if (delete_index_in_req < delete_request.get_count()) {
-      keys_to_delete.clear();
-      keys_to_delete = delete_request.get_keys(
-          delete_index_in_req,
-          S3Option::get_instance()->get_motr_idx_fetch_count());
-      if (s3_fi_is_enabled("fail_fetch_objects_info")) {
-        s3_fi_enable_once("motr_kv_get_fail");
-      }
-      motr_kv_reader->get_keyval(
-          object_list_index_layout, keys_to_delete,
-          std::bind(
-              &S3DeleteMultipleObjectsAction::fetch_objects_info_successful,
-              this),
-          std::bind(&S3DeleteMultipleObjectsAction::fetch_objects_info_failed,
-                    this));
-      delete_index_in_req += keys_to_delete.size();
+    launch_batches();
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+std::vector<std::string> S3DeleteMultipleObjectsAction::get_next_batch_keys() {
+  S3Option* option_instance = S3Option::get_instance();
+  const size_t max_count = option_instance->get_motr_idx_fetch_count();
+  const size_t max_size = option_instance->get_motr_max_rpc_msg_size();
+
+  std::vector<std::string> keys =
+      delete_request.get_keys(delete_index_in_req, max_count);
+  size_t batch_size = 0;
+  size_t count = 0;
+
+  for (; count < keys.size(); ++count) {
+    batch_size += keys[count].length() + OBJECT_METADATA_SIZE_ESTIMATE;
+    if (count > 0 && batch_size > max_size) {
+      break;
     }
   }
+  keys.resize(count);
+  return keys;
+}
+
+void S3DeleteMultipleObjectsAction::launch_batches() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  while (!is_error_state() && batches_in_flight < delete_objects_window &&
+         delete_index_in_req < delete_request.get_count()) {
+    std::unique_ptr<DeleteBatch> batch(new DeleteBatch());
+
+    batch->keys = get_next_batch_keys();
+    batch->motr_kv_reader =
+        motr_kvs_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
+    batch->motr_kv_writer =
+        motr_kvs_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
+    delete_index_in_req += batch->keys.size();
+    ++batches_in_flight;
+
+    batches.push_back(std::move(batch));
+    fetch_batch_objects_info(batches.back().get());
+  }
+  if (batches_in_flight == 0) {
+    // All batches are done or the rest is cancelled by an error
+    if (!is_error_state() && !at_least_one_delete_successful &&
+        delete_objects_response.get_failure_count() > 0) {
+      set_s3_error("InternalError");
+    }
+    send_response_to_s3_client();
+  }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::fetch_objects_info_failed() {
+void S3DeleteMultipleObjectsAction::batch_done(DeleteBatch* batch) {
+  s3_log(S3_LOG_DEBUG, request_id, "Batch of %zu keys is done\n",
+         batch->keys.size());
+  batch->objects_metadata.clear();
+  --batches_in_flight;
+  launch_batches();
+}
+
+void S3DeleteMultipleObjectsAction::fetch_batch_objects_info(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
-  if (motr_kv_reader->get_state() == S3MotrKVSReaderOpState::missing) {
-    for (auto& key : keys_to_delete) {
+
+  if (s3_fi_is_enabled("fail_fetch_objects_info")) {
+    s3_fi_enable_once("motr_kv_get_fail");
+  }
+  batch->motr_kv_reader->get_keyval(
+      object_list_index_layout, batch->keys,
+      std::bind(&S3DeleteMultipleObjectsAction::fetch_objects_info_successful,
+                this, batch),
+      std::bind(&S3DeleteMultipleObjectsAction::fetch_objects_info_failed,
+                this, batch));
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3DeleteMultipleObjectsAction::fetch_objects_info_failed(
+    DeleteBatch* batch) {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  if (batch->motr_kv_reader->get_state() ==
+      S3MotrKVSReaderOpState::missing) {
+    for (auto& key : batch->keys) {
       delete_objects_response.add_success(key);
     }
-    if (delete_index_in_req < delete_request.get_count()) {
-      fetch_objects_info();
-    } else {
-      send_response_to_s3_client();
-    }
   } else {
     set_s3_error("InternalError");
-    send_response_to_s3_client();
   }
+  batch_done(batch);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::fetch_objects_info_successful() {
+void S3DeleteMultipleObjectsAction::fetch_objects_info_successful(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
   // Create a list of objects found to be deleted
 
-  const auto& kvps = motr_kv_reader->get_key_values();
-  objects_metadata.clear();
+  const auto& kvps = batch->motr_kv_reader->get_key_values();
+  batch->objects_metadata.clear();
 
   bool atleast_one_json_error = false;
-  bool all_had_json_error = true;
 
   for (const auto& kv : kvps) {
     if ((kv.second.first == 0) && (!kv.second.second.empty())) {
@@ -250,8 +324,7 @@ void S3DeleteMultipleObjectsAction::fetch_objects_info_successful() {
         delete_objects_response.add_failure(kv.first, "InternalError");
         object->mark_invalid();
       } else {
-        all_had_json_error = false;  // at least one good object to delete
-        objects_metadata.push_back(object);
+        batch->objects_metadata.push_back(object);
       }
     } else {
       s3_log(S3_LOG_DEBUG, request_id, "Object metadata missing for = %s\n",
@@ -264,30 +337,25 @@ void S3DeleteMultipleObjectsAction::fetch_objects_info_successful() {
     //     S3_IEM_METADATA_CORRUPTED_JSON);
     s3_log(S3_LOG_DEBUG, request_id, "metadata may be corrupted\n");
   }
-  if (all_had_json_error) {
-    // Fetch more if present, else just respond
-    if (delete_index_in_req < delete_request.get_count()) {
-      // Try to delete the remaining
-      fetch_objects_info();
-    } else {
-      if (!at_least_one_delete_successful) {
-        set_s3_error("InternalError");
-      }
-      send_response_to_s3_client();
-    }
+  if (batch->objects_metadata.empty()) {
+    // No good object to delete in this batch
+    batch_done(batch);
   } else {
-    add_object_oid_to_probable_dead_oid_list();
+    add_object_oid_to_probable_dead_oid_list(batch);
   }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::add_object_oid_to_probable_dead_oid_list() {
+void S3DeleteMultipleObjectsAction::add_object_oid_to_probable_dead_oid_list(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   std::map<std::string, std::string> delete_list;
 
-  for (const auto& obj : objects_metadata) {
-    if (obj->get_state() != S3ObjectMetadataState::invalid) {
-      std::string oid_str = S3M0Uint128Helper::to_string(obj->get_oid());
+  for (const auto& obj : batch->objects_metadata) {
+    // Data of inline objects goes away with their metadata
+    if (obj->get_state() != S3ObjectMetadataState::invalid &&
+        !obj->has_inline_data()) {
+      std::string oid_str = probable_delete_key(*obj);
       assert(!oid_str.empty());
       // Add error when any key is empty
       if (oid_str.empty()) {
@@ -295,11 +363,6 @@ void S3DeleteMultipleObjectsAction::add_object_oid_to_probable_dead_oid_list() {
                "Invalid object metadata with empty object OID\n");
       }
 
-      // prepending a char depending on the size of the object (size based
-      // bucketing of object)
-      S3CommonUtilities::size_based_bucketing_of_objects(
-          oid_str, obj->get_content_length());
-
       s3_log(S3_LOG_DEBUG, request_id,
              "Adding probable_del_rec with key [%s]\n", oid_str.c_str());
 
@@ -313,80 +376,94 @@ void S3DeleteMultipleObjectsAction::add_object_oid_to_probable_dead_oid_list() {
       delete_list[oid_str] = probable_oid_list[oid_str]->to_json();
     }
   }
-  motr_kv_writer->put_keyval(
+  if (delete_list.empty()) {
+    delete_objects_metadata(batch);
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
+  batch->motr_kv_writer->put_keyval(
       global_probable_dead_object_list_index_layout, delete_list,
-      std::bind(&S3DeleteMultipleObjectsAction::delete_objects_metadata, this),
+      std::bind(&S3DeleteMultipleObjectsAction::delete_objects_metadata, this,
+                batch),
       std::bind(&S3DeleteMultipleObjectsAction::
                      add_object_oid_to_probable_dead_oid_list_failed,
-                this));
+                this, batch));
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
 void S3DeleteMultipleObjectsAction::
-    add_object_oid_to_probable_dead_oid_list_failed() {
+    add_object_oid_to_probable_dead_oid_list_failed(DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
-  if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::failed_to_launch) {
+  if (batch->motr_kv_writer->get_state() ==
+      S3MotrKVSWriterOpState::failed_to_launch) {
     set_s3_error("ServiceUnavailable");
   } else {
     set_s3_error("InternalError");
   }
-  send_response_to_s3_client();
+  batch_done(batch);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::delete_objects_metadata() {
+void S3DeleteMultipleObjectsAction::delete_objects_metadata(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   std::vector<std::string> keys;
-  for (auto& obj : objects_metadata) {
+  for (auto& obj : batch->objects_metadata) {
     if (obj->get_state() != S3ObjectMetadataState::invalid) {
       keys.push_back(obj->get_object_name());
+      obj->invalidate_cached();
     }
   }
   if (s3_fi_is_enabled("fail_delete_objects_metadata")) {
     s3_fi_enable_once("motr_kv_delete_fail");
   }
-  motr_kv_writer->delete_keyval(
+  batch->motr_kv_writer->delete_keyval(
       object_list_index_layout, keys,
       std::bind(
           &S3DeleteMultipleObjectsAction::delete_objects_metadata_successful,
-          this),
+          this, batch),
       std::bind(&S3DeleteMultipleObjectsAction::delete_objects_metadata_failed,
-                this));
+                this, batch));
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::delete_objects_metadata_successful() {
+void S3DeleteMultipleObjectsAction::delete_objects_metadata_successful(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   at_least_one_delete_successful = true;
-  for (auto& obj : objects_metadata) {
+  for (auto& obj : batch->objects_metadata) {
+    obj->invalidate_cached();
     delete_objects_response.add_success(obj->get_object_name());
+    if (obj->has_inline_data()) {
+      continue;
+    }
     oids_to_delete.push_back(obj->get_oid());
+    probable_keys_to_delete.push_back(probable_delete_key(*obj));
     layout_id_for_objs_to_delete.push_back(obj->get_layout_id());
     pv_ids_to_delete.push_back(obj->get_pvid());
   }
-
-  if (delete_index_in_req < delete_request.get_count()) {
-    // Try to fetch the remaining
-    fetch_objects_info();
-  } else {
-    send_response_to_s3_client();
-  }
+  batch_done(batch);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3DeleteMultipleObjectsAction::delete_objects_metadata_failed() {
+void S3DeleteMultipleObjectsAction::delete_objects_metadata_failed(
+    DeleteBatch* batch) {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  for (auto& obj : batch->objects_metadata) {
+    obj->invalidate_cached();
+  }
 
-  if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::failed_to_launch) {
+  if (batch->motr_kv_writer->get_state() ==
+      S3MotrKVSWriterOpState::failed_to_launch) {
     s3_log(
         S3_LOG_DEBUG, request_id,
         "Object metadata delete operation failed due to pre launch failure\n");
     set_s3_error("ServiceUnavailable");
-    send_response_to_s3_client();
   } else {
     uint obj_index = 0;
-    for (auto& obj : objects_metadata) {
-      if (motr_kv_writer->get_op_ret_code_for_del_kv(obj_index) == -ENOENT) {
+    for (auto& obj : batch->objects_metadata) {
+      if (batch->motr_kv_writer->get_op_ret_code_for_del_kv(obj_index) ==
+          -ENOENT) {
         at_least_one_delete_successful = true;
         delete_objects_response.add_success(obj->get_object_name());
       } else {
@@ -395,16 +472,8 @@ void S3DeleteMultipleObjectsAction::delete_objects_metadata_failed() {
       }
       ++obj_index;
     }
-    if (delete_index_in_req < delete_request.get_count()) {
-      // Try to fetch the remaining
-      fetch_objects_info();
-    } else {
-      if (!at_least_one_delete_successful) {
-        set_s3_error("InternalError");
-      }
-      send_response_to_s3_client();
-    }
   }
+  batch_done(batch);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -477,15 +546,14 @@ void S3DeleteMultipleObjectsAction::cleanup_failed() {
     // map to retain all the object oids entries in probable list index id
     probable_oid_list.clear();
   } else {
-    uint obj_index = 0;
-    for (auto& oid : oids_to_delete) {
+    for (size_t obj_index = 0; obj_index < oids_to_delete.size();
+         ++obj_index) {
       if (motr_writer->get_op_ret_code_for_delete_op(obj_index) != -ENOENT) {
         // object oid failed to delete, so erase the object oid from
         // probable_oid_list map and so that this object oid will be retained in
         // global_probable_dead_object_list_index_layout
-        probable_oid_list.erase(S3M0Uint128Helper::to_string(oid));
+        probable_oid_list.erase(probable_keys_to_delete[obj_index]);
       }
-      ++obj_index;
     }
   }
   cleanup_oid_from_probable_dead_oid_list();
@@ -26,6 +26,7 @@
 #include <gtest/gtest_prod.h>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "s3_bucket_action_base.h"
 #include "s3_motr_kvs_reader.h"
@@ -39,10 +40,25 @@
 #include "s3_probable_delete_record.h"
 
 class S3DeleteMultipleObjectsAction : public S3BucketAction {
-  std::vector<std::shared_ptr<S3ObjectMetadata>> objects_metadata;
+  // Keys of the request are processed in batches. Each batch is fetched,
+  // added to the probable delete list and removed from the object list with
+  // one Motr KVS operation per step. Up to S3_DELETE_OBJECTS_WINDOW batches
+  // are in flight at a time.
+  struct DeleteBatch {
+    std::vector<std::string> keys;
+    std::vector<std::shared_ptr<S3ObjectMetadata>> objects_metadata;
+    std::shared_ptr<S3MotrKVSReader> motr_kv_reader;
+    std::shared_ptr<S3MotrKVSWriter> motr_kv_writer;
+  };
+  // Batches stay allocated till the action ends, as their readers and
+  // writers may still be on the stack when the batch completes
+  std::vector<std::unique_ptr<DeleteBatch>> batches;
+  size_t batches_in_flight;
+  size_t delete_objects_window;
+
   std::shared_ptr<S3MotrWiter> motr_writer;
-  std::shared_ptr<S3MotrKVSReader> motr_kv_reader;
   std::shared_ptr<S3MotrKVSWriter> motr_kv_writer;
+  std::shared_ptr<MotrAPI> s3_motr_api;
 
   std::shared_ptr<S3ObjectMetadataFactory> object_metadata_factory;
   std::shared_ptr<S3MotrWriterFactory> motr_writer_factory;
@@ -54,9 +70,10 @@ class S3DeleteMultipleObjectsAction : public S3BucketAction {
   S3DeleteMultipleObjectsBody delete_request;
   int delete_index_in_req;
   std::vector<struct m0_uint128> oids_to_delete;
+  // probable_oid_list keys of oids_to_delete
+  std::vector<std::string> probable_keys_to_delete;
   std::vector<int> layout_id_for_objs_to_delete;
   std::vector<struct m0_fid> pv_ids_to_delete;
-  std::vector<std::string> keys_to_delete;
   bool at_least_one_delete_successful;
 
   S3DeleteMultipleObjectsResponseBody delete_objects_response;
@@ -68,6 +85,12 @@ class S3DeleteMultipleObjectsAction : public S3BucketAction {
     return "BUCKET/" + request->get_bucket_name();
   }
 
+  // Next keys of the request, bounded by S3_MOTR_MAX_IDX_FETCH_COUNT and by
+  // what fits in one Motr RPC message
+  std::vector<std::string> get_next_batch_keys();
+  void launch_batches();
+  void batch_done(DeleteBatch* batch);
+
  public:
   S3DeleteMultipleObjectsAction(
       std::shared_ptr<S3RequestObject> req,
@@ -87,15 +110,16 @@ class S3DeleteMultipleObjectsAction : public S3BucketAction {
 
   void fetch_bucket_info_failed();
   void fetch_objects_info();
-  void fetch_objects_info_successful();
-  void fetch_objects_info_failed();
+  void fetch_batch_objects_info(DeleteBatch* batch);
+  void fetch_objects_info_successful(DeleteBatch* batch);
+  void fetch_objects_info_failed(DeleteBatch* batch);
 
-  void delete_objects_metadata();
-  void delete_objects_metadata_successful();
-  void delete_objects_metadata_failed();
+  void delete_objects_metadata(DeleteBatch* batch);
+  void delete_objects_metadata_successful(DeleteBatch* batch);
+  void delete_objects_metadata_failed(DeleteBatch* batch);
 
-  void add_object_oid_to_probable_dead_oid_list();
-  void add_object_oid_to_probable_dead_oid_list_failed();
+  void add_object_oid_to_probable_dead_oid_list(DeleteBatch* batch);
+  void add_object_oid_to_probable_dead_oid_list_failed(DeleteBatch* batch);
 
   void cleanup();
   void cleanup_oid_from_probable_dead_oid_list();
@@ -104,6 +128,7 @@ class S3DeleteMultipleObjectsAction : public S3BucketAction {
 
   void send_response_to_s3_client();
 
+  friend class S3DeleteMultipleObjectsActionTest;
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest, ConstructorTest);
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest,
               ValidateOnAllDataShouldCallNext4ValidData);
@@ -123,7 +148,11 @@ class S3DeleteMultipleObjectsAction : public S3BucketAction {
               FetchObjectInfoWhenBucketPresentAndObjIndexAbsent);
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest,
               FetchObjectInfoWhenBucketAndObjIndexPresent);
+  FRIEND_TEST(S3DeleteMultipleObjectsActionTest, FetchObjectInfoLaunchesWindow);
+  FRIEND_TEST(S3DeleteMultipleObjectsActionTest, BatchKeysFitInRpcMessage);
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest, FetchObjectInfoFailed);
+  FRIEND_TEST(S3DeleteMultipleObjectsActionTest,
+              FailedBatchWaitsForBatchesInFlight);
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest,
               FetchObjectInfoFailedWithMissingAndMoreToProcess);
   FRIEND_TEST(S3DeleteMultipleObjectsActionTest,
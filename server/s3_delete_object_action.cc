@@ -121,8 +121,15 @@ void S3DeleteObjectAction::fetch_object_info_failed() {
 
 void S3DeleteObjectAction::add_object_oid_to_probable_dead_oid_list() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  if (object_metadata->has_inline_data()) {
+    // Data goes away with the metadata
+    next();
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
 
-  oid_str = S3M0Uint128Helper::to_string(object_metadata->get_oid());
+  // Copies sharing data with their source are keyed by their copy OID too
+  oid_str = object_metadata->get_probable_delete_key();
   if (!motr_kv_writer) {
     motr_kv_writer =
         mote_kv_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
@@ -217,7 +224,8 @@ void S3DeleteObjectAction::startcleanup() {
 
   if (s3_del_obj_action_state == S3DeleteObjectActionState::validationFailed ||
       s3_del_obj_action_state ==
-          S3DeleteObjectActionState::probableEntryRecordFailed) {
+          S3DeleteObjectActionState::probableEntryRecordFailed ||
+      object_metadata->has_inline_data()) {
     // Nothing to clean up
     done();
   } else {
@@ -18,13 +18,26 @@
  *
  */
 
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
 #include "s3_evbuffer_wrapper.h"
+#include "s3_mem_pool_manager.h"
 #include "s3_motr_context.h"
 #include "s3_option.h"
 
+// evbuffer cleanup callback for chains referencing motr read mempool buffers,
+// unit size of the buffer is passed in extra.
+static void release_mempool_buffer(const void* data, size_t datalen,
+                                   void* extra) {
+  S3MempoolManager::get_instance()->release_buffer_for_unit_size(
+      const_cast<void*>(data), (size_t)(uintptr_t)extra);
+}
+
 // Create evbuffer of size buf_sz, with each basic buffer buf_unit_sz
 S3Evbuffer::S3Evbuffer(const std::string req_id, size_t buf_sz,
-                       int buf_unit_sz) {
+                       int buf_unit_sz, bool use_mempool_bufs) {
   p_evbuf = evbuffer_new();
   assert(p_evbuf);
   assert(buf_unit_sz);
@@ -34,6 +47,10 @@ S3Evbuffer::S3Evbuffer(const std::string req_id, size_t buf_sz,
   buffer_unit_sz = buf_unit_sz;
   request_id = req_id;
   vec = nullptr;
+  use_mempool_buffers = use_mempool_bufs;
+  data_offset = 0;
+  data_length = 0;
+  bytes_copied = 0;
 }
 
 int S3Evbuffer::init() {
@@ -42,6 +59,13 @@ int S3Evbuffer::init() {
     s3_log(S3_LOG_ERROR, request_id, "memory allocation failure\n");
     return -ENOMEM;
   }
+  if (use_mempool_buffers) {
+    if (init_mempool_buffers() == 0) {
+      return 0;
+    }
+    // Pool exhausted, fall back to evbuffer's own memory
+    use_mempool_buffers = false;
+  }
   for (size_t i = 0; i < nvecs; i++) {
     // Reserve buf_sz bytes memory
     int no_of_extends =
@@ -91,6 +115,42 @@ int S3Evbuffer::init() {
   return 0;
 }
 
+int S3Evbuffer::init_mempool_buffers() {
+  S3MempoolManager* mempool_manager = S3MempoolManager::get_instance();
+  if (mempool_manager == nullptr) {
+    return -ENOMEM;
+  }
+  for (size_t i = 0; i < nvecs; i++) {
+    vec[i].iov_base = mempool_manager->get_buffer_for_unit_size(buffer_unit_sz);
+    if (vec[i].iov_base == nullptr) {
+      s3_log(S3_LOG_WARN, request_id,
+             "Motr read mempool has no buffer of size %zu, i = %zu "
+             "nvecs = %zu\n",
+             buffer_unit_sz, i, nvecs);
+      release_mempool_buffers();
+      return -ENOMEM;
+    }
+    vec[i].iov_len = buffer_unit_sz;
+  }
+  data_offset = 0;
+  data_length = nvecs * buffer_unit_sz;
+  return 0;
+}
+
+// Returns mempool buffers not handed to p_evbuf
+void S3Evbuffer::release_mempool_buffers() {
+  if (vec == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < nvecs; i++) {
+    if (vec[i].iov_base != nullptr) {
+      S3MempoolManager::get_instance()->release_buffer_for_unit_size(
+          vec[i].iov_base, buffer_unit_sz);
+      vec[i].iov_base = nullptr;
+    }
+  }
+}
+
 // Setup pointers in motr structs so that buffers can be passed to motr.
 // No references will be help within object to any rw_ctx members.
 // Caller will be responsible not to free any pointers returned as these are
@@ -112,6 +172,35 @@ void S3Evbuffer::to_motr_read_buffers(struct s3_motr_rw_op_context* rw_ctx,
 // Releases ownership of evbuffer, caller needs to ensure evbuffer is freed
 // later point of time by owning a reference returned.
 struct evbuffer* S3Evbuffer::release_ownership() {
+  if (use_mempool_buffers && p_evbuf != nullptr) {
+    // Chain buffers holding [data_offset, data_offset + data_length)
+    const size_t data_end = data_offset + data_length;
+    size_t buf_start = 0;
+    for (size_t i = 0; i < nvecs; i++) {
+      void* buf = vec[i].iov_base;
+      size_t len = vec[i].iov_len;
+      vec[i].iov_base = nullptr;
+      if (buf_start < data_end &&
+          evbuffer_add_reference(p_evbuf, buf,
+                                 std::min(len, data_end - buf_start),
+                                 release_mempool_buffer,
+                                 (void*)(uintptr_t)buffer_unit_sz) == 0) {
+        buf_start += len;
+        continue;
+      }
+      if (buf_start < data_end) {
+        s3_log(S3_LOG_ERROR, request_id,
+               "evbuffer_add_reference failed, i = %zu nvecs = %zu\n", i,
+               nvecs);
+      }
+      S3MempoolManager::get_instance()->release_buffer_for_unit_size(
+          buf, buffer_unit_sz);
+      buf_start += len;
+    }
+    // Chains before data_offset are released to pool as they are drained
+    evbuffer_drain(p_evbuf, data_offset);
+    use_mempool_buffers = false;
+  }
   struct evbuffer* tmp = p_evbuf;
   p_evbuf = NULL;
   return tmp;
@@ -122,6 +211,14 @@ int S3Evbuffer::drain_data(size_t start_offset) {
   if (p_evbuf == NULL) {
     return -1;
   }
+  if (use_mempool_buffers) {
+    if (start_offset > data_length) {
+      return -1;
+    }
+    data_offset += start_offset;
+    data_length -= start_offset;
+    return 0;
+  }
   rc = evbuffer_drain(p_evbuf, start_offset);
   if (rc != 0) {
     s3_log(S3_LOG_ERROR, request_id,
@@ -134,10 +231,34 @@ size_t S3Evbuffer::get_evbuff_length() {
   if (p_evbuf == nullptr) {
     return 0;
   }
+  if (use_mempool_buffers) {
+    return data_length;
+  }
   return evbuffer_get_length(p_evbuf);
 }
 
+// Keeps first length bytes only
 void S3Evbuffer::read_drain_data_from_buffer(size_t length) {
+  if (use_mempool_buffers) {
+    if (length < data_length) {
+      data_length = length;
+    }
+    return;
+  }
+  // Whole chains are moved, the tail of the last one gets copied
+  int n_chains = evbuffer_peek(p_evbuf, length, NULL, NULL, 0);
+  if (n_chains > 0) {
+    std::vector<struct evbuffer_iovec> chains(n_chains);
+    evbuffer_peek(p_evbuf, length, NULL, chains.data(), n_chains);
+    size_t left = length;
+    for (auto& chain : chains) {
+      if (chain.iov_len > left) {
+        bytes_copied += left;
+        break;
+      }
+      left -= chain.iov_len;
+    }
+  }
   struct evbuffer* new_evbuf_body = evbuffer_new();
   int moved_bytes = evbuffer_remove_buffer(p_evbuf, new_evbuf_body, length);
   evbuffer_free(p_evbuf);
@@ -38,6 +38,12 @@
 //  delete evbuf;
 //  ...
 //  evhtp_obj->http_send_reply_body(ev_req, evbuf);
+//
+// With use_mempool_buffers, motr reads into buffers of the motr read mempool
+// (S3MempoolManager) which are chained into evbuffer by reference in
+// release_ownership(), each one released back to the pool once libevent is
+// done with it. Drain/trim only move offsets, so no data is copied between
+// motr completion and the socket write.
 
 class S3Evbuffer {
   struct evbuffer *p_evbuf;
@@ -49,9 +55,22 @@ class S3Evbuffer {
   size_t buffer_unit_sz;
   std::string request_id;
 
+  // Buffers in vec are from motr read mempool, not yet in p_evbuf
+  bool use_mempool_buffers;
+  // Part of mempool buffers to hand out, see drain_data() and
+  // read_drain_data_from_buffer()
+  size_t data_offset;
+  size_t data_length;
+  // Bytes memcpy'ed so far while trimming data
+  size_t bytes_copied;
+
+  int init_mempool_buffers();
+  void release_mempool_buffers();
+
  public:
   // Create evbuffer of size buf_sz
-  S3Evbuffer(std::string request_id, size_t buf_sz, int buf_unit_sz = 16384);
+  S3Evbuffer(std::string request_id, size_t buf_sz, int buf_unit_sz = 16384,
+             bool use_mempool_buffers = false);
 
   int init();
   inline unsigned int const get_nvecs() { return nvecs; }
@@ -69,11 +88,18 @@ class S3Evbuffer {
   // later point of time by owning a reference returned.
   struct evbuffer *release_ownership();
 
+  bool is_using_mempool_buffers() const { return use_mempool_buffers; }
+  size_t get_bytes_copied() const { return bytes_copied; }
+
   ~S3Evbuffer() {
+    if (use_mempool_buffers) {
+      release_mempool_buffers();
+    }
     if (p_evbuf != nullptr) {
       evbuffer_free(p_evbuf);
       p_evbuf = NULL;
     }
+    free(vec);
   }
 };
 
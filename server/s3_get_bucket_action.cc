@@ -18,6 +18,7 @@
  *
  */
 
+#include <iterator>
 #include <string>
 
 #include "s3_error_codes.h"
@@ -217,6 +218,35 @@ void S3GetBucketAction::get_next_objects_successful() {
   }
   retry_count = 0;
   s3_log(S3_LOG_DEBUG, request_id, "Found Object listing\n");
+  const auto& kvps = motr_kv_reader->get_key_values();
+
+  // Statistics - Total keys visited/loaded
+  total_keys_visited += kvps.size();
+
+  list_keys(kvps);
+}
+
+// Keys of one common prefix may be followed by other keys in the same batch.
+// Instead of asking Motr for the keys after the skipped prefix, continue with
+// the rest of the batch, and fetch only when it is exhausted.
+void S3GetBucketAction::list_keys(const KeyValues& kvps) {
+  auto it = kvps.begin();
+
+  while (list_keys_from(kvps, it)) {
+    it = kvps.upper_bound(last_key);
+    if (it == kvps.end() && kvps.size() >= max_record_count) {
+      get_next_objects();
+      return;
+    }
+    // Short batch is the end of the index, empty tail then means no more keys
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Continue listing after [%s] with %zu fetched keys\n",
+           last_key.c_str(), (size_t)std::distance(it, kvps.end()));
+  }
+}
+
+bool S3GetBucketAction::list_keys_from(const KeyValues& kvps,
+                                       KeyValues::const_iterator from) {
   m0_uint128 object_list_index_oid =
       bucket_metadata->get_object_list_index_layout().oid;
   bool atleast_one_json_error = false;
@@ -224,8 +254,7 @@ void S3GetBucketAction::get_next_objects_successful() {
   bool skip_no_further_prefix_match = false;
   bool b_skip_remaining_common_prefixes = false;
   std::string last_common_prefix = "";
-  auto& kvps = motr_kv_reader->get_key_values();
-  size_t length = kvps.size();
+  size_t length = std::distance(from, kvps.end());
   if (b_state_start_check_any_more_keys) {
     // Check if this is the call to identify any more keys left
     // in bucket, after skipping keys belonging to same common prefix.
@@ -236,7 +265,7 @@ void S3GetBucketAction::get_next_objects_successful() {
       if (!request_prefix.empty()) {
         // If prefix is specified, we need to make sure that there exists
         // atleast one key with same prefix. If no, it indicates no keys.
-        const std::string& firt_key = kvps.begin()->first;
+        const std::string& firt_key = from->first;
         if (firt_key.find(request_prefix) == std::string::npos) {
           // There exists no key matching the prefix. Set 'length' 0
           length = 0;
@@ -258,15 +287,11 @@ void S3GetBucketAction::get_next_objects_successful() {
     fetch_successful = true;
     object_list->set_key_count(key_Count);
     send_response_to_s3_client();
-    return;
+    return false;
   }
 
-  // Statistics - Total keys visited/loaded
-  if (!kvps.empty()) {
-    total_keys_visited += length;
-  }
-
-  for (auto& kv : kvps) {
+  for (auto it = from; it != kvps.end(); ++it) {
+    const auto& kv = *it;
     s3_log(S3_LOG_DEBUG, request_id, "Read Object = %s\n", kv.first.c_str());
     s3_log(S3_LOG_DEBUG, request_id, "Read Object Value = %s\n",
            kv.second.second.c_str());
@@ -327,7 +352,7 @@ void S3GetBucketAction::get_next_objects_successful() {
     auto object = object_metadata_factory->create_object_metadata_obj(request);
     size_t delimiter_pos = std::string::npos;
     if (request_prefix.empty() && request_delimiter.empty()) {
-      if (object->from_json(kv.second.second) != 0) {
+      if (object->from_json_for_listing(kv.second.second) != 0) {
         atleast_one_json_error = true;
         s3_log(S3_LOG_ERROR, request_id,
                "Json Parsing failed. Index oid = "
@@ -340,7 +365,7 @@ void S3GetBucketAction::get_next_objects_successful() {
     } else if (!request_prefix.empty() && request_delimiter.empty()) {
       // Filter out by prefix
       if (kv.first.find(request_prefix) == 0) {
-        if (object->from_json(kv.second.second) != 0) {
+        if (object->from_json_for_listing(kv.second.second) != 0) {
           atleast_one_json_error = true;
           s3_log(S3_LOG_ERROR, request_id,
                  "Json Parsing failed. Index oid = "
@@ -367,7 +392,7 @@ void S3GetBucketAction::get_next_objects_successful() {
     } else if (request_prefix.empty() && !request_delimiter.empty()) {
       delimiter_pos = kv.first.find(request_delimiter);
       if (delimiter_pos == std::string::npos) {
-        if (object->from_json(kv.second.second) != 0) {
+        if (object->from_json_for_listing(kv.second.second) != 0) {
           atleast_one_json_error = true;
           s3_log(S3_LOG_ERROR, request_id,
                  "Json Parsing failed. Index oid = "
@@ -421,7 +446,7 @@ void S3GetBucketAction::get_next_objects_successful() {
         delimiter_pos =
             kv.first.find(request_delimiter, request_prefix.length());
         if (delimiter_pos == std::string::npos) {
-          if (object->from_json(kv.second.second) != 0) {
+          if (object->from_json_for_listing(kv.second.second) != 0) {
             atleast_one_json_error = true;
             s3_log(S3_LOG_ERROR, request_id.c_str(),
                    "Json Parsing failed. Index oid = "
@@ -522,10 +547,9 @@ void S3GetBucketAction::get_next_objects_successful() {
         if (last_key_in_common_prefix) {
           saved_last_key = last_common_prefix;
         }
-        // Call get_next_objects to see remaining keys, if any, after skipping
-        // keys belonging to common prefix.
-        get_next_objects();
-        return;
+        // See remaining keys, if any, after skipping keys belonging to
+        // common prefix.
+        return true;
       } else {
         object_list->set_response_is_truncated(true);
         // Before sending response, check if the previous key was in common
@@ -543,9 +567,9 @@ void S3GetBucketAction::get_next_objects_successful() {
     fetch_successful = true;
     object_list->set_key_count(key_Count);
     send_response_to_s3_client();
-  } else {
-    get_next_objects();
+    return false;
   }
+  return true;
 }
 
 void S3GetBucketAction::get_next_objects_failed() {
@@ -618,19 +642,20 @@ void S3GetBucketAction::send_response_to_s3_client() {
     }
     request->send_response(error.get_http_status_code(), response_xml);
   } else if (fetch_successful) {
-    std::string& response_xml = object_list->get_xml(
-        request->get_canonical_id(), bucket_metadata->get_owner_id(),
-        request->get_user_id());
+    S3XmlWriter xml_writer;
+    object_list->write_xml(xml_writer, request->get_canonical_id(),
+                           bucket_metadata->get_owner_id(),
+                           request->get_user_id());
     request->set_out_header_value("Content-Length",
-                                  std::to_string(response_xml.length()));
-    request->set_bytes_sent(response_xml.length());
+                                  std::to_string(xml_writer.length()));
+    request->set_bytes_sent(xml_writer.length());
     request->set_out_header_value("Content-Type", "application/xml");
-    s3_log(S3_LOG_DEBUG, request_id, "Object list response_xml = %s\n",
-           response_xml.c_str());
+    s3_log(S3_LOG_DEBUG, request_id, "Object list response_xml length = %zu\n",
+           xml_writer.length());
     // Total visited/touched keys in the bucket
     s3_log(S3_LOG_INFO, stripped_request_id, "Total keys visited = %zu\n",
            total_keys_visited);
-    request->send_response(S3HttpSuccess200, response_xml);
+    request->send_response_buffer(S3HttpSuccess200, xml_writer.get_buffer());
   } else {
     S3Error error("InternalError", request->get_request_id(),
                   request->get_bucket_name());
@@ -23,6 +23,7 @@
 #ifndef __S3_SERVER_S3_GET_BUCKET_ACTION_H__
 #define __S3_SERVER_S3_GET_BUCKET_ACTION_H__
 
+#include <map>
 #include <memory>
 
 #include "s3_bucket_action_base.h"
@@ -42,6 +43,12 @@ class S3GetBucketAction : public S3BucketAction {
   bool b_state_start_check_any_more_keys;
   std::string saved_last_key;
 
+  using KeyValues = std::map<std::string, std::pair<int, std::string>>;
+
+  void list_keys(const KeyValues& kvps);
+  // Returns true if listing has to go on with the keys after last_key
+  bool list_keys_from(const KeyValues& kvps, KeyValues::const_iterator from);
+
  protected:
   std::shared_ptr<S3ObjectListResponse> object_list;
   std::string last_key;  // last key during each iteration
@@ -118,6 +125,10 @@ class S3GetBucketAction : public S3BucketAction {
   FRIEND_TEST(S3GetBucketActionTest,
               GetNextObjectsSuccessfulPrefixDelimMultiComponentKey);
   FRIEND_TEST(S3GetBucketActionTest, GetNextObjectsSuccessfulDelimiterLastKey);
+  FRIEND_TEST(S3GetBucketActionTest,
+              GetNextObjectsSuccessfulDelimiterSkipsWithinBatch);
+  FRIEND_TEST(S3GetBucketActionTest,
+              GetNextObjectsSuccessfulDelimiterFetchesAfterFullBatch);
 };
 
 #endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include "s3_error_codes.h"
+#include "s3_get_latency_histograms_action.h"
+#include "s3_latency_histograms.h"
+#include "s3_log.h"
+
+S3GetLatencyHistogramsAction::S3GetLatencyHistogramsAction(
+    std::shared_ptr<S3RequestObject> req)
+    : S3Action(std::move(req), true, nullptr, true, true) {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Ctor\n", __func__);
+
+  setup_steps();
+}
+
+void S3GetLatencyHistogramsAction::setup_steps() {
+  ACTION_TASK_ADD(S3GetLatencyHistogramsAction::send_response_to_s3_client,
+                  this);
+}
+
+void S3GetLatencyHistogramsAction::send_response_to_s3_client() {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Entry\n", __func__);
+
+  std::string response_json = S3LatencyHistograms::to_json();
+
+  request->set_out_header_value("Content-Type", "application/json");
+  request->set_out_header_value("Content-Length",
+                                std::to_string(response_json.length()));
+  request->send_response(S3HttpSuccess200, response_json);
+
+  done();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
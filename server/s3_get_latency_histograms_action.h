@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_GET_LATENCY_HISTOGRAMS_ACTION_H__
+#define __S3_SERVER_S3_GET_LATENCY_HISTOGRAMS_ACTION_H__
+
+#include "s3_action_base.h"
+
+// GET /s3/latency-histograms on the management API, responds with
+// S3LatencyHistograms::to_json()
+class S3GetLatencyHistogramsAction : public S3Action {
+ public:
+  S3GetLatencyHistogramsAction(std::shared_ptr<S3RequestObject> req);
+
+  void setup_steps();
+  void send_response_to_s3_client();
+};
+
+#endif  // __S3_SERVER_S3_GET_LATENCY_HISTOGRAMS_ACTION_H__
@@ -373,16 +373,17 @@ void S3GetMultipartPartAction::send_response_to_s3_client() {
     multipart_part_list.set_account_id(request->get_account_id());
     multipart_part_list.set_account_name(request->get_account_name());
 
-    std::string& response_xml = multipart_part_list.get_multipart_xml();
+    S3XmlWriter xml_writer;
+    multipart_part_list.write_multipart_xml(xml_writer);
 
     request->set_out_header_value("Content-Length",
-                                  std::to_string(response_xml.length()));
+                                  std::to_string(xml_writer.length()));
     request->set_out_header_value("Content-Type", "application/xml");
-    request->set_bytes_sent(response_xml.length());
-    s3_log(S3_LOG_DEBUG, request_id, "Object list response_xml = %s\n",
-           response_xml.c_str());
+    request->set_bytes_sent(xml_writer.length());
+    s3_log(S3_LOG_DEBUG, request_id, "Object list response_xml length = %zu\n",
+           xml_writer.length());
 
-    request->send_response(S3HttpSuccess200, response_xml);
+    request->send_response_buffer(S3HttpSuccess200, xml_writer.get_buffer());
   } else {
     S3Error error("InternalError", request->get_request_id(), bucket_name);
     std::string& response_xml = error.to_xml();
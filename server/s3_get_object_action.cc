@@ -43,6 +43,9 @@ S3GetObjectAction::S3GetObjectAction(
       first_byte_offset_to_read(0),
       last_byte_offset_to_read(0),
       total_blocks_to_read(0),
+      blocks_to_read(0),
+      blocks_launched(0),
+      read_ahead_depth(1),
       read_object_reply_started(false) {
   s3_log(S3_LOG_DEBUG, request_id, "%s Ctor\n", __func__);
 
@@ -56,6 +59,10 @@ S3GetObjectAction::S3GetObjectAction(
   } else {
     motr_reader_factory = std::make_shared<S3MotrReaderFactory>();
   }
+  motr_read_window = S3Option::get_instance()->get_motr_read_window();
+  if (motr_read_window == 0) {
+    motr_read_window = 1;
+  }
 
   setup_steps();
 }
@@ -319,6 +326,10 @@ void S3GetObjectAction::check_full_or_range_object_read() {
 
 void S3GetObjectAction::read_object() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  if (object_metadata->has_inline_data()) {
+    send_inline_data_to_client();
+    return;
+  }
   // get total number of blocks to read from an object
   set_total_blocks_to_read_from_object();
   motr_reader = motr_reader_factory->create_motr_reader(
@@ -365,7 +376,10 @@ void S3GetObjectAction::check_outbuffer_and_mempool_stats(bool& bcontinue) {
   if ((len_response_buffer >=
        (motr_read_payload_size *
         S3Option::get_instance()->get_write_buffer_multiple())) ||
-      (!S3MemoryProfile().free_memory_in_pool_above_threshold_limits())) {
+      (!S3MemoryProfile().free_memory_in_pool_above_threshold_limits()) ||
+      (S3Option::get_instance()->is_motr_read_zero_copy() &&
+       !S3MemoryProfile().free_memory_in_motr_read_pool_for_get_obj(
+           motr_read_payload_size))) {
     bcontinue = false;
     s3_log(
         S3_LOG_WARN, stripped_request_id,
@@ -387,9 +401,13 @@ void S3GetObjectAction::read_object_data() {
   // S3Option::get_instance()->get_write_buffer_multiple()
   // threshold2 :=
   // S3MemoryProfile().free_memory_in_pool_above_threshold_limits()
+  // With zero copy, sent data pins motr read pool buffers until libevent
+  // writes it out, so that pool must also have room for the next read.
   bool bcontinue = true;
   check_outbuffer_and_mempool_stats(bcontinue);
   if (!bcontinue) {
+    // Client or memory can not keep up, restart read ahead from scratch
+    read_ahead_depth = 1;
     int throttle_for_millisecs =
         S3Option::get_instance()->get_s3_req_throttle_time();
     // Throttle S3 Get API by adding delay using timer event
@@ -417,6 +435,22 @@ void S3GetObjectAction::read_object_data() {
          blocks_already_read);
   s3_log(S3_LOG_DEBUG, request_id, "total_blocks_to_read: (%zu)\n",
          total_blocks_to_read);
+  if (!read_ahead_blocks.empty()) {
+    // Already launched, keep the window full before taking it
+    blocks_to_read = read_ahead_blocks.front();
+    read_ahead_blocks.pop_front();
+    s3_log(S3_LOG_DEBUG, request_id, "blocks_to_read from read ahead: (%zu)\n",
+           blocks_to_read);
+    read_ahead();
+    // Completed read ahead is reported right away and may finish the
+    // request, so nothing must follow this call.
+    motr_reader->read_object_data(
+        blocks_to_read,
+        std::bind(&S3GetObjectAction::send_data_to_client, this),
+        std::bind(&S3GetObjectAction::read_object_data_failed, this));
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
   if (blocks_already_read != total_blocks_to_read) {
     if (blocks_already_read == 0 &&
         get_requested_content_length() >
@@ -450,6 +484,9 @@ void S3GetObjectAction::read_object_data() {
           set_s3_error("InternalError");
         }
         send_response_to_s3_client();
+      } else {
+        blocks_launched += blocks_to_read;
+        read_ahead();
       }
     } else {
       send_response_to_s3_client();
@@ -461,6 +498,89 @@ void S3GetObjectAction::read_object_data() {
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+// Launches reads of the following blocks while the current one is in
+// flight or being sent, up to read_ahead_depth reads in total. The depth
+// grows by one read per call up to S3_MOTR_READ_WINDOW.
+void S3GetObjectAction::read_ahead() {
+  size_t max_blocks_in_one_read_op =
+      S3Option::get_instance()->get_motr_units_per_request();
+
+  while (read_ahead_blocks.size() + 1 < read_ahead_depth &&
+         blocks_launched < total_blocks_to_read) {
+    bool bcontinue = true;
+    check_outbuffer_and_mempool_stats(bcontinue);
+    if (!bcontinue) {
+      read_ahead_depth = 1;
+      break;
+    }
+    size_t blocks = std::min(max_blocks_in_one_read_op,
+                             total_blocks_to_read - blocks_launched);
+    if (!motr_reader->read_ahead_object_data(blocks)) {
+      break;
+    }
+    s3_log(S3_LOG_DEBUG, request_id, "Read ahead of %zu blocks launched\n",
+           blocks);
+    read_ahead_blocks.push_back(blocks);
+    blocks_launched += blocks;
+  }
+  if (read_ahead_depth < motr_read_window) {
+    ++read_ahead_depth;
+  }
+}
+
+void S3GetObjectAction::start_reply() {
+  // AWS add explicit quotes "" to etag values.
+  // https://docs.aws.amazon.com/AmazonS3/latest/API/API_GetObject.html
+  std::string e_tag = "\"" + object_metadata->get_md5() + "\"";
+
+  request->set_out_header_value("Last-Modified",
+                                object_metadata->get_last_modified_gmt());
+  request->set_out_header_value("Content-Type",
+                                object_metadata->get_content_type());
+  request->set_out_header_value("ETag", e_tag);
+  s3_log(S3_LOG_INFO, stripped_request_id, "e_tag= %s", e_tag.c_str());
+  request->set_out_header_value("Accept-Ranges", "bytes");
+  request->set_out_header_value(
+      "Content-Length", std::to_string(get_requested_content_length()));
+  for (auto it : object_metadata->get_user_attributes()) {
+    request->set_out_header_value(it.first, it.second);
+  }
+  if (!request->get_header_value("Range").empty()) {
+    std::ostringstream content_range_stream;
+    content_range_stream << "bytes " << first_byte_offset_to_read << "-"
+                         << last_byte_offset_to_read << "/" << content_length;
+    request->set_out_header_value("Content-Range", content_range_stream.str());
+    // Partial Content
+    request->send_reply_start(S3HttpSuccess206);
+  } else {
+    request->send_reply_start(S3HttpSuccess200);
+  }
+  read_object_reply_started = true;
+}
+
+// Data is in the metadata record, nothing to read from Motr
+void S3GetObjectAction::send_inline_data_to_client() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  const std::string& data = object_metadata->get_inline_data();
+  const size_t length = get_requested_content_length();
+
+  if (data.length() != content_length) {
+    s3_log(S3_LOG_ERROR, request_id,
+           "Inline data of %zu bytes, object size is %zu\n", data.length(),
+           content_length);
+    set_s3_error("InternalError");
+    send_response_to_s3_client();
+    return;
+  }
+  start_reply();
+  request->send_reply_body(data.data() + first_byte_offset_to_read, length);
+  data_sent_to_client = length;
+  s3_perf_count_outcoming_bytes(length);
+
+  send_response_to_s3_client();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
 void S3GetObjectAction::send_data_to_client() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   s3_stats_inc("read_object_data_success_count");
@@ -471,35 +591,7 @@ void S3GetObjectAction::send_data_to_client() {
   }
   if (!read_object_reply_started) {
     s3_timer.start();
-
-    // AWS add explicit quotes "" to etag values.
-    // https://docs.aws.amazon.com/AmazonS3/latest/API/API_GetObject.html
-    std::string e_tag = "\"" + object_metadata->get_md5() + "\"";
-
-    request->set_out_header_value("Last-Modified",
-                                  object_metadata->get_last_modified_gmt());
-    request->set_out_header_value("Content-Type",
-                                  object_metadata->get_content_type());
-    request->set_out_header_value("ETag", e_tag);
-    s3_log(S3_LOG_INFO, stripped_request_id, "e_tag= %s", e_tag.c_str());
-    request->set_out_header_value("Accept-Ranges", "bytes");
-    request->set_out_header_value(
-        "Content-Length", std::to_string(get_requested_content_length()));
-    for (auto it : object_metadata->get_user_attributes()) {
-      request->set_out_header_value(it.first, it.second);
-    }
-    if (!request->get_header_value("Range").empty()) {
-      std::ostringstream content_range_stream;
-      content_range_stream << "bytes " << first_byte_offset_to_read << "-"
-                           << last_byte_offset_to_read << "/" << content_length;
-      request->set_out_header_value("Content-Range",
-                                    content_range_stream.str());
-      // Partial Content
-      request->send_reply_start(S3HttpSuccess206);
-    } else {
-      request->send_reply_start(S3HttpSuccess200);
-    }
-    read_object_reply_started = true;
+    start_reply();
   } else {
     s3_timer.resume();
   }
@@ -541,6 +633,9 @@ void S3GetObjectAction::send_data_to_client() {
     p_evbuffer->read_drain_data_from_buffer(length);
   }
   data_sent_to_client += p_evbuffer->get_evbuff_length();
+  size_t bytes_copied = p_evbuffer->get_bytes_copied();
+  s3_perf_count_get_object_data_bytes(
+      bytes_copied, p_evbuffer->get_evbuff_length() - bytes_copied);
   // Send data to client. evbuf_body will be free'ed internally
   s3_perf_count_outcoming_bytes(p_evbuffer->get_evbuff_length());
   request->send_reply_body(p_evbuffer->release_ownership());
@@ -592,6 +687,15 @@ void S3GetObjectAction::read_object_data_failed() {
 
 void S3GetObjectAction::send_response_to_s3_client() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  if (motr_reader && motr_reader->get_read_ahead_in_flight() > 0) {
+    // Motr still fills buffers of reads ahead, respond once it is done
+    s3_log(S3_LOG_DEBUG, request_id, "Waiting for %zu reads ahead\n",
+           motr_reader->get_read_ahead_in_flight());
+    read_ahead_blocks.clear();
+    motr_reader->discard_read_ahead(
+        std::bind(&S3GetObjectAction::send_response_to_s3_client, this));
+    return;
+  }
   s3_log(S3_LOG_DEBUG, request_id,
          "S3 request [%s] with total allocated mempool buffers = %zu\n",
          request_id.c_str(), request->get_mempool_buffer_count());
@@ -641,6 +745,7 @@ void S3GetObjectAction::send_response_to_s3_client() {
     request->send_response(error.get_http_status_code(), response_xml);
   } else if (object_metadata &&
              (object_metadata->get_content_length() == 0 ||
+              object_metadata->has_inline_data() ||
               (motr_reader &&
                motr_reader->get_state() == S3MotrReaderOpState::success))) {
     request->send_reply_end();
@@ -24,6 +24,7 @@
 #define __S3_SERVER_S3_GET_OBJECT_ACTION_H__
 
 #include <gtest/gtest_prod.h>
+#include <deque>
 #include <memory>
 
 #include "s3_object_action_base.h"
@@ -45,6 +46,15 @@ class S3GetObjectAction : public S3ObjectAction {
   size_t last_byte_offset_to_read;
   size_t total_blocks_to_read;
   size_t blocks_to_read;
+  // Blocks of all reads launched so far, including reads ahead
+  size_t blocks_launched;
+
+  // Blocks of each read launched ahead by motr_reader, oldest first
+  std::deque<size_t> read_ahead_blocks;
+  // Current limit of reads in flight, grows up to motr_read_window
+  // (S3_MOTR_READ_WINDOW) while client keeps up and memory permits
+  size_t read_ahead_depth;
+  size_t motr_read_window;
 
   bool read_object_reply_started;
   std::shared_ptr<S3MotrReaderFactory> motr_reader_factory;
@@ -73,10 +83,13 @@ class S3GetObjectAction : public S3ObjectAction {
   void read_object();
 
   void read_object_data();
+  void read_ahead();
   void read_object_data_failed();
   void check_outbuffer_and_mempool_stats(bool& bcontinue);
   void resume_action_handler();
+  void start_reply();
   void send_data_to_client();
+  void send_inline_data_to_client();
   void send_response_to_s3_client();
   // Overridden from base
   void resume_action_step();
@@ -102,6 +115,9 @@ class S3GetObjectAction : public S3ObjectAction {
   FRIEND_TEST(S3GetObjectActionTest, ReadObjectOfSizeEqualToUnitSize);
   FRIEND_TEST(S3GetObjectActionTest, ReadObjectOfSizeMoreThanUnitSize);
   FRIEND_TEST(S3GetObjectActionTest, ReadObjectOfGivenRange);
+  FRIEND_TEST(S3GetObjectActionTest, ReadObjectDataTakesReadAheadFirst);
+  FRIEND_TEST(S3GetObjectActionTest, ReadAheadStopsAtLastBlock);
+  FRIEND_TEST(S3GetObjectActionTest, SendResponseWaitsForReadAhead);
   FRIEND_TEST(S3GetObjectActionTest,
               SendResponseWhenShuttingDownAndResponseStarted);
   FRIEND_TEST(S3GetObjectActionTest,
@@ -157,6 +173,7 @@ class S3GetObjectAction : public S3ObjectAction {
   FRIEND_TEST(
       S3GetObjectActionTest,
       CheckFullOrRangeObjectReadWithUnsupportMultiRangeForContentLength8000);
+  FRIEND_TEST(S3GetObjectActionTest, ReadObjectSendsInlineDataRange);
 };
 
 #endif
@@ -200,14 +200,15 @@ void S3GetServiceAction::send_response_to_s3_client() {
 
     request->send_response(error.get_http_status_code(), response_xml);
   } else if (fetch_successful) {
-    std::string& response_xml = bucket_list.get_xml();
+    S3XmlWriter xml_writer;
+    bucket_list.write_xml(xml_writer);
     request->set_out_header_value("Content-Length",
-                                  std::to_string(response_xml.length()));
-    request->set_bytes_sent(response_xml.length());
+                                  std::to_string(xml_writer.length()));
+    request->set_bytes_sent(xml_writer.length());
     request->set_out_header_value("Content-Type", "application/xml");
-    s3_log(S3_LOG_DEBUG, request_id, "Bucket list response_xml = %s\n",
-           response_xml.c_str());
-    request->send_response(S3HttpSuccess200, response_xml);
+    s3_log(S3_LOG_DEBUG, request_id, "Bucket list response_xml length = %zu\n",
+           xml_writer.length());
+    request->send_response_buffer(S3HttpSuccess200, xml_writer.get_buffer());
   } else {
     S3Error error("InternalError", request->get_request_id(), "");
     std::string& response_xml = error.to_xml();
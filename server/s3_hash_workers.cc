@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cstdlib>
+#include <utility>
+
+#include "s3_hash_workers.h"
+#include "s3_log.h"
+#include "s3_option.h"
+#include "s3_post_to_main_loop.h"
+#include "s3_stats.h"
+
+S3HashWorkers* S3HashWorkers::p_instance;
+
+S3HashWorkers::S3HashWorkers(unsigned n_threads, size_t batch_size,
+                             size_t max_queued_jobs)
+    : batch_size(batch_size ? batch_size : 1),
+      max_queued_jobs(max_queued_jobs) {
+  for (unsigned i = 0; i < n_threads; ++i) {
+    pthread_t tid;
+
+    if (pthread_create(&tid, NULL, &S3HashWorkers::worker_thread, this) != 0) {
+      s3_log(S3_LOG_ERROR, "", "Failed to create hash worker thread\n");
+      break;
+    }
+    threads.push_back(tid);
+  }
+  s3_log(S3_LOG_INFO, "", "Started %zu hash worker thread(s)\n",
+         threads.size());
+}
+
+S3HashWorkers::~S3HashWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cond.notify_all();
+
+  for (auto tid : threads) {
+    pthread_join(tid, NULL);
+  }
+  if (!jobs.empty()) {
+    s3_log(S3_LOG_WARN, "", "%zu hash jobs dropped\n", jobs.size());
+  }
+}
+
+void S3HashWorkers::create_instance(unsigned n_threads, size_t batch_size,
+                                    size_t max_queued_jobs) {
+  if (!p_instance && n_threads > 0) {
+    p_instance = new S3HashWorkers(n_threads, batch_size, max_queued_jobs);
+    if (p_instance->get_thread_count() == 0) {
+      destroy_instance();
+    }
+  }
+}
+
+void S3HashWorkers::destroy_instance() {
+  S3HashWorkers* instance = p_instance;
+
+  p_instance = nullptr;
+  delete instance;
+}
+
+S3HashWorkers* S3HashWorkers::get_instance() { return p_instance; }
+
+bool S3HashWorkers::submit(std::function<void()> work,
+                           std::function<void()> done, evbase_t* evbase) {
+  if (!evbase) {
+    evbase = S3Option::get_instance()->get_eventbase();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (stopping || jobs.size() >= max_queued_jobs) {
+      s3_stats_inc("hash_workers_queue_full_count");
+      return false;
+    }
+    jobs.push_back({std::move(work), std::move(done), evbase});
+  }
+  cond.notify_one();
+  return true;
+}
+
+void* S3HashWorkers::worker_thread(void* arg) {
+  static_cast<S3HashWorkers*>(arg)->run_worker();
+  return NULL;
+}
+
+void S3HashWorkers::run_worker() {
+  std::vector<Job> batch;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+      if (stopping) {
+        return;
+      }
+      while (!jobs.empty() && batch.size() < batch_size) {
+        batch.push_back(std::move(jobs.front()));
+        jobs.pop_front();
+      }
+    }
+    for (auto& job : batch) {
+      job.work();
+    }
+    // One post per event base, jobs mostly come from a few reactors
+    while (!batch.empty()) {
+      evbase_t* evbase = batch.front().evbase;
+      auto handlers = new std::vector<std::function<void()>>();
+
+      for (auto it = batch.begin(); it != batch.end();) {
+        if (it->evbase == evbase) {
+          handlers->push_back(std::move(it->done));
+          it = batch.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      post_done(evbase, handlers);
+    }
+  }
+}
+
+void S3HashWorkers::post_done(evbase_t* evbase,
+                              std::vector<std::function<void()>>* handlers) {
+  struct user_event_context* user_ctx = (struct user_event_context*)calloc(
+      1, sizeof(struct user_event_context));
+  user_ctx->app_ctx = handlers;
+
+  S3PostToMainLoop((void*)user_ctx, evbase)(S3HashWorkers::on_jobs_done);
+}
+
+void S3HashWorkers::on_jobs_done(evutil_socket_t, short events,
+                                 void* user_data) {
+  struct user_event_context* user_context =
+      (struct user_event_context*)user_data;
+  auto handlers =
+      static_cast<std::vector<std::function<void()>>*>(user_context->app_ctx);
+
+  for (auto& handler : *handlers) {
+    handler();
+  }
+  delete handlers;
+
+  event_free((struct event*)user_context->user_event);
+  free(user_data);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_HASH_WORKERS_H__
+#define __S3_SERVER_S3_HASH_WORKERS_H__
+
+#include <pthread.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <evhtp.h>
+
+// Threads computing digests of request payloads (chunk signatures, Motr PI
+// of written data), so that event loops only hand data over instead of
+// hashing it.
+//
+// Jobs from all requests share one queue. A worker takes up to batch_size
+// jobs at once and posts their completions back with one event per event
+// base, so under load wakeups and posts are paid per batch, not per job.
+// work() runs on a worker thread and must only touch data owned by the job;
+// done() runs on the event base the job was submitted from.
+//
+// Single instance, created at startup when S3_HASH_WORKER_THREADS > 0.
+class S3HashWorkers {
+  static S3HashWorkers* p_instance;
+
+  struct Job {
+    std::function<void()> work;
+    std::function<void()> done;
+    evbase_t* evbase;
+  };
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<Job> jobs;
+  bool stopping = false;
+
+  std::vector<pthread_t> threads;
+  size_t batch_size;
+  size_t max_queued_jobs;
+
+  static void* worker_thread(void* arg);
+  void run_worker();
+  static void post_done(evbase_t* evbase,
+                        std::vector<std::function<void()>>* handlers);
+  static void on_jobs_done(evutil_socket_t, short events, void* user_data);
+
+ public:
+  S3HashWorkers(unsigned n_threads, size_t batch_size, size_t max_queued_jobs);
+
+  S3HashWorkers(const S3HashWorkers&) = delete;
+  S3HashWorkers& operator=(const S3HashWorkers&) = delete;
+
+  // Waits for jobs being run, queued jobs are dropped
+  ~S3HashWorkers();
+
+  // No instance is made if no thread could be started
+  static void create_instance(unsigned n_threads, size_t batch_size,
+                              size_t max_queued_jobs);
+  // Callers must make sure nothing submits jobs anymore
+  static void destroy_instance();
+  // Returns nullptr if hashing is done inline
+  static S3HashWorkers* get_instance();
+
+  size_t get_thread_count() const { return threads.size(); }
+
+  // Returns false if too many jobs are waiting, the caller should do the
+  // work itself. evbase defaults to the calling reactor's one.
+  bool submit(std::function<void()> work, std::function<void()> done,
+              evbase_t* evbase = nullptr);
+};
+
+#endif  // __S3_SERVER_S3_HASH_WORKERS_H__
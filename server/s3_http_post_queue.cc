@@ -34,13 +34,27 @@ S3HttpPostQueue::~S3HttpPostQueue() = default;
 S3HttpPostEngine::~S3HttpPostEngine() = default;
 S3HttpPostQueueImpl::~S3HttpPostQueueImpl() = default;
 
-S3HttpPostQueueImpl::S3HttpPostQueueImpl(S3HttpPostEngine *http_post_engine_)
-    : http_post_engine(http_post_engine_) {
-
-  assert(http_post_engine_ != nullptr);
-  http_post_engine->set_callbacks(
-      std::bind(&S3HttpPostQueueImpl::on_msg_sent, this),
-      std::bind(&S3HttpPostQueueImpl::on_error, this));
+S3HttpPostQueueImpl::S3HttpPostQueueImpl(S3HttpPostEngine *http_post_engine_,
+                                         S3HttpPostQueueConfig config_)
+    : S3HttpPostQueueImpl(std::vector<S3HttpPostEngine *>{http_post_engine_},
+                          std::move(config_)) {}
+
+S3HttpPostQueueImpl::S3HttpPostQueueImpl(
+    std::vector<S3HttpPostEngine *> http_post_engines,
+    S3HttpPostQueueConfig config_)
+    : config(std::move(config_)), senders(http_post_engines.size()) {
+
+  assert(!http_post_engines.empty());
+  if (!config.max_batch_size) {
+    config.max_batch_size = 1;
+  }
+  for (size_t i = 0; i < senders.size(); ++i) {
+    assert(http_post_engines[i] != nullptr);
+    senders[i].engine.reset(http_post_engines[i]);
+    senders[i].engine->set_callbacks(
+        std::bind(&S3HttpPostQueueImpl::on_msg_sent, this, i),
+        std::bind(&S3HttpPostQueueImpl::on_error, this, i));
+  }
 }
 
 bool S3HttpPostQueueImpl::post(std::string msg) {
@@ -52,63 +66,117 @@ bool S3HttpPostQueueImpl::post(std::string msg) {
     s3_log(S3_LOG_INFO, nullptr, "Empty messages are not allowed");
     return false;
   }
-  if (msg_queue.size() >= MAX_MSG_IN_QUEUE) {
-    s3_log(S3_LOG_DEBUG, nullptr, "Too many messages in the queue");
+  if (queued_bytes + msg.length() > config.max_queued_bytes) {
+    // Reported once per overflow, not per message
+    if (n_dropped++ == n_dropped_reported) {
+      s3_log(S3_LOG_WARN, nullptr,
+             "Queue is full (%zu bytes), dropping messages", queued_bytes);
+    }
     return false;
   }
-  msg_queue.push(std::move(msg));
+  queued_bytes += msg.length();
+  msg_queue.push_back(std::move(msg));
 
-  if (!msg_in_progress) {
-    send_front();
-  } else {
-    s3_log(S3_LOG_DEBUG, nullptr, "Another message is being processed");
-  }
+  send_queued();
   return true;
 }
 
-void S3HttpPostQueueImpl::on_msg_sent() {
-  assert(msg_in_progress);
+void S3HttpPostQueueImpl::send_queued() {
+  for (auto &sender : senders) {
+    if (msg_queue.empty()) {
+      return;
+    }
+    if (!sender.in_progress) {
+      send_batch(sender);
+    }
+  }
+  s3_log(S3_LOG_DEBUG, nullptr, "%zu message(s) in the queue",
+         msg_queue.size());
+}
+
+void S3HttpPostQueueImpl::send_batch(Sender &sender) {
+  assert(!sender.in_progress);
   assert(!msg_queue.empty());
 
-  msg_in_progress = false;
+  size_t n_msgs = 0;
+
+  // Keeps the capacity of the previous body
+  sender.body = config.batch_prefix;
+  sender.msg_bytes = 0;
+
+  while (!msg_queue.empty() && n_msgs < config.max_batch_size) {
+    const std::string &msg = msg_queue.front();
+    const size_t separator_bytes =
+        n_msgs ? config.batch_separator.length() : 0;
+
+    if (n_msgs && sender.body.length() + separator_bytes + msg.length() +
+                          config.batch_suffix.length() >
+                      config.max_batch_bytes) {
+      break;
+    }
+    if (n_msgs) {
+      sender.body += config.batch_separator;
+    }
+    sender.body += msg;
+    sender.msg_bytes += msg.length();
+    ++n_msgs;
+    msg_queue.pop_front();
+  }
+  sender.body += config.batch_suffix;
+
+  s3_log(S3_LOG_DEBUG, nullptr, "Sending %zu message(s), %zu bytes", n_msgs,
+         sender.body.length());
+  sender.in_progress = true;
+
+  bool ret = sender.engine->post(sender.body);
+  assert(ret);
+  (void)ret;
+}
+
+void S3HttpPostQueueImpl::on_msg_sent(size_t sender_idx) {
+  Sender &sender = senders.at(sender_idx);
+  assert(sender.in_progress);
+
+  sender.in_progress = false;
   n_err = 0;
-  msg_queue.pop();
+  queued_bytes -= sender.msg_bytes;
+  sender.msg_bytes = 0;
+  sender.body.clear();
 
-  if (!msg_queue.empty()) {
-    s3_log(S3_LOG_DEBUG, nullptr, "%zu message(s) in the queue",
-           msg_queue.size());
-    send_front();
+  if (n_dropped != n_dropped_reported) {
+    s3_log(S3_LOG_WARN, nullptr, "%zu message(s) dropped while queue was full",
+           n_dropped - n_dropped_reported);
+    n_dropped_reported = n_dropped;
   }
+  send_queued();
 }
 
-void S3HttpPostQueueImpl::on_error() {
-  assert(msg_in_progress);
-  assert(!msg_queue.empty());
+void S3HttpPostQueueImpl::on_error(size_t sender_idx) {
+  Sender &sender = senders.at(sender_idx);
+  assert(sender.in_progress);
 
-  msg_in_progress = false;
+  sender.in_progress = false;
 
   if (++n_err > MAX_ERR) {
     s3_log(S3_LOG_ERROR, nullptr,
            "The number of errors has exceeded the threshold");
-    while (!msg_queue.empty()) {
-      msg_queue.pop();
+    queued_bytes -= sender.msg_bytes;
+    sender.msg_bytes = 0;
+    sender.body.clear();
+
+    for (const auto &msg : msg_queue) {
+      queued_bytes -= msg.length();
     }
+    msg_queue.clear();
   } else {
     s3_log(S3_LOG_DEBUG, nullptr,
            "Message hasn't been sent %u times. Repeat...", n_err);
-    send_front();
-  }
-}
-
-void S3HttpPostQueueImpl::send_front() {
-  assert(!msg_in_progress);
-  assert(!msg_queue.empty());
+    sender.in_progress = true;
 
-  bool ret = http_post_engine->post(msg_queue.front());
-  assert(ret);
-  (void)ret;
-
-  msg_in_progress = true;
+    bool ret = sender.engine->post(sender.body);
+    assert(ret);
+    (void)ret;
+  }
 }
 
 S3HttpPostEngineImpl::S3HttpPostEngineImpl(
@@ -517,8 +585,15 @@ bool S3HttpPostEngineImpl::post(const std::string &msg) {
 template <>
 S3HttpPostQueue *create_http_post_queue(
     evbase_t *p_evbase, std::string s_host, uint16_t port, std::string path,
-    std::map<std::string, std::string> headers) {
+    std::map<std::string, std::string> headers, S3HttpPostQueueConfig config) {
 
-  return new S3HttpPostQueueImpl(new S3HttpPostEngineImpl(
-      p_evbase, std::move(s_host), port, std::move(path), std::move(headers)));
+  std::vector<S3HttpPostEngine *> engines;
+  const unsigned n_engines =
+      config.max_posts_in_flight ? config.max_posts_in_flight : 1;
+
+  for (unsigned i = 0; i < n_engines; ++i) {
+    engines.push_back(
+        new S3HttpPostEngineImpl(p_evbase, s_host, port, path, headers));
+  }
+  return new S3HttpPostQueueImpl(std::move(engines), std::move(config));
 }
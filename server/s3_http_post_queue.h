@@ -21,11 +21,28 @@
 #ifndef __S3_SERVER_S3_HTTP_POST_QUEUE_H__
 #define __S3_SERVER_S3_HTTP_POST_QUEUE_H__
 
+#include <cstddef>
 #include <string>
 
+// How queued messages are sent. A POST body is batch_prefix, then up to
+// max_batch_size messages joined with batch_separator, then batch_suffix.
+struct S3HttpPostQueueConfig {
+  std::string batch_prefix;
+  std::string batch_separator;
+  std::string batch_suffix;
+  // Messages and bytes per POST body, a longer message is sent alone
+  size_t max_batch_size = 1;
+  size_t max_batch_bytes = 1024 * 1024;
+  // Connections used, each has one POST in flight
+  unsigned max_posts_in_flight = 1;
+  // Messages queued or in flight, post() fails beyond it
+  size_t max_queued_bytes = 64 * 1024 * 1024;
+};
+
 class S3HttpPostQueue {
  public:
   virtual ~S3HttpPostQueue();
+  // Returns false if the message is dropped
   virtual bool post(std::string msg) = 0;
 };
 
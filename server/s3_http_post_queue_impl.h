@@ -25,8 +25,9 @@
 
 #include <functional>
 #include <map>
+#include <deque>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include <gtest/gtest_prod.h>
 #include <evhtp.h>
@@ -41,36 +42,58 @@ class S3HttpPostEngine {
   virtual bool post(const std::string &msg) = 0;
 };
 
+// Messages are sent in the order they were posted, packed into as few POST
+// bodies as the config allows. A batch is sent as soon as an engine is idle,
+// so messages only wait, and pile up into bigger batches, while all engines
+// have a POST in flight. A failed POST is retried by the same engine.
 class S3HttpPostQueueImpl : public S3HttpPostQueue {
  public:
-  S3HttpPostQueueImpl(S3HttpPostEngine *);
+  explicit S3HttpPostQueueImpl(
+      S3HttpPostEngine *, S3HttpPostQueueConfig config = {});
+  S3HttpPostQueueImpl(std::vector<S3HttpPostEngine *>,
+                      S3HttpPostQueueConfig config);
   ~S3HttpPostQueueImpl();
 
   bool post(std::string msg) override;
 
+  size_t get_dropped_count() const { return n_dropped; }
+
  protected:
-  virtual void on_msg_sent();
-  virtual void on_error();
+  virtual void on_msg_sent(size_t sender_idx);
+  virtual void on_error(size_t sender_idx);
 
  private:
-  void send_front();
+  struct Sender {
+    std::unique_ptr<S3HttpPostEngine> engine;
+    std::string body;
+    // Queued bytes the body holds
+    size_t msg_bytes = 0;
+    bool in_progress = false;
+  };
+
+  void send_queued();
+  void send_batch(Sender &);
 
   enum : unsigned {
     MAX_ERR = 100
   };
-  enum : unsigned {
-    MAX_MSG_IN_QUEUE = 1024
-  };
+  S3HttpPostQueueConfig config;
   unsigned n_err = 0;
-  bool msg_in_progress = false;
+  size_t n_dropped = 0;
+  size_t n_dropped_reported = 0;
+  // Of messages in msg_queue and in bodies being sent
+  size_t queued_bytes = 0;
 
-  std::queue<std::string> msg_queue;
-  std::unique_ptr<S3HttpPostEngine> http_post_engine;
+  std::deque<std::string> msg_queue;
+  std::vector<Sender> senders;
 
   FRIEND_TEST(S3HttpPostQueueTest, Basic);
   FRIEND_TEST(S3HttpPostQueueTest, InProgress);
   FRIEND_TEST(S3HttpPostQueueTest, ErrorCount);
   FRIEND_TEST(S3HttpPostQueueTest, Thresholds);
+  FRIEND_TEST(S3HttpPostQueueBatchTest, PacksMessagesWhileEnginesAreBusy);
+  FRIEND_TEST(S3HttpPostQueueBatchTest, LimitsBatchSize);
+  FRIEND_TEST(S3HttpPostQueueBatchTest, RetriesFailedBatch);
 };
 
 class S3HttpPostEngineImpl : public S3HttpPostEngine {
@@ -39,15 +39,10 @@ extern S3Option* g_option_instance;
 #ifdef IEM_FRAMEWORK_ENABLE
 #define s3_iem_(loglevel, s3_loglevel, event_code, event_desc, json_fmt, ...) \
   do {                                                                        \
-    S3IEM* iem_obj =                                            \
-        new S3IEM(S3Option::get_instance()->get_eventbase(),                  \
-                  S3Option::get_instance()->get_iem_host(),                   \
-                  S3Option::get_instance()->get_iem_port(),                   \
-                  S3Option::get_instance()->get_iem_path());                  \
     if (loglevel == LOG_ALERT) {                                              \
-      iem_obj->save_msg(event_code, "A", event_desc);           \
+      S3IEM::post(event_code, "A", event_desc);                               \
     } else {                                                                  \
-      iem_obj->save_msg(event_code, "E", event_desc);           \
+      S3IEM::post(event_code, "E", event_desc);                               \
     }                                                                         \
     std::string timestamp = s3_get_timestamp();                               \
     s3_log(S3_##s3_loglevel, "",                                              \
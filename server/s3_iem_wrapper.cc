@@ -24,6 +24,8 @@
 #include "s3_log.h"
 #include "s3_iem_wrapper.h"
 #include "s3_http_post_queue.h"
+#include "s3_option.h"
+#include "s3_post_to_main_loop.h"
 
 S3IEM::S3IEM(evbase_t* p_base, std::string host_ip, uint16_t port,
              std::string path) {
@@ -31,8 +33,10 @@ S3IEM::S3IEM(evbase_t* p_base, std::string host_ip, uint16_t port,
   std::map<std::string, std::string> headers;
   headers["Content-Type"] = "application/json";
 
+  // Each IEM is a POST of its own
   p_s3_post_queue.reset(create_http_post_queue(
-      p_base, std::move(host_ip), port, std::move(path), std::move(headers)));
+      p_base, std::move(host_ip), port, std::move(path), std::move(headers),
+      S3HttpPostQueueConfig()));
 }
 
 int S3IEM::save_msg(std::string const& eventID, std::string const& severity,
@@ -65,3 +69,17 @@ int S3IEM::save_msg(std::string const& eventID, std::string const& severity,
   s3_log(S3_LOG_DEBUG, nullptr, "%s Exit", __func__);
   return !fSucc;
 }
+
+void S3IEM::post(std::string const& eventID, std::string const& severity,
+                 std::string const& msg) {
+  s3_run_on_main_loop([eventID, severity, msg]() {
+    // Created on first use and kept for the process lifetime, so pending
+    // posts are not cut short by teardown order.
+    static S3IEM* iem =
+        new S3IEM(S3Option::get_instance()->get_main_eventbase(),
+                  S3Option::get_instance()->get_iem_host(),
+                  S3Option::get_instance()->get_iem_port(),
+                  S3Option::get_instance()->get_iem_path());
+    iem->save_msg(eventID, severity, msg);
+  });
+}
@@ -35,6 +35,10 @@ class S3IEM {
   S3IEM(evbase_t* p_base, std::string host_ip, uint16_t port, std::string path);
   int save_msg(std::string const& eventID, std::string const& severity,
                std::string const& msg);
+  // Sends the IEM through the process wide instance, which lives on the
+  // main event base; safe to call from any reactor.
+  static void post(std::string const& eventID, std::string const& severity,
+                   std::string const& msg);
 
  private:
   std::unique_ptr<S3HttpPostQueue> p_s3_post_queue;
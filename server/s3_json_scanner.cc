@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cstring>
+
+#include "s3_json_scanner.h"
+
+S3JsonScanner::S3JsonScanner(const std::string& json)
+    : p(json.data()), end(json.data() + json.length()) {}
+
+S3JsonScanner::S3JsonScanner(const char* json, size_t len)
+    : p(json), end(json + len) {}
+
+bool S3JsonScanner::fail() {
+  f_failed = true;
+  p = end;
+  return false;
+}
+
+void S3JsonScanner::skip_ws() {
+  while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+    ++p;
+  }
+}
+
+bool S3JsonScanner::enter_object() {
+  skip_ws();
+
+  if (p == end || *p != '{') {
+    return fail();
+  }
+  ++p;
+  return true;
+}
+
+bool S3JsonScanner::next_member(std::string& key) {
+  skip_ws();
+
+  if (p == end) {
+    return fail();
+  }
+  if (*p == '}') {
+    ++p;
+    return false;
+  }
+  if (*p == ',') {
+    ++p;
+    skip_ws();
+  }
+  if (p == end || *p != '"' || !parse_string(&key)) {
+    return fail();
+  }
+  skip_ws();
+
+  if (p == end || *p != ':') {
+    return fail();
+  }
+  ++p;
+  return true;
+}
+
+bool S3JsonScanner::read_string(std::string& value) {
+  skip_ws();
+  value.clear();
+
+  if (p == end) {
+    return fail();
+  }
+  if (*p == '"') {
+    return parse_string(&value);
+  }
+  if (*p == '{' || *p == '[') {
+    return fail();
+  }
+  return skip_literal(&value);
+}
+
+bool S3JsonScanner::skip_value() {
+  skip_ws();
+
+  if (p == end) {
+    return fail();
+  }
+  if (*p == '"') {
+    return parse_string(nullptr);
+  }
+  if (*p == '{' || *p == '[') {
+    return skip_nested();
+  }
+  return skip_literal(nullptr);
+}
+
+// Numbers, true, false and null
+bool S3JsonScanner::skip_literal(std::string* p_dst) {
+  const char* const start = p;
+
+  while (p < end && !strchr(",}] \n\r\t", *p)) {
+    ++p;
+  }
+  if (p == start) {
+    return fail();
+  }
+  if (p_dst && !(p - start == 4 && !memcmp(start, "null", 4))) {
+    p_dst->assign(start, p - start);
+  }
+  return true;
+}
+
+bool S3JsonScanner::skip_nested() {
+  unsigned depth = 0;
+
+  while (p < end) {
+    switch (*p) {
+      case '"':
+        if (!parse_string(nullptr)) {
+          return false;
+        }
+        continue;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0) {
+          ++p;
+          return true;
+        }
+        break;
+    }
+    ++p;
+  }
+  return fail();
+}
+
+// Expects *p == '"', leaves p after the closing quote.
+// With p_dst == nullptr the string is only skipped.
+bool S3JsonScanner::parse_string(std::string* p_dst) {
+  ++p;
+
+  if (p_dst) {
+    p_dst->clear();
+  }
+  for (;;) {
+    const char* const start = p;
+
+    while (p < end && *p != '"' && *p != '\\') {
+      ++p;
+    }
+    if (p == end) {
+      return fail();
+    }
+    if (p_dst) {
+      p_dst->append(start, p - start);
+    }
+    if (*p++ == '"') {
+      return true;
+    }
+    if (p == end) {
+      return fail();
+    }
+    char ch = *p++;
+
+    switch (ch) {
+      case 'b':
+        ch = '\b';
+        break;
+      case 'f':
+        ch = '\f';
+        break;
+      case 'n':
+        ch = '\n';
+        break;
+      case 'r':
+        ch = '\r';
+        break;
+      case 't':
+        ch = '\t';
+        break;
+      case 'u':
+        if (!parse_unicode_escape(p_dst)) {
+          return false;
+        }
+        continue;
+      case '"':
+      case '\\':
+      case '/':
+        break;
+      default:
+        return fail();
+    }
+    if (p_dst) {
+      *p_dst += ch;
+    }
+  }
+}
+
+static bool parse_hex4(const char* s, unsigned& code) {
+  code = 0;
+
+  for (int i = 0; i < 4; ++i) {
+    const char ch = s[i];
+    code <<= 4;
+
+    if (ch >= '0' && ch <= '9') {
+      code |= ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+      code |= ch - 'a' + 10;
+    } else if (ch >= 'A' && ch <= 'F') {
+      code |= ch - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Follows "\u", writes the code point as UTF-8
+bool S3JsonScanner::parse_unicode_escape(std::string* p_dst) {
+  unsigned code;
+
+  if (end - p < 4 || !parse_hex4(p, code)) {
+    return fail();
+  }
+  p += 4;
+
+  if (code >= 0xD800 && code <= 0xDBFF) {
+    // Surrogate pair
+    unsigned low;
+
+    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+        !parse_hex4(p + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+      return fail();
+    }
+    p += 6;
+    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+  }
+  if (!p_dst) {
+    return true;
+  }
+  if (code < 0x80) {
+    *p_dst += (char)code;
+  } else if (code < 0x800) {
+    *p_dst += (char)(0xC0 | (code >> 6));
+    *p_dst += (char)(0x80 | (code & 0x3F));
+  } else if (code < 0x10000) {
+    *p_dst += (char)(0xE0 | (code >> 12));
+    *p_dst += (char)(0x80 | ((code >> 6) & 0x3F));
+    *p_dst += (char)(0x80 | (code & 0x3F));
+  } else {
+    *p_dst += (char)(0xF0 | (code >> 18));
+    *p_dst += (char)(0x80 | ((code >> 12) & 0x3F));
+    *p_dst += (char)(0x80 | ((code >> 6) & 0x3F));
+    *p_dst += (char)(0x80 | (code & 0x3F));
+  }
+  return true;
+}
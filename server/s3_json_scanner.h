@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_JSON_SCANNER_H__
+#define __S3_SERVER_S3_JSON_SCANNER_H__
+
+#include <cstddef>
+#include <string>
+
+// Forward-only reader of JSON objects, for hot paths which need a few
+// members of a large document (e.g. object listing needs a handful of
+// fields out of the whole object metadata). Unlike Json::Reader it builds
+// no tree: members are visited in the document order, wanted values are
+// decoded, everything else is skipped over.
+//
+//   S3JsonScanner scanner(json);
+//   std::string key;
+//
+//   if (scanner.enter_object()) {
+//     while (scanner.next_member(key)) {
+//       if (key == "Object-Name") {
+//         scanner.read_string(object_name);
+//       } else {
+//         scanner.skip_value();
+//       }
+//     }
+//   }
+//   if (scanner.failed()) ...
+//
+// Exactly one of read_string(), enter_object() or skip_value() must be
+// called for each member returned by next_member(). Once the document is
+// found malformed every call returns false and failed() returns true.
+class S3JsonScanner {
+  const char* p;
+  const char* const end;
+  bool f_failed = false;
+
+  bool fail();
+  void skip_ws();
+  bool parse_string(std::string* p_dst);
+  bool parse_unicode_escape(std::string* p_dst);
+  bool skip_nested();
+  bool skip_literal(std::string* p_dst);
+
+ public:
+  explicit S3JsonScanner(const std::string& json);
+  S3JsonScanner(const char* json, size_t len);
+
+  // Consumes '{' of an object value (or of the whole document)
+  bool enter_object();
+
+  // Returns false at the end of the current object (consuming '}')
+  bool next_member(std::string& key);
+
+  // Strings are unescaped. Numbers, true and false are returned as they are
+  // written, null as empty string (as Json::Value::asString() does).
+  bool read_string(std::string& value);
+
+  bool skip_value();
+
+  bool failed() const { return f_failed; }
+};
+
+#endif  // __S3_SERVER_S3_JSON_SCANNER_H__
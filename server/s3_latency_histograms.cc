@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <algorithm>
+
+#include <json/json.h>
+
+#include "s3_latency_histograms.h"
+
+const unsigned S3LatencyHistogram::sub_bucket_bits;
+const uint64_t S3LatencyHistogram::max_value;
+const size_t S3LatencyHistogram::buckets;
+
+std::mutex S3LatencyHistograms::mutex;
+std::map<std::string, std::unique_ptr<S3LatencyHistograms::ApiHistograms>>
+    S3LatencyHistograms::apis;
+thread_local std::unordered_map<std::string,
+                                S3LatencyHistograms::ApiHistograms*>
+    S3LatencyHistograms::thread_apis;
+
+static const uint64_t sub_buckets = 1ULL << S3LatencyHistogram::sub_bucket_bits;
+
+size_t S3LatencyHistogram::get_bucket(uint64_t value) {
+  if (value > max_value) {
+    value = max_value;
+  }
+  if (value < sub_buckets) {
+    return value;
+  }
+  // Position of the highest bit, at least sub_bucket_bits
+  unsigned exponent = 63 - __builtin_clzll(value);
+  unsigned shift = exponent - sub_bucket_bits;
+
+  return sub_buckets + shift * sub_buckets +
+         ((value >> shift) & (sub_buckets - 1));
+}
+
+uint64_t S3LatencyHistogram::get_bucket_max(size_t bucket) {
+  if (bucket < sub_buckets) {
+    return bucket;
+  }
+  unsigned shift = (bucket - sub_buckets) / sub_buckets;
+  uint64_t sub_bucket = (bucket - sub_buckets) % sub_buckets;
+  uint64_t low = (sub_buckets + sub_bucket) << shift;
+
+  return low + (1ULL << shift) - 1;
+}
+
+void S3LatencyHistogram::record(uint64_t value) {
+  counts[get_bucket(value)].fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t current = max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t S3LatencyHistogram::get_count() const {
+  uint64_t count = 0;
+
+  for (size_t i = 0; i < buckets; ++i) {
+    count += counts[i].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t S3LatencyHistogram::get_percentile(double fraction) const {
+  uint64_t snapshot[buckets];
+  uint64_t count = 0;
+
+  for (size_t i = 0; i < buckets; ++i) {
+    snapshot[i] = counts[i].load(std::memory_order_relaxed);
+    count += snapshot[i];
+  }
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(fraction * count + 0.5);
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < buckets; ++i) {
+    seen += snapshot[i];
+    if (seen >= rank) {
+      return std::min(get_bucket_max(i), get_max());
+    }
+  }
+  return get_max();
+}
+
+S3LatencyPhase S3LatencyHistograms::get_task_phase(
+    const std::string& task_name) {
+  size_t pos = task_name.rfind("::");
+  std::string method =
+      pos == std::string::npos ? task_name : task_name.substr(pos + 2);
+
+  if (method.find("authoriz") != std::string::npos ||
+      method.find("authentic") != std::string::npos ||
+      method == "validate_acl_with_auth" ||
+      method == "set_authorization_meta") {
+    return S3LatencyPhase::auth;
+  }
+  if (method == "send_response_to_s3_client") {
+    return S3LatencyPhase::client_send;
+  }
+  if (method.find("_data") != std::string::npos || method == "read_object" ||
+      method == "copy_object" || method == "create_object" ||
+      method == "create_destination_object" ||
+      method == "create_inline_object" || method == "delete_new_object" ||
+      method == "delete_old_object") {
+    return S3LatencyPhase::data_io;
+  }
+  if (method.find("bucket") != std::string::npos ||
+      method == "load_metadata") {
+    return S3LatencyPhase::bucket_metadata;
+  }
+  if (method.compare(0, 8, "validate") == 0) {
+    return S3LatencyPhase::other;
+  }
+  return S3LatencyPhase::object_metadata;
+}
+
+const char* S3LatencyHistograms::get_phase_name(S3LatencyPhase phase) {
+  switch (phase) {
+    case S3LatencyPhase::auth:
+      return "auth";
+    case S3LatencyPhase::bucket_metadata:
+      return "bucket_metadata";
+    case S3LatencyPhase::object_metadata:
+      return "object_metadata";
+    case S3LatencyPhase::data_io:
+      return "data_io";
+    case S3LatencyPhase::client_send:
+      return "client_send";
+    default:
+      return "other";
+  }
+}
+
+S3LatencyHistograms::ApiHistograms* S3LatencyHistograms::get_api_histograms(
+    const std::string& api) {
+  auto it = thread_apis.find(api);
+  if (it != thread_apis.end()) {
+    return it->second;
+  }
+  ApiHistograms* histograms;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = apis[api];
+
+    if (!entry) {
+      entry.reset(new ApiHistograms());
+    }
+    histograms = entry.get();
+  }
+  thread_apis[api] = histograms;
+  return histograms;
+}
+
+void S3LatencyHistograms::record(const std::string& api,
+                                 const S3LatencySample& sample) {
+  if (api.empty()) {
+    return;
+  }
+  ApiHistograms* histograms = get_api_histograms(api);
+
+  histograms->total.record(sample.total_usec);
+  for (unsigned i = 0; i < S3_LATENCY_PHASES; ++i) {
+    if (sample.phases_seen & (1U << i)) {
+      histograms->phases[i].record(sample.phase_usec[i]);
+    }
+  }
+}
+
+static Json::Value histogram_to_json(const S3LatencyHistogram& histogram) {
+  Json::Value value;
+
+  value["count"] = (Json::UInt64)histogram.get_count();
+  value["p50"] = (Json::UInt64)histogram.get_percentile(0.5);
+  value["p99"] = (Json::UInt64)histogram.get_percentile(0.99);
+  value["p999"] = (Json::UInt64)histogram.get_percentile(0.999);
+  value["max"] = (Json::UInt64)histogram.get_max();
+  return value;
+}
+
+std::string S3LatencyHistograms::to_json() {
+  Json::Value root(Json::objectValue);
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (auto& api : apis) {
+    Json::Value& api_value = root[api.first];
+
+    api_value["total"] = histogram_to_json(api.second->total);
+    for (unsigned i = 0; i < S3_LATENCY_PHASES; ++i) {
+      const S3LatencyHistogram& phase = api.second->phases[i];
+
+      if (phase.get_count() > 0) {
+        api_value[get_phase_name(static_cast<S3LatencyPhase>(i))] =
+            histogram_to_json(phase);
+      }
+    }
+  }
+  Json::FastWriter writer;
+  return writer.write(root);
+}
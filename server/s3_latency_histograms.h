@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_LATENCY_HISTOGRAMS_H__
+#define __S3_SERVER_S3_LATENCY_HISTOGRAMS_H__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Part of request processing an action step is charged to
+enum class S3LatencyPhase {
+  other,  // Validation and anything not listed below
+  auth,
+  bucket_metadata,
+  object_metadata,
+  data_io,  // Motr object reads and writes
+  client_send
+};
+
+#define S3_LATENCY_PHASES 6
+
+// Time one request spent in each phase, in microseconds
+struct S3LatencySample {
+  uint64_t total_usec = 0;
+  uint64_t phase_usec[S3_LATENCY_PHASES] = {};
+  // Bit per phase which has run, others are not recorded
+  uint32_t phases_seen = 0;
+};
+
+// HDR style log-linear histogram of microseconds. Values below 16 are
+// counted exactly, each power of 2 above is split into 16 buckets, so any
+// value is reported within 1/16 of it. Updates are relaxed atomics, readers
+// may see a histogram which is being updated.
+class S3LatencyHistogram {
+ public:
+  static const unsigned sub_bucket_bits = 4;
+  // About 12 days, larger values are counted as this
+  static const uint64_t max_value = (1ULL << 40) - 1;
+  static const size_t buckets = (40 - sub_bucket_bits + 1) << sub_bucket_bits;
+
+ private:
+  std::atomic<uint64_t> counts[buckets];
+  std::atomic<uint64_t> max;
+
+ public:
+  S3LatencyHistogram() : counts(), max(0) {}
+
+  static size_t get_bucket(uint64_t value);
+  // Highest value counted in the bucket
+  static uint64_t get_bucket_max(size_t bucket);
+
+  void record(uint64_t value);
+
+  uint64_t get_count() const;
+  uint64_t get_max() const { return max.load(std::memory_order_relaxed); }
+  // Value which at least `fraction` of recorded values are not above
+  uint64_t get_percentile(double fraction) const;
+};
+
+// Latency histograms of each S3 API, one for the whole request and one per
+// phase. Actions charge time to the phase of the step being run, see
+// Action::set_latency_phase(), and record a sample once the response is sent.
+// Histograms are never freed, so there is one set per API name seen.
+class S3LatencyHistograms {
+ public:
+  struct ApiHistograms {
+    S3LatencyHistogram total;
+    S3LatencyHistogram phases[S3_LATENCY_PHASES];
+  };
+
+ private:
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<ApiHistograms>> apis;
+  // Saves taking the mutex for each request
+  static thread_local std::unordered_map<std::string, ApiHistograms*>
+      thread_apis;
+
+ public:
+  // Phase of an action step, by name of its function, "Class::method"
+  static S3LatencyPhase get_task_phase(const std::string& task_name);
+  static const char* get_phase_name(S3LatencyPhase phase);
+
+  static ApiHistograms* get_api_histograms(const std::string& api);
+  static void record(const std::string& api, const S3LatencySample& sample);
+
+  // {"<api>": {"total": {"count": n, "p50": us, "p99": us, "p999": us,
+  // "max": us}, "<phase>": {...}, ...}, ...}
+  static std::string to_json();
+};
+
+#endif  // __S3_SERVER_S3_LATENCY_HISTOGRAMS_H__
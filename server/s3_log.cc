@@ -18,6 +18,9 @@
  *
  */
 
+#include <cstring>
+
+#include "s3_async_log.h"
 #include "s3_log.h"
 #include "s3_option.h"
 
@@ -30,6 +33,14 @@ size_t __log_buff_sz() { return sizeof(log_buffer); }
 int s3log_level = S3_LOG_INFO;
 s3_fatal_log_handler s3_fatal_handler;
 
+void s3_log_write(int loglevel, const char *file, int line, const char *msg) {
+  S3AsyncLog *async_log = S3AsyncLog::get_instance();
+
+  if (!async_log || !async_log->write(loglevel, file, line, msg)) {
+    S3AsyncLog::write_record(loglevel, file, line, msg, strlen(msg));
+  }
+}
+
 int init_log(char *process_name) {
   S3Option *option_instance = S3Option::get_instance();
 
@@ -86,6 +97,15 @@ int init_log(char *process_name) {
   return 0;
 }
 
+void init_async_log() {
+  S3Option *option_instance = S3Option::get_instance();
+
+  if (option_instance->is_log_async_enabled()) {
+    S3AsyncLog::create_instance(
+        (size_t)option_instance->get_log_async_buffer_size_kb() * ONE_KB);
+  }
+}
+
 void redefine_log_level() {
   S3Option *option_instance = S3Option::get_instance();
   if (option_instance->get_log_level() != "") {
@@ -120,6 +140,7 @@ void redefine_log_level() {
 }
 
 void fini_log() {
+  S3AsyncLog::destroy_instance();
   google::FlushLogFiles(google::GLOG_INFO);
   google::ShutdownGoogleLogging();
 
@@ -127,5 +148,10 @@ void fini_log() {
   closelog();
 }
 
-void flushall_log() { google::FlushLogFiles(google::GLOG_INFO); }
+void flushall_log() {
+  if (S3AsyncLog::get_instance()) {
+    S3AsyncLog::get_instance()->flush();
+  }
+  google::FlushLogFiles(google::GLOG_INFO);
+}
 
@@ -51,15 +51,13 @@ inline const char* s3_log_get_req_id(const std::string& requestid) {
   return requestid.empty() ? S3_DEFAULT_REQID : requestid.c_str();
 }
 
-#define s3_log_msg_S3_LOG_DEBUG(p) (LOG(INFO) << (p))
-#define s3_log_msg_S3_LOG_INFO(p) (LOG(INFO) << (p))
-#define s3_log_msg_S3_LOG_WARN(p) (LOG(WARNING) << (p))
-#define s3_log_msg_S3_LOG_ERROR(p) (LOG(ERROR) << (p))
-#define s3_log_msg_S3_LOG_FATAL(p) (LOG(ERROR) << (p))
-
 char* __log_buff();
 size_t __log_buff_sz();
 
+// Hands a formatted message to the log thread, or to glog if there is none
+// or the record cannot be queued. See S3AsyncLog.
+void s3_log_write(int loglevel, const char* file, int line, const char* msg);
+
 // Note:
 // 1. Google glog doesn't have a separate severity level for DEBUG logs.
 //    So we map our DEBUG logs to INFO level. This level promotion happens
@@ -71,7 +69,7 @@ size_t __log_buff_sz();
     if (loglevel >= s3log_level) {                                          \
       snprintf(__log_buff(), __log_buff_sz(), "[%s] [ReqID: %s] " fmt "\n", \
                __func__, s3_log_get_req_id(requestid), ##__VA_ARGS__);      \
-      s3_log_msg_##loglevel(__log_buff());                                  \
+      s3_log_write(loglevel, __FILE__, __LINE__, __log_buff());             \
     }                                                                       \
     if (loglevel >= S3_LOG_FATAL) {                                         \
       s3_fatal_handler(1);                                                  \
@@ -105,6 +103,8 @@ static inline std::string s3_get_timestamp() {
 }
 
 int init_log(char *process_name);
+// Starts the log thread if enabled, call once the process has daemonized
+void init_async_log();
 void redefine_log_level();
 void fini_log();
 void flushall_log();
@@ -18,11 +18,20 @@
  *
  */
 
+#include <inttypes.h>
+#include <sched.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
 #include "s3_mem_pool_manager.h"
 
+#define SYSFS_NODE_PATH "/sys/devices/system/node/"
+
 S3MempoolManager *S3MempoolManager::instance = NULL;
 
-size_t S3MempoolManager::free_space = 0;
+std::atomic<size_t> S3MempoolManager::free_space(0);
 
 extern "C" size_t mem_get_free_space_func() {
   return S3MempoolManager::free_space;
@@ -52,12 +61,83 @@ extern "C" void mempool_log_msg_func(int mempool_log_level, const char *msg) {
   }
 }
 
+// Parse sysfs cpu/node list format, e.g. "0-3,8,10-11"
+static std::vector<int> parse_sysfs_id_list(const std::string &list) {
+  std::vector<int> ids;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    int first = 0, last = 0;
+    size_t dash = range.find('-');
+    try {
+      first = std::stoi(range.substr(0, dash));
+      last = (dash == std::string::npos) ? first
+                                         : std::stoi(range.substr(dash + 1));
+    }
+    catch (const std::exception &) {
+      continue;
+    }
+    for (int id = first; id <= last; ++id) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+static std::string read_sysfs_line(const std::string &path) {
+  std::ifstream file(path);
+  std::string line;
+  if (file.is_open()) {
+    std::getline(file, line);
+  }
+  return line;
+}
+
 S3MempoolManager::S3MempoolManager(size_t max_mem)
-    : total_memory_threshold(max_mem) {}
+    : numa_nodes(1), total_memory_threshold(max_mem) {}
+
+void S3MempoolManager::discover_numa_topology() {
+  std::vector<int> nodes =
+      parse_sysfs_id_list(read_sysfs_line(SYSFS_NODE_PATH "online"));
+  if (nodes.size() <= 1) {
+    s3_log(S3_LOG_INFO, "", "Single NUMA node, NUMA aware pools not needed\n");
+    return;
+  }
+  for (int node : nodes) {
+    std::vector<int> cpus = parse_sysfs_id_list(read_sysfs_line(
+        SYSFS_NODE_PATH "node" + std::to_string(node) + "/cpulist"));
+    for (int cpu : cpus) {
+      if (cpu >= (int)cpu_to_node.size()) {
+        cpu_to_node.resize(cpu + 1, 0);
+      }
+      cpu_to_node[cpu] = node;
+    }
+    if (node + 1 > numa_nodes) {
+      numa_nodes = node + 1;
+    }
+  }
+  s3_log(S3_LOG_INFO, "", "NUMA aware memory pools across %d nodes\n",
+         numa_nodes);
+}
+
+int S3MempoolManager::current_numa_node() const {
+  if (numa_nodes == 1) {
+    return 0;
+  }
+  int cpu = sched_getcpu();
+  if (cpu < 0 || cpu >= (int)cpu_to_node.size()) {
+    return 0;
+  }
+  return cpu_to_node[cpu];
+}
 
 int S3MempoolManager::initialize(std::vector<int> unit_sizes,
                                  int initial_buffer_count_per_pool,
-                                 size_t expandable_count, int flags) {
+                                 size_t expandable_count, int flags,
+                                 bool numa_aware) {
   s3_log(S3_LOG_DEBUG, "",
          "initial_buffer_count_per_pool = %d, expandable_count = %zu",
          initial_buffer_count_per_pool, expandable_count);
@@ -65,53 +145,76 @@ int S3MempoolManager::initialize(std::vector<int> unit_sizes,
   // creation will allocate memory and reduce S3MempoolManager::free_space
   S3MempoolManager::free_space = total_memory_threshold;
 
+  if (numa_aware) {
+    discover_numa_topology();
+  }
+  node_stats.reset(new S3MempoolNumaNodeStats[numa_nodes]);
+  // Preallocation is split between nodes, so memory use matches the
+  // non NUMA aware setup
+  int initial_buffer_count_per_node =
+      (initial_buffer_count_per_pool + numa_nodes - 1) / numa_nodes;
+
   for (auto unit_size : unit_sizes) {
-    MemoryPoolHandle handle;
-    s3_log(S3_LOG_INFO, "", "mem pool for size = %d\n", unit_size);
-
-    int rc = mempool_create_with_shared_mem(
-        unit_size, initial_buffer_count_per_pool * unit_size,
-        expandable_count * unit_size, mem_get_free_space_func,
-        mem_mark_used_space_func, mem_mark_free_space_func,
-        mempool_log_msg_func, flags, &handle);
-
-    if (rc != 0) {
-      s3_log(S3_LOG_ERROR, "", "FATAL: Memory pool creation failed!\n");
-      if (rc == S3_MEMPOOL_THRESHOLD_EXCEEDED) {
-        s3_log(S3_LOG_ERROR, "",
-               "Pool allocation crossing current threshold value %zu, increase "
-               "threshold value (S3_MOTR_READ_POOL_MAX_THRESHOLD) or "
-               "decrease pool allocation size "
-               "(S3_MOTR_READ_POOL_INITIAL_BUFFER_COUNT) \n",
-               mem_get_free_space_func());
+    for (int node = 0; node < numa_nodes; ++node) {
+      MemoryPoolHandle handle;
+      s3_log(S3_LOG_INFO, "", "mem pool for size = %d, NUMA node = %d\n",
+             unit_size, node);
+
+      // Buffers carry their home node pool in a trailer, so release does
+      // not need to look it up
+      int rc = mempool_create_with_shared_mem(
+          unit_size, initial_buffer_count_per_node * unit_size,
+          expandable_count * unit_size, mem_get_free_space_func,
+          mem_mark_used_space_func, mem_mark_free_space_func,
+          mempool_log_msg_func,
+          numa_nodes > 1 ? flags | ENABLE_BUFFER_OWNER : flags, &handle);
+
+      if (rc != 0) {
+        s3_log(S3_LOG_ERROR, "", "FATAL: Memory pool creation failed!\n");
+        if (rc == S3_MEMPOOL_THRESHOLD_EXCEEDED) {
+          s3_log(S3_LOG_ERROR, "",
+                 "Pool allocation crossing current threshold value %zu, "
+                 "increase threshold value (S3_MOTR_READ_POOL_MAX_THRESHOLD) "
+                 "or decrease pool allocation size "
+                 "(S3_MOTR_READ_POOL_INITIAL_BUFFER_COUNT) \n",
+                 mem_get_free_space_func());
+        }
+        return rc;
+      }
+      pool_of_mem_pool[unit_size].push_back(handle);
+      if (numa_nodes > 1) {
+        mempool_set_numa_node(handle, node);
       }
-      return rc;
-    }
-    pool_of_mem_pool[unit_size] = handle;
 
-    struct pool_info poolinfo = {0};
-    mempool_getinfo(handle, &poolinfo);
-    s3_log(S3_LOG_DEBUG, "", "Created pool with [[ \n");
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.mempool_item_size = %zu\n",
-           poolinfo.mempool_item_size);
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.free_bufs_in_pool = %d\n",
-           poolinfo.free_bufs_in_pool);
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.number_of_bufs_shared = %d\n",
-           poolinfo.number_of_bufs_shared);
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.expandable_size = %zu\n",
-           poolinfo.expandable_size);
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.total_bufs_allocated_by_pool = %d\n",
-           poolinfo.total_bufs_allocated_by_pool);
-    s3_log(S3_LOG_DEBUG, "", "poolinfo.flags = %d ]]\n", poolinfo.flags);
+      struct pool_info poolinfo = {0};
+      mempool_getinfo(handle, &poolinfo);
+      s3_log(S3_LOG_DEBUG, "", "Created pool with [[ \n");
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.mempool_item_size = %zu\n",
+             poolinfo.mempool_item_size);
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.free_bufs_in_pool = %d\n",
+             poolinfo.free_bufs_in_pool);
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.number_of_bufs_shared = %d\n",
+             poolinfo.number_of_bufs_shared);
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.expandable_size = %zu\n",
+             poolinfo.expandable_size);
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.total_bufs_allocated_by_pool = %d\n",
+             poolinfo.total_bufs_allocated_by_pool);
+      s3_log(S3_LOG_DEBUG, "", "poolinfo.flags = %d ]]\n", poolinfo.flags);
+    }
   }
   return 0;
 }
 
 void S3MempoolManager::free_pools() {
+  if (numa_nodes > 1) {
+    log_numa_node_stats();
+  }
   for (auto &mem_pool : pool_of_mem_pool) {
     s3_log(S3_LOG_DEBUG, "", "Freeing memory pool for unit_size = %zu.\n",
            mem_pool.first);
-    mempool_destroy(&(mem_pool.second));
+    for (auto &handle : mem_pool.second) {
+      mempool_destroy(&handle);
+    }
     s3_log(S3_LOG_DEBUG, "",
            "Free memory pool successful for unit_size = %zu.\n",
            mem_pool.first);
@@ -125,11 +228,18 @@ void *S3MempoolManager::get_buffer_for_unit_size(size_t unit_size) {
          unit_size);
   auto item = pool_of_mem_pool.find(unit_size);
   if (item != pool_of_mem_pool.end()) {
-    // We have required memory pool.
-    MemoryPoolHandle handle = item->second;
+    // We have required memory pools, prefer the caller's NUMA node.
+    std::vector<MemoryPoolHandle> &node_pools = item->second;
+    int node = current_numa_node();
     int max_retries = 3;
     while (max_retries > 0) {
-      void *buffer = (void *)mempool_getbuffer(handle, unit_size);
+      int served_by = node;
+      void *buffer = (void *)mempool_getbuffer(node_pools[node], unit_size);
+      // Local node cannot grow, remote memory is better than none
+      for (int i = 1; buffer == NULL && i < numa_nodes; ++i) {
+        served_by = (node + i) % numa_nodes;
+        buffer = (void *)mempool_getbuffer(node_pools[served_by], unit_size);
+      }
       // If buffer is NULL, check if other pool can release some memory
       if (buffer == NULL) {
         s3_log(S3_LOG_WARN, "", "Allocation error for unit_size[%zu]\n",
@@ -142,6 +252,12 @@ void *S3MempoolManager::get_buffer_for_unit_size(size_t unit_size) {
           break;
         }
       }
+      if (served_by == node) {
+        node_stats[node].local_allocs.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        node_stats[served_by].remote_allocs.fetch_add(
+            1, std::memory_order_relaxed);
+      }
       return buffer;
     }
   }
@@ -159,8 +275,17 @@ int S3MempoolManager::release_buffer_for_unit_size(void *buf,
   if (item != pool_of_mem_pool.end()) {
     s3_log(S3_LOG_DEBUG, "",
            "Found pool for unit_size[%zu] to release memory\n", unit_size);
-    // We have required memory pool.
-    MemoryPoolHandle handle = item->second;
+    // We have required memory pool, buffer goes back to its home node.
+    int home_node = 0;
+    if (numa_nodes > 1) {
+      int node = current_numa_node();
+      home_node = mempool_buffer_numa_node(buf, unit_size);
+      if (home_node != node) {
+        node_stats[home_node].remote_releases.fetch_add(
+            1, std::memory_order_relaxed);
+      }
+    }
+    MemoryPoolHandle handle = item->second[home_node];
     int retn = mempool_releasebuffer(handle, buf, unit_size);
     const char *log_memool_stats =
         "S3 Mempool stats during release:"
@@ -186,11 +311,14 @@ int S3MempoolManager::release_buffer_for_unit_size(void *buf,
 size_t S3MempoolManager::get_free_space_for(size_t unit_size) {
   auto item = pool_of_mem_pool.find(unit_size);
   if (item != pool_of_mem_pool.end()) {
-    // We have required memory pool.
-    MemoryPoolHandle handle = item->second;
-    size_t free_bytes = 0;
-    mempool_reserved_space(handle, &free_bytes);
-    return free_bytes + S3MempoolManager::free_space;
+    // We have required memory pools, free space is across all nodes.
+    size_t total_free_bytes = 0;
+    for (auto handle : item->second) {
+      size_t free_bytes = 0;
+      mempool_reserved_space(handle, &free_bytes);
+      total_free_bytes += free_bytes;
+    }
+    return total_free_bytes + S3MempoolManager::free_space;
   }
   return 0;
 }
@@ -201,10 +329,12 @@ bool S3MempoolManager::free_any_unused() {
 
   // Find free space in all mem pools
   for (auto &mem_pool : pool_of_mem_pool) {
-    size_t free_bytes = 0;
-    mempool_reserved_space(mem_pool.second, &free_bytes);
-    if (free_bytes > 0) {
-      free_space_map[free_bytes] = mem_pool.second;
+    for (auto handle : mem_pool.second) {
+      size_t free_bytes = 0;
+      mempool_reserved_space(handle, &free_bytes);
+      if (free_bytes > 0) {
+        free_space_map[free_bytes] = handle;
+      }
     }
   }
 
@@ -230,3 +360,24 @@ bool S3MempoolManager::free_any_unused() {
     }
   }
 }
+
+void S3MempoolManager::log_numa_node_stats() {
+  for (int node = 0; node < numa_nodes; ++node) {
+    s3_log(S3_LOG_INFO, "S3_Mempool_Stats",
+           "NUMA node %d: local_allocs = %" PRIu64 " remote_allocs = %" PRIu64
+           " remote_releases = %" PRIu64 "\n",
+           node, node_stats[node].local_allocs.load(),
+           node_stats[node].remote_allocs.load(),
+           node_stats[node].remote_releases.load());
+    for (auto &mem_pool : pool_of_mem_pool) {
+      struct pool_info poolinfo = {0};
+      mempool_getinfo(mem_pool.second[node], &poolinfo);
+      s3_log(S3_LOG_INFO, "S3_Mempool_Stats",
+             "NUMA node %d unit_size %zu: free_bufs_in_pool = %d "
+             "number_of_bufs_shared = %d total_bufs_allocated_by_pool = %d\n",
+             node, mem_pool.first, poolinfo.free_bufs_in_pool,
+             poolinfo.number_of_bufs_shared,
+             poolinfo.total_bufs_allocated_by_pool);
+    }
+  }
+}
@@ -23,7 +23,10 @@
 #ifndef __S3_SERVER_S3_MEM_POOL_MANAGER_H__
 #define __S3_SERVER_S3_MEM_POOL_MANAGER_H__
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <gtest/gtest_prod.h>
@@ -31,10 +34,29 @@
 #include "s3_log.h"
 #include "s3_memory_pool.h"
 
+// Per NUMA node buffer traffic counters
+struct S3MempoolNumaNodeStats {
+  // Buffers served from this node's pool to a thread running on this node
+  std::atomic<uint64_t> local_allocs{0};
+  // Buffers served from this node's pool to a thread on another node,
+  // i.e. the caller's own node pool was exhausted
+  std::atomic<uint64_t> remote_allocs{0};
+  // Buffers of this node released by a thread running on another node
+  std::atomic<uint64_t> remote_releases{0};
+};
+
 // Pool of memory pools specifically for use of different unit_size buffers
+// When NUMA aware, there is one memory pool per NUMA node for each unit_size,
+// buffers are served from the caller's node and returned to their home node.
 class S3MempoolManager {
-  // map<unit_size, memory_pool_for_unit_size>
-  std::map<size_t, MemoryPoolHandle> pool_of_mem_pool;
+  // map<unit_size, memory_pool_for_unit_size indexed by NUMA node>
+  std::map<size_t, std::vector<MemoryPoolHandle>> pool_of_mem_pool;
+
+  // Number of NUMA nodes pools are split across, 1 when not NUMA aware
+  int numa_nodes;
+  // cpu id -> NUMA node id
+  std::vector<int> cpu_to_node;
+  std::unique_ptr<S3MempoolNumaNodeStats[]> node_stats;
 
   // map<unit_size, last_used_timestamp>
   std::map<size_t, size_t> last_used_timestamp;
@@ -49,7 +71,12 @@ class S3MempoolManager {
   S3MempoolManager(size_t max_mem);
 
   int initialize(std::vector<int> unit_sizes, int initial_buffer_count_per_pool,
-                 size_t expandable_count, int flags);
+                 size_t expandable_count, int flags, bool numa_aware);
+
+  // Discover NUMA nodes and cpu -> node mapping from sysfs
+  void discover_numa_topology();
+  // NUMA node of the calling thread's current cpu
+  int current_numa_node() const;
 
   // Free up all the memory pools help by this pool
   void free_pools();
@@ -57,7 +84,9 @@ class S3MempoolManager {
  public:
   // initially equal to total_memory_threshold
   // static so C callback passed to mempool can access this
-  static size_t free_space;
+  // atomic as pools of different unit_size/node update it under their own
+  // locks
+  static std::atomic<size_t> free_space;
 
   //  Return the buffer of give unit_size
   // For flags see mempool_getbuffer() in s3_memory_pool.h header
@@ -73,15 +102,28 @@ class S3MempoolManager {
   // Returns true if space was free'ed in any pool, false if it cannot be
   bool free_any_unused();
 
+  int get_numa_nodes() const { return numa_nodes; }
+
+  // Per node stats, numa_node in [0, get_numa_nodes())
+  const S3MempoolNumaNodeStats& get_numa_node_stats(int numa_node) const {
+    return node_stats[numa_node];
+  }
+
+  // Log per node stats and pool usage
+  void log_numa_node_stats();
+
   // Creates a pool to support various given unit_sizes and maximum threshold
+  // numa_aware: create one pool per NUMA node for each unit_size, the
+  // initial buffer count is then split between nodes
   static int create_pool(size_t max_mem, std::vector<int> unit_sizes,
                          int initial_buffer_count_per_pool,
-                         size_t expandable_count, int flags = 0) {
+                         size_t expandable_count, int flags = 0,
+                         bool numa_aware = false) {
     if (!instance) {
       instance = new S3MempoolManager(max_mem);
       S3MempoolManager::free_space = max_mem;
       int rc = instance->initialize(unit_sizes, initial_buffer_count_per_pool,
-                                    expandable_count, flags);
+                                    expandable_count, flags, numa_aware);
       if (rc != 0) {
         S3MempoolManager::destroy_instance();
       }
@@ -112,6 +154,7 @@ class S3MempoolManager {
   FRIEND_TEST(S3MempoolManagerTestSuite, CreateEXISTSTest);
   FRIEND_TEST(S3MempoolManagerTestSuite, PoolShouldGrowAndErrorOnMax);
   FRIEND_TEST(S3MempoolManagerTestSuite, PoolShouldGrowByDownsizingUnusedPool);
+  FRIEND_TEST(S3MempoolManagerTestSuite, NumaAwarePoolPerNode);
 };
 
 #endif
@@ -22,6 +22,7 @@
 
 #include "s3_motr_layout.h"
 #include "s3_log.h"
+#include "s3_mem_pool_manager.h"
 #include "s3_memory_pool.h"
 #include "s3_memory_profile.h"
 #include "s3_option.h"
@@ -29,8 +30,14 @@
 extern S3Option* g_option_instance;
 
 size_t S3MemoryProfile::memory_per_put_request(int layout_id) {
-  return g_option_instance->get_motr_write_payload_size(layout_id) *
-         g_option_instance->get_read_ahead_multiple();
+  // Every write in flight beyond the first pins one more payload worth of
+  // buffers on top of the read ahead.
+  size_t window = g_option_instance->get_motr_write_window();
+  size_t payloads = g_option_instance->get_read_ahead_multiple();
+  if (window > 1) {
+    payloads += window - 1;
+  }
+  return g_option_instance->get_motr_write_payload_size(layout_id) * payloads;
 }
 
 bool S3MemoryProfile::we_have_enough_memory_for_put_obj(int layout_id) {
@@ -112,3 +119,26 @@ bool S3MemoryProfile::free_memory_in_pool_above_threshold_limits() {
   return true;
 }
 
+
+bool S3MemoryProfile::free_memory_in_motr_read_pool_for_get_obj(
+    size_t read_size) {
+#ifdef S3_GOOGLE_TEST
+  return true;
+#endif
+  S3MempoolManager* mempool_manager = S3MempoolManager::get_instance();
+  if (mempool_manager == nullptr) {
+    return true;
+  }
+  size_t free_space_in_motr_read_pool = mempool_manager->get_free_space_for(
+      g_option_instance->get_libevent_pool_buffer_size());
+  s3_log(S3_LOG_DEBUG, "", "free_space_in_motr_read_pool = %zu\n",
+         free_space_in_motr_read_pool);
+  if (free_space_in_motr_read_pool < read_size) {
+    s3_log(S3_LOG_WARN, "",
+           "Free space in motr read mempool (%zu) is less than next GET read "
+           "size (%zu)\n",
+           free_space_in_motr_read_pool, read_size);
+    return false;
+  }
+  return true;
+}
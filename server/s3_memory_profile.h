@@ -33,6 +33,10 @@ class S3MemoryProfile {
   // blocked by less used unit_size, so we cannot get accurate estimate
   virtual bool we_have_enough_memory_for_put_obj(int layout_id);
   virtual bool free_memory_in_pool_above_threshold_limits();
+  // With S3_MOTR_READ_ZERO_COPY, GET response data sits in motr read pool
+  // buffers until libevent has written it out. Returns true if that pool can
+  // still take a read of read_size bytes.
+  virtual bool free_memory_in_motr_read_pool_for_get_obj(size_t read_size);
 };
 
 #endif
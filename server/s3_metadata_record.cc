@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "base64.h"
+#include "s3_log.h"
+#include "s3_metadata_record.h"
+#include "s3_option.h"
+
+namespace {
+
+enum ValueType : unsigned char {
+  TYPE_NULL = 0,
+  TYPE_FALSE,
+  TYPE_TRUE,
+  TYPE_INT,
+  TYPE_UINT,
+  TYPE_STRING,
+  TYPE_BASE64,
+  TYPE_OBJECT
+};
+
+// Records nest System-Defined and similar objects one level deep
+const unsigned max_depth = 8;
+
+struct KnownKey {
+  const char* name;
+  // Value is a base64 string, stored decoded
+  bool f_base64;
+};
+
+// Index of the key in a record is its position here + 1. Append only.
+const KnownKey known_keys[] = {
+    {"Bucket-Name", false},
+    {"Object-Name", false},
+    {"Object-URI", false},
+    {"layout_id", false},
+    {"Upload-ID", false},
+    {"motr_part_layout", true},
+    {"motr_old_oid", false},
+    {"old_layout_id", false},
+    {"motr_old_object_version_id", false},
+    {"motr_oid", false},
+    {"PVID", true},
+    {"System-Defined", false},
+    {"User-Defined", false},
+    {"User-Defined-Tags", false},
+    {"ACL", true},
+    {"create_timestamp", false},
+    {"Part-Num", false},
+    {"Policy", true},
+    {"motr_object_list_index_layout", true},
+    {"motr_multipart_index_layout", true},
+    {"extended_metadata_index_layout", true},
+    {"motr_objects_version_list_index_layout", true},
+    {"Content-Length", false},
+    {"Content-MD5", false},
+    {"Content-Type", false},
+    {"Date", false},
+    {"Last-Modified", false},
+    {"Owner-User", false},
+    {"Owner-User-id", false},
+    {"Owner-Account", false},
+    {"Owner-Account-id", false},
+    {"Owner-Canonical-id", false},
+    {"x-amz-version-id", false},
+    {"x-amz-storage-class", false},
+    {"Part-One-Size", false},
+    {"LocationConstraint", false},
+    {"x-amz-website-redirect-location", false},
+    {"x-amz-server-side-encryption", false},
+    {"x-amz-server-side-encryption-aws-kms-key-id", false},
+    {"x-amz-server-side-encryption-customer-algorithm", false},
+    {"x-amz-server-side-encryption-customer-key", false},
+    {"x-amz-server-side-encryption-customer-key-MD5", false},
+    {"inline_data", true},
+    {"motr_copy_oid", false}};
+
+const size_t n_known_keys = sizeof(known_keys) / sizeof(known_keys[0]);
+
+const std::unordered_map<std::string, size_t>& get_known_key_index() {
+  static const std::unordered_map<std::string, size_t> known_key_index = [] {
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < n_known_keys; ++i) {
+      index[known_keys[i].name] = i + 1;
+    }
+    return index;
+  }();
+  return known_key_index;
+}
+
+void put_varint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out += (char)(value | 0x80);
+    value >>= 7;
+  }
+  out += (char)value;
+}
+
+void put_string(std::string& out, const std::string& str) {
+  put_varint(out, str.length());
+  out += str;
+}
+
+bool encode_object(const Json::Value& object, unsigned depth,
+                   std::string& out);
+
+bool encode_value(const Json::Value& value, bool f_base64, unsigned depth,
+                  std::string& out) {
+  switch (value.type()) {
+    case Json::nullValue:
+      out += (char)TYPE_NULL;
+      return true;
+    case Json::booleanValue:
+      out += (char)(value.asBool() ? TYPE_TRUE : TYPE_FALSE);
+      return true;
+    case Json::intValue: {
+      const int64_t n = value.asInt64();
+      out += (char)TYPE_INT;
+      put_varint(out, ((uint64_t)n << 1) ^ (uint64_t)(n >> 63));
+      return true;
+    }
+    case Json::uintValue:
+      out += (char)TYPE_UINT;
+      put_varint(out, value.asUInt64());
+      return true;
+    case Json::stringValue: {
+      const std::string str = value.asString();
+      if (f_base64) {
+        std::string decoded = base64_decode(str);
+        // Only canonical encoding can be restored exactly
+        if (base64_encode((const unsigned char*)decoded.c_str(),
+                          decoded.length()) == str) {
+          out += (char)TYPE_BASE64;
+          put_string(out, decoded);
+          return true;
+        }
+      }
+      out += (char)TYPE_STRING;
+      put_string(out, str);
+      return true;
+    }
+    case Json::objectValue:
+      out += (char)TYPE_OBJECT;
+      return encode_object(value, depth + 1, out);
+    default:
+      return false;
+  }
+}
+
+bool encode_object(const Json::Value& object, unsigned depth,
+                   std::string& out) {
+  if (depth > max_depth) {
+    return false;
+  }
+  const auto& known_key_index = get_known_key_index();
+  const Json::Value::Members members = object.getMemberNames();
+
+  put_varint(out, members.size());
+  for (const auto& key : members) {
+    auto it = known_key_index.find(key);
+    bool f_base64 = false;
+
+    if (it != known_key_index.end()) {
+      put_varint(out, it->second);
+      f_base64 = known_keys[it->second - 1].f_base64;
+    } else {
+      put_varint(out, 0);
+      put_string(out, key);
+    }
+    if (!encode_value(object[key], f_base64, depth, out)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class RecordReader {
+  const char* p_cur;
+  const char* const p_end;
+
+ public:
+  RecordReader(const char* p_begin, const char* p_end)
+      : p_cur(p_begin), p_end(p_end) {}
+
+  bool at_end() const { return p_cur == p_end; }
+
+  bool get_byte(unsigned char& byte) {
+    if (p_cur == p_end) {
+      return false;
+    }
+    byte = (unsigned char)*p_cur++;
+    return true;
+  }
+
+  bool get_varint(uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      unsigned char byte;
+      if (!get_byte(byte)) {
+        return false;
+      }
+      value |= (uint64_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool get_string(std::string& str) {
+    uint64_t len;
+    if (!get_varint(len) || len > (uint64_t)(p_end - p_cur)) {
+      return false;
+    }
+    str.assign(p_cur, len);
+    p_cur += len;
+    return true;
+  }
+
+  bool skip_string() {
+    uint64_t len;
+    if (!get_varint(len) || len > (uint64_t)(p_end - p_cur)) {
+      return false;
+    }
+    p_cur += len;
+    return true;
+  }
+
+  bool get_object(unsigned depth, Json::Value& object);
+  bool get_value(unsigned depth, Json::Value& value);
+
+  bool read_fields(unsigned depth, const std::string* p_object_key,
+                   const S3MetadataRecord::FieldSelector& select);
+  bool get_value_as_string(unsigned char type, std::string& str);
+  bool skip_value(unsigned char type);
+};
+
+bool RecordReader::get_object(unsigned depth, Json::Value& object) {
+  uint64_t n_members;
+  if (depth > max_depth || !get_varint(n_members)) {
+    return false;
+  }
+  object = Json::Value(Json::objectValue);
+  std::string key;
+
+  for (uint64_t i = 0; i < n_members; ++i) {
+    uint64_t key_idx;
+    if (!get_varint(key_idx)) {
+      return false;
+    }
+    if (key_idx > n_known_keys) {
+      // Written by a newer version with a longer key table
+      return false;
+    }
+    if (key_idx) {
+      key = known_keys[key_idx - 1].name;
+    } else if (!get_string(key)) {
+      return false;
+    }
+    if (!get_value(depth, object[key])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RecordReader::get_value(unsigned depth, Json::Value& value) {
+  unsigned char type;
+  if (!get_byte(type)) {
+    return false;
+  }
+  uint64_t n;
+  std::string str;
+
+  switch (type) {
+    case TYPE_NULL:
+      value = Json::Value();
+      return true;
+    case TYPE_FALSE:
+    case TYPE_TRUE:
+      value = (type == TYPE_TRUE);
+      return true;
+    case TYPE_INT:
+      if (!get_varint(n)) {
+        return false;
+      }
+      value = (Json::Int64)((n >> 1) ^ (~(n & 1) + 1));
+      return true;
+    case TYPE_UINT:
+      if (!get_varint(n)) {
+        return false;
+      }
+      value = (Json::UInt64)n;
+      return true;
+    case TYPE_STRING:
+      if (!get_string(str)) {
+        return false;
+      }
+      value = str;
+      return true;
+    case TYPE_BASE64:
+      if (!get_string(str)) {
+        return false;
+      }
+      value = base64_encode((const unsigned char*)str.c_str(), str.length());
+      return true;
+    case TYPE_OBJECT:
+      return get_object(depth + 1, value);
+  }
+  return false;
+}
+
+bool RecordReader::read_fields(unsigned depth, const std::string* p_object_key,
+                               const S3MetadataRecord::FieldSelector& select) {
+  uint64_t n_members;
+  if (depth > max_depth || !get_varint(n_members)) {
+    return false;
+  }
+  std::string key;
+
+  for (uint64_t i = 0; i < n_members; ++i) {
+    uint64_t key_idx;
+    if (!get_varint(key_idx) || key_idx > n_known_keys) {
+      return false;
+    }
+    if (key_idx) {
+      key = known_keys[key_idx - 1].name;
+    } else if (!get_string(key)) {
+      return false;
+    }
+    unsigned char type;
+    if (!get_byte(type)) {
+      return false;
+    }
+    if (type == TYPE_OBJECT) {
+      if (!read_fields(depth + 1, &key, select)) {
+        return false;
+      }
+      continue;
+    }
+    std::string* p_value = select(p_object_key, key);
+    if (!(p_value ? get_value_as_string(type, *p_value) : skip_value(type))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RecordReader::get_value_as_string(unsigned char type, std::string& str) {
+  uint64_t n;
+
+  switch (type) {
+    case TYPE_NULL:
+      str.clear();
+      return true;
+    case TYPE_FALSE:
+      str = "false";
+      return true;
+    case TYPE_TRUE:
+      str = "true";
+      return true;
+    case TYPE_INT:
+      if (!get_varint(n)) {
+        return false;
+      }
+      str = std::to_string((int64_t)((n >> 1) ^ (~(n & 1) + 1)));
+      return true;
+    case TYPE_UINT:
+      if (!get_varint(n)) {
+        return false;
+      }
+      str = std::to_string(n);
+      return true;
+    case TYPE_STRING:
+      return get_string(str);
+    case TYPE_BASE64:
+      if (!get_string(str)) {
+        return false;
+      }
+      str = base64_encode((const unsigned char*)str.c_str(), str.length());
+      return true;
+  }
+  return false;
+}
+
+bool RecordReader::skip_value(unsigned char type) {
+  uint64_t n;
+
+  switch (type) {
+    case TYPE_NULL:
+    case TYPE_FALSE:
+    case TYPE_TRUE:
+      return true;
+    case TYPE_INT:
+    case TYPE_UINT:
+      return get_varint(n);
+    case TYPE_STRING:
+    case TYPE_BASE64:
+      return skip_string();
+  }
+  return false;
+}
+
+}  // namespace
+
+bool S3MetadataRecord::is_binary(const std::string& record) {
+  return !record.empty() && (unsigned char)record[0] == format_tag_v1;
+}
+
+bool S3MetadataRecord::encode(const Json::Value& root, std::string& record) {
+  record.clear();
+  if (!root.isObject()) {
+    return false;
+  }
+  record += (char)format_tag_v1;
+  return encode_object(root, 0, record);
+}
+
+bool S3MetadataRecord::decode(const std::string& record, Json::Value& root) {
+  if (!is_binary(record)) {
+    return false;
+  }
+  RecordReader reader(record.data() + 1, record.data() + record.length());
+  return reader.get_object(0, root) && reader.at_end();
+}
+
+bool S3MetadataRecord::read_fields(const std::string& record,
+                                   const FieldSelector& select) {
+  if (!is_binary(record)) {
+    return false;
+  }
+  RecordReader reader(record.data() + 1, record.data() + record.length());
+  return reader.read_fields(0, nullptr, select) && reader.at_end();
+}
+
+std::string S3MetadataRecord::serialize(const Json::Value& root) {
+  if (S3Option::get_instance()->is_metadata_binary_format_enabled()) {
+    std::string record;
+    if (encode(root, record)) {
+      return record;
+    }
+    s3_log(S3_LOG_WARN, "", "Metadata can't be encoded, writing JSON\n");
+  }
+  Json::FastWriter fastWriter;
+  return fastWriter.write(root);
+}
+
+bool S3MetadataRecord::parse(const std::string& record, Json::Value& root) {
+  if (is_binary(record)) {
+    return decode(record, root);
+  }
+  Json::Reader reader;
+  return reader.parse(record.c_str(), root);
+}
+
+std::string S3MetadataRecord::to_json(const std::string& record) {
+  Json::Value root;
+
+  // Motr KV API can also store values which only look like binary records
+  if (!is_binary(record) || !decode(record, root)) {
+    return record;
+  }
+  Json::FastWriter fastWriter;
+  return fastWriter.write(root);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_METADATA_RECORD_H__
+#define __S3_SERVER_S3_METADATA_RECORD_H__
+
+#include <functional>
+#include <string>
+
+#include <json/json.h>
+
+// Compact binary encoding of metadata records kept in Motr indices: object,
+// part and bucket metadata, and object version entries.
+//
+// Binary record starts with a format tag byte, which can't start JSON text,
+// so records written as JSON before the binary format was enabled stay
+// readable. They are converted when saved next time, there is no separate
+// migration pass. Clients of Motr KV API (e.g. s3backgrounddelete) always
+// get JSON, see to_json().
+//
+// The tag is followed by the root object. Object is a varint count of
+// members, member is a key and a typed value. Key is a varint index (> 0) in
+// the table of well-known key names, or 0 followed by the key as a string.
+// String is a varint length and the bytes. Values are null, bool, integer
+// (zigzag varint), unsigned (varint), string, object, and base64 string
+// stored decoded (ACL, policy, index layouts). The key table is part of the
+// format, new names may only be appended to it.
+class S3MetadataRecord {
+ public:
+  // Tag of format version 1, a UTF-8 continuation byte
+  static const unsigned char format_tag_v1 = 0xB1;
+
+  static bool is_binary(const std::string& record);
+
+  // Fails if the tree has values of other types than listed above, i.e.
+  // arrays or doubles
+  static bool encode(const Json::Value& root, std::string& record);
+  static bool decode(const std::string& record, Json::Value& root);
+
+  // Called for each non-object value of a binary record, p_object_key is
+  // nullptr for members of the root object. Returns where to store the value
+  // as a string (like Json::Value::asString()), or nullptr to skip it.
+  typedef std::function<std::string*(const std::string* p_object_key,
+                                     const std::string& key)> FieldSelector;
+
+  // Reads only the values picked by select, without building the tree.
+  // Fails on what decode() fails on.
+  static bool read_fields(const std::string& record,
+                          const FieldSelector& select);
+
+  // Binary record if S3_METADATA_BINARY_FORMAT is enabled, JSON otherwise
+  static std::string serialize(const Json::Value& root);
+  // Parses record in either format
+  static bool parse(const std::string& record, Json::Value& root);
+  // JSON text of the record, values which don't decode as binary records are
+  // returned as is
+  static std::string to_json(const std::string& record);
+};
+
+#endif  // __S3_SERVER_S3_METADATA_RECORD_H__
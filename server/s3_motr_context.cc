@@ -32,6 +32,9 @@ extern std::set<struct s3_motr_idx_context *> global_motr_idx;
 extern std::set<struct s3_motr_obj_context *> global_motr_obj;
 extern int shutdown_motr_teardown_called;
 
+std::mutex global_motr_obj_lists_mutex;
+std::mutex global_motr_idx_lists_mutex;
+
 // Helper methods to free m0_bufvec array which holds
 // Memory buffers from custom memory pool
 static void s3_bufvec_free_aligned(struct m0_bufvec *bufvec, size_t unit_size,
@@ -114,7 +117,7 @@ struct s3_motr_obj_context *create_obj_context(size_t count) {
 
   ctx->objs = (struct m0_obj *)calloc(count, sizeof(struct m0_obj));
   ctx->obj_count = count;
-  global_motr_obj.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_obj, ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return ctx;
 }
@@ -148,7 +151,8 @@ struct s3_motr_op_context *create_basic_op_ctx(size_t op_count) {
 int free_basic_op_ctx(struct s3_motr_op_context *ctx) {
   s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
   if (!shutdown_motr_teardown_called) {
-    global_motr_object_ops_list.erase(ctx);
+    s3_motr_set_erase(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                      ctx);
     for (size_t i = 0; i < ctx->op_count; i++) {
       if (ctx->ops[i] != NULL) {
         teardown_motr_op(ctx->ops[i]);
@@ -307,7 +311,7 @@ struct s3_motr_idx_context *create_idx_context(size_t idx_count) {
       1, sizeof(struct s3_motr_idx_context));
   ctx->idx = (struct m0_idx *)calloc(idx_count, sizeof(struct m0_idx));
   ctx->idx_count = idx_count;
-  global_motr_idx.insert(ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx, ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return ctx;
 }
@@ -338,7 +342,8 @@ struct s3_motr_idx_op_context *create_basic_idx_op_ctx(int op_count) {
 int free_basic_idx_op_ctx(struct s3_motr_idx_op_context *ctx) {
   s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
   if (!shutdown_motr_teardown_called) {
-    global_motr_idx_ops_list.erase(ctx);
+    s3_motr_set_erase(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                      ctx);
 
     for (size_t i = 0; i < ctx->op_count; i++) {
       if (ctx->ops[i] == NULL) {
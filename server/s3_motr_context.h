@@ -25,6 +25,7 @@
 
 #include "s3_common.h"
 #include "s3_log.h"
+#include <mutex>
 #include <set>
 #include <openssl/md5.h>
 
@@ -40,6 +41,27 @@ EXTERN_C_BLOCK_END
 
 #include "s3_memory_pool.h"
 
+// Contexts registered in the global_motr_* sets are torn down by
+// global_motr_teardown() on shutdown. With several reactor threads the sets
+// are updated concurrently, so object side sets (global_motr_obj,
+// global_motr_object_ops_list) are guarded by global_motr_obj_lists_mutex and
+// index side sets (global_motr_idx, global_motr_idx_ops_list) by
+// global_motr_idx_lists_mutex.
+extern std::mutex global_motr_obj_lists_mutex;
+extern std::mutex global_motr_idx_lists_mutex;
+
+template <typename T>
+void s3_motr_set_insert(std::mutex &lock, std::set<T *> &list, T *item) {
+  std::lock_guard<std::mutex> guard(lock);
+  list.insert(item);
+}
+
+template <typename T>
+void s3_motr_set_erase(std::mutex &lock, std::set<T *> &list, T *item) {
+  std::lock_guard<std::mutex> guard(lock);
+  list.erase(item);
+}
+
 struct s3_motr_obj_context {
   struct m0_obj *objs;
   size_t n_initialized_contexts;
@@ -52,7 +52,7 @@ S3MotrKVSReader::~S3MotrKVSReader() { clean_up_contexts(); }
 void S3MotrKVSReader::clean_up_contexts() {
   reader_context = nullptr;
   if (!shutdown_motr_teardown_called) {
-    global_motr_idx.erase(idx_ctx);
+    s3_motr_set_erase(global_motr_idx_lists_mutex, global_motr_idx, idx_ctx);
     if (idx_ctx) {
       for (size_t i = 0; i < idx_ctx->n_initialized_contexts; i++) {
         s3_motr_api->motr_idx_fini(&idx_ctx->idx[i]);
@@ -154,7 +154,8 @@ void S3MotrKVSReader::get_keyval(const struct s3_motr_idx_layout &idx_lo,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::getkv);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return;
 }
@@ -389,7 +390,8 @@ void S3MotrKVSReader::next_keyval(const struct s3_motr_idx_layout &idx_lo,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::getkv);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return;
 }
@@ -72,7 +72,7 @@ void S3MotrKVSWriter::clean_up_contexts() {
   writer_context = nullptr;
   sync_context = nullptr;
   if (!shutdown_motr_teardown_called) {
-    global_motr_idx.erase(idx_ctx);
+    s3_motr_set_erase(global_motr_idx_lists_mutex, global_motr_idx, idx_ctx);
     if (idx_ctx) {
       for (size_t i = 0; i < idx_ctx->n_initialized_contexts; i++) {
         if (shutdown_motr_teardown_called) {
@@ -164,7 +164,8 @@ void S3MotrKVSWriter::create_index_with_oid(
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::createidx);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -356,7 +357,8 @@ void S3MotrKVSWriter::delete_index(const struct s3_motr_idx_layout &idx_lo,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::deleteidx);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -458,7 +460,8 @@ void S3MotrKVSWriter::delete_indices(
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops,
                               ops_count, MotrOpType::deleteidx);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -593,7 +596,8 @@ int S3MotrKVSWriter::put_keyval_impl(
   s3_motr_api->motr_op_launch(
       (is_async ? request->addb_request_id : S3_ADDB_STARTUP_REQUESTS_ID),
       &(idx_op_ctx->ops[0]), 1, MotrOpType::putkv);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   if (!is_async) {
     s3_log(S3_LOG_DEBUG, request_id, "Waiting for motr put KV to complete\n");
     rc = s3_motr_api->motr_op_wait(
@@ -719,7 +723,8 @@ void S3MotrKVSWriter::put_keyval(const struct s3_motr_idx_layout &idx_lo,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::putkv);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -928,7 +933,8 @@ void S3MotrKVSWriter::delete_keyval(const struct s3_motr_idx_layout &idx_lo,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, idx_op_ctx->ops, 1,
                               MotrOpType::deletekv);
-  global_motr_idx_ops_list.insert(idx_op_ctx);
+  s3_motr_set_insert(global_motr_idx_lists_mutex, global_motr_idx_ops_list,
+                     idx_op_ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
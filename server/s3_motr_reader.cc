@@ -56,8 +56,9 @@ void S3MotrReader::clean_up_contexts() {
   // op contexts need to be free'ed before object
   open_context = nullptr;
   reader_context = nullptr;
+  reads_ahead.clear();
   if (!shutdown_motr_teardown_called) {
-    global_motr_obj.erase(obj_ctx);
+    s3_motr_set_erase(global_motr_obj_lists_mutex, global_motr_obj, obj_ctx);
     if (obj_ctx) {
       for (size_t i = 0; i < obj_ctx->n_initialized_contexts; i++) {
         s3_motr_api->motr_obj_fini(&obj_ctx->objs[i]);
@@ -85,7 +86,19 @@ bool S3MotrReader::read_object_data(size_t num_of_blocks,
 
   num_of_blocks_to_read = num_of_blocks;
 
-  if (is_object_opened) {
+  if (!reads_ahead.empty()) {
+    // Already launched by read_ahead_object_data()
+    if (reads_ahead.begin()->second.num_of_blocks != num_of_blocks) {
+      s3_log(S3_LOG_WARN, request_id,
+             "Read ahead of %zu blocks handed out for %zu blocks\n",
+             reads_ahead.begin()->second.num_of_blocks, num_of_blocks);
+    }
+    if (reads_ahead.begin()->second.done) {
+      hand_out_read_ahead();
+    } else {
+      waiting_for_read_ahead = true;
+    }
+  } else if (is_object_opened) {
     rc = read_object();
   } else {
     int retcode =
@@ -177,7 +190,8 @@ int S3MotrReader::open_object(std::function<void(void)> on_success,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, 1,
                               MotrOpType::openobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return rc;
 }
@@ -223,7 +237,6 @@ void S3MotrReader::open_object_failed() {
 }
 
 bool S3MotrReader::read_object() {
-  int rc;
   s3_log(S3_LOG_INFO, stripped_request_id,
          "%s Entry with num_of_blocks_to_read = %zu from last_index = %zu\n",
          __func__, num_of_blocks_to_read, (size_t)last_index);
@@ -233,12 +246,26 @@ bool S3MotrReader::read_object() {
   reader_context.reset(new S3MotrReaderContext(
       request, std::bind(&S3MotrReader::read_object_successful, this),
       std::bind(&S3MotrReader::read_object_failed, this), layout_id));
+  starting_index_for_read = last_index;
+
+  if (!launch_read(reader_context.get(), num_of_blocks_to_read, false)) {
+    return false;
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+  return true;
+}
+
+bool S3MotrReader::launch_read(S3MotrReaderContext *context,
+                               size_t num_of_blocks, bool is_read_ahead) {
+  int rc;
 
   /* Read the requisite number of blocks from the entity */
-  if (!reader_context->init_read_op_ctx(request_id, num_of_blocks_to_read,
-                                        motr_unit_size, &last_index)) {
+  if (!context->init_read_op_ctx(request_id, num_of_blocks, motr_unit_size,
+                                 &last_index)) {
     // out-of-memory
-    state = S3MotrReaderOpState::ooo;
+    if (!is_read_ahead) {
+      state = S3MotrReaderOpState::ooo;
+    }
     s3_log(S3_LOG_ERROR, request_id,
            "S3 API failed: openobj(oid: ("
            "%" SCNx64 " : %" SCNx64 "), out-of-memory)\n",
@@ -246,17 +273,19 @@ bool S3MotrReader::read_object() {
     return false;
   }
 
-  struct s3_motr_op_context *ctx = reader_context->get_motr_op_ctx();
-  struct s3_motr_rw_op_context *rw_ctx = reader_context->get_motr_rw_op_ctx();
-  // Remember, so buffers can be iterated.
-  motr_rw_op_context = rw_ctx;
-  iteration_index = 0;
+  struct s3_motr_op_context *ctx = context->get_motr_op_ctx();
+  struct s3_motr_rw_op_context *rw_ctx = context->get_motr_rw_op_ctx();
+  if (!is_read_ahead) {
+    // Remember, so buffers can be iterated.
+    motr_rw_op_context = rw_ctx;
+    iteration_index = 0;
+  }
 
   struct s3_motr_context_obj *op_ctx = (struct s3_motr_context_obj *)calloc(
       1, sizeof(struct s3_motr_context_obj));
 
   op_ctx->op_index_in_launch = 0;
-  op_ctx->application_context = (void *)reader_context.get();
+  op_ctx->application_context = (void *)context;
 
   ctx->cbs[0].oop_executed = NULL;
   ctx->cbs[0].oop_stable = s3_motr_op_stable;
@@ -276,15 +305,18 @@ bool S3MotrReader::read_object() {
   if (rc != 0) {
     s3_log(S3_LOG_WARN, request_id,
            "Motr API: motr_obj_op failed with error code %d\n", rc);
-    state = S3MotrReaderOpState::failed_to_launch;
+    if (!is_read_ahead) {
+      state = S3MotrReaderOpState::failed_to_launch;
+    }
     s3_motr_op_pre_launch_failure(op_ctx->application_context, rc);
-    return false;
+    // Read ahead failure is reported when it is handed out
+    return is_read_ahead;
   }
 
   ctx->ops[0]->op_datum = (void *)op_ctx;
   s3_motr_api->motr_op_setup(ctx->ops[0], &ctx->cbs[0], 0);
 
-  reader_context->start_timer_for("read_object_data");
+  context->start_timer_for("read_object_data");
 
   s3_log(S3_LOG_INFO, stripped_request_id,
          "Motr API: readobj(operation: M0_OC_READ, oid: ("
@@ -293,11 +325,119 @@ bool S3MotrReader::read_object() {
 
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, 1,
                               MotrOpType::readobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
+  return true;
+}
+
+bool S3MotrReader::read_ahead_object_data(size_t num_of_blocks) {
+  s3_log(S3_LOG_INFO, stripped_request_id,
+         "%s Entry with num_of_blocks = %zu from last_index = %zu\n", __func__,
+         num_of_blocks, (size_t)last_index);
+
+  if (!is_object_opened || handler_on_read_ahead_drained) {
+    return false;
+  }
+  const uint64_t seq = next_read_ahead_seq++;
+  S3MotrReadAhead &read_ahead = reads_ahead[seq];
+  read_ahead.num_of_blocks = num_of_blocks;
+  read_ahead.start_index = last_index;
+  read_ahead.context.reset(new S3MotrReaderContext(
+      request, std::bind(&S3MotrReader::read_ahead_successful, this, seq),
+      std::bind(&S3MotrReader::read_ahead_failed, this, seq), layout_id));
+
+  if (!launch_read(read_ahead.context.get(), num_of_blocks, true)) {
+    // Nothing launched, buffers were not handed to motr
+    last_index = read_ahead.start_index;
+    reads_ahead.erase(seq);
+    return false;
+  }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return true;
 }
 
+size_t S3MotrReader::get_read_ahead_in_flight() const {
+  size_t in_flight = 0;
+  for (auto &read_ahead : reads_ahead) {
+    if (!read_ahead.second.done) {
+      ++in_flight;
+    }
+  }
+  return in_flight;
+}
+
+void S3MotrReader::discard_read_ahead(std::function<void(void)> on_drained) {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Entry with %zu reads ahead\n",
+         __func__, reads_ahead.size());
+  waiting_for_read_ahead = false;
+  for (auto it = reads_ahead.begin(); it != reads_ahead.end();) {
+    if (it->second.done) {
+      it = reads_ahead.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (reads_ahead.empty()) {
+    if (on_drained) {
+      on_drained();
+    }
+    return;
+  }
+  handler_on_read_ahead_drained = std::move(on_drained);
+}
+
+void S3MotrReader::read_ahead_successful(uint64_t seq) {
+  s3_log(S3_LOG_INFO, stripped_request_id,
+         "Motr API Successful: readobj(oid: ("
+         "%" SCNx64 " : %" SCNx64 ")) read ahead\n",
+         oid.u_hi, oid.u_lo);
+  read_ahead_completed(seq, false);
+}
+
+void S3MotrReader::read_ahead_failed(uint64_t seq) {
+  s3_log(S3_LOG_WARN, request_id, "Read ahead failed, errno = %d\n",
+         reads_ahead[seq].context->get_errno_for(0));
+  read_ahead_completed(seq, true);
+}
+
+void S3MotrReader::read_ahead_completed(uint64_t seq, bool failed) {
+  if (handler_on_read_ahead_drained) {
+    reads_ahead.erase(seq);
+    if (reads_ahead.empty()) {
+      std::function<void(void)> on_drained;
+      on_drained.swap(handler_on_read_ahead_drained);
+      on_drained();
+    }
+    return;
+  }
+  S3MotrReadAhead &read_ahead = reads_ahead[seq];
+  read_ahead.done = true;
+  read_ahead.failed = failed;
+  if (waiting_for_read_ahead && seq == reads_ahead.begin()->first) {
+    hand_out_read_ahead();
+  }
+}
+
+// Makes the oldest read ahead the current read and reports it
+void S3MotrReader::hand_out_read_ahead() {
+  auto head = reads_ahead.begin();
+  bool failed = head->second.failed;
+
+  waiting_for_read_ahead = false;
+  reader_context = std::move(head->second.context);
+  motr_rw_op_context = reader_context->get_motr_rw_op_ctx();
+  iteration_index = 0;
+  num_of_blocks_to_read = head->second.num_of_blocks;
+  starting_index_for_read = head->second.start_index;
+  reads_ahead.erase(head);
+
+  if (failed) {
+    read_object_failed();
+  } else {
+    read_object_successful();
+  }
+}
+
 bool S3MotrReader::ValidateStoredMD5Chksum(m0_bufvec *motr_data_unit,
                                            struct m0_generic_pi *pi_info,
                                            struct m0_pi_seed *seed) {
@@ -24,6 +24,7 @@
 #define __S3_SERVER_S3_MOTR_READER_H__
 
 #include <functional>
+#include <map>
 #include <memory>
 
 #include "s3_asyncop_context_base.h"
@@ -119,8 +120,9 @@ class S3MotrReaderContext : public S3AsyncOpContextBase {
       return false;
     }
     // Create real buffer space using evbuffer
-    p_s3_evbuffer = std::unique_ptr<S3Evbuffer>(
-        new S3Evbuffer(request_id, total_read_sz, evbuf_unit_buf_sz));
+    p_s3_evbuffer = std::unique_ptr<S3Evbuffer>(new S3Evbuffer(
+        request_id, total_read_sz, evbuf_unit_buf_sz,
+        S3Option::get_instance()->is_motr_read_zero_copy()));
     int rc = p_s3_evbuffer->init();
     if (rc != 0) {
       s3_log(S3_LOG_ERROR, request_id, "p_s3_evbuffer->init failed\n");
@@ -198,6 +200,23 @@ class S3MotrReader {
   uint64_t last_index = 0;
   uint64_t starting_index_for_read = 0;
 
+  // Reads launched ahead of read_object_data() calls, keyed by launch
+  // sequence. Each is handed out by a later read_object_data() call in
+  // launch order.
+  struct S3MotrReadAhead {
+    size_t num_of_blocks = 0;
+    uint64_t start_index = 0;
+    bool done = false;
+    bool failed = false;
+    std::unique_ptr<S3MotrReaderContext> context;
+  };
+  std::map<uint64_t, S3MotrReadAhead> reads_ahead;
+  uint64_t next_read_ahead_seq = 0;
+  // read_object_data() is waiting for the oldest read ahead to complete
+  bool waiting_for_read_ahead = false;
+  // Reads ahead are not needed anymore, called once motr returned all
+  std::function<void()> handler_on_read_ahead_drained;
+
   bool is_object_opened = false;
   struct s3_motr_obj_context* obj_ctx = nullptr;
 
@@ -223,6 +242,14 @@ class S3MotrReader {
                                struct m0_pi_seed* seed);
   void read_object_failed();
 
+  // Launches a read of num_of_blocks from last_index into context
+  bool launch_read(S3MotrReaderContext* context, size_t num_of_blocks,
+                   bool is_read_ahead);
+  void read_ahead_successful(uint64_t seq);
+  void read_ahead_failed(uint64_t seq);
+  void read_ahead_completed(uint64_t seq, bool failed);
+  void hand_out_read_ahead();
+
   void clean_up_contexts();
 
  public:
@@ -243,6 +270,19 @@ class S3MotrReader {
                                 std::function<void(void)> on_success,
                                 std::function<void(void)> on_failed);
 
+  // Launches a read of the next num_of_blocks without waiting for the
+  // earlier ones. Its data is handed out by the next read_object_data()
+  // call, which must ask for the same number of blocks.
+  // Returns: true = launched, false = object not open or out-of-memory
+  virtual bool read_ahead_object_data(size_t num_of_blocks);
+
+  // Number of reads ahead not yet completed by motr
+  virtual size_t get_read_ahead_in_flight() const;
+
+  // Drops data of reads ahead. on_drained is called once motr is done with
+  // all of them, as their buffers can not be freed earlier.
+  virtual void discard_read_ahead(std::function<void(void)> on_drained);
+
   virtual bool check_object_exist(std::function<void(void)> on_success,
                                   std::function<void(void)> on_failed);
 
@@ -291,6 +331,7 @@ class S3MotrReader {
   FRIEND_TEST(S3MotrReaderTest, OpenObjectMissingTest);
   FRIEND_TEST(S3MotrReaderTest, OpenObjectErrFailedTest);
   FRIEND_TEST(S3MotrReaderTest, OpenObjectSuccessTest);
+  FRIEND_TEST(S3MotrReaderTest, ReadAheadObjectDataHandedOutInOrder);
 };
 
 #endif
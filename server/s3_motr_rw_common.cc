@@ -189,7 +189,8 @@ void s3_motr_op_stable(struct m0_op *op) {
     short events = 0;
     motr_op_done_on_main_thread(test_sock, events, (void *)user_ctx);
 #else
-    S3PostToMainLoop((void *)user_ctx)(motr_op_done_on_main_thread, request_id);
+    S3PostToMainLoop((void *)user_ctx, app_ctx->get_event_base())(
+        motr_op_done_on_main_thread, request_id);
 #endif  // S3_GOOGLE_TEST
   }
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
@@ -230,7 +231,8 @@ void s3_motr_op_failed(struct m0_op *op) {
     short events = 0;
     motr_op_done_on_main_thread(test_sock, events, (void *)user_ctx);
 #else
-    S3PostToMainLoop((void *)user_ctx)(motr_op_done_on_main_thread, request_id);
+    S3PostToMainLoop((void *)user_ctx, app_ctx->get_event_base())(
+        motr_op_done_on_main_thread, request_id);
 #endif  // S3_GOOGLE_TEST
   }
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
@@ -253,7 +255,8 @@ void s3_motr_op_pre_launch_failure(void *application_context, int rc) {
   short events = 0;
   motr_op_done_on_main_thread(test_sock, events, (void *)user_ctx);
 #else
-  S3PostToMainLoop((void *)user_ctx)(motr_op_done_on_main_thread, request_id);
+  S3PostToMainLoop((void *)user_ctx, app_ctx->get_event_base())(
+      motr_op_done_on_main_thread, request_id);
 #endif  // S3_GOOGLE_TEST
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
 }
@@ -22,11 +22,13 @@
 #include "s3_common.h"
 
 #include <string.h>
+#include "s3_hash_workers.h"
 #include "s3_motr_layout.h"
 #include "s3_motr_rw_common.h"
 #include "s3_motr_writer.h"
 #include "s3_mem_pool_manager.h"
 #include "s3_memory_pool.h"
+#include "s3_object_data_refs.h"
 #include "s3_option.h"
 #include "s3_perf_logger.h"
 #include "s3_stats.h"
@@ -130,6 +132,20 @@ S3MotrWiter::S3MotrWiter(std::shared_ptr<RequestObject> req,
 }
 
 S3MotrWiter::~S3MotrWiter() {
+  if (pi_job) {
+    // The job may still be reading the padding buffer
+    pi_job->cancelled = true;
+    if (place_holder_for_last_unit) {
+      void *place_holder = place_holder_for_last_unit;
+      const int unit_size = unit_size_for_place_holder;
+
+      place_holder_for_last_unit = NULL;
+      release_after_pi([place_holder, unit_size]() {
+        S3MempoolManager::get_instance()->release_buffer_for_unit_size(
+            place_holder, unit_size);
+      });
+    }
+  }
   reset_buffers_if_any(unit_size_for_place_holder);
   clean_up_contexts();
 }
@@ -156,10 +172,11 @@ void S3MotrWiter::clean_up_contexts() {
   // op contexts need to be free'ed before object
   open_context = nullptr;
   create_context = nullptr;
-  writer_context = nullptr;
+  writes_in_flight.clear();
+  completed_write_contexts.clear();
   delete_context = nullptr;
   if (!shutdown_motr_teardown_called) {
-    global_motr_obj.erase(obj_ctx);
+    s3_motr_set_erase(global_motr_obj_lists_mutex, global_motr_obj, obj_ctx);
     if (obj_ctx) {
       for (size_t i = 0; i < obj_ctx->n_initialized_contexts; ++i) {
         s3_motr_api->motr_obj_fini(&obj_ctx->objs[i]);
@@ -234,7 +251,8 @@ int S3MotrWiter::open_objects() {
          oid_list_stream.str().c_str());
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, ops_count,
                               MotrOpType::openobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
   return 0;
 }
@@ -363,7 +381,8 @@ void S3MotrWiter::create_object(std::function<void(void)> on_success,
 
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, 1,
                               MotrOpType::createobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -424,7 +443,18 @@ void S3MotrWiter::write_content(std::function<void(void)> on_success,
 
   handler_on_success = std::move(on_success);
   handler_on_failed = std::move(on_failed);
+
+  if (pi_job) {
+    // PI of the previous write is still being calculated
+    assert(size_of_each_buf == this->size_of_each_buf);
+    writes_waiting_for_pi.push_back(
+        {std::move(buffer_sequence), is_first_write_part_segment});
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
   this->buffer_sequence = std::move(buffer_sequence);
+  // Callers may change it before the object is open
+  buffer_sequence_starts_part = is_first_write_part_segment;
   this->size_of_each_buf = size_of_each_buf;
 
   state = S3MotrWiterOpState::writing;
@@ -442,7 +472,6 @@ void S3MotrWiter::write_content(std::function<void(void)> on_success,
 }
 
 void S3MotrWiter::write_content() {
-  int rc;
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry with layout_id = %d\n",
          __func__, layout_ids[0]);
 
@@ -476,15 +505,139 @@ void S3MotrWiter::write_content() {
       motr_buf_count += pad_buf_count;
     }
   }
-  writer_context.reset(new S3MotrWiterContext(
-      request, std::bind(&S3MotrWiter::write_content_successful, this),
-      std::bind(&S3MotrWiter::write_content_failed, this)));
+  // Contexts of writes already reported to caller are not needed anymore
+  completed_write_contexts.clear();
+
+  const uint64_t write_seq = next_write_seq++;
+  S3MotrWrite &write = writes_in_flight[write_seq];
+  write.context.reset(new S3MotrWiterContext(
+      request,
+      std::bind(&S3MotrWiter::write_content_successful, this, write_seq),
+      std::bind(&S3MotrWiter::write_content_failed, this, write_seq)));
+  S3MotrWiterContext *writer_context = write.context.get();
 
   // After padding motr_buf_count, it will be an absolute multiple
   // of buffers_per_unit
 
   writer_context->init_write_op_ctx(motr_buf_count, buffers_per_unit);
 
+  struct s3_motr_rw_op_context *rw_ctx = writer_context->get_motr_rw_op_ctx();
+
+  // Padding comes from the mempool, which is used by event loops only
+  size_t data_buf_count = buffer_sequence.size();
+  find_and_allocate_placeholder_for_data_alignment(data_buf_count,
+                                                   motr_buf_count);
+
+  if (calculate_pi_on_worker(write_seq, rw_ctx, motr_buf_count)) {
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
+  set_up_motr_data_buffers(rw_ctx, std::move(buffer_sequence), motr_buf_count);
+  launch_write(write_seq);
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+S3MotrWiterBufferSetup S3MotrWiter::get_buffer_setup(
+    struct s3_motr_rw_op_context *rw_ctx, size_t motr_buf_count) {
+  S3MotrWiterBufferSetup setup;
+
+  setup.request_id = request_id;
+  setup.rw_ctx = rw_ctx;
+  setup.buffer_sequence = std::move(buffer_sequence);
+  setup.motr_buf_count = motr_buf_count;
+  setup.size_of_each_buf = size_of_each_buf;
+  setup.motr_unit_size = motr_unit_size;
+  setup.oid = oid_list[0];
+  setup.is_first_write_part_segment = buffer_sequence_starts_part;
+  setup.is_s3_write_di_check_enabled = is_s3_write_di_check_enabled;
+  setup.place_holder_for_last_unit = place_holder_for_last_unit;
+  setup.s3_md5crypt = s3_md5crypt;
+  setup.last_index = last_index;
+  return setup;
+}
+
+bool S3MotrWiter::calculate_pi_on_worker(uint64_t write_seq,
+                                         struct s3_motr_rw_op_context *rw_ctx,
+                                         size_t motr_buf_count) {
+  S3HashWorkers *workers = S3HashWorkers::get_instance();
+  if (!workers) {
+    return false;
+  }
+  auto job = std::make_shared<S3MotrWiterPiJob>();
+  job->setup = get_buffer_setup(rw_ctx, motr_buf_count);
+  job->context = std::move(writes_in_flight[write_seq].context);
+  job->request = request;
+
+  // The worker touches only the job. Flags, offsets and MD5 context in it
+  // are taken now, later writes wait in writes_waiting_for_pi and the
+  // callers may change is_first_write_part_segment meanwhile.
+  if (workers->submit(
+          [job]() {
+            if (!job->cancelled) {
+              job->setup.set_up_motr_data_buffers();
+            }
+          },
+          [this, job, write_seq]() {
+            if (job->cancelled) {
+              for (auto &release : job->on_done) {
+                release();
+              }
+              return;
+            }
+            writes_in_flight[write_seq].context = std::move(job->context);
+            write_pi_calculated(write_seq, job->setup);
+          })) {
+    pi_job = std::move(job);
+    return true;
+  }
+  writes_in_flight[write_seq].context = std::move(job->context);
+  buffer_sequence = std::move(job->setup.buffer_sequence);
+  return false;
+}
+
+void S3MotrWiter::write_pi_calculated(uint64_t write_seq,
+                                      const S3MotrWiterBufferSetup &setup) {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Entry with write_seq = %" PRIu64 "\n",
+         __func__, write_seq);
+  std::vector<std::function<void()>> on_done = std::move(pi_job->on_done);
+
+  pi_job.reset();
+  last_index = setup.last_index;
+  size_in_current_write = setup.size_in_current_write;
+  for (auto &release : on_done) {
+    release();
+  }
+  launch_write(write_seq);
+
+  if (!writes_waiting_for_pi.empty()) {
+    if (state == S3MotrWiterOpState::writing && !write_failed_in_window) {
+      S3MotrWaitingWrite &next_write = writes_waiting_for_pi.front();
+
+      buffer_sequence = std::move(next_write.buffer_sequence);
+      buffer_sequence_starts_part = next_write.is_first_write_part_segment;
+      writes_waiting_for_pi.pop_front();
+      write_content();
+    } else {
+      // Failure is reported once the writes in flight are done
+      writes_waiting_for_pi.clear();
+    }
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3MotrWiter::release_after_pi(std::function<void()> release) {
+  if (pi_job) {
+    pi_job->on_done.push_back(std::move(release));
+  } else {
+    release();
+  }
+}
+
+void S3MotrWiter::launch_write(uint64_t write_seq) {
+  int rc;
+  S3MotrWrite &write = writes_in_flight[write_seq];
+  S3MotrWiterContext *writer_context = write.context.get();
+
   struct s3_motr_op_context *ctx = writer_context->get_motr_op_ctx();
 
   struct s3_motr_rw_op_context *rw_ctx = writer_context->get_motr_rw_op_ctx();
@@ -494,13 +647,13 @@ void S3MotrWiter::write_content() {
 
   op_ctx->op_index_in_launch = 0;
   op_ctx->application_context =
-      static_cast<S3AsyncOpContextBase *>(writer_context.get());
+      static_cast<S3AsyncOpContextBase *>(writer_context);
 
   ctx->cbs[0].oop_executed = NULL;
   ctx->cbs[0].oop_stable = s3_motr_op_stable;
   ctx->cbs[0].oop_failed = s3_motr_op_failed;
 
-  set_up_motr_data_buffers(rw_ctx, std::move(buffer_sequence), motr_buf_count);
+  write.size = size_in_current_write;
 
   // see also similar code in S3MotrReader::read_object_successful()
   if (s3_di_fi_is_enabled("di_data_corrupted_on_write")) {
@@ -559,32 +712,70 @@ void S3MotrWiter::write_content() {
          size_in_current_write);
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, 1,
                               MotrOpType::writeobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3MotrWiter::write_content_successful() {
-  total_written += size_in_current_write;
-  s3_log(S3_LOG_INFO, stripped_request_id,
-         "Motr API sucessful: write(total_written = %zu)\n", total_written);
+void S3MotrWiter::write_content_successful(uint64_t write_seq) {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Entry with write_seq = %" PRIu64 "\n",
+         __func__, write_seq);
   s3_stats_inc("write_to_motr_op_success_count");
 
-  state = S3MotrWiterOpState::saved;
-  this->handler_on_success();
+  writes_in_flight[write_seq].done = true;
+  report_completed_writes();
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
-void S3MotrWiter::write_content_failed() {
+void S3MotrWiter::write_content_failed(uint64_t write_seq) {
   s3_log(S3_LOG_ERROR, request_id, "Write to object failed after writing %zu\n",
          total_written);
 
-  state = S3MotrWiterOpState::failed;
-  this->handler_on_failed();
+  writes_in_flight[write_seq].done = true;
+  write_failed_in_window = true;
+  report_completed_writes();
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+void S3MotrWiter::report_completed_writes() {
+  if (write_failed_in_window) {
+    // Caller cleans up on failure, so wait for the rest of the window
+    for (auto &write : writes_in_flight) {
+      if (!write.second.done) {
+        return;
+      }
+    }
+    for (auto &write : writes_in_flight) {
+      completed_write_contexts.push_back(std::move(write.second.context));
+    }
+    writes_in_flight.clear();
+    write_failed_in_window = false;
+    if (state != S3MotrWiterOpState::failed_to_launch) {
+      state = S3MotrWiterOpState::failed;
+    }
+    this->handler_on_failed();
+    return;
+  }
+  // Report in submission order, later writes wait for earlier ones
+  while (!writes_in_flight.empty() && !write_failed_in_window &&
+         writes_in_flight.begin()->second.done) {
+    auto head = writes_in_flight.begin();
+    total_written += head->second.size;
+    completed_write_contexts.push_back(std::move(head->second.context));
+    writes_in_flight.erase(head);
+    s3_log(S3_LOG_INFO, stripped_request_id,
+           "Motr API sucessful: write(total_written = %zu)\n", total_written);
+
+    if (writes_in_flight.empty()) {
+      state = S3MotrWiterOpState::saved;
+    }
+    // May launch more writes
+    this->handler_on_success();
+  }
+}
+
 void S3MotrWiter::delete_object(std::function<void(void)> on_success,
                                 std::function<void(void)> on_failed,
                                 const struct m0_uint128 &object_id,
@@ -608,7 +799,73 @@ void S3MotrWiter::delete_object(std::function<void(void)> on_success,
   pv_ids.push_back(pv_id);
 
   state = S3MotrWiterOpState::deleting;
+  delete_op_index.clear();
 
+  check_data_refs();
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3MotrWiter::check_data_refs() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  data_refs.reset(
+      new S3ObjectDataRefs(request, s3_motr_api, motr_kvs_reader_factory));
+  data_refs->check(oid_list,
+                   std::bind(&S3MotrWiter::check_data_refs_done, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3MotrWiter::check_data_refs_done() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  std::vector<struct m0_uint128> oids;
+  std::vector<int> layoutids;
+  std::vector<struct m0_fid> pvids;
+
+  delete_op_index.assign(oid_list.size(), -1);
+  delete_ret_codes.assign(oid_list.size(), 0);
+
+  for (size_t i = 0; i < oid_list.size(); ++i) {
+    switch (data_refs->get_data_state(i)) {
+      case S3ObjectDataState::unreferenced:
+        delete_op_index[i] = oids.size();
+        oids.push_back(oid_list[i]);
+        layoutids.push_back(layout_ids[i]);
+        pvids.push_back(pv_ids[i]);
+        break;
+      case S3ObjectDataState::referenced:
+        s3_log(S3_LOG_INFO, stripped_request_id,
+               "Data of object (%" SCNx64 " : %" SCNx64
+               ") is shared, not deleted\n",
+               oid_list[i].u_hi, oid_list[i].u_lo);
+        break;
+      case S3ObjectDataState::unknown:
+        s3_log(S3_LOG_WARN, request_id,
+               "References to data of object (%" SCNx64 " : %" SCNx64
+               ") are unknown, not deleted\n",
+               oid_list[i].u_hi, oid_list[i].u_lo);
+        delete_ret_codes[i] = -EAGAIN;
+        break;
+    }
+  }
+  if (oids.empty()) {
+    if (has_kept_object_failed()) {
+      state = S3MotrWiterOpState::failed;
+      this->handler_on_failed();
+    } else {
+      state = S3MotrWiterOpState::deleted;
+      this->handler_on_success();
+    }
+    return;
+  }
+  if (oids.size() != oid_list.size()) {
+    is_object_opened = false;
+    oid_list = std::move(oids);
+    layout_ids = std::move(layoutids);
+    pv_ids = std::move(pvids);
+  }
   if (is_object_opened) {
     delete_objects();
   } else {
@@ -617,6 +874,15 @@ void S3MotrWiter::delete_object(std::function<void(void)> on_success,
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+bool S3MotrWiter::has_kept_object_failed() const {
+  for (size_t i = 0; i < delete_op_index.size(); ++i) {
+    if (delete_op_index[i] < 0 && delete_ret_codes[i] < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void S3MotrWiter::delete_objects() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
@@ -667,15 +933,22 @@ void S3MotrWiter::delete_objects() {
          oid_list_stream.str().c_str());
   s3_motr_api->motr_op_launch(request->addb_request_id, ctx->ops, ops_count,
                               MotrOpType::deleteobj);
-  global_motr_object_ops_list.insert(ctx);
+  s3_motr_set_insert(global_motr_obj_lists_mutex, global_motr_object_ops_list,
+                     ctx);
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
 void S3MotrWiter::delete_objects_successful() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
-  state = S3MotrWiterOpState::deleted;
   s3_log(S3_LOG_INFO, stripped_request_id, "Motr API Successful: deleteobj\n");
-  this->handler_on_success();
+  if (has_kept_object_failed()) {
+    // Deletion of the other objects is reported per object
+    state = S3MotrWiterOpState::failed;
+    this->handler_on_failed();
+  } else {
+    state = S3MotrWiterOpState::deleted;
+    this->handler_on_success();
+  }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -715,21 +988,36 @@ void S3MotrWiter::delete_objects(std::vector<struct m0_uint128> oids,
   pv_ids = std::move(pvids);
 
   state = S3MotrWiterOpState::deleting;
+  delete_op_index.clear();
 
   // Force open all objects
-  open_objects();
+  is_object_opened = false;
+  check_data_refs();
+
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
 int S3MotrWiter::get_op_ret_code_for(int index) {
-  if (writer_context) {
-    return writer_context->get_errno_for(index);
+  // Error of the first failed write among the last reported ones
+  for (auto &writer_context : completed_write_contexts) {
+    if (writer_context && writer_context->get_errno_for(index) != 0) {
+      return writer_context->get_errno_for(index);
+    }
+  }
+  if (!completed_write_contexts.empty()) {
+    return 0;
   }
   s3_log(S3_LOG_ERROR, request_id, "writer_context is NULL");
   return -ENOENT;
 }
 
 int S3MotrWiter::get_op_ret_code_for_delete_op(int index) {
+  if (!delete_op_index.empty()) {
+    if (delete_op_index[index] < 0) {
+      return delete_ret_codes[index];
+    }
+    index = delete_op_index[index];
+  }
   if (delete_context) {
     return delete_context->get_errno_for(index);
   }
@@ -744,9 +1032,8 @@ int S3MotrWiter::get_op_ret_code_for_delete_op(int index) {
 // is_this_alignment_buffer : true in case of padding buffers,
 //                            false otherwise.
 //
-void S3MotrWiter::add_buffer_to_motr_structures(
-    struct s3_motr_rw_op_context *rw_ctx, void *pbuffer, size_t &buf_idx,
-    size_t &starting_checksum_buf_idx) {
+void S3MotrWiterBufferSetup::add_buffer_to_motr_structures(
+    void *pbuffer, size_t &buf_idx, size_t &starting_checksum_buf_idx) {
   assert(pbuffer != NULL);
   assert(rw_ctx != NULL);
   assert(buf_idx >= 0);
@@ -786,10 +1073,10 @@ void S3MotrWiter::add_buffer_to_motr_structures(
 // is_finalize_call : should be true only when calculating ETAG for
 //                    unaligned case. false otherwise
 //
-void S3MotrWiter::calc_pi_info(
-    struct s3_motr_rw_op_context *rw_ctx, size_t &saved_last_index,
-    bool &initial_buffers_part_write, int &s3_checksum_flag,
-    size_t &chksum_buf_idx, size_t &unaligned_buf_idx_offset, size_t &buf_idx,
+void S3MotrWiterBufferSetup::calc_pi_info(
+    size_t &saved_last_index, bool &initial_buffers_part_write,
+    int &s3_checksum_flag, size_t &chksum_buf_idx,
+    size_t &unaligned_buf_idx_offset, size_t &buf_idx,
     size_t &starting_checksum_buf_idx, bool &calculated_chksum_at_unit_boundary,
     bool reset_initial_buffers, bool is_called_for_unaligned_buffers,
     bool is_finalize_call) {
@@ -830,7 +1117,7 @@ void S3MotrWiter::calc_pi_info(
     }
 
     rc = s3_md5crypt->s3_calculate_unit_pi(rw_ctx, chksum_buf_idx++,
-                                           saved_last_index, oid_list[0],
+                                           saved_last_index, oid,
                                            s3_checksum_flag);
     if (rc != 0) {
       s3_log(S3_LOG_ERROR, request_id,
@@ -879,14 +1166,13 @@ void S3MotrWiter::find_and_allocate_placeholder_for_data_alignment(
 // if data buffers are unaligned this function aligns
 // them to the nearest motr unit size
 //
-void S3MotrWiter::align_data_to_motr_unit_size(
-    struct s3_motr_rw_op_context *rw_ctx, size_t &buf_idx,
-    size_t &motr_buf_count, size_t &starting_checksum_buf_idx) {
+void S3MotrWiterBufferSetup::align_data_to_motr_unit_size(
+    size_t &buf_idx, size_t &starting_checksum_buf_idx) {
   assert(rw_ctx != NULL);
   s3_log(S3_LOG_DEBUG, "", "%s Entry", __func__);
 
   while (buf_idx < motr_buf_count) {
-    add_buffer_to_motr_structures(rw_ctx, place_holder_for_last_unit, buf_idx,
+    add_buffer_to_motr_structures(place_holder_for_last_unit, buf_idx,
                                   starting_checksum_buf_idx);
   }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
@@ -895,6 +1181,15 @@ void S3MotrWiter::align_data_to_motr_unit_size(
 void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
                                            S3BufferSequence buffer_sequence,
                                            size_t motr_buf_count) {
+  this->buffer_sequence = std::move(buffer_sequence);
+  S3MotrWiterBufferSetup setup = get_buffer_setup(rw_ctx, motr_buf_count);
+
+  setup.set_up_motr_data_buffers();
+  last_index = setup.last_index;
+  size_in_current_write = setup.size_in_current_write;
+}
+
+void S3MotrWiterBufferSetup::set_up_motr_data_buffers() {
   s3_log(S3_LOG_DEBUG, request_id, "%s Entry\n", __func__);
   size_in_current_write = 0;
 
@@ -949,7 +1244,7 @@ void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
 
     // Append  One Read buffer (typically 16k) to motr data structures in rw_ctx
     // Increment starting_checksum_buf_idx and buf_idx
-    add_buffer_to_motr_structures(rw_ctx, ptr_n_len.first, buf_idx,
+    add_buffer_to_motr_structures(ptr_n_len.first, buf_idx,
                                   starting_checksum_buf_idx);
 
     size_in_current_write += len_in_buf;
@@ -962,7 +1257,7 @@ void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
     // as well as for ETAG)
     // We will fall through for last 0.3M
     if (size_in_current_write % motr_unit_size == 0) {
-      calc_pi_info(rw_ctx, saved_last_index, initial_buffers_part_write,
+      calc_pi_info(saved_last_index, initial_buffers_part_write,
                    s3_checksum_flag, chksum_buf_idx, unaligned_buf_idx_offset,
                    buf_idx, starting_checksum_buf_idx,
                    calculated_chksum_at_unit_boundary, true, false, false);
@@ -986,12 +1281,10 @@ void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
         (unsigned char *)s3_md5crypt->get_prev_write_checksum());
   }
 
-  // Placeholder buffer allocation for padding
-  find_and_allocate_placeholder_for_data_alignment(buf_idx, motr_buf_count);
+  // Placeholder buffer for padding was allocated by write_content()
 
   // Perform padding using above placeholder buffer
-  align_data_to_motr_unit_size(rw_ctx, buf_idx, motr_buf_count,
-                               starting_checksum_buf_idx);
+  align_data_to_motr_unit_size(buf_idx, starting_checksum_buf_idx);
 
   // Checksum for unaligned + padded buffers to be saved in motr
   if (is_s3_write_di_check_enabled && number_of_unit_unaligned != 0) {
@@ -1002,7 +1295,7 @@ void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
            "number_of_unit_unaligned(%zu)\n",
            number_of_unit_unaligned);
 
-    calc_pi_info(rw_ctx, saved_last_index, initial_buffers_part_write,
+    calc_pi_info(saved_last_index, initial_buffers_part_write,
                  s3_checksum_flag, chksum_buf_idx, unaligned_buf_idx_offset,
                  buf_idx, starting_checksum_buf_idx,
                  calculated_chksum_at_unit_boundary, false, true, false);
@@ -1025,7 +1318,7 @@ void S3MotrWiter::set_up_motr_data_buffers(struct s3_motr_rw_op_context *rw_ctx,
            "number of bufvec(%u) len_in_buf(%zu)\n",
            rw_ctx->pi_bufvec->ov_vec.v_nr, len_in_buf);
 
-    calc_pi_info(rw_ctx, saved_last_index, initial_buffers_part_write,
+    calc_pi_info(saved_last_index, initial_buffers_part_write,
                  s3_checksum_flag, chksum_buf_idx, unaligned_buf_idx_offset,
                  buf_idx, starting_checksum_buf_idx,
                  calculated_chksum_at_unit_boundary, false, true, true);
@@ -23,9 +23,12 @@
 #ifndef __S3_SERVER_S3_MOTR_WRITER_H__
 #define __S3_SERVER_S3_MOTR_WRITER_H__
 
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "s3_asyncop_context_base.h"
 #include "s3_motr_context.h"
@@ -36,6 +39,9 @@
 #include "s3_request_object.h"
 #include "s3_buffer_sequence.h"
 
+class S3MotrKVSReaderFactory;
+class S3ObjectDataRefs;
+
 class S3MotrWiterContext : public S3AsyncOpContextBase {
   // Basic Operation context.
   struct s3_motr_op_context* motr_op_context = NULL;
@@ -65,6 +71,59 @@ class S3MotrWiterContext : public S3AsyncOpContextBase {
   }
 };
 
+// Sets up Motr data buffers of a write and calculates their PI. It works
+// only on what it is given and the writer picks last_index and
+// size_in_current_write up when it's done, so it can be run by
+// S3HashWorkers while the writer is used on the event loop.
+class S3MotrWiterBufferSetup {
+  void add_buffer_to_motr_structures(void* pbuffer, size_t& buf_idx,
+                                     size_t& starting_checksum_buf_idx);
+  void calc_pi_info(size_t& saved_last_index, bool& initial_buffers_part_write,
+                    int& s3_checksum_flag, size_t& chksum_buf_idx,
+                    size_t& unaligned_buf_idx_offset, size_t& buf_idx,
+                    size_t& starting_checksum_buf_idx,
+                    bool& calculated_chksum_at_unit_boundary,
+                    bool reset_initial_buffers,
+                    bool is_called_for_unaligned_buffers,
+                    bool is_finalize_call);
+  void align_data_to_motr_unit_size(size_t& buf_idx,
+                                    size_t& starting_checksum_buf_idx);
+
+ public:
+  std::string request_id;
+  struct s3_motr_rw_op_context* rw_ctx = nullptr;
+  S3BufferSequence buffer_sequence;
+  size_t motr_buf_count = 0;
+  size_t size_of_each_buf = 0;
+  size_t motr_unit_size = 0;
+  struct m0_uint128 oid = {};
+  // This is first write of a part
+  bool is_first_write_part_segment = false;
+  bool is_s3_write_di_check_enabled = false;
+  void* place_holder_for_last_unit = nullptr;
+  // MD5 is chained across writes
+  std::shared_ptr<MD5hash> s3_md5crypt;
+  // Object offset of the write, moved past it by set_up_motr_data_buffers()
+  uint64_t last_index = 0;
+  size_t size_in_current_write = 0;
+
+  void set_up_motr_data_buffers();
+};
+
+// PI calculation of a write, run by S3HashWorkers. The job owns what the
+// worker touches, so the writer going away only cancels it and hands it
+// what has to outlive the calculation, see S3MotrWiter::release_after_pi().
+struct S3MotrWiterPiJob {
+  S3MotrWiterBufferSetup setup;
+  // Holds rw_ctx of setup, given back to the writer when the job is done
+  std::unique_ptr<S3MotrWiterContext> context;
+  // Data being written is buffered in the request
+  std::shared_ptr<RequestObject> request;
+  // Run on the event loop once the job is done
+  std::vector<std::function<void()>> on_done;
+  std::atomic<bool> cancelled{false};
+};
+
 enum class S3MotrWiterOpState {
   start,
   failed_to_launch,
@@ -85,8 +144,30 @@ class S3MotrWiter {
   std::shared_ptr<RequestObject> request;
   std::unique_ptr<S3MotrWiterContext> open_context;
   std::unique_ptr<S3MotrWiterContext> create_context;
-  std::unique_ptr<S3MotrWiterContext> writer_context;
   std::unique_ptr<S3MotrWiterContext> delete_context;
+
+  // Writes launched to motr and not yet reported to caller, keyed by
+  // submission sequence. Completions are reported in submission order so
+  // callers can release buffers in the order they handed them out.
+  struct S3MotrWrite {
+    size_t size = 0;
+    bool done = false;
+    std::unique_ptr<S3MotrWiterContext> context;
+  };
+  std::map<uint64_t, S3MotrWrite> writes_in_flight;
+  uint64_t next_write_seq = 0;
+  // Some write of the current window failed, reported once all are done
+  bool write_failed_in_window = false;
+  // Contexts of reported writes, freed when the next write is launched
+  std::vector<std::unique_ptr<S3MotrWiterContext>> completed_write_contexts;
+  // PI of a write is being calculated off the event loop. MD5 is chained
+  // across writes, so writes submitted meanwhile wait for it in order.
+  std::shared_ptr<S3MotrWiterPiJob> pi_job;
+  struct S3MotrWaitingWrite {
+    S3BufferSequence buffer_sequence;
+    bool is_first_write_part_segment;
+  };
+  std::deque<S3MotrWaitingWrite> writes_waiting_for_pi;
   std::shared_ptr<MotrAPI> s3_motr_api;
   // md5 for the content written to motr.
   std::shared_ptr<MD5hash> s3_md5crypt;
@@ -99,6 +180,17 @@ class S3MotrWiter {
   std::vector<int> layout_ids;
   std::vector<struct m0_fid> pv_ids;
 
+  // Objects whose data is shared are deleted only when no other object
+  // refers to the data, see S3ObjectDataRefs. Kept objects are dropped from
+  // oid_list, delete_op_index maps index given by caller to the index of
+  // delete op, or -1 if the object was kept with delete_ret_codes[index].
+  // Data may have been shared while S3_COPY_OBJECT_BY_REFERENCE was enabled,
+  // so refs are checked on every delete regardless of the option.
+  std::unique_ptr<S3ObjectDataRefs> data_refs;
+  std::shared_ptr<S3MotrKVSReaderFactory> motr_kvs_reader_factory;
+  std::vector<int> delete_op_index;
+  std::vector<int> delete_ret_codes;
+
   S3MotrWiterOpState state = S3MotrWiterOpState::start;
 
   std::string content_md5;
@@ -128,6 +220,8 @@ class S3MotrWiter {
 
   // buffer currently used to write, will be freed on completion
   S3BufferSequence buffer_sequence;
+  // is_first_write_part_segment when buffer_sequence was given to write
+  bool buffer_sequence_starts_part = false;
   size_t size_of_each_buf = 0;
 
   // fill entire object with zeroes after checksum calculation, but before
@@ -143,8 +237,21 @@ class S3MotrWiter {
   void open_objects_failed();
 
   void write_content();
-  void write_content_successful();
-  void write_content_failed();
+  S3MotrWiterBufferSetup get_buffer_setup(
+      struct s3_motr_rw_op_context* rw_ctx, size_t motr_buf_count);
+  bool calculate_pi_on_worker(uint64_t write_seq,
+                              struct s3_motr_rw_op_context* rw_ctx,
+                              size_t motr_buf_count);
+  void write_pi_calculated(uint64_t write_seq,
+                           const S3MotrWiterBufferSetup& setup);
+  void launch_write(uint64_t write_seq);
+  void write_content_successful(uint64_t write_seq);
+  void write_content_failed(uint64_t write_seq);
+  void report_completed_writes();
+
+  void check_data_refs();
+  void check_data_refs_done();
+  bool has_kept_object_failed() const;
 
   void delete_objects();
   void delete_objects_successful();
@@ -167,6 +274,20 @@ class S3MotrWiter {
 
   virtual S3MotrWiterOpState get_state() { return state; }
 
+  // Number of writes submitted and not yet reported to caller
+  virtual size_t get_writes_in_flight() const {
+    return writes_in_flight.size() + writes_waiting_for_pi.size();
+  }
+
+  // true if write_content() can be called again before earlier writes
+  // complete, i.e. object is open and none of the writes in flight failed.
+  // Data is hashed and offsets assigned in submission order, so writes are
+  // launched in order even if motr completes them out of order.
+  virtual bool can_pipeline_write() const {
+    return is_object_opened && state == S3MotrWiterOpState::writing &&
+           !write_failed_in_window;
+  }
+
   virtual struct m0_uint128 get_oid() {
     assert(oid_list.size() == 1);
     return oid_list[0];
@@ -207,6 +328,8 @@ class S3MotrWiter {
                              std::function<void(void)> on_failed,
                              const struct m0_uint128& object_id, int layoutid);
   // Async save operation.
+  // on_success is called once per write_content() call, in call order.
+  // on_failed is called once, after all writes in flight are done.
   virtual void write_content(std::function<void(void)> on_success,
                              std::function<void(void)> on_failed,
                              S3BufferSequence buffer_sequence,
@@ -231,23 +354,11 @@ class S3MotrWiter {
   void set_up_motr_data_buffers(struct s3_motr_rw_op_context* rw_ctx,
                                 S3BufferSequence buffer_sequence,
                                 size_t motr_buf_count);
-  void align_data_to_motr_unit_size(struct s3_motr_rw_op_context *rw_ctx,
-                                    size_t &buf_idx, size_t &motr_buf_count,
-                                    size_t &starting_checksum_buf_idx);
   void find_and_allocate_placeholder_for_data_alignment(size_t &buf_idx,
                                                         size_t &motr_buf_count);
-  void calc_pi_info(struct s3_motr_rw_op_context *rw_ctx,
-                    size_t &saved_last_index, bool &initial_buffers_part_write,
-                    int &s3_checksum_flag, size_t &chksum_buf_idx,
-                    size_t &unaligned_buf_idx_offset, size_t &buf_idx,
-                    size_t &starting_checksum_buf_idx,
-                    bool &calculated_chksum_at_unit_boundary,
-                    bool reset_initial_buffers,
-                    bool is_called_for_unaligned_buffers,
-                    bool is_finalize_call);
-  void add_buffer_to_motr_structures(struct s3_motr_rw_op_context *rw_ctx,
-                                     void *pbuffer, size_t &buf_idx,
-                                     size_t &starting_checksum_buf_idx);
+  // release is run once PI being calculated by S3HashWorkers is done, or
+  // right away if there is none
+  void release_after_pi(std::function<void()> release);
 
   struct m0_fid* get_ppvid() const;
 
@@ -276,6 +387,7 @@ class S3MotrWiter {
   FRIEND_TEST(S3MotrWiterTest, WriteContentSuccessfulTest2MUnaligned);
   FRIEND_TEST(S3MotrWiterTest, WriteContentSuccessfulTest1MUnaligned);
   FRIEND_TEST(S3MotrWiterTest, WriteContentSuccessfulTest1M);
+  FRIEND_TEST(S3MotrWiterTest, WriteContentCalculatesPiOnHashWorkers);
   FRIEND_TEST(S3MotrWiterTest, WriteContentFailedTest);
 };
 
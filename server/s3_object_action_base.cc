@@ -75,6 +75,8 @@ void S3ObjectAction::fetch_bucket_info_success() {
 
 void S3ObjectAction::fetch_object_info() {
   s3_log(S3_LOG_DEBUG, request_id, "%s Entry\n", __func__);
+  // Runs within the load_metadata task, charged to bucket metadata so far
+  set_latency_phase(S3LatencyPhase::object_metadata);
   // Object create case no object metadata exist
   s3_log(S3_LOG_DEBUG, request_id, "Found bucket metadata\n");
 
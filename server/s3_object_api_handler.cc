@@ -77,8 +77,11 @@ void S3ObjectAPIHandler::create_action() {
           break;
         case S3HttpVerb::PUT:
           if (!request->get_header_value("x-amz-copy-source").empty()) {
-            // Copy Object in part upload not yet supported.
-            // Do nothing = unsupported API
+            // Multipart part upload copying data of an existing object
+            request->set_object_size(request->get_data_length());
+            request->set_action_str("PutMultiObject");
+            action = std::make_shared<S3PutMultiObjectAction>(request);
+            s3_stats_inc("put_multipart_part_copy_request_count");
           } else {
             // Multipart part uploads
             request->set_object_size(request->get_data_length());
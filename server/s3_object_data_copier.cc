@@ -18,10 +18,13 @@
  *
  */
 
+#include <cstring>
+
 #include "s3_factory.h"
 #include "s3_log.h"
 #include "s3_m0_uint128_helper.h"
 #include "s3_mem_pool_manager.h"
+#include "s3_memory_profile.h"
 #include "s3_motr_layout.h"
 #include "s3_motr_reader.h"
 #include "s3_motr_writer.h"
@@ -43,35 +46,149 @@ S3ObjectDataCopier::S3ObjectDataCopier(
 }
 
 S3ObjectDataCopier::~S3ObjectDataCopier() {
-  if (p_evbuffer_write) {
-    ::evbuffer_free(p_evbuffer_write);
+  for (auto& chunk : data_read) {
+    ::evbuffer_free(chunk.p_evbuffer);
   }
-  if (p_evbuffer_read) {
-    ::evbuffer_free(p_evbuffer_read);
+  // PI of the data written last may still be calculated by S3HashWorkers.
+  // shifted_tail is a whole ev buffer, so its data stays where it is.
+  auto p_evbuffers = std::make_shared<std::deque<struct evbuffer*>>(
+      std::move(evbuffers_written));
+  auto p_tail = std::make_shared<std::string>(std::move(shifted_tail));
+
+  motr_writer->release_after_pi([p_evbuffers, p_tail]() {
+    for (auto* p_evbuffer : *p_evbuffers) {
+      ::evbuffer_free(p_evbuffer);
+    }
+  });
+}
+
+size_t S3ObjectDataCopier::get_chunks_in_flight() const {
+  return (read_in_progress ? 1 : 0) + read_ahead_blocks.size() +
+         data_read.size() + evbuffers_written.size();
+}
+
+size_t S3ObjectDataCopier::get_blocks_for_next_read() const {
+  return std::min<size_t>(
+      S3Option::get_instance()->get_motr_units_per_request(),
+      (bytes_left_to_launch + motr_unit_size - 1) / motr_unit_size);
+}
+
+// Read buffers come from libevent memory pool, leave its reserve to other
+// requests.
+bool S3ObjectDataCopier::memory_allows_read_ahead() const {
+  if (!S3MemoryProfile().free_memory_in_pool_above_threshold_limits()) {
+    s3_log(S3_LOG_DEBUG, request_id, "Low on memory, no read ahead");
+    return false;
   }
+  return true;
+}
+
+// Starts the reads and writes the window allows and reports the result once
+// nothing is in flight anymore. Reader may complete a read synchronously, such
+// nested calls are folded into the outermost one, so on_success/on_failure
+// are only called at its very end.
+void S3ObjectDataCopier::continue_copy() {
+  if (in_continue_copy) {
+    continue_copy_again = true;
+    return;
+  }
+  in_continue_copy = true;
+  do {
+    continue_copy_again = false;
+
+    while (!copy_failed && !data_read.empty() &&
+           (evbuffers_written.empty() || motr_writer->can_pipeline_write())) {
+      write_data_block();
+    }
+    if (!copy_failed && !read_in_progress &&
+        (!read_ahead_blocks.empty() ||
+         (bytes_left_to_launch > 0 && get_chunks_in_flight() < copy_window))) {
+      read_data_block();
+    }
+    if (!copy_failed && read_in_progress) {
+      read_ahead();
+    }
+    if (copy_failed && !read_in_progress && !read_ahead_draining &&
+        !read_ahead_blocks.empty()) {
+      // Motr still fills buffers of reads ahead, they can't be freed earlier
+      s3_log(S3_LOG_DEBUG, request_id, "Discarding %zu reads ahead",
+             read_ahead_blocks.size());
+      read_ahead_blocks.clear();
+      read_ahead_draining = true;
+      motr_reader->discard_read_ahead(
+          std::bind(&S3ObjectDataCopier::read_ahead_drained, this));
+    }
+  } while (continue_copy_again);
+
+  in_continue_copy = false;
+
+  if (copy_failed) {
+    if (!read_in_progress && !read_ahead_draining &&
+        evbuffers_written.empty()) {
+      this->on_failure();
+    }
+  } else if (!bytes_left_to_read && data_read.empty() &&
+             evbuffers_written.empty()) {
+    assert(!read_in_progress);
+    assert(read_ahead_blocks.empty());
+
+    this->on_success();
+  }
+}
+
+// Launches reads of the following chunks while the current one is in flight
+void S3ObjectDataCopier::read_ahead() {
+  while (bytes_left_to_launch > 0 && get_chunks_in_flight() < copy_window &&
+         memory_allows_read_ahead()) {
+    const size_t n_blocks = get_blocks_for_next_read();
+
+    if (!motr_reader->read_ahead_object_data(n_blocks)) {
+      break;
+    }
+    s3_log(S3_LOG_DEBUG, request_id, "Read ahead of %zu data blocks launched",
+           n_blocks);
+    read_ahead_blocks.push_back(n_blocks);
+    bytes_left_to_launch -=
+        std::min(bytes_left_to_launch, n_blocks * motr_unit_size);
+  }
+}
+
+void S3ObjectDataCopier::read_ahead_drained() {
+  s3_log(S3_LOG_DEBUG, request_id, "Reads ahead are drained");
+  read_ahead_draining = false;
+  continue_copy();
 }
 
 void S3ObjectDataCopier::read_data_block() {
   s3_log(S3_LOG_INFO, request_id, "%s Entry\n", __func__);
 
   assert(!read_in_progress);
-  assert(data_blocks_read.empty());
-  assert(!p_evbuffer_read);
-  assert(bytes_left_to_read > 0);
 
-  const auto n_blocks = std::min<size_t>(
-      S3Option::get_instance()->get_motr_units_per_request(),
-      (bytes_left_to_read + motr_unit_size - 1) / motr_unit_size);
+  size_t n_blocks;
+
+  if (!read_ahead_blocks.empty()) {
+    // Already launched, read_object_data() hands it out
+    n_blocks = read_ahead_blocks.front();
+    read_ahead_blocks.pop_front();
+  } else {
+    assert(bytes_left_to_launch > 0);
+
+    n_blocks = get_blocks_for_next_read();
+    bytes_left_to_launch -=
+        std::min(bytes_left_to_launch, n_blocks * motr_unit_size);
+  }
+  s3_log(S3_LOG_DEBUG, request_id, "Reading %zu data blocks", n_blocks);
+
+  // Completed read ahead is reported from within read_object_data()
+  read_in_progress = true;
 
-  if (motr_reader->read_object_data(
+  if (!motr_reader->read_object_data(
           n_blocks,
           std::bind(&S3ObjectDataCopier::read_data_block_success, this),
-          std::bind(&S3ObjectDataCopier::read_data_block_failed, this))) {
+          std::bind(&S3ObjectDataCopier::read_data_block_failed, this)) &&
+      read_in_progress) {
 
-    s3_log(S3_LOG_DEBUG, request_id, "Read of %zu data block is started",
-           n_blocks);
-    read_in_progress = true;
-  } else {
+    read_in_progress = false;
     copy_failed = true;
     s3_log(S3_LOG_ERROR, request_id, "Read of %zu data block failed to start",
            n_blocks);
@@ -79,9 +196,6 @@ void S3ObjectDataCopier::read_data_block() {
                          S3MotrReaderOpState::failed_to_launch
                      ? "ServiceUnavailable"
                      : "InternalError");
-    if (!write_in_progress) {
-      this->on_failure();
-    }
   }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
@@ -99,37 +213,35 @@ void S3ObjectDataCopier::read_data_block_success() {
     return;
   }
   if (copy_failed) {
-    assert(!write_in_progress);
-
-    this->on_failure();
+    continue_copy();
     return;
   }
-  assert(data_blocks_read.empty());
-  data_blocks_read = motr_reader->extract_blocks_read();
+  DataRead chunk;
+  chunk.blocks = motr_reader->extract_blocks_read();
 
   // Save ev buffer containing the read data, which will be freed after
   // data write completion.
-  assert(!p_evbuffer_read);
-  p_evbuffer_read = motr_reader->get_evbuffer_ownership();
-  assert(p_evbuffer_read != nullptr);
+  chunk.p_evbuffer = motr_reader->get_evbuffer_ownership();
 
-  size_t bytes_in_chunk_count = 0;
-
-  if (data_blocks_read.empty()) {
+  if (chunk.blocks.empty()) {
     s3_log(S3_LOG_ERROR, request_id, "Motr reader returned no data");
 
+    if (chunk.p_evbuffer) {
+      ::evbuffer_free(chunk.p_evbuffer);
+    }
     copy_failed = true;
     set_s3_error("InternalError");
 
-    if (!write_in_progress) {
-      this->on_failure();
-    }
+    continue_copy();
     return;
   }
+  assert(chunk.p_evbuffer != nullptr);
+
   // Calculating actial size of data that has just been read
+  size_t bytes_in_chunk_count = 0;
 
-  for (size_t i = 0, n = data_blocks_read.size(); i < n; ++i) {
-    const auto motr_block_size = data_blocks_read[i].second;
+  for (size_t i = 0, n = chunk.blocks.size(); i < n; ++i) {
+    const auto motr_block_size = chunk.blocks[i].second;
     assert(motr_block_size == size_of_ev_buffer);
 
     // We can use multiplication, but something may change in the future
@@ -139,29 +251,24 @@ void S3ObjectDataCopier::read_data_block_success() {
     s3_log(S3_LOG_DEBUG, request_id,
            "Too many data has been read. Data left - %zu, got - %zu",
            bytes_left_to_read, bytes_in_chunk_count);
-    // get_buffers(data_blocks_read, bytes_in_chunk_count, bytes_left_to_read);
     bytes_in_chunk_count = bytes_left_to_read;
     bytes_left_to_read = 0;
   } else {
     bytes_left_to_read -= bytes_in_chunk_count;
   }
-
   s3_log(S3_LOG_DEBUG, request_id, "Got %zu bytes in %zu blocks",
-         bytes_in_chunk_count, data_blocks_read.size());
+         bytes_in_chunk_count, chunk.blocks.size());
 
-  if (!write_in_progress) {
-    // Anyway we have data for writing here and can kick data writing
-    write_data_block();
+  take_range_data(chunk.blocks, bytes_left_to_read == 0);
 
-    if (write_in_progress && bytes_left_to_read) {
-      // Writing has started successfully.
-      // So we have 'space' for reading.
-      assert(data_blocks_read.empty());
-      assert(!p_evbuffer_read);
-
-      read_data_block();
-    }
+  if (chunk.blocks.empty()) {
+    // All of it is before the range or moved to the next chunk
+    ::evbuffer_free(chunk.p_evbuffer);
+  } else {
+    data_read.push_back(std::move(chunk));
   }
+  continue_copy();
+
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -176,43 +283,105 @@ void S3ObjectDataCopier::read_data_block_failed() {
   set_s3_error(motr_reader->get_state() == S3MotrReaderOpState::failed_to_launch
                    ? "ServiceUnavailable"
                    : "InternalError");
-  if (!write_in_progress) {
-    this->on_failure();
-  }
+  continue_copy();
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+// Leaves in blocks only the data of the range. When the range doesn't start
+// at an ev buffer boundary, writer still needs whole buffers, so data is
+// moved down in place by data_shift bytes: each buffer gets the end of the
+// previous one followed by its own start. End of the last buffer is kept in
+// shifted_tail for the next chunk.
+void S3ObjectDataCopier::take_range_data(S3BufferSequence& blocks,
+                                         bool f_last_chunk) {
+  const size_t buf_size = size_of_ev_buffer;
+
+  while (bytes_to_skip >= buf_size && !blocks.empty()) {
+    blocks.pop_front();
+    bytes_to_skip -= buf_size;
+  }
+  if (bytes_to_skip && !blocks.empty()) {
+    data_shift = bytes_to_skip;
+    bytes_to_skip = 0;
+  }
+  if (data_shift && !blocks.empty()) {
+    const size_t shift = data_shift;
+    const size_t rest = buf_size - shift;
+    std::string next_tail;
+    // Writer reads whole ev buffers, the last block included
+    next_tail.reserve(buf_size);
+    next_tail.assign((const char*)blocks.back().first + shift, rest);
+
+    for (size_t i = blocks.size() - 1; i > 0; --i) {
+      char* p_block = (char*)blocks[i].first;
+
+      memmove(p_block + rest, p_block, shift);
+      memcpy(p_block, (const char*)blocks[i - 1].first + shift, rest);
+    }
+    if (shifted_tail.empty()) {
+      // Range starts in the first buffer, its data is in the second one now
+      blocks.pop_front();
+    } else {
+      char* p_block = (char*)blocks.front().first;
+
+      memmove(p_block + rest, p_block, shift);
+      memcpy(p_block, shifted_tail.data(), rest);
+    }
+    shifted_tail = std::move(next_tail);
+  }
+  const size_t bytes_in_blocks = blocks.size() * buf_size;
+
+  if (bytes_in_blocks >= bytes_left_to_write) {
+    blocks.resize((bytes_left_to_write + buf_size - 1) / buf_size);
+    if (bytes_left_to_write % buf_size) {
+      blocks.back().second = bytes_left_to_write % buf_size;
+    }
+    bytes_left_to_write = 0;
+  } else {
+    bytes_left_to_write -= bytes_in_blocks;
+
+    if (f_last_chunk && !shifted_tail.empty()) {
+      // Range ends in the tail, it is written straight from shifted_tail,
+      // which isn't changed anymore
+      const size_t len = std::min(bytes_left_to_write, shifted_tail.length());
+
+      blocks.emplace_back(&shifted_tail[0], len);
+      bytes_left_to_write -= len;
+    }
+  }
+  if (f_last_chunk && bytes_left_to_write) {
+    s3_log(S3_LOG_ERROR, request_id, "%zu bytes of range are not read",
+           bytes_left_to_write);
+  }
+}
+
 void S3ObjectDataCopier::write_data_block() {
   s3_log(S3_LOG_INFO, request_id, "%s Entry\n", __func__);
 
-  assert(!write_in_progress);
+  assert(!data_read.empty());
 
-  assert(!data_blocks_read.empty());
+  DataRead chunk = std::move(data_read.front());
+  data_read.pop_front();
 
-  assert(p_evbuffer_read != nullptr);
-  assert(!p_evbuffer_write);
-  p_evbuffer_write = p_evbuffer_read;
-  p_evbuffer_read = nullptr;
+  assert(chunk.p_evbuffer != nullptr);
+  evbuffers_written.push_back(chunk.p_evbuffer);
 
-  // We have just separated part of data for writing and
-  // also freed a 'slot' for futher reading
   motr_writer->write_content(
       std::bind(&S3ObjectDataCopier::write_data_block_success, this),
       std::bind(&S3ObjectDataCopier::write_data_block_failed, this),
-      std::move(data_blocks_read), size_of_ev_buffer);
+      std::move(chunk.blocks), size_of_ev_buffer);
+  // Checksum context of a part is initialised by its first write only
+  motr_writer->first_write_part_request(false);
 
   if (motr_writer->get_state() == S3MotrWiterOpState::failed_to_launch) {
     s3_log(S3_LOG_ERROR, request_id, "Write of data block failed to start");
 
+    ::evbuffer_free(evbuffers_written.back());
+    evbuffers_written.pop_back();
+
     copy_failed = true;
     set_s3_error("ServiceUnavailable");
-
-    if (!read_in_progress) {
-      this->on_failure();
-    }
-  } else {
-    write_in_progress = true;
   }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
@@ -220,47 +389,16 @@ void S3ObjectDataCopier::write_data_block() {
 void S3ObjectDataCopier::write_data_block_success() {
   s3_log(S3_LOG_INFO, request_id, "%s Entry\n", __func__);
 
-  assert(p_evbuffer_write != nullptr);
-  ::evbuffer_free(p_evbuffer_write);
-  p_evbuffer_write = nullptr;
-
-  assert(write_in_progress);
-  write_in_progress = false;
+  assert(!evbuffers_written.empty());
+  ::evbuffer_free(evbuffers_written.front());
+  evbuffers_written.pop_front();
 
   if (check_shutdown_and_rollback()) {
     s3_log(S3_LOG_DEBUG, nullptr, "Shutdown or rollback");
     return;
   }
-  if (copy_failed) {
-    assert(!read_in_progress);
-
-    this->on_failure();
-    return;
-  }
-  if (!data_blocks_read.empty()) {
-    // We have new chunk of data for writing
-    write_data_block();
+  continue_copy();
 
-    if (copy_failed) {
-      // New writing failed to start
-      return;
-    }
-  }
-  assert(!copy_failed);
-  assert(data_blocks_read.empty());
-
-  if (bytes_left_to_read) {
-
-    if (!read_in_progress) {
-      read_data_block();
-    }
-  } else if (!write_in_progress) {
-    // We have read all source's data but the call of write_data_block()
-    // did not start writing.
-    // It means that the function did not find data ready for writing.
-    // So all data has been written.
-    this->on_success();
-  }
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -268,17 +406,19 @@ void S3ObjectDataCopier::write_data_block_failed() {
   s3_log(S3_LOG_INFO, request_id, "%s Entry\n", __func__);
   s3_log(S3_LOG_ERROR, request_id, "Failed to write object data to motr");
 
-  assert(write_in_progress);
-  write_in_progress = false;
+  // Writer reports a failure once all writes in flight are over
+  for (auto* p_evbuffer : evbuffers_written) {
+    ::evbuffer_free(p_evbuffer);
+  }
+  evbuffers_written.clear();
 
   copy_failed = true;
 
   set_s3_error(motr_writer->get_state() == S3MotrWiterOpState::failed_to_launch
                    ? "ServiceUnavailable"
                    : "InternalError");
-  if (!read_in_progress) {
-    this->on_failure();
-  }
+  continue_copy();
+
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
@@ -287,10 +427,23 @@ void S3ObjectDataCopier::copy(
     struct m0_fid pvid, std::function<bool(void)> check_shutdown_and_rollback,
     std::function<void(void)> on_success,
     std::function<void(void)> on_failure) {
+  assert(object_size > 0);
+
+  copy_range(src_obj_id, 0, object_size - 1, layout_id, pvid,
+             std::move(check_shutdown_and_rollback), std::move(on_success),
+             std::move(on_failure));
+}
+
+void S3ObjectDataCopier::copy_range(
+    struct m0_uint128 src_obj_id, size_t first_byte_offset,
+    size_t last_byte_offset, int layout_id, struct m0_fid pvid,
+    std::function<bool(void)> check_shutdown_and_rollback,
+    std::function<void(void)> on_success,
+    std::function<void(void)> on_failure) {
   s3_log(S3_LOG_INFO, request_id, "%s Entry\n", __func__);
 
   assert(non_zero(src_obj_id));
-  assert(object_size > 0);
+  assert(first_byte_offset <= last_byte_offset);
   assert(layout_id > 0);
   assert(check_shutdown_and_rollback);
   assert(on_success);
@@ -303,17 +456,29 @@ void S3ObjectDataCopier::copy(
   motr_unit_size =
       S3MotrLayoutMap::get_instance()->get_unit_size_for_layout(layout_id);
 
+  const size_t read_start =
+      first_byte_offset - first_byte_offset % motr_unit_size;
+
   motr_reader = motr_reader_factory->create_motr_reader(
       request_object, src_obj_id, layout_id, pvid, motr_api);
-  motr_reader->set_last_index(0);
+  motr_reader->set_last_index(read_start);
 
-  bytes_left_to_read = object_size;
+  bytes_left_to_read = last_byte_offset + 1 - read_start;
+  bytes_left_to_launch = bytes_left_to_read;
+  bytes_to_skip = first_byte_offset - read_start;
+  bytes_left_to_write = last_byte_offset + 1 - first_byte_offset;
+  data_shift = 0;
+  shifted_tail.clear();
+  copy_window =
+      std::max<size_t>(S3Option::get_instance()->get_motr_copy_window(), 1);
 
   copy_failed = false;
   read_in_progress = false;
-  write_in_progress = false;
+  read_ahead_draining = false;
+  in_continue_copy = false;
+  continue_copy_again = false;
 
-  read_data_block();
+  continue_copy();
 
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
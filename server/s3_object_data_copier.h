@@ -20,6 +20,7 @@
 #pragma once
 
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -36,6 +37,14 @@ class S3MotrReaderFactory;
 class S3MotrWiter;
 struct evbuffer;
 
+// Copies data of a motr object, or a byte range of it, into the object of
+// motr_writer.
+//
+// The copy is pipelined: up to S3_MOTR_COPY_WINDOW chunks of data are being
+// read, waiting for writing or being written at a time, so reads of the
+// following chunks overlap writes of the earlier ones. Reads beyond the
+// current one are launched ahead only while the memory pool is above its
+// reserve.
 class S3ObjectDataCopier {
 
   std::string request_id;
@@ -51,25 +60,52 @@ class S3ObjectDataCopier {
   std::shared_ptr<MotrAPI> motr_api;
   std::shared_ptr<S3MotrReader> motr_reader;
 
-  S3BufferSequence data_blocks_read;  // Source's data has been read but not
-                                      // taken for writing.
-
-  // All POD variables should be (re)initialized in This::copy()
+  // Chunk of source's data that has been read but not taken for writing
+  struct DataRead {
+    S3BufferSequence blocks;
+    // Ev buffer containing the data, freed after write completion
+    struct evbuffer* p_evbuffer;
+  };
+  std::deque<DataRead> data_read;  // Oldest first
+  // Ev buffers of writes in flight, oldest first. The writer reports writes
+  // in submission order, so the front one is freed on each success.
+  std::deque<struct evbuffer*> evbuffers_written;
+  // Block counts of reads launched ahead of read_object_data() calls
+  std::deque<size_t> read_ahead_blocks;
+
+  // All POD variables should be (re)initialized in This::copy_range()
   size_t bytes_left_to_read;
+  size_t bytes_left_to_launch;  // Not covered by reads launched yet
+  // Reads start at the motr unit holding the first byte of the range, the
+  // data before it is dropped
+  size_t bytes_to_skip;
+  size_t bytes_left_to_write;  // Part of the range not taken for writing
+  // Offset of the range's first byte in an ev buffer. If not 0, data is
+  // moved down by it to fill whole ev buffers, see take_range_data().
+  size_t data_shift;
+  // End of the last chunk read, moved to the start of the next chunk
+  std::string shifted_tail;
   size_t motr_unit_size;
+  // Maximum chunks being read, waiting for writing or being written
+  size_t copy_window;
   bool copy_failed;
   bool read_in_progress;
-  bool write_in_progress;
+  bool read_ahead_draining;
+  bool in_continue_copy;
+  bool continue_copy_again;
   // Size of each ev buffer (e.g, 16384)
   size_t size_of_ev_buffer;
 
-  struct evbuffer* p_evbuffer_read = nullptr;
-  struct evbuffer* p_evbuffer_write = nullptr;
-
-  void cleanup_blocks_written();
+  size_t get_chunks_in_flight() const;
+  size_t get_blocks_for_next_read() const;
+  bool memory_allows_read_ahead() const;
+  void continue_copy();
+  void read_ahead();
+  void read_ahead_drained();
   void read_data_block();
   void read_data_block_success();
   void read_data_block_failed();
+  void take_range_data(S3BufferSequence& blocks, bool f_last_chunk);
   void write_data_block();
   void write_data_block_success();
   void write_data_block_failed();
@@ -88,6 +124,12 @@ class S3ObjectDataCopier {
             std::function<bool(void)> check_shutdown_and_rollback,
             std::function<void(void)> on_success,
             std::function<void(void)> on_failure);
+  // Copies bytes [first_byte_offset, last_byte_offset] of the source
+  void copy_range(struct m0_uint128 src_obj_id, size_t first_byte_offset,
+                  size_t last_byte_offset, int layout_id, struct m0_fid pvid,
+                  std::function<bool(void)> check_shutdown_and_rollback,
+                  std::function<void(void)> on_success,
+                  std::function<void(void)> on_failure);
 
   const std::string& get_s3_error() { return s3_error; }
   // Trims input 'buffer' to the expected size
@@ -98,13 +140,19 @@ class S3ObjectDataCopier {
 
   friend class S3ObjectDataCopierTest;
 
+  FRIEND_TEST(S3ObjectDataCopierTest, CopyStartsWithOneRead);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockStarted);
+  FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockTakesReadAhead);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockFailedToStart);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockSuccessWhileShuttingDown);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockSuccessCopyFailed);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockSuccessShouldStartWrite);
+  FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockSuccessReadsAheadInWindow);
+  FRIEND_TEST(S3ObjectDataCopierTest, ReadAheadStopsWhenReaderRefuses);
+  FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockFailedDrainsReadAhead);
   FRIEND_TEST(S3ObjectDataCopierTest, ReadDataBlockFailed);
   FRIEND_TEST(S3ObjectDataCopierTest, WriteObjectStarted);
+  FRIEND_TEST(S3ObjectDataCopierTest, WritesArePipelinedWhileWriterAllows);
   FRIEND_TEST(S3ObjectDataCopierTest, WriteObjectFailedShouldUndoMarkProgress);
   FRIEND_TEST(S3ObjectDataCopierTest, WriteObjectFailedDuetoEntityOpenFailure);
   FRIEND_TEST(S3ObjectDataCopierTest, WriteObjectSuccessfulWhileShuttingDown);
@@ -112,4 +160,8 @@ class S3ObjectDataCopier {
               WriteObjectSuccessfulShouldRestartWritingData);
   FRIEND_TEST(S3ObjectDataCopierTest,
               WriteObjectSuccessfulDoNextStepWhenAllIsWritten);
+  FRIEND_TEST(S3ObjectDataCopierTest, WriteFailedWaitsForReadInFlight);
+  FRIEND_TEST(S3ObjectDataCopierTest, CopyRangeStartsAtUnitOfFirstByte);
+  FRIEND_TEST(S3ObjectDataCopierTest, TakeRangeDataDropsWholeBuffers);
+  FRIEND_TEST(S3ObjectDataCopierTest, TakeRangeDataShiftsData);
 };
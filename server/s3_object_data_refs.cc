@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <map>
+#include <utility>
+
+#include <json/json.h>
+
+#include "s3_factory.h"
+#include "s3_log.h"
+#include "s3_m0_uint128_helper.h"
+#include "s3_metadata_record.h"
+#include "s3_motr_kvs_reader.h"
+#include "s3_motr_kvs_writer.h"
+#include "s3_object_data_refs.h"
+#include "s3_option.h"
+
+extern struct s3_motr_idx_layout global_object_data_ref_index_layout;
+
+S3ObjectDataRefs::S3ObjectDataRefs(
+    std::shared_ptr<RequestObject> req, std::shared_ptr<MotrAPI> motr_api,
+    std::shared_ptr<S3MotrKVSReaderFactory> kvs_reader_factory,
+    std::shared_ptr<S3MotrKVSWriterFactory> kvs_writer_factory)
+    : request(std::move(req)), s3_motr_api(std::move(motr_api)) {
+  request_id = request->get_request_id();
+  stripped_request_id = request->get_stripped_request_id();
+
+  if (kvs_reader_factory) {
+    motr_kvs_reader_factory = std::move(kvs_reader_factory);
+  } else {
+    motr_kvs_reader_factory = std::make_shared<S3MotrKVSReaderFactory>();
+  }
+  if (kvs_writer_factory) {
+    motr_kvs_writer_factory = std::move(kvs_writer_factory);
+  } else {
+    motr_kvs_writer_factory = std::make_shared<S3MotrKVSWriterFactory>();
+  }
+}
+
+bool S3ObjectDataRefs::is_enabled() {
+  return S3Option::get_instance()->is_copy_object_by_reference_enabled();
+}
+
+std::string S3ObjectDataRefs::get_marker_key(const struct m0_uint128& oid) {
+  return S3M0Uint128Helper::to_string(oid);
+}
+
+// Encoded OIDs have fixed length, so the marker key followed by '/' is a
+// prefix of references of this data only
+std::string S3ObjectDataRefs::get_ref_key(const struct m0_uint128& oid,
+                                          const Ref& ref) {
+  return get_marker_key(oid) + '/' +
+         S3M0Uint128Helper::to_string(ref.object_list_index_layout.oid) +
+         '/' + ref.version_id + '/' + ref.object_name;
+}
+
+std::string S3ObjectDataRefs::ref_to_json(const Ref& ref, time_t create_time) {
+  Json::Value root;
+
+  root["object_list_index_layout"] =
+      S3M0Uint128Helper::to_string(ref.object_list_index_layout);
+  root["object_key_in_index"] = ref.object_name;
+  root["version_id"] = ref.version_id;
+  root["create_time"] = (Json::UInt64)create_time;
+
+  Json::FastWriter fastWriter;
+  return fastWriter.write(root);
+}
+
+bool S3ObjectDataRefs::ref_from_json(const std::string& json, Ref& ref,
+                                     time_t& create_time) {
+  Json::Value root;
+  Json::Reader reader;
+
+  if (!reader.parse(json, root) || !root.isObject()) {
+    return false;
+  }
+  ref.object_list_index_layout = S3M0Uint128Helper::to_idx_layout(
+      root["object_list_index_layout"].asString());
+  ref.object_name = root["object_key_in_index"].asString();
+  ref.version_id = root["version_id"].asString();
+  create_time = (time_t)root["create_time"].asUInt64();
+
+  return !ref.object_name.empty();
+}
+
+bool S3ObjectDataRefs::is_ref_live(const std::string& metadata,
+                                   const struct m0_uint128& oid,
+                                   const Ref& ref) {
+  Json::Value root;
+
+  if (!S3MetadataRecord::parse(metadata, root) || !root.isObject()) {
+    return false;
+  }
+  return root["motr_oid"].asString() == S3M0Uint128Helper::to_string(oid) &&
+         root["System-Defined"]["x-amz-version-id"].asString() ==
+             ref.version_id;
+}
+
+void S3ObjectDataRefs::add(const struct m0_uint128& oid, const Ref& source,
+                           const Ref& copy,
+                           std::function<void(void)> on_success,
+                           std::function<void(void)> on_failed) {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  handler_on_success = std::move(on_success);
+  handler_on_failed = std::move(on_failed);
+  data_oid = oid;
+  source_ref = source;
+  copy_ref = copy;
+
+  const time_t now = time(nullptr);
+  std::map<std::string, std::string> kvs;
+
+  kvs[get_marker_key(oid)] = "{}";
+  kvs[get_ref_key(oid, source)] = ref_to_json(source, now);
+  kvs[get_ref_key(oid, copy)] = ref_to_json(copy, now);
+
+  motr_kvs_writer =
+      motr_kvs_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
+  motr_kvs_writer->put_keyval(
+      global_object_data_ref_index_layout, kvs,
+      std::bind(&S3ObjectDataRefs::add_refs_successful, this),
+      std::bind(&S3ObjectDataRefs::add_refs_failed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3ObjectDataRefs::add_refs_successful() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  // Source could be deleted before the references were seen by its deleter
+  motr_kvs_reader =
+      motr_kvs_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
+  motr_kvs_reader->get_keyval(
+      source_ref.object_list_index_layout, source_ref.object_name,
+      std::bind(&S3ObjectDataRefs::verify_source_successful, this),
+      std::bind(&S3ObjectDataRefs::verify_source_failed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3ObjectDataRefs::add_refs_failed() {
+  s3_log(S3_LOG_ERROR, request_id, "Failed to add data references\n");
+
+  if (motr_kvs_writer->get_state() ==
+      S3MotrKVSWriterOpState::failed_to_launch) {
+    state = S3ObjectDataRefsOpState::failed_to_launch;
+  } else {
+    state = S3ObjectDataRefsOpState::failed;
+  }
+  handler_on_failed();
+}
+
+void S3ObjectDataRefs::verify_source_successful() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  if (is_ref_live(motr_kvs_reader->get_value(), data_oid, source_ref)) {
+    state = S3ObjectDataRefsOpState::added;
+    handler_on_success();
+  } else {
+    s3_log(S3_LOG_WARN, request_id, "Source object [%s] was overwritten\n",
+           source_ref.object_name.c_str());
+    state = S3ObjectDataRefsOpState::source_changed;
+    remove_added_refs();
+  }
+}
+
+void S3ObjectDataRefs::verify_source_failed() {
+  const auto reader_state = motr_kvs_reader->get_state();
+
+  if (reader_state == S3MotrKVSReaderOpState::missing) {
+    s3_log(S3_LOG_WARN, request_id, "Source object [%s] was deleted\n",
+           source_ref.object_name.c_str());
+    state = S3ObjectDataRefsOpState::source_missing;
+    remove_added_refs();
+    return;
+  }
+  // Source may still be there, references which were added stay until the
+  // deletion check finds them stale
+  if (reader_state == S3MotrKVSReaderOpState::failed_to_launch) {
+    state = S3ObjectDataRefsOpState::failed_to_launch;
+  } else {
+    s3_log(S3_LOG_ERROR, request_id, "Failed to read source metadata\n");
+    state = S3ObjectDataRefsOpState::failed;
+  }
+  handler_on_failed();
+}
+
+// The source version no longer points to the data and the copy won't be
+// saved, so neither reference can become live. Otherwise they would keep
+// the data as pending for pending_ref_timeout_sec. The marker stays, other
+// copies may share the data, and the deletion check drops it when unused.
+void S3ObjectDataRefs::remove_added_refs() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  std::vector<std::string> keys = {get_ref_key(data_oid, source_ref),
+                                   get_ref_key(data_oid, copy_ref)};
+
+  motr_kvs_writer->delete_keyval(
+      global_object_data_ref_index_layout, keys,
+      std::bind(&S3ObjectDataRefs::added_refs_removed, this),
+      std::bind(&S3ObjectDataRefs::added_refs_removed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+// Best effort, references left behind are dropped by the deletion check
+void S3ObjectDataRefs::added_refs_removed() { handler_on_failed(); }
+
+void S3ObjectDataRefs::check(std::vector<struct m0_uint128> oids,
+                             std::function<void(void)> on_done) {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry with %zu objects\n",
+         __func__, oids.size());
+
+  handler_on_success = std::move(on_done);
+  oids_to_check = std::move(oids);
+  data_states.assign(oids_to_check.size(), S3ObjectDataState::unreferenced);
+  check_index = 0;
+
+  // Data which was never shared has no marker, one lookup covers all
+  std::vector<std::string> keys;
+  keys.reserve(oids_to_check.size());
+
+  for (const auto& oid : oids_to_check) {
+    keys.push_back(get_marker_key(oid));
+  }
+  motr_kvs_reader =
+      motr_kvs_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
+  motr_kvs_reader->get_keyval(
+      global_object_data_ref_index_layout, keys,
+      std::bind(&S3ObjectDataRefs::get_markers_successful, this),
+      std::bind(&S3ObjectDataRefs::get_markers_failed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3ObjectDataRefs::get_markers_successful() {
+  const auto& kvs = motr_kvs_reader->get_key_values();
+
+  // Shared data is marked referenced until its references are checked
+  for (size_t i = 0; i < oids_to_check.size(); ++i) {
+    auto it = kvs.find(get_marker_key(oids_to_check[i]));
+
+    if (it != kvs.end() && it->second.first == 0) {
+      data_states[i] = S3ObjectDataState::referenced;
+    }
+  }
+  check_next_object();
+}
+
+void S3ObjectDataRefs::get_markers_failed() {
+  if (motr_kvs_reader->get_state() == S3MotrKVSReaderOpState::missing) {
+    s3_log(S3_LOG_DEBUG, request_id, "No data is shared\n");
+  } else {
+    s3_log(S3_LOG_ERROR, request_id, "Failed to look up data references\n");
+    data_states.assign(oids_to_check.size(), S3ObjectDataState::unknown);
+  }
+  handler_on_success();
+}
+
+void S3ObjectDataRefs::check_next_object() {
+  while (check_index < oids_to_check.size() &&
+         data_states[check_index] != S3ObjectDataState::referenced) {
+    ++check_index;
+  }
+  if (check_index == oids_to_check.size()) {
+    handler_on_success();
+    return;
+  }
+  refs_found.clear();
+  stale_ref_keys.clear();
+  has_pending_ref = false;
+
+  list_refs(get_marker_key(oids_to_check[check_index]) + '/');
+}
+
+void S3ObjectDataRefs::list_refs(const std::string& start_key) {
+  motr_kvs_reader->next_keyval(
+      global_object_data_ref_index_layout, start_key, refs_per_listing,
+      std::bind(&S3ObjectDataRefs::list_refs_successful, this),
+      std::bind(&S3ObjectDataRefs::list_refs_failed, this));
+}
+
+void S3ObjectDataRefs::list_refs_successful() {
+  const std::string prefix =
+      get_marker_key(oids_to_check[check_index]) + '/';
+  const auto& kvs = motr_kvs_reader->get_key_values();
+  std::string last_key;
+
+  for (const auto& kv : kvs) {
+    if (kv.first.compare(0, prefix.length(), prefix) != 0) {
+      // Past references of this data
+      ref_index = 0;
+      verify_next_ref();
+      return;
+    }
+    RefRecord record;
+    record.key = kv.first;
+
+    if (ref_from_json(kv.second.second, record.ref, record.create_time)) {
+      refs_found.push_back(std::move(record));
+    } else {
+      s3_log(S3_LOG_WARN, request_id, "Malformed data reference [%s]\n",
+             kv.first.c_str());
+      stale_ref_keys.push_back(kv.first);
+    }
+    last_key = kv.first;
+  }
+  if (kvs.size() < refs_per_listing) {
+    ref_index = 0;
+    verify_next_ref();
+  } else {
+    list_refs(last_key);
+  }
+}
+
+void S3ObjectDataRefs::list_refs_failed() {
+  if (motr_kvs_reader->get_state() == S3MotrKVSReaderOpState::missing) {
+    ref_index = 0;
+    verify_next_ref();
+  } else {
+    s3_log(S3_LOG_ERROR, request_id, "Failed to list data references\n");
+    object_checked(S3ObjectDataState::unknown);
+  }
+}
+
+void S3ObjectDataRefs::verify_next_ref() {
+  if (ref_index == refs_found.size()) {
+    // None of the objects refers to the data any more
+    if (has_pending_ref) {
+      drop_stale_refs(false, S3ObjectDataState::unknown);
+    } else {
+      drop_stale_refs(true, S3ObjectDataState::unreferenced);
+    }
+    return;
+  }
+  const Ref& ref = refs_found[ref_index].ref;
+
+  motr_kvs_reader->get_keyval(
+      ref.object_list_index_layout, ref.object_name,
+      std::bind(&S3ObjectDataRefs::verify_ref_successful, this),
+      std::bind(&S3ObjectDataRefs::verify_ref_failed, this));
+}
+
+void S3ObjectDataRefs::verify_ref_successful() {
+  const RefRecord& record = refs_found[ref_index];
+
+  if (is_ref_live(motr_kvs_reader->get_value(), oids_to_check[check_index],
+                  record.ref)) {
+    s3_log(S3_LOG_INFO, stripped_request_id,
+           "Data is still referenced by object [%s]\n",
+           record.ref.object_name.c_str());
+    drop_stale_refs(false, S3ObjectDataState::referenced);
+    return;
+  }
+  verify_ref_failed();
+}
+
+// Also called for metadata which no longer points to the data
+void S3ObjectDataRefs::verify_ref_failed() {
+  const auto reader_state = motr_kvs_reader->get_state();
+
+  if (reader_state != S3MotrKVSReaderOpState::present &&
+      reader_state != S3MotrKVSReaderOpState::missing) {
+    s3_log(S3_LOG_ERROR, request_id, "Failed to look up referring object\n");
+    object_checked(S3ObjectDataState::unknown);
+    return;
+  }
+  const RefRecord& record = refs_found[ref_index];
+
+  if (time(nullptr) - record.create_time < pending_ref_timeout_sec) {
+    has_pending_ref = true;
+  } else {
+    stale_ref_keys.push_back(record.key);
+  }
+  ++ref_index;
+  verify_next_ref();
+}
+
+// Best effort, stale references are looked at again next time
+void S3ObjectDataRefs::drop_stale_refs(bool drop_marker,
+                                       S3ObjectDataState data_state) {
+  checked_data_state = data_state;
+
+  if (drop_marker) {
+    stale_ref_keys.push_back(get_marker_key(oids_to_check[check_index]));
+  }
+  if (stale_ref_keys.empty()) {
+    object_checked(data_state);
+    return;
+  }
+  s3_log(S3_LOG_DEBUG, request_id, "Dropping %zu data references\n",
+         stale_ref_keys.size());
+
+  if (!motr_kvs_writer) {
+    motr_kvs_writer =
+        motr_kvs_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
+  }
+  motr_kvs_writer->delete_keyval(
+      global_object_data_ref_index_layout, stale_ref_keys,
+      std::bind(&S3ObjectDataRefs::stale_refs_dropped, this),
+      std::bind(&S3ObjectDataRefs::stale_refs_dropped, this));
+}
+
+void S3ObjectDataRefs::stale_refs_dropped() {
+  object_checked(checked_data_state);
+}
+
+void S3ObjectDataRefs::object_checked(S3ObjectDataState data_state) {
+  data_states[check_index] = data_state;
+  stale_ref_keys.clear();
+  ++check_index;
+  check_next_object();
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_OBJECT_DATA_REFS_H__
+#define __S3_SERVER_S3_OBJECT_DATA_REFS_H__
+
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest_prod.h>
+
+#include "s3_motr_context.h"
+
+class MotrAPI;
+class RequestObject;
+class S3MotrKVSReader;
+class S3MotrKVSReaderFactory;
+class S3MotrKVSWriter;
+class S3MotrKVSWriterFactory;
+
+enum class S3ObjectDataRefsOpState {
+  empty,
+  added,
+  source_missing,  // Source object was deleted before its data got shared
+  source_changed,  // Source object was overwritten
+  failed_to_launch,
+  failed,
+};
+
+// What deletion of an object data may do
+enum class S3ObjectDataState {
+  unreferenced,  // No object refers to the data, it can be deleted
+  referenced,    // Some other object still refers to the data, keep it
+  unknown,       // Lookup failed or a copy may be in progress, retry later
+};
+
+// Objects sharing data of one Motr object, made by CopyObject when
+// S3_COPY_OBJECT_BY_REFERENCE is enabled.
+//
+// Records are kept in global_object_data_ref_index_layout. Key "<oid>"
+// marks the data as shared, and there is a "<oid>/..." key for each object
+// metadata record (index, name and version) which refers to the data. Keys
+// are only ever added by copies and dropped once their metadata record is
+// gone, so concurrent copies don't need to agree on a counter.
+//
+// Data without the marker belongs to the object it was written for, as
+// before. With the marker it is deleted only if none of the recorded
+// objects still point to it. Every data deletion goes through
+// S3MotrWiter, which calls check() first, including the ones requested by
+// s3backgrounddelete.
+//
+// A copy adds references to both source and destination, then reads the
+// source metadata again. Deleters remove metadata before checking the
+// references, so either the copy sees the source gone and fails, or the
+// deleter sees the new references and keeps the data. References younger
+// than pending_ref_timeout_sec are never dropped, their copy may still be
+// saving the destination metadata.
+class S3ObjectDataRefs {
+ public:
+  // Object metadata record referring to the data
+  struct Ref {
+    struct s3_motr_idx_layout object_list_index_layout;
+    std::string object_name;
+    std::string version_id;
+  };
+
+  // Same age as background delete waits for before it treats a new object
+  // as leaked
+  static const time_t pending_ref_timeout_sec = 15 * 60;
+  // References listed per KV request
+  static const size_t refs_per_listing = 32;
+
+ private:
+  std::shared_ptr<RequestObject> request;
+  std::shared_ptr<MotrAPI> s3_motr_api;
+  std::shared_ptr<S3MotrKVSReaderFactory> motr_kvs_reader_factory;
+  std::shared_ptr<S3MotrKVSWriterFactory> motr_kvs_writer_factory;
+  std::shared_ptr<S3MotrKVSReader> motr_kvs_reader;
+  std::shared_ptr<S3MotrKVSWriter> motr_kvs_writer;
+
+  std::string request_id;
+  std::string stripped_request_id;
+
+  std::function<void()> handler_on_success;
+  std::function<void()> handler_on_failed;
+  S3ObjectDataRefsOpState state = S3ObjectDataRefsOpState::empty;
+
+  // add()
+  struct m0_uint128 data_oid = {};
+  Ref source_ref;
+  Ref copy_ref;
+
+  // check()
+  struct RefRecord {
+    std::string key;
+    Ref ref;
+    time_t create_time;
+  };
+  std::vector<struct m0_uint128> oids_to_check;
+  std::vector<S3ObjectDataState> data_states;
+  size_t check_index = 0;
+  std::vector<RefRecord> refs_found;
+  size_t ref_index = 0;
+  std::vector<std::string> stale_ref_keys;
+  bool has_pending_ref = false;
+  S3ObjectDataState checked_data_state = S3ObjectDataState::unknown;
+
+  void add_refs_successful();
+  void add_refs_failed();
+  void verify_source_successful();
+  void verify_source_failed();
+  void remove_added_refs();
+  void added_refs_removed();
+
+  void get_markers_successful();
+  void get_markers_failed();
+  void check_next_object();
+  void list_refs(const std::string& start_key);
+  void list_refs_successful();
+  void list_refs_failed();
+  void verify_next_ref();
+  void verify_ref_successful();
+  void verify_ref_failed();
+  void drop_stale_refs(bool drop_marker, S3ObjectDataState data_state);
+  void stale_refs_dropped();
+  void object_checked(S3ObjectDataState data_state);
+
+ public:
+  S3ObjectDataRefs(
+      std::shared_ptr<RequestObject> req,
+      std::shared_ptr<MotrAPI> motr_api = nullptr,
+      std::shared_ptr<S3MotrKVSReaderFactory> kvs_reader_factory = nullptr,
+      std::shared_ptr<S3MotrKVSWriterFactory> kvs_writer_factory = nullptr);
+
+  static bool is_enabled();
+
+  static std::string get_marker_key(const struct m0_uint128& oid);
+  static std::string get_ref_key(const struct m0_uint128& oid, const Ref& ref);
+  static std::string ref_to_json(const Ref& ref, time_t create_time);
+  static bool ref_from_json(const std::string& json, Ref& ref,
+                            time_t& create_time);
+  // true if the object metadata record still is the one ref points to
+  static bool is_ref_live(const std::string& metadata,
+                          const struct m0_uint128& oid, const Ref& ref);
+
+  S3ObjectDataRefsOpState get_state() const { return state; }
+
+  // Makes data of the source object (oid) shared with the copy. on_success
+  // is called only if the source metadata still points to the data
+  // afterwards, so the copy's metadata can be saved. Otherwise references
+  // added for the source and the copy are removed before on_failed.
+  void add(const struct m0_uint128& oid, const Ref& source, const Ref& copy,
+           std::function<void(void)> on_success,
+           std::function<void(void)> on_failed);
+
+  // Finds out whether data of each object may be deleted, see
+  // get_data_state(). Callers must have removed the metadata of the object
+  // being deleted. References whose metadata is gone are dropped.
+  void check(std::vector<struct m0_uint128> oids,
+             std::function<void(void)> on_done);
+
+  S3ObjectDataState get_data_state(size_t index) const {
+    return data_states[index];
+  }
+
+  FRIEND_TEST(S3ObjectDataRefsTest, AddSucceedsWhenSourceIsUnchanged);
+  FRIEND_TEST(S3ObjectDataRefsTest, AddFailsWhenSourceChanged);
+  FRIEND_TEST(S3ObjectDataRefsTest, AddFailsWhenSourceMissing);
+  FRIEND_TEST(S3ObjectDataRefsTest, AddFailureKeepsRefsOnLookupError);
+  FRIEND_TEST(S3ObjectDataRefsTest, CheckWithoutMarkersAllowsDeletion);
+  FRIEND_TEST(S3ObjectDataRefsTest, CheckFailureKeepsAllData);
+  FRIEND_TEST(S3ObjectDataRefsTest, CheckListsRefsOfSharedDataOnly);
+  FRIEND_TEST(S3ObjectDataRefsTest, CheckKeepsPendingRefs);
+  FRIEND_TEST(S3ObjectDataRefsTest, CheckDropsMarkerOfUnreferencedData);
+};
+
+#endif  // __S3_SERVER_S3_OBJECT_DATA_REFS_H__
@@ -21,8 +21,8 @@
 
 #include <evhttp.h>
 #include "s3_object_list_response.h"
-#include "s3_common_utilities.h"
 #include "s3_log.h"
+#include "s3_xml_writer.h"
 
 S3ObjectListResponse::S3ObjectListResponse(const std::string& encoding_type)
     : encoding_type(encoding_type),
@@ -204,187 +204,172 @@ std::string& S3ObjectListResponse::get_xml(
     const std::string requestor_canonical_id,
     const std::string bucket_owner_user_id,
     const std::string requestor_user_id) {
-  // clang-format off
-  response_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-  response_xml +=
-      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
-  response_xml += S3CommonUtilities::format_xml_string("Name", bucket_name);
-  response_xml +=
-      S3CommonUtilities::format_xml_string("Prefix", request_prefix);
+  S3XmlWriter writer;
+  write_xml(writer, requestor_canonical_id, bucket_owner_user_id,
+            requestor_user_id);
+  response_xml = writer.to_string();
+  return response_xml;
+}
+
+std::string& S3ObjectListResponse::get_multiupload_xml() {
+  S3XmlWriter writer;
+  write_multiupload_xml(writer);
+  response_xml = writer.to_string();
+  return response_xml;
+}
+
+std::string& S3ObjectListResponse::get_multipart_xml() {
+  S3XmlWriter writer;
+  write_multipart_xml(writer);
+  response_xml = writer.to_string();
+  return response_xml;
+}
+
+void S3ObjectListResponse::write_key(S3XmlWriter& writer, const char* tag,
+                                     const std::string& key_value) {
+  if (encoding_type == "url") {
+    writer.element(tag, get_response_format_key_value(key_value));
+  } else {
+    writer.element(tag, key_value);
+  }
+}
+
+void S3ObjectListResponse::write_common_prefixes(S3XmlWriter& writer) {
+  for (auto&& prefix : common_prefixes) {
+    writer.start_element("CommonPrefixes");
+    // Remove the delimiter from the end
+    std::string uri_encode_prefix =
+        get_response_format_key_value(prefix.substr(0, prefix.length() - 1));
+    // Add the delimiter at the end
+    uri_encode_prefix += request_delimiter;
+    writer.element("Prefix", uri_encode_prefix);
+    writer.end_element("CommonPrefixes");
+  }
+}
+
+void S3ObjectListResponse::write_xml(S3XmlWriter& writer,
+                                     const std::string& requestor_canonical_id,
+                                     const std::string& bucket_owner_user_id,
+                                     const std::string& requestor_user_id) {
+  writer.declaration();
+  writer.start_element("ListBucketResult",
+                       "http://s3.amazonaws.com/doc/2006-03-01/");
+  writer.element("Name", bucket_name);
+  writer.element("Prefix", request_prefix);
   // When 'Delimiter' is specified in the request, the response should have
   // 'Delimiter'
   if (!this->get_request_delimiter().empty()) {
-    response_xml +=
-        S3CommonUtilities::format_xml_string("Delimiter", request_delimiter);
+    writer.element("Delimiter", request_delimiter);
   }
   if (encoding_type == "url") {
-    response_xml += S3CommonUtilities::format_xml_string("EncodingType", "url");
+    writer.element("EncodingType", "url");
   }
-  response_xml +=
-      S3CommonUtilities::format_xml_string("Marker", request_marker_key);
-  response_xml += S3CommonUtilities::format_xml_string("MaxKeys", max_keys);
+  writer.element("Marker", request_marker_key);
+  writer.element("MaxKeys", max_keys);
   // When is_truncated is true, the response should have "NextMarker".
   // Refer AWS S3 ListObjects documentation for NextMarker.
   if (this->response_is_truncated) {
-    response_xml +=
-        S3CommonUtilities::format_xml_string("NextMarker", next_marker_key);
+    writer.element("NextMarker", next_marker_key);
   }
-  response_xml += S3CommonUtilities::format_xml_string(
-      "IsTruncated", (response_is_truncated ? "true" : "false"));
+  writer.element("IsTruncated", response_is_truncated ? "true" : "false");
 
   for (auto&& object : object_list) {
-    response_xml += "<Contents>";
-    response_xml += S3CommonUtilities::format_xml_string(
-        "Key", get_response_format_key_value(object->get_object_name()));
-    response_xml += S3CommonUtilities::format_xml_string(
-        "LastModified", object->get_last_modified_iso());
-    response_xml +=
-        S3CommonUtilities::format_xml_string("ETag", object->get_md5(), true);
-    response_xml += S3CommonUtilities::format_xml_string(
-        "Size", object->get_content_length_str());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "StorageClass", object->get_storage_class());
+    writer.start_element("Contents");
+    write_key(writer, "Key", object->get_object_name());
+    writer.element("LastModified", object->get_last_modified_iso());
+    writer.element("ETag", object->get_md5(), true);
+    writer.element("Size", object->get_content_length_str());
+    writer.element("StorageClass", object->get_storage_class());
     if (requestor_canonical_id == object->get_canonical_id() ||
         bucket_owner_user_id == requestor_user_id) {
-    response_xml += "<Owner>";
-    response_xml +=
-        S3CommonUtilities::format_xml_string("ID", object->get_canonical_id());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "DisplayName", object->get_account_name());
-    response_xml += "</Owner>";
+      writer.start_element("Owner");
+      writer.element("ID", object->get_canonical_id());
+      writer.element("DisplayName", object->get_account_name());
+      writer.end_element("Owner");
     }
-    response_xml += "</Contents>";
-  }
-
-  for (auto&& prefix : common_prefixes) {
-    response_xml += "<CommonPrefixes>";
-    std::string prefix_no_delimiter = prefix;
-    // Remove the delimiter from the end
-    prefix_no_delimiter.pop_back();
-    std::string uri_encode_prefix =
-        get_response_format_key_value(prefix_no_delimiter);
-    // Add the delimiter at the end
-    uri_encode_prefix += request_delimiter;
-    response_xml +=
-        S3CommonUtilities::format_xml_string("Prefix", uri_encode_prefix);
-    response_xml += "</CommonPrefixes>";
+    writer.end_element("Contents");
   }
+  write_common_prefixes(writer);
 
-  response_xml += "</ListBucketResult>";
-  // clang-format on
-  return response_xml;
+  writer.end_element("ListBucketResult");
 }
 
-std::string& S3ObjectListResponse::get_multiupload_xml() {
-  // clang-format off
-  response_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-  response_xml +=
-      "<ListMultipartUploadsResult "
-      "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
-  response_xml += S3CommonUtilities::format_xml_string("Bucket", bucket_name);
-  response_xml +=
-      S3CommonUtilities::format_xml_string("KeyMarker", request_marker_key);
-  response_xml += S3CommonUtilities::format_xml_string("UploadIdMarker",
-                                                       request_marker_uploadid);
-  response_xml +=
-      S3CommonUtilities::format_xml_string("NextKeyMarker", next_marker_key);
-  response_xml += S3CommonUtilities::format_xml_string("NextUploadIdMarker",
-                                                       next_marker_uploadid);
-  response_xml +=
-      S3CommonUtilities::format_xml_string("MaxUploads", max_uploads);
-  response_xml += S3CommonUtilities::format_xml_string(
-      "IsTruncated", (response_is_truncated ? "true" : "false"));
+void S3ObjectListResponse::write_multiupload_xml(S3XmlWriter& writer) {
+  writer.declaration();
+  writer.start_element("ListMultipartUploadsResult",
+                       "http://s3.amazonaws.com/doc/2006-03-01/");
+  writer.element("Bucket", bucket_name);
+  writer.element("KeyMarker", request_marker_key);
+  writer.element("UploadIdMarker", request_marker_uploadid);
+  writer.element("NextKeyMarker", next_marker_key);
+  writer.element("NextUploadIdMarker", next_marker_uploadid);
+  writer.element("MaxUploads", max_uploads);
+  writer.element("IsTruncated", response_is_truncated ? "true" : "false");
 
   if (encoding_type == "url") {
-    response_xml += S3CommonUtilities::format_xml_string("EncodingType", "url");
+    writer.element("EncodingType", "url");
   }
 
   for (auto&& object : object_list) {
-    response_xml += "<Upload>";
-    response_xml += S3CommonUtilities::format_xml_string(
-        "Key", get_response_format_key_value(object->get_object_name()));
-    response_xml += S3CommonUtilities::format_xml_string(
-        "UploadId", object->get_upload_id());
-    response_xml += "<Initiator>";
-    response_xml +=
-        S3CommonUtilities::format_xml_string("ID", object->get_user_id());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "DisplayName", object->get_user_name());
-    response_xml += "</Initiator>";
-    response_xml += "<Owner>";
-    response_xml +=
-        S3CommonUtilities::format_xml_string("ID", object->get_user_id());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "DisplayName", object->get_user_name());
-    response_xml += "</Owner>";
-    response_xml += S3CommonUtilities::format_xml_string("StorageClass",
-                                                         get_storage_class());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "Initiated", object->get_last_modified_iso());
-    response_xml += "</Upload>";
+    writer.start_element("Upload");
+    write_key(writer, "Key", object->get_object_name());
+    writer.element("UploadId", object->get_upload_id());
+    writer.start_element("Initiator");
+    writer.element("ID", object->get_user_id());
+    writer.element("DisplayName", object->get_user_name());
+    writer.end_element("Initiator");
+    writer.start_element("Owner");
+    writer.element("ID", object->get_user_id());
+    writer.element("DisplayName", object->get_user_name());
+    writer.end_element("Owner");
+    writer.element("StorageClass", get_storage_class());
+    writer.element("Initiated", object->get_last_modified_iso());
+    writer.end_element("Upload");
   }
 
   for (auto&& prefix : common_prefixes) {
-    response_xml += "<CommonPrefixes>";
-    response_xml += S3CommonUtilities::format_xml_string("Prefix", prefix);
-    response_xml += "</CommonPrefixes>";
+    writer.start_element("CommonPrefixes");
+    writer.element("Prefix", prefix);
+    writer.end_element("CommonPrefixes");
   }
 
-  response_xml += "</ListMultipartUploadsResult>";
-  // clang-format on
-  return response_xml;
+  writer.end_element("ListMultipartUploadsResult");
 }
 
-std::string& S3ObjectListResponse::get_multipart_xml() {
-  // clang-format off
-  response_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-  response_xml +=
-      "<ListPartsResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
-  response_xml += S3CommonUtilities::format_xml_string("Bucket", bucket_name);
-  response_xml += S3CommonUtilities::format_xml_string(
-      "Key", get_response_format_key_value(get_object_name()));
-  response_xml +=
-      S3CommonUtilities::format_xml_string("UploadID", get_upload_id());
-  response_xml += "<Initiator>";
-  response_xml += S3CommonUtilities::format_xml_string("ID", get_user_id());
-  response_xml +=
-      S3CommonUtilities::format_xml_string("DisplayName", get_user_name());
-  response_xml += "</Initiator>";
-  response_xml += "<Owner>";
-  response_xml += S3CommonUtilities::format_xml_string("ID", get_account_id());
-  response_xml +=
-      S3CommonUtilities::format_xml_string("DisplayName", get_account_name());
-  response_xml += "</Owner>";
-  response_xml +=
-      S3CommonUtilities::format_xml_string("StorageClass", get_storage_class());
-  response_xml += S3CommonUtilities::format_xml_string("PartNumberMarker",
-                                                       request_marker_key);
-  response_xml += S3CommonUtilities::format_xml_string(
-      "NextPartNumberMarker",
-      (next_marker_key.empty() ? "0" : next_marker_key));
-  response_xml += S3CommonUtilities::format_xml_string("MaxParts", max_parts);
-  response_xml += S3CommonUtilities::format_xml_string(
-      "IsTruncated", (response_is_truncated ? "true" : "false"));
+void S3ObjectListResponse::write_multipart_xml(S3XmlWriter& writer) {
+  writer.declaration();
+  writer.start_element("ListPartsResult",
+                       "http://s3.amazonaws.com/doc/2006-03-01/");
+  writer.element("Bucket", bucket_name);
+  write_key(writer, "Key", get_object_name());
+  writer.element("UploadID", get_upload_id());
+  writer.start_element("Initiator");
+  writer.element("ID", get_user_id());
+  writer.element("DisplayName", get_user_name());
+  writer.end_element("Initiator");
+  writer.start_element("Owner");
+  writer.element("ID", get_account_id());
+  writer.element("DisplayName", get_account_name());
+  writer.end_element("Owner");
+  writer.element("StorageClass", get_storage_class());
+  writer.element("PartNumberMarker", request_marker_key);
+  writer.element("NextPartNumberMarker",
+                 next_marker_key.empty() ? "0" : next_marker_key);
+  writer.element("MaxParts", max_parts);
+  writer.element("IsTruncated", response_is_truncated ? "true" : "false");
 
   if (encoding_type == "url") {
-    response_xml += S3CommonUtilities::format_xml_string("EncodingType", "url");
+    writer.element("EncodingType", "url");
   }
 
   for (auto&& part : part_list) {
-    response_xml += "<Part>";
-    response_xml += S3CommonUtilities::format_xml_string(
-        "PartNumber", part.second->get_part_number());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "LastModified", part.second->get_last_modified_iso());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "ETag", part.second->get_md5(), true);
-    response_xml += S3CommonUtilities::format_xml_string(
-        "Size", part.second->get_content_length_str());
-    response_xml += "</Part>";
+    writer.start_element("Part");
+    writer.element("PartNumber", part.second->get_part_number());
+    writer.element("LastModified", part.second->get_last_modified_iso());
+    writer.element("ETag", part.second->get_md5(), true);
+    writer.element("Size", part.second->get_content_length_str());
+    writer.end_element("Part");
   }
 
-  response_xml += "</ListPartsResult>";
-  // clang-format on
-
-  return response_xml;
+  writer.end_element("ListPartsResult");
 }
@@ -31,6 +31,7 @@
 
 #include "s3_object_metadata.h"
 #include "s3_part_metadata.h"
+#include "s3_xml_writer.h"
 
 class S3ObjectListResponse {
   // value can be url or empty string
@@ -61,6 +62,9 @@ class S3ObjectListResponse {
   std::string response_xml;
 
   std::string get_response_format_key_value(const std::string& key_value);
+  void write_key(S3XmlWriter& writer, const char* tag,
+                 const std::string& key_value);
+  void write_common_prefixes(S3XmlWriter& writer);
 
  public:
   S3ObjectListResponse(const std::string& encoding_type = "");
@@ -108,6 +112,13 @@ class S3ObjectListResponse {
                                const std::string requestor_user_id);
   std::string& get_multipart_xml();
   std::string& get_multiupload_xml();
+  // Same as get_*xml() above, but serialize into the writer
+  virtual void write_xml(S3XmlWriter& writer,
+                         const std::string& requestor_canonical_id,
+                         const std::string& bucket_owner_user_id,
+                         const std::string& requestor_user_id);
+  void write_multipart_xml(S3XmlWriter& writer);
+  void write_multiupload_xml(S3XmlWriter& writer);
   std::string& get_user_id();
   std::string& get_user_name();
   std::string& get_canonical_id();
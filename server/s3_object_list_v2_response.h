@@ -50,6 +50,9 @@ class S3ObjectListResponseV2 : public S3ObjectListResponse {
   std::string &get_xml(const std::string &requestor_canonical_id,
                        const std::string &bucket_owner_user_id,
                        const std::string &requestor_user_id);
+  void write_xml(S3XmlWriter &writer, const std::string &requestor_canonical_id,
+                 const std::string &bucket_owner_user_id,
+                 const std::string &requestor_user_id) override;
 
   // Google tests.
   FRIEND_TEST(S3ObjectListResponseV2Test, ConstructorTest);
@@ -27,8 +27,11 @@
 #include "s3_datetime.h"
 #include "s3_factory.h"
 #include "s3_iem.h"
+#include "s3_json_scanner.h"
+#include "s3_metadata_record.h"
 #include "s3_log.h"
 #include "s3_object_metadata.h"
+#include "s3_object_metadata_cache.h"
 #include "s3_object_versioning_helper.h"
 #include "s3_uri_to_motr_oid.h"
 #include "s3_common_utilities.h"
@@ -343,6 +346,12 @@ void S3ObjectMetadata::set_oid(struct m0_uint128 id) {
   motr_oid_str = S3M0Uint128Helper::to_string(oid);
 }
 
+void S3ObjectMetadata::set_inline_data(std::string data) {
+  f_inline_data = true;
+  inline_data = std::move(data);
+  set_oid({0ULL, 0ULL});
+}
+
 void S3ObjectMetadata::set_version_id(std::string ver_id) {
   object_version_id = ver_id;
   rev_epoch_version_id_key =
@@ -354,6 +363,20 @@ void S3ObjectMetadata::set_old_oid(struct m0_uint128 id) {
   motr_old_oid_str = S3M0Uint128Helper::to_string(old_oid);
 }
 
+void S3ObjectMetadata::set_copy_oid(struct m0_uint128 id) {
+  copy_oid = id;
+  motr_copy_oid_str = S3M0Uint128Helper::to_string(copy_oid);
+}
+
+std::string S3ObjectMetadata::get_probable_delete_key() {
+  std::string key = S3M0Uint128Helper::to_string(get_oid());
+  const struct m0_uint128 id = get_copy_oid();
+  if (id.u_hi || id.u_lo) {
+    key += '-' + S3M0Uint128Helper::to_string(id);
+  }
+  return key;
+}
+
 void S3ObjectMetadata::set_old_version_id(std::string old_obj_ver_id) {
   motr_old_object_version_id = old_obj_ver_id;
 }
@@ -390,10 +413,17 @@ void S3ObjectMetadata::load(std::function<void(void)> on_success,
 
   state = S3ObjectMetadataState::empty;
 
-  motr_kv_reader =
-      motr_kv_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
   requested_bucket_name = bucket_name;
   requested_object_name = object_name;
+
+  if (load_from_cache()) {
+    s3_log(S3_LOG_DEBUG, request_id, "Object metadata taken from cache\n");
+    state = S3ObjectMetadataState::present;
+    this->handler_on_success();
+    return;
+  }
+  motr_kv_reader =
+      motr_kv_reader_factory->create_motr_kvs_reader(request, s3_motr_api);
   motr_kv_reader->get_keyval(
       object_list_index_layout, object_name,
       std::bind(&S3ObjectMetadata::load_successful, this),
@@ -457,11 +487,49 @@ void S3ObjectMetadata::load_successful() {
     LOG_PERF("load_object_metadata_ms", request_id.c_str(), mss);
     s3_stats_timing("load_object_metadata", mss);
 
+    auto* p_cache = S3ObjectMetadataCache::get_instance();
+    if (p_cache && !is_multipart) {
+      p_cache->put(get_cache_key(), motr_kv_reader->get_value(),
+                   cache_generation);
+    }
     state = S3ObjectMetadataState::present;
     this->handler_on_success();
   }
 }
 
+std::string S3ObjectMetadata::get_cache_key() const {
+  return S3ObjectMetadataCache::make_key(
+      S3M0Uint128Helper::to_string(object_list_index_layout.oid), object_name);
+}
+
+bool S3ObjectMetadata::load_from_cache() {
+  auto* p_cache = S3ObjectMetadataCache::get_instance();
+
+  if (!p_cache || !p_cache->is_enabled() || is_multipart) {
+    return false;
+  }
+  const std::string key = get_cache_key();
+  std::string json;
+
+  if (p_cache->get(key, json)) {
+    if (this->from_json(std::move(json)) == 0 && validate_attrs()) {
+      return true;
+    }
+    // Loading from Motr will sort it out
+    p_cache->invalidate(key);
+  }
+  cache_generation = p_cache->get_generation();
+  return false;
+}
+
+void S3ObjectMetadata::invalidate_cached() {
+  auto* p_cache = S3ObjectMetadataCache::get_instance();
+
+  if (p_cache && non_zero(object_list_index_layout.oid)) {
+    p_cache->invalidate(get_cache_key());
+  }
+}
+
 void S3ObjectMetadata::load_failed() {
   switch (motr_kv_reader->get_state()) {
     case S3MotrKVSReaderOpState::failed_to_launch:
@@ -502,8 +570,10 @@ void S3ObjectMetadata::save(std::function<void(void)> on_success,
 
   this->handler_on_success = on_success;
   this->handler_on_failed = on_failed;
-  if (is_multipart) {
+  if (is_multipart || f_inline_data) {
     // Write only to multpart object list and not real object list in a bucket.
+    // Inline object has no data for background delete to find through its
+    // version entry.
     save_metadata();
   } else {
     // First write metadata to objects version list index for a bucket.
@@ -551,6 +621,8 @@ void S3ObjectMetadata::save_metadata() {
   // object_list_index_layout should be set before using this method
   assert(non_zero(object_list_index_layout.oid));
 
+  invalidate_cached();
+
   motr_kv_writer =
       mote_kv_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
   motr_kv_writer->put_keyval(
@@ -573,6 +645,7 @@ void S3ObjectMetadata::save_metadata(std::function<void(void)> on_success,
 void S3ObjectMetadata::save_metadata_successful() {
   s3_log(S3_LOG_DEBUG, request_id, "Object metadata saved for Object [%s].\n",
          object_name.c_str());
+  invalidate_cached();
   state = S3ObjectMetadataState::saved;
   this->handler_on_success();
 }
@@ -580,6 +653,7 @@ void S3ObjectMetadata::save_metadata_successful() {
 void S3ObjectMetadata::save_metadata_failed() {
   s3_log(S3_LOG_ERROR, request_id,
          "Object metadata save failed for Object [%s].\n", object_name.c_str());
+  invalidate_cached();
   if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::failed_to_launch) {
     state = S3ObjectMetadataState::failed_to_launch;
   } else {
@@ -604,6 +678,8 @@ void S3ObjectMetadata::remove_object_metadata() {
   // object_list_index_layout should be set before using this method
   assert(non_zero(object_list_index_layout.oid));
 
+  invalidate_cached();
+
   motr_kv_writer =
       mote_kv_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
   motr_kv_writer->delete_keyval(
@@ -615,7 +691,8 @@ void S3ObjectMetadata::remove_object_metadata() {
 void S3ObjectMetadata::remove_object_metadata_successful() {
   s3_log(S3_LOG_DEBUG, request_id, "Deleted metadata for Object [%s].\n",
          object_name.c_str());
-  if (is_multipart) {
+  invalidate_cached();
+  if (is_multipart || f_inline_data) {
     // In multipart, version entry is not yet created.
     state = S3ObjectMetadataState::deleted;
     this->handler_on_success();
@@ -628,6 +705,7 @@ void S3ObjectMetadata::remove_object_metadata_failed() {
   s3_log(S3_LOG_DEBUG, request_id,
          "Delete Object metadata failed for Object [%s].\n",
          object_name.c_str());
+  invalidate_cached();
   if (motr_kv_writer->get_state() == S3MotrKVSWriterOpState::failed_to_launch) {
     state = S3ObjectMetadataState::failed_to_launch;
   } else {
@@ -701,7 +779,14 @@ std::string S3ObjectMetadata::to_json() {
   }
 
   root["motr_oid"] = motr_oid_str;
+  if (copy_oid.u_hi || copy_oid.u_lo) {
+    root["motr_copy_oid"] = motr_copy_oid_str;
+  }
   root["PVID"] = this->pvid_str;
+  if (f_inline_data) {
+    root["inline_data"] = base64_encode(
+        (const unsigned char*)inline_data.data(), inline_data.length());
+  }
 
   for (auto sit : system_defined_attribute) {
     root["System-Defined"][sit.first] = sit.second;
@@ -728,10 +813,8 @@ std::string S3ObjectMetadata::to_json() {
     // MD5 of empty string - md5("")
     root["System-Defined"]["Content-MD5"] = "d41d8cd98f00b204e9800998ecf8427e";
   }
-
-  Json::FastWriter fastWriter;
-  return fastWriter.write(root);
-  ;
+  // JSON or binary, see S3_METADATA_BINARY_FORMAT
+  return S3MetadataRecord::serialize(root);
 }
 
 // Streaming to json
@@ -750,9 +833,7 @@ std::string S3ObjectMetadata::version_entry_to_json() {
   current_time.init_current_time();
   root["create_timestamp"] = current_time.get_isoformat_string();
 
-  Json::FastWriter fastWriter;
-  return fastWriter.write(root);
-  ;
+  return S3MetadataRecord::serialize(root);
 }
 
 /*
@@ -782,8 +863,7 @@ int S3ObjectMetadata::from_json(std::string content) {
   s3_log(S3_LOG_DEBUG, request_id, "Called with content [%s]\n",
          content.c_str());
   Json::Value newroot;
-  Json::Reader reader;
-  bool parsingSuccessful = reader.parse(content.c_str(), newroot);
+  bool parsingSuccessful = S3MetadataRecord::parse(content, newroot);
   if (!parsingSuccessful || s3_di_fi_is_enabled("object_metadata_corrupted")) {
     s3_log(S3_LOG_ERROR, request_id, "Json Parsing failed\n");
     return -1;
@@ -805,6 +885,16 @@ int S3ObjectMetadata::from_json(std::string content) {
   layout_id = newroot["layout_id"].asInt();
   pvid_str = newroot["PVID"].asString();
   oid = S3M0Uint128Helper::to_m0_uint128(motr_oid_str);
+  if (newroot.isMember("motr_copy_oid")) {
+    set_copy_oid(
+        S3M0Uint128Helper::to_m0_uint128(newroot["motr_copy_oid"].asString()));
+  } else {
+    set_copy_oid({0ULL, 0ULL});
+  }
+  f_inline_data = newroot.isMember("inline_data");
+  if (f_inline_data) {
+    inline_data = base64_decode(newroot["inline_data"].asString());
+  }
 
   //
   // Old oid is needed to remove the OID when the object already exists
@@ -849,6 +939,99 @@ int S3ObjectMetadata::from_json(std::string content) {
   return 0;
 }
 
+int S3ObjectMetadata::from_json_for_listing(const std::string& content) {
+  if (s3_di_fi_is_enabled("object_metadata_corrupted")) {
+    s3_log(S3_LOG_ERROR, request_id, "Json Parsing failed\n");
+    return -1;
+  }
+  // As from_json() does, don't keep values taken from the request
+  bucket_name.clear();
+  object_name.clear();
+  canonical_id.clear();
+  account_name.clear();
+
+  if (S3MetadataRecord::is_binary(content)) {
+    if (listing_fields_from_record(content) != 0) {
+      s3_log(S3_LOG_ERROR, request_id, "Binary metadata decoding failed\n");
+      return -1;
+    }
+  } else if (listing_fields_from_json(content) != 0) {
+    s3_log(S3_LOG_ERROR, request_id, "Json Parsing failed\n");
+    return -1;
+  }
+  if (s3_di_fi_is_enabled("di_metadata_bcktname_on_read_corrupted")) {
+    bucket_name = "@" + bucket_name + "@";
+  }
+  if (s3_di_fi_is_enabled("di_metadata_objname_on_read_corrupted")) {
+    object_name = "@" + object_name + "@";
+  }
+  return 0;
+}
+
+int S3ObjectMetadata::listing_fields_from_record(const std::string& content) {
+  // Other values are skipped, not decoded
+  auto select = [this](const std::string* p_object_key,
+                       const std::string& key) -> std::string* {
+    if (!p_object_key) {
+      if (key == "Bucket-Name") {
+        return &bucket_name;
+      } else if (key == "Object-Name") {
+        return &object_name;
+      }
+    } else if (*p_object_key == "System-Defined") {
+      if (key == "Content-Length" || key == "Content-MD5" ||
+          key == "Last-Modified" || key == "x-amz-storage-class") {
+        return &system_defined_attribute[key];
+      } else if (key == "Owner-Canonical-id") {
+        return &canonical_id;
+      } else if (key == "Owner-Account") {
+        return &account_name;
+      }
+    }
+    return nullptr;
+  };
+  return S3MetadataRecord::read_fields(content, select) ? 0 : -1;
+}
+
+int S3ObjectMetadata::listing_fields_from_json(const std::string& content) {
+  S3JsonScanner scanner(content);
+  std::string key;
+
+  if (scanner.enter_object()) {
+    while (scanner.next_member(key)) {
+      if (key == "Bucket-Name") {
+        scanner.read_string(bucket_name);
+      } else if (key == "Object-Name") {
+        scanner.read_string(object_name);
+      } else if (key == "System-Defined") {
+        if (!scanner.enter_object()) {
+          break;
+        }
+        while (scanner.next_member(key)) {
+          std::string* p_value = nullptr;
+
+          if (key == "Content-Length" || key == "Content-MD5" ||
+              key == "Last-Modified" || key == "x-amz-storage-class") {
+            p_value = &system_defined_attribute[key];
+          } else if (key == "Owner-Canonical-id") {
+            p_value = &canonical_id;
+          } else if (key == "Owner-Account") {
+            p_value = &account_name;
+          }
+          if (p_value) {
+            scanner.read_string(*p_value);
+          } else {
+            scanner.skip_value();
+          }
+        }
+      } else {
+        scanner.skip_value();
+      }
+    }
+  }
+  return scanner.failed() ? -1 : 0;
+}
+
 void S3ObjectMetadata::acl_from_json(std::string acl_json_str) {
   s3_log(S3_LOG_DEBUG, "", "Called\n");
   encoded_acl = acl_json_str;
@@ -107,6 +107,9 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
 
   struct m0_uint128 oid = M0_ID_APP;
   struct m0_uint128 old_oid = {};
+  // OID generated for a copy that shares the data of its source, zero when
+  // the object owns its data.
+  struct m0_uint128 copy_oid = {};
   // Will be object list index oid when simple object upload.
   // Will be multipart object list index oid when multipart object upload.
   struct s3_motr_idx_layout object_list_index_layout = {};
@@ -115,12 +118,19 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
 
   std::string motr_oid_str;
   std::string motr_old_oid_str;
+  std::string motr_copy_oid_str;
   std::string motr_old_object_version_id;
 
   std::string motr_part_layout_str;
 
   bool is_multipart = false;
 
+  // Data of a small object kept in the record itself, such object has no
+  // Motr object (zero oid) and no version entry.
+  // See S3_OBJECT_INLINE_DATA_MAX_SIZE.
+  bool f_inline_data = false;
+  std::string inline_data;
+
   std::shared_ptr<S3MotrKVSReader> motr_kv_reader;
   std::shared_ptr<S3MotrKVSWriter> motr_kv_writer;
   std::shared_ptr<S3BucketMetadata> bucket_metadata;
@@ -132,6 +142,9 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   S3ObjectMetadataState state;
   S3Timer s3_timer;
 
+  // See S3ObjectMetadataCache::put()
+  uint64_t cache_generation = 0;
+
   void initialize(bool is_multipart, const std::string& uploadid);
 
   // Any validations we want to do on metadata.
@@ -198,6 +211,7 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
 
   virtual void set_oid(struct m0_uint128 id);
   void set_old_oid(struct m0_uint128 id);
+  void set_copy_oid(struct m0_uint128 id);
   void acl_from_json(std::string acl_json_str);
   void set_part_index_layout(const struct s3_motr_idx_layout&);
   virtual struct m0_uint128 get_oid() { return oid; }
@@ -207,6 +221,10 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   void set_old_layout_id(int id) { old_layout_id = id; }
 
   virtual struct m0_uint128 get_old_oid() { return old_oid; }
+  virtual struct m0_uint128 get_copy_oid() { return copy_oid; }
+  // Key of the probable delete record of the object data. Copies sharing
+  // data get "<data oid>-<copy oid>" so they don't collide with the source.
+  std::string get_probable_delete_key();
 
   const struct s3_motr_idx_layout& get_part_index_layout() const {
     return part_index_layout;
@@ -246,6 +264,11 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   const std::string& get_pvid_str() const { return pvid_str; }
   void set_pvid_str(const std::string& val) { pvid_str = val; }
 
+  // Also sets zero oid
+  void set_inline_data(std::string data);
+  virtual bool has_inline_data() const { return f_inline_data; }
+  virtual const std::string& get_inline_data() const { return inline_data; }
+
   // Load attributes.
   std::string get_system_attribute(std::string key);
   void add_system_attribute(std::string key, std::string val);
@@ -275,6 +298,10 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
 
   virtual S3ObjectMetadataState get_state() { return state; }
 
+  // Drops cached copy of the object list index entry, for callers which
+  // change the entry bypassing save() and remove().
+  void invalidate_cached();
+
   // placeholder state, so as to not perform any operation on this.
   void mark_invalid() { state = S3ObjectMetadataState::invalid; }
 
@@ -285,6 +312,11 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
 
   // returns 0 on success, -1 on parsing error.
   virtual int from_json(std::string content);
+  // Decodes only what object listing shows (name, size, ETag, last
+  // modified time, storage class and owner), building no JSON tree for
+  // JSON records.
+  // Returns 0 on success, -1 on parsing error.
+  virtual int from_json_for_listing(const std::string& content);
   virtual void setacl(const std::string& input_acl);
   virtual void set_tags(const std::map<std::string, std::string>& tags_as_map);
   virtual const std::map<std::string, std::string>& get_tags();
@@ -326,6 +358,13 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   // Validate just read metadata
   bool validate_attrs();
 
+  std::string get_cache_key() const;
+  bool load_from_cache();
+
+  // Helpers of from_json_for_listing() for both record formats
+  int listing_fields_from_record(const std::string& content);
+  int listing_fields_from_json(const std::string& content);
+
  public:
   // Google tests.
   FRIEND_TEST(S3ObjectMetadataTest, ConstructorTest);
@@ -338,6 +377,8 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   FRIEND_TEST(S3ObjectMetadataTest, AddUserDefinedAttribute);
   FRIEND_TEST(S3ObjectMetadataTest, Load);
   FRIEND_TEST(S3ObjectMetadataTest, LoadSuccessful);
+  FRIEND_TEST(S3ObjectMetadataTest, LoadSuccessfulFillsCache);
+  FRIEND_TEST(S3ObjectMetadataTest, LoadFromCache);
   FRIEND_TEST(S3ObjectMetadataTest, LoadMetadataFail);
   FRIEND_TEST(S3ObjectMetadataTest, LoadSuccessInvalidJson);
   FRIEND_TEST(S3ObjectMetadataTest, LoadSuccessfulInvalidJson);
@@ -360,8 +401,10 @@ class S3ObjectMetadata : private S3ObjectMetadataCopyable {
   FRIEND_TEST(S3ObjectMetadataTest, RemoveVersionMetadataFailed);
   FRIEND_TEST(S3ObjectMetadataTest, ToJson);
   FRIEND_TEST(S3ObjectMetadataTest, FromJson);
+  FRIEND_TEST(S3ObjectMetadataTest, FromJsonForListing);
   FRIEND_TEST(S3MultipartObjectMetadataTest, FromJson);
   FRIEND_TEST(S3ObjectMetadataTest, GetEncodedBucketAcl);
+  FRIEND_TEST(S3ObjectMetadataTest, InlineDataRoundTrip);
 };
 
 #endif
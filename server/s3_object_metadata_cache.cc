@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <iterator>
+
+#include "s3_log.h"
+#include "s3_object_metadata_cache.h"
+#include "s3_stats.h"
+
+thread_local S3ObjectMetadataCache* S3ObjectMetadataCache::p_instance;
+
+S3ObjectMetadataCache::S3ObjectMetadataCache(unsigned max_cache_size,
+                                             unsigned ttl_sec)
+    : max_cache_size(max_cache_size), ttl_sec(ttl_sec) {
+  p_instance = this;
+}
+
+S3ObjectMetadataCache::~S3ObjectMetadataCache() { p_instance = nullptr; }
+
+S3ObjectMetadataCache* S3ObjectMetadataCache::get_instance() {
+  return p_instance;
+}
+
+// Encoded index OID never contains '\n', so the key is unambiguous
+std::string S3ObjectMetadataCache::make_key(const std::string& index_id,
+                                            const std::string& object_name) {
+  std::string key;
+  key.reserve(index_id.length() + 1 + object_name.length());
+
+  key += index_id;
+  key += '\n';
+  key += object_name;
+
+  return key;
+}
+
+void S3ObjectMetadataCache::remove_entry(Entries::iterator it) {
+  index.erase(it->key);
+  entries.erase(it);
+}
+
+bool S3ObjectMetadataCache::get(const std::string& key, std::string& json) {
+  if (!is_enabled()) {
+    return false;
+  }
+  auto map_it = index.find(key);
+
+  if (index.end() == map_it) {
+    s3_stats_inc("object_metadata_cache_miss_count");
+    return false;
+  }
+  auto it = map_it->second;
+
+  if (Clock::now() >= it->expire_time) {
+    s3_log(S3_LOG_DEBUG, "", "Object metadata cache entry has expired");
+    remove_entry(it);
+    s3_stats_inc("object_metadata_cache_miss_count");
+    return false;
+  }
+  entries.splice(entries.begin(), entries, it);
+  json = it->json;
+
+  s3_stats_inc("object_metadata_cache_hit_count");
+  return true;
+}
+
+void S3ObjectMetadataCache::put(const std::string& key, std::string json,
+                                uint64_t load_generation) {
+  if (!is_enabled()) {
+    return;
+  }
+  if (load_generation != generation) {
+    s3_log(S3_LOG_DEBUG, "",
+           "Object metadata changed while loading, not cached");
+    return;
+  }
+  auto map_it = index.find(key);
+
+  if (index.end() != map_it) {
+    remove_entry(map_it->second);
+  } else if (entries.size() >= max_cache_size) {
+    remove_entry(std::prev(entries.end()));
+  }
+  entries.push_front(
+      {key, std::move(json), Clock::now() + std::chrono::seconds(ttl_sec)});
+  index[key] = entries.begin();
+}
+
+void S3ObjectMetadataCache::invalidate(const std::string& key) {
+  if (!is_enabled()) {
+    return;
+  }
+  ++generation;
+
+  auto map_it = index.find(key);
+
+  if (index.end() != map_it) {
+    remove_entry(map_it->second);
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_OBJECT_METADATA_CACHE_H__
+#define __S3_SERVER_S3_OBJECT_METADATA_CACHE_H__
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Object metadata (JSON as stored in the object list index) of recently
+// loaded objects, so that HEAD and GET of hot keys don't need a Motr KV
+// lookup.
+//
+// Entries are keyed by object list index and object name, so a re-created
+// bucket never sees entries of the old one. Writes to the object list index
+// through this instance drop the entry. Writes done by other reactors and
+// s3server instances are not seen, ttl_sec bounds how long a stale entry
+// may be served.
+//
+// A load which was in flight while an entry got invalidated must not put
+// the value it has read, so put() takes the generation observed before the
+// load started and is ignored if any invalidation happened since then.
+//
+// One instance per reactor thread, like S3BucketMetadataCache.
+class S3ObjectMetadataCache {
+
+  // The class should have single instance per reactor thread
+  static thread_local S3ObjectMetadataCache* p_instance;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string key;
+    std::string json;
+    Clock::time_point expire_time;
+  };
+  using Entries = std::list<Entry>;
+
+  // Most recently used entry is at the front
+  Entries entries;
+  std::unordered_map<std::string, Entries::iterator> index;
+
+  unsigned max_cache_size;
+  unsigned ttl_sec;
+  uint64_t generation = 0;
+
+  void remove_entry(Entries::iterator it);
+
+ public:
+  S3ObjectMetadataCache(unsigned max_cache_size, unsigned ttl_sec);
+
+  S3ObjectMetadataCache(const S3ObjectMetadataCache&) = delete;
+  S3ObjectMetadataCache& operator=(const S3ObjectMetadataCache&) = delete;
+
+  ~S3ObjectMetadataCache();
+
+  // Returns nullptr if the cache isn't created on the calling thread
+  static S3ObjectMetadataCache* get_instance();
+
+  // index_id is the encoded OID of the object list index
+  static std::string make_key(const std::string& index_id,
+                              const std::string& object_name);
+
+  bool is_enabled() const { return max_cache_size > 0; }
+
+  // Returns false if there is no fresh entry for the key
+  bool get(const std::string& key, std::string& json);
+
+  // Generation to be passed to put() once the load has finished
+  uint64_t get_generation() const { return generation; }
+
+  void put(const std::string& key, std::string json, uint64_t load_generation);
+
+  // Called both before and after the object list index entry is changed
+  void invalidate(const std::string& key);
+
+  size_t size() const { return entries.size(); }
+};
+
+#endif  // __S3_SERVER_S3_OBJECT_METADATA_CACHE_H__
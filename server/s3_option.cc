@@ -33,6 +33,7 @@ std::map<std::string, int> g_pi_map = {
     {std::string("PI_TYPE_MD5_INC_CONTEXT"), (int)M0_PI_TYPE_MD5_INC_CONTEXT}};
 
 S3Option* S3Option::option_instance = NULL;
+thread_local evbase_t* S3Option::reactor_eventbase = NULL;
 
 bool S3Option::load_section(std::string section_name,
                             bool force_override_from_config = false) {
@@ -259,11 +260,131 @@ bool S3Option::load_section(std::string section_name,
           s3_option_node["S3_BUCKET_METADATA_CACHE_EXPIRE_SEC"].as<unsigned>();
       bucket_metadata_cache_refresh_sec =
           s3_option_node["S3_BUCKET_METADATA_CACHE_REFRESH_SEC"].as<unsigned>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_BUCKET_METADATA_CACHE_MISSING_SEC");
+      bucket_metadata_cache_missing_sec =
+          s3_option_node["S3_BUCKET_METADATA_CACHE_MISSING_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_BUCKET_METADATA_CACHE_MISSING_SEC",
+                                    bucket_metadata_cache_missing_sec, 0, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_REACTOR_THREADS");
+      reactor_threads = s3_option_node["S3_REACTOR_THREADS"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_REACTOR_THREADS", reactor_threads, 1,
+                                    128);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_WRITE_WINDOW");
+      motr_write_window = s3_option_node["S3_MOTR_WRITE_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_WRITE_WINDOW", motr_write_window,
+                                    1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_WINDOW");
+      motr_read_window = s3_option_node["S3_MOTR_READ_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_READ_WINDOW", motr_read_window, 1,
+                                    64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_OBJECT_METADATA_CACHE_SIZE");
+      object_metadata_cache_size =
+          s3_option_node["S3_OBJECT_METADATA_CACHE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_METADATA_CACHE_SIZE",
+                                    object_metadata_cache_size, 0, 10000000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_OBJECT_METADATA_CACHE_TTL_SEC");
+      object_metadata_cache_ttl_sec =
+          s3_option_node["S3_OBJECT_METADATA_CACHE_TTL_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_METADATA_CACHE_TTL_SEC",
+                                    object_metadata_cache_ttl_sec, 0, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_METADATA_BINARY_FORMAT");
+      metadata_binary_format =
+          s3_option_node["S3_METADATA_BINARY_FORMAT"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_DELETE_OBJECTS_WINDOW");
+      delete_objects_window =
+          s3_option_node["S3_DELETE_OBJECTS_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_DELETE_OBJECTS_WINDOW",
+                                    delete_objects_window, 1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_COPY_WINDOW");
+      motr_copy_window = s3_option_node["S3_MOTR_COPY_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_COPY_WINDOW", motr_copy_window, 1,
+                                    64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_COPY_OBJECT_BY_REFERENCE");
+      copy_object_by_reference =
+          s3_option_node["S3_COPY_OBJECT_BY_REFERENCE"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_THREADS");
+      hash_worker_threads =
+          s3_option_node["S3_HASH_WORKER_THREADS"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_THREADS",
+                                    hash_worker_threads, 0, 256);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_BATCH_SIZE");
+      hash_worker_batch_size =
+          s3_option_node["S3_HASH_WORKER_BATCH_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_BATCH_SIZE",
+                                    hash_worker_batch_size, 1, 1024);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_QUEUE_SIZE");
+      hash_worker_queue_size =
+          s3_option_node["S3_HASH_WORKER_QUEUE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_QUEUE_SIZE",
+                                    hash_worker_queue_size, 1, 1048576);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_OBJECT_INLINE_DATA_MAX_SIZE");
+      object_inline_data_max_size =
+          s3_option_node["S3_OBJECT_INLINE_DATA_MAX_SIZE"].as<size_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_INLINE_DATA_MAX_SIZE",
+                                    object_inline_data_max_size, 0, 65536);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_STATS_FLUSH_INTERVAL_MSEC");
+      stats_flush_interval_msec =
+          s3_option_node["S3_STATS_FLUSH_INTERVAL_MSEC"].as<uint32_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_STATS_FLUSH_INTERVAL_MSEC",
+                                    stats_flush_interval_msec, 0, 60000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_STATSD_MAX_PACKET_SIZE");
+      statsd_max_packet_size =
+          s3_option_node["S3_STATSD_MAX_PACKET_SIZE"].as<size_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_STATSD_MAX_PACKET_SIZE",
+                                    statsd_max_packet_size, 64, 65507);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_LOG_ASYNC_ENABLED");
+      log_async_enable = s3_option_node["S3_LOG_ASYNC_ENABLED"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_LOG_ASYNC_BUFFER_SIZE_KB");
+      log_async_buffer_size_kb =
+          s3_option_node["S3_LOG_ASYNC_BUFFER_SIZE_KB"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_LOG_ASYNC_BUFFER_SIZE_KB",
+                                    log_async_buffer_size_kb, 64, 65536);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POST_BATCH_SIZE");
+      audit_logger_post_batch_size =
+          s3_option_node["S3_AUDIT_LOGGER_POST_BATCH_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POST_BATCH_SIZE",
+                                    audit_logger_post_batch_size, 1, 10000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POSTS_IN_FLIGHT");
+      audit_logger_posts_in_flight =
+          s3_option_node["S3_AUDIT_LOGGER_POSTS_IN_FLIGHT"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POSTS_IN_FLIGHT",
+                                    audit_logger_posts_in_flight, 1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB");
+      audit_logger_post_queue_size_mb =
+          s3_option_node["S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB",
+                                    audit_logger_post_queue_size_mb, 1, 4096);
     } else if (section_name == "S3_AUTH_CONFIG") {
       S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_PORT");
       auth_port = s3_option_node["S3_AUTH_PORT"].as<unsigned short>();
       S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_IP_ADDR");
       auth_ip_addr = s3_option_node["S3_AUTH_IP_ADDR"].as<std::string>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CONN_POOL_SIZE");
+      auth_conn_pool_size =
+          s3_option_node["S3_AUTH_CONN_POOL_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CONN_POOL_SIZE",
+                                    auth_conn_pool_size, 0, 1024);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC");
+      auth_conn_pool_idle_timeout_sec =
+          s3_option_node["S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC",
+                                    auth_conn_pool_idle_timeout_sec, 1, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CACHE_SIZE");
+      auth_cache_size = s3_option_node["S3_AUTH_CACHE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CACHE_SIZE", auth_cache_size, 0,
+                                    1048576);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CACHE_TTL_SEC");
+      auth_cache_ttl_sec =
+          s3_option_node["S3_AUTH_CACHE_TTL_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CACHE_TTL_SEC", auth_cache_ttl_sec,
+                                    1, 3600);
     } else if (section_name == "S3_MOTR_CONFIG") {
       S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_LOCAL_ADDR");
       motr_local_addr = s3_option_node["S3_MOTR_LOCAL_ADDR"].as<std::string>();
@@ -355,6 +476,11 @@ bool S3Option::load_section(std::string section_name,
              &motr_read_pool_expandable_count);
       sscanf(motr_read_pool_max_threshold_str.c_str(), "%zu",
              &motr_read_pool_max_threshold);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_POOL_NUMA_AWARE");
+      motr_read_pool_numa_aware =
+          s3_option_node["S3_MOTR_READ_POOL_NUMA_AWARE"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_ZERO_COPY");
+      motr_read_zero_copy = s3_option_node["S3_MOTR_READ_ZERO_COPY"].as<bool>();
 
     } else if (section_name == "S3_THIRDPARTY_CONFIG") {
       std::string libevent_pool_initial_size_str;
@@ -618,6 +744,106 @@ bool S3Option::load_section(std::string section_name,
           s3_option_node["S3_BUCKET_METADATA_CACHE_EXPIRE_SEC"].as<unsigned>();
       bucket_metadata_cache_refresh_sec =
           s3_option_node["S3_BUCKET_METADATA_CACHE_REFRESH_SEC"].as<unsigned>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_BUCKET_METADATA_CACHE_MISSING_SEC");
+      bucket_metadata_cache_missing_sec =
+          s3_option_node["S3_BUCKET_METADATA_CACHE_MISSING_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_BUCKET_METADATA_CACHE_MISSING_SEC",
+                                    bucket_metadata_cache_missing_sec, 0, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_REACTOR_THREADS");
+      reactor_threads = s3_option_node["S3_REACTOR_THREADS"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_REACTOR_THREADS", reactor_threads, 1,
+                                    128);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_WRITE_WINDOW");
+      motr_write_window = s3_option_node["S3_MOTR_WRITE_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_WRITE_WINDOW", motr_write_window,
+                                    1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_WINDOW");
+      motr_read_window = s3_option_node["S3_MOTR_READ_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_READ_WINDOW", motr_read_window, 1,
+                                    64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_OBJECT_METADATA_CACHE_SIZE");
+      object_metadata_cache_size =
+          s3_option_node["S3_OBJECT_METADATA_CACHE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_METADATA_CACHE_SIZE",
+                                    object_metadata_cache_size, 0, 10000000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_OBJECT_METADATA_CACHE_TTL_SEC");
+      object_metadata_cache_ttl_sec =
+          s3_option_node["S3_OBJECT_METADATA_CACHE_TTL_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_METADATA_CACHE_TTL_SEC",
+                                    object_metadata_cache_ttl_sec, 0, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_METADATA_BINARY_FORMAT");
+      metadata_binary_format =
+          s3_option_node["S3_METADATA_BINARY_FORMAT"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_DELETE_OBJECTS_WINDOW");
+      delete_objects_window =
+          s3_option_node["S3_DELETE_OBJECTS_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_DELETE_OBJECTS_WINDOW",
+                                    delete_objects_window, 1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_COPY_WINDOW");
+      motr_copy_window = s3_option_node["S3_MOTR_COPY_WINDOW"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_MOTR_COPY_WINDOW", motr_copy_window, 1,
+                                    64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_COPY_OBJECT_BY_REFERENCE");
+      copy_object_by_reference =
+          s3_option_node["S3_COPY_OBJECT_BY_REFERENCE"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_THREADS");
+      hash_worker_threads =
+          s3_option_node["S3_HASH_WORKER_THREADS"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_THREADS",
+                                    hash_worker_threads, 0, 256);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_BATCH_SIZE");
+      hash_worker_batch_size =
+          s3_option_node["S3_HASH_WORKER_BATCH_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_BATCH_SIZE",
+                                    hash_worker_batch_size, 1, 1024);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_HASH_WORKER_QUEUE_SIZE");
+      hash_worker_queue_size =
+          s3_option_node["S3_HASH_WORKER_QUEUE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_HASH_WORKER_QUEUE_SIZE",
+                                    hash_worker_queue_size, 1, 1048576);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_OBJECT_INLINE_DATA_MAX_SIZE");
+      object_inline_data_max_size =
+          s3_option_node["S3_OBJECT_INLINE_DATA_MAX_SIZE"].as<size_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_OBJECT_INLINE_DATA_MAX_SIZE",
+                                    object_inline_data_max_size, 0, 65536);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_STATS_FLUSH_INTERVAL_MSEC");
+      stats_flush_interval_msec =
+          s3_option_node["S3_STATS_FLUSH_INTERVAL_MSEC"].as<uint32_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_STATS_FLUSH_INTERVAL_MSEC",
+                                    stats_flush_interval_msec, 0, 60000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_STATSD_MAX_PACKET_SIZE");
+      statsd_max_packet_size =
+          s3_option_node["S3_STATSD_MAX_PACKET_SIZE"].as<size_t>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_STATSD_MAX_PACKET_SIZE",
+                                    statsd_max_packet_size, 64, 65507);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_LOG_ASYNC_ENABLED");
+      log_async_enable = s3_option_node["S3_LOG_ASYNC_ENABLED"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_LOG_ASYNC_BUFFER_SIZE_KB");
+      log_async_buffer_size_kb =
+          s3_option_node["S3_LOG_ASYNC_BUFFER_SIZE_KB"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_LOG_ASYNC_BUFFER_SIZE_KB",
+                                    log_async_buffer_size_kb, 64, 65536);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POST_BATCH_SIZE");
+      audit_logger_post_batch_size =
+          s3_option_node["S3_AUDIT_LOGGER_POST_BATCH_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POST_BATCH_SIZE",
+                                    audit_logger_post_batch_size, 1, 10000);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POSTS_IN_FLIGHT");
+      audit_logger_posts_in_flight =
+          s3_option_node["S3_AUDIT_LOGGER_POSTS_IN_FLIGHT"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POSTS_IN_FLIGHT",
+                                    audit_logger_posts_in_flight, 1, 64);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB");
+      audit_logger_post_queue_size_mb =
+          s3_option_node["S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB",
+                                    audit_logger_post_queue_size_mb, 1, 4096);
     } else if (section_name == "S3_AUTH_CONFIG") {
       if (!(cmd_opt_flag & S3_OPTION_AUTH_PORT)) {
         S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_PORT");
@@ -627,6 +853,26 @@ bool S3Option::load_section(std::string section_name,
         S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_IP_ADDR");
         auth_ip_addr = s3_option_node["S3_AUTH_IP_ADDR"].as<std::string>();
       }
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CONN_POOL_SIZE");
+      auth_conn_pool_size =
+          s3_option_node["S3_AUTH_CONN_POOL_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CONN_POOL_SIZE",
+                                    auth_conn_pool_size, 0, 1024);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node,
+                               "S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC");
+      auth_conn_pool_idle_timeout_sec =
+          s3_option_node["S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC",
+                                    auth_conn_pool_idle_timeout_sec, 1, 3600);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CACHE_SIZE");
+      auth_cache_size = s3_option_node["S3_AUTH_CACHE_SIZE"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CACHE_SIZE", auth_cache_size, 0,
+                                    1048576);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_AUTH_CACHE_TTL_SEC");
+      auth_cache_ttl_sec =
+          s3_option_node["S3_AUTH_CACHE_TTL_SEC"].as<unsigned>();
+      S3_OPTION_RANGE_CHECK_AND_RET("S3_AUTH_CACHE_TTL_SEC", auth_cache_ttl_sec,
+                                    1, 3600);
     } else if (section_name == "S3_MOTR_CONFIG") {
       if (!(cmd_opt_flag & S3_OPTION_MOTR_LOCAL_ADDR)) {
         S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_LOCAL_ADDR");
@@ -708,6 +954,11 @@ bool S3Option::load_section(std::string section_name,
              &motr_read_pool_expandable_count);
       sscanf(motr_read_pool_max_threshold_str.c_str(), "%zu",
              &motr_read_pool_max_threshold);
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_POOL_NUMA_AWARE");
+      motr_read_pool_numa_aware =
+          s3_option_node["S3_MOTR_READ_POOL_NUMA_AWARE"].as<bool>();
+      S3_OPTION_ASSERT_AND_RET(s3_option_node, "S3_MOTR_READ_ZERO_COPY");
+      motr_read_zero_copy = s3_option_node["S3_MOTR_READ_ZERO_COPY"].as<bool>();
 
     } else if (section_name == "S3_THIRDPARTY_CONFIG") {
       std::string libevent_pool_initial_size_str;
@@ -986,8 +1237,52 @@ void S3Option::dump_options() {
            endpoint.c_str());
   }
 
+  s3_log(S3_LOG_INFO, "", "S3_REACTOR_THREADS = %u\n", reactor_threads);
+  s3_log(S3_LOG_INFO, "", "S3_MOTR_READ_POOL_NUMA_AWARE = %s\n",
+         (motr_read_pool_numa_aware ? "true" : "false"));
+  s3_log(S3_LOG_INFO, "", "S3_MOTR_WRITE_WINDOW = %u\n", motr_write_window);
+  s3_log(S3_LOG_INFO, "", "S3_MOTR_READ_WINDOW = %u\n", motr_read_window);
+  s3_log(S3_LOG_INFO, "", "S3_MOTR_READ_ZERO_COPY = %s\n",
+         (motr_read_zero_copy ? "true" : "false"));
+  s3_log(S3_LOG_INFO, "", "S3_OBJECT_METADATA_CACHE_SIZE = %u\n",
+         object_metadata_cache_size);
+  s3_log(S3_LOG_INFO, "", "S3_OBJECT_METADATA_CACHE_TTL_SEC = %u\n",
+         object_metadata_cache_ttl_sec);
+  s3_log(S3_LOG_INFO, "", "S3_METADATA_BINARY_FORMAT = %s\n",
+         (metadata_binary_format ? "true" : "false"));
+  s3_log(S3_LOG_INFO, "", "S3_DELETE_OBJECTS_WINDOW = %u\n",
+         delete_objects_window);
+  s3_log(S3_LOG_INFO, "", "S3_MOTR_COPY_WINDOW = %u\n", motr_copy_window);
+  s3_log(S3_LOG_INFO, "", "S3_COPY_OBJECT_BY_REFERENCE = %s\n",
+         (copy_object_by_reference ? "true" : "false"));
+  s3_log(S3_LOG_INFO, "", "S3_HASH_WORKER_THREADS = %u\n", hash_worker_threads);
+  s3_log(S3_LOG_INFO, "", "S3_HASH_WORKER_BATCH_SIZE = %u\n",
+         hash_worker_batch_size);
+  s3_log(S3_LOG_INFO, "", "S3_HASH_WORKER_QUEUE_SIZE = %u\n",
+         hash_worker_queue_size);
+  s3_log(S3_LOG_INFO, "", "S3_OBJECT_INLINE_DATA_MAX_SIZE = %zu\n",
+         object_inline_data_max_size);
+  s3_log(S3_LOG_INFO, "", "S3_STATS_FLUSH_INTERVAL_MSEC = %u\n",
+         stats_flush_interval_msec);
+  s3_log(S3_LOG_INFO, "", "S3_STATSD_MAX_PACKET_SIZE = %zu\n",
+         statsd_max_packet_size);
+  s3_log(S3_LOG_INFO, "", "S3_LOG_ASYNC_ENABLED = %s\n",
+         (log_async_enable ? "true" : "false"));
+  s3_log(S3_LOG_INFO, "", "S3_LOG_ASYNC_BUFFER_SIZE_KB = %u\n",
+         log_async_buffer_size_kb);
+  s3_log(S3_LOG_INFO, "", "S3_AUDIT_LOGGER_POST_BATCH_SIZE = %u\n",
+         audit_logger_post_batch_size);
+  s3_log(S3_LOG_INFO, "", "S3_AUDIT_LOGGER_POSTS_IN_FLIGHT = %u\n",
+         audit_logger_posts_in_flight);
+  s3_log(S3_LOG_INFO, "", "S3_AUDIT_LOGGER_POST_QUEUE_SIZE_MB = %u\n",
+         audit_logger_post_queue_size_mb);
   s3_log(S3_LOG_INFO, "", "S3_AUTH_IP_ADDR = %s\n", auth_ip_addr.c_str());
   s3_log(S3_LOG_INFO, "", "S3_AUTH_PORT = %d\n", auth_port);
+  s3_log(S3_LOG_INFO, "", "S3_AUTH_CONN_POOL_SIZE = %u\n", auth_conn_pool_size);
+  s3_log(S3_LOG_INFO, "", "S3_AUTH_CONN_POOL_IDLE_TIMEOUT_SEC = %u\n",
+         auth_conn_pool_idle_timeout_sec);
+  s3_log(S3_LOG_INFO, "", "S3_AUTH_CACHE_SIZE = %u\n", auth_cache_size);
+  s3_log(S3_LOG_INFO, "", "S3_AUTH_CACHE_TTL_SEC = %u\n", auth_cache_ttl_sec);
   s3_log(S3_LOG_INFO, "", "S3_version = %s\n", s3_version.c_str());
 
   s3_log(S3_LOG_INFO, "", "S3_MOTR_LOCAL_ADDR = %s\n", motr_local_addr.c_str());
@@ -1306,6 +1601,110 @@ unsigned S3Option::get_bucket_metadata_cache_refresh_sec() const {
   return bucket_metadata_cache_refresh_sec;
 }
 
+unsigned S3Option::get_bucket_metadata_cache_missing_sec() const {
+  return bucket_metadata_cache_missing_sec;
+}
+
+unsigned S3Option::get_reactor_threads() const { return reactor_threads; }
+
+bool S3Option::is_motr_read_pool_numa_aware() const {
+  return motr_read_pool_numa_aware;
+}
+
+unsigned S3Option::get_motr_write_window() const { return motr_write_window; }
+
+unsigned S3Option::get_motr_read_window() const { return motr_read_window; }
+
+bool S3Option::is_motr_read_zero_copy() const { return motr_read_zero_copy; }
+
+unsigned S3Option::get_auth_conn_pool_size() const {
+  return auth_conn_pool_size;
+}
+
+unsigned S3Option::get_auth_conn_pool_idle_timeout_sec() const {
+  return auth_conn_pool_idle_timeout_sec;
+}
+
+unsigned S3Option::get_auth_cache_size() const { return auth_cache_size; }
+
+unsigned S3Option::get_auth_cache_ttl_sec() const { return auth_cache_ttl_sec; }
+
+unsigned S3Option::get_object_metadata_cache_size() const {
+  return object_metadata_cache_size;
+}
+
+unsigned S3Option::get_object_metadata_cache_ttl_sec() const {
+  return object_metadata_cache_ttl_sec;
+}
+
+bool S3Option::is_metadata_binary_format_enabled() const {
+  return metadata_binary_format;
+}
+
+void S3Option::set_metadata_binary_format(bool enabled) {
+  metadata_binary_format = enabled;
+}
+
+unsigned S3Option::get_delete_objects_window() const {
+  return delete_objects_window;
+}
+
+unsigned S3Option::get_motr_copy_window() const { return motr_copy_window; }
+
+bool S3Option::is_copy_object_by_reference_enabled() const {
+  return copy_object_by_reference;
+}
+
+void S3Option::set_copy_object_by_reference(bool enabled) {
+  copy_object_by_reference = enabled;
+}
+
+unsigned S3Option::get_hash_worker_threads() const {
+  return hash_worker_threads;
+}
+
+unsigned S3Option::get_hash_worker_batch_size() const {
+  return hash_worker_batch_size;
+}
+
+unsigned S3Option::get_hash_worker_queue_size() const {
+  return hash_worker_queue_size;
+}
+
+size_t S3Option::get_object_inline_data_max_size() const {
+  return object_inline_data_max_size;
+}
+
+void S3Option::set_object_inline_data_max_size(size_t max_size) {
+  object_inline_data_max_size = max_size;
+}
+
+uint32_t S3Option::get_stats_flush_interval_msec() const {
+  return stats_flush_interval_msec;
+}
+
+size_t S3Option::get_statsd_max_packet_size() const {
+  return statsd_max_packet_size;
+}
+
+bool S3Option::is_log_async_enabled() const { return log_async_enable; }
+
+unsigned S3Option::get_log_async_buffer_size_kb() const {
+  return log_async_buffer_size_kb;
+}
+
+unsigned S3Option::get_audit_logger_post_batch_size() const {
+  return audit_logger_post_batch_size;
+}
+
+unsigned S3Option::get_audit_logger_posts_in_flight() const {
+  return audit_logger_posts_in_flight;
+}
+
+unsigned S3Option::get_audit_logger_post_queue_size_mb() const {
+  return audit_logger_post_queue_size_mb;
+}
+
 std::string S3Option::get_motr_local_addr() { return motr_local_addr; }
 
 std::string S3Option::get_motr_ha_addr() { return motr_ha_addr; }
@@ -1460,7 +1859,15 @@ void S3Option::set_stats_allowlist_filename(const std::string& filename) {
   stats_allowlist_filename = filename;
 }
 
-evbase_t* S3Option::get_eventbase() { return eventbase; }
+evbase_t* S3Option::get_eventbase() {
+  return reactor_eventbase ? reactor_eventbase : eventbase;
+}
+
+evbase_t* S3Option::get_main_eventbase() { return eventbase; }
+
+void S3Option::set_reactor_eventbase(evbase_t* base) {
+  reactor_eventbase = base;
+}
 
 void S3Option::enable_fault_injection() { FLAGS_fault_injection = true; }
 
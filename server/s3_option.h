@@ -64,6 +64,19 @@
     return false;                                                           \
   } while (0)
 
+#define S3_OPTION_RANGE_CHECK_AND_RET(option, value, min_value, max_value) \
+  do {                                                                     \
+    if ((value) < (min_value) || (value) > (max_value)) {                  \
+      fprintf(stderr,                                                      \
+              "%s:%d:option [%s], value [%llu] is out of range "          \
+              "[%llu, %llu]\n",                                            \
+              __FILE__, __LINE__, (option), (unsigned long long)(value),   \
+              (unsigned long long)(min_value),                             \
+              (unsigned long long)(max_value));                            \
+      return false;                                                        \
+    }                                                                      \
+  } while (0)
+
 #include <gtest/gtest_prod.h>
 #include <limits.h>
 #include <netdb.h>
@@ -154,6 +167,34 @@ class S3Option {
   unsigned bucket_metadata_cache_max_size;
   unsigned bucket_metadata_cache_expire_sec;
   unsigned bucket_metadata_cache_refresh_sec;
+  unsigned bucket_metadata_cache_missing_sec;
+
+  unsigned reactor_threads;
+  bool motr_read_pool_numa_aware;
+  unsigned motr_write_window;
+  unsigned motr_read_window;
+  bool motr_read_zero_copy;
+  unsigned auth_conn_pool_size;
+  unsigned auth_conn_pool_idle_timeout_sec;
+  unsigned auth_cache_size;
+  unsigned auth_cache_ttl_sec;
+  unsigned object_metadata_cache_size;
+  unsigned object_metadata_cache_ttl_sec;
+  bool metadata_binary_format;
+  unsigned delete_objects_window;
+  unsigned motr_copy_window;
+  bool copy_object_by_reference;
+  unsigned hash_worker_threads;
+  unsigned hash_worker_batch_size;
+  unsigned hash_worker_queue_size;
+  size_t object_inline_data_max_size;
+  uint32_t stats_flush_interval_msec;
+  size_t statsd_max_packet_size;
+  bool log_async_enable;
+  unsigned log_async_buffer_size_kb;
+  unsigned audit_logger_post_batch_size;
+  unsigned audit_logger_posts_in_flight;
+  unsigned audit_logger_post_queue_size_mb;
 
   bool s3_di_disable_data_corruption_iem;
   bool s3_di_disable_metadata_corruption_iem;
@@ -207,6 +248,9 @@ class S3Option {
   std::string stats_allowlist_filename;
   uint32_t perf_stats_inout_bytes_interval_msec;
   evbase_t* eventbase;
+  // Event base of the reactor owning the calling thread, NULL on threads
+  // which are not running a reactor loop (e.g. Motr callback threads).
+  static thread_local evbase_t* reactor_eventbase;
 
   static S3Option* option_instance;
   void set_motr_idx_fetch_count(short count);
@@ -326,6 +370,33 @@ class S3Option {
     motr_etimedout_max_threshold = 5;
     motr_etimedout_window_sec = 60;
 
+    reactor_threads = 1;
+    motr_read_pool_numa_aware = true;
+    motr_write_window = 1;
+    motr_read_window = 1;
+    motr_read_zero_copy = false;
+    auth_conn_pool_size = 0;
+    auth_conn_pool_idle_timeout_sec = 30;
+    auth_cache_size = 0;
+    auth_cache_ttl_sec = 30;
+    bucket_metadata_cache_missing_sec = 0;
+    object_metadata_cache_size = 0;
+    object_metadata_cache_ttl_sec = 5;
+    metadata_binary_format = false;
+    delete_objects_window = 1;
+    motr_copy_window = 2;
+    copy_object_by_reference = false;
+    hash_worker_threads = 0;
+    hash_worker_batch_size = 16;
+    hash_worker_queue_size = 1024;
+    object_inline_data_max_size = 0;
+    stats_flush_interval_msec = 1000;
+    statsd_max_packet_size = 1432;
+    log_async_enable = true;
+    log_async_buffer_size_kb = 256;
+    audit_logger_post_batch_size = 100;
+    audit_logger_posts_in_flight = 4;
+    audit_logger_post_queue_size_mb = 64;
     eventbase = NULL;
 
     // find out the nodename
@@ -436,6 +507,37 @@ class S3Option {
   unsigned get_bucket_metadata_cache_max_size() const;
   unsigned get_bucket_metadata_cache_expire_sec() const;
   unsigned get_bucket_metadata_cache_refresh_sec() const;
+  unsigned get_bucket_metadata_cache_missing_sec() const;
+
+  unsigned get_reactor_threads() const;
+  bool is_motr_read_pool_numa_aware() const;
+  unsigned get_motr_write_window() const;
+  unsigned get_motr_read_window() const;
+  bool is_motr_read_zero_copy() const;
+  unsigned get_auth_conn_pool_size() const;
+  unsigned get_auth_conn_pool_idle_timeout_sec() const;
+  unsigned get_auth_cache_size() const;
+  unsigned get_auth_cache_ttl_sec() const;
+  unsigned get_object_metadata_cache_size() const;
+  unsigned get_object_metadata_cache_ttl_sec() const;
+  bool is_metadata_binary_format_enabled() const;
+  void set_metadata_binary_format(bool enabled);
+  unsigned get_delete_objects_window() const;
+  unsigned get_motr_copy_window() const;
+  bool is_copy_object_by_reference_enabled() const;
+  void set_copy_object_by_reference(bool enabled);
+  unsigned get_hash_worker_threads() const;
+  unsigned get_hash_worker_batch_size() const;
+  unsigned get_hash_worker_queue_size() const;
+  size_t get_object_inline_data_max_size() const;
+  void set_object_inline_data_max_size(size_t max_size);
+  uint32_t get_stats_flush_interval_msec() const;
+  size_t get_statsd_max_packet_size() const;
+  bool is_log_async_enabled() const;
+  unsigned get_log_async_buffer_size_kb() const;
+  unsigned get_audit_logger_post_batch_size() const;
+  unsigned get_audit_logger_posts_in_flight() const;
+  unsigned get_audit_logger_post_queue_size_mb() const;
 
   std::string get_motr_local_addr();
   std::string get_motr_ha_addr();
@@ -496,7 +598,11 @@ class S3Option {
   bool is_sync_kvs_allowed();
 
   void set_eventbase(evbase_t* base);
+  // Returns the event base of the calling reactor thread, falls back to
+  // the main event base.
   evbase_t* get_eventbase();
+  evbase_t* get_main_eventbase();
+  void set_reactor_eventbase(evbase_t* base);
 
   std::string get_redis_srv_addr();
   unsigned short get_redis_srv_port();
@@ -25,6 +25,7 @@
 #include "s3_factory.h"
 #include "s3_iem.h"
 #include "s3_log.h"
+#include "s3_metadata_record.h"
 #include "s3_motr_kvs_reader.h"
 #include "s3_motr_kvs_writer.h"
 #include "s3_part_metadata.h"
@@ -450,15 +451,13 @@ std::string S3PartMetadata::to_json() {
   for (auto uit : user_defined_attribute) {
     root["User-Defined"][uit.first] = uit.second;
   }
-  Json::FastWriter fastWriter;
-  return fastWriter.write(root);
+  return S3MetadataRecord::serialize(root);
 }
 
 int S3PartMetadata::from_json(std::string content) {
   s3_log(S3_LOG_DEBUG, request_id, "\n");
   Json::Value newroot;
-  Json::Reader reader;
-  bool parsingSuccessful = reader.parse(content.c_str(), newroot);
+  bool parsingSuccessful = S3MetadataRecord::parse(content, newroot);
   if (!parsingSuccessful || s3_di_fi_is_enabled("part_metadata_corrupted")) {
     s3_log(S3_LOG_ERROR, request_id, "Json Parsing failed.\n");
     return -1;
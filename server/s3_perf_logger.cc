@@ -47,6 +47,7 @@ void S3PerfLogger::write(const char* perf_text, const char* req_id,
   assert(req_id && req_id[0]);
 
   if (instance && elapsed_time != (size_t)(-1)) {
+    std::lock_guard<std::mutex> guard(instance->perf_file_lock);
     instance->perf_file << req_id << ' ' << perf_text << ':' << elapsed_time
                         << '\n';
   }
@@ -66,6 +67,9 @@ void log_timed_counter(TimedCounter& timed_counter,
   if (!FLAGS_loading_indicators) {
     return;
   }
+  // Counters are shared by all reactor threads
+  static std::mutex timed_counter_lock;
+  std::lock_guard<std::mutex> guard(timed_counter_lock);
   using namespace std::chrono;
 
   auto current_time = steady_clock::now();
@@ -26,12 +26,14 @@
 #include <string>
 #include <fstream>
 #include <chrono>
+#include <mutex>
 
-// Not thread-safe, but we are single threaded.
+// Shared by all reactor threads, writes are serialized by perf_file_lock.
 class S3PerfLogger {
 
   static S3PerfLogger* instance;
   std::ofstream perf_file;
+  std::mutex perf_file_lock;
 
  public:
   // Opens the Performance log file
@@ -18,49 +18,92 @@
  *
  */
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <cstdint>
 
+#include <vector>
+
 #include "s3_stats.h"
 #include "event_utils.h"
+#include "s3_mem_pool_manager.h"
 #include "s3_perf_metrics.h"
 #include "atexit.h"
 
 // Helper class, will keep value of a single throughput metric.
+// Bytes are added by every reactor thread, the main loop timer submits them.
 class S3ThroughputMetric {
  private:
-  int64_t bytes_cnt = 0;
+  std::atomic<int64_t> bytes_cnt{0};
   std::string name;
 
  public:
   explicit S3ThroughputMetric(std::string const &name_) : name(name_) {}
 
   void submit() {
-    s3_stats_count(name, bytes_cnt);
-    bytes_cnt = 0;
+    s3_stats_count(name, bytes_cnt.exchange(0, std::memory_order_relaxed));
   }
 
   void more_bytes(int64_t cnt) {
-    bytes_cnt += cnt;
-    if (bytes_cnt > (((int64_t)1) << 51)) {  // some docs say that statsd can
-                                             // eat numbers up to 2^52^, so
-                                             // making sure we're not above that
-                                             // limit
+    int64_t total = bytes_cnt.fetch_add(cnt, std::memory_order_relaxed) + cnt;
+    if (total > (((int64_t)1) << 51)) {  // some docs say that statsd can
+                                         // eat numbers up to 2^52^, so
+                                         // making sure we're not above that
+                                         // limit
       submit();
     }
   }
 };
 
+// Helper class, submits per NUMA node motr read buffer pool traffic deltas
+// since last submission.
+class S3MempoolNumaMetrics {
+ private:
+  std::vector<uint64_t> last;  // 3 counters per node
+
+  void submit_delta(std::string const &name, size_t idx, uint64_t value) {
+    if (value > last[idx]) {
+      s3_stats_count(name, value - last[idx]);
+    }
+    last[idx] = value;
+  }
+
+ public:
+  void submit() {
+    S3MempoolManager *mgr = S3MempoolManager::get_instance();
+    if (!mgr || mgr->get_numa_nodes() <= 1) {
+      return;
+    }
+    last.resize(3 * mgr->get_numa_nodes(), 0);
+    for (int node = 0; node < mgr->get_numa_nodes(); ++node) {
+      const S3MempoolNumaNodeStats &stats = mgr->get_numa_node_stats(node);
+      std::string prefix = "motr_read_pool_node" + std::to_string(node);
+      submit_delta(prefix + "_local_alloc_count", 3 * node,
+                   stats.local_allocs.load());
+      submit_delta(prefix + "_remote_alloc_count", 3 * node + 1,
+                   stats.remote_allocs.load());
+      submit_delta(prefix + "_remote_release_count", 3 * node + 2,
+                   stats.remote_releases.load());
+    }
+  }
+};
+
 // Helper class, defines recurring event for metrics submission to statsd.
 class S3ThroughputMetricsEvent : public RecurringEventBase {
  private:
   S3ThroughputMetric in{"incoming_object_bytes_count"};
   S3ThroughputMetric out{"outcoming_object_bytes_count"};
+  S3ThroughputMetric get_copied{"get_object_copied_bytes_count"};
+  S3ThroughputMetric get_referenced{"get_object_referenced_bytes_count"};
+  S3MempoolNumaMetrics numa;
 
   void submit_metrics() {
     in.submit();
     out.submit();
+    get_copied.submit();
+    get_referenced.submit();
+    numa.submit();
   }
 
  public:
@@ -73,6 +116,11 @@ class S3ThroughputMetricsEvent : public RecurringEventBase {
   void more_bytes_in(int cnt) { in.more_bytes(cnt); }
 
   void more_bytes_out(int cnt) { out.more_bytes(cnt); }
+
+  void more_get_object_bytes(size_t copied, size_t referenced) {
+    get_copied.more_bytes(copied);
+    get_referenced.more_bytes(referenced);
+  }
 };
 
 static std::shared_ptr<EventWrapper> gs_event_obj_ptr;
@@ -152,3 +200,14 @@ void s3_perf_count_outcoming_bytes(int byte_count) {
     gs_throughput_event->more_bytes_out(byte_count);
   }
 }
+
+void s3_perf_count_get_object_data_bytes(size_t copied, size_t referenced) {
+  if (!g_option_instance->is_stats_enabled()) {
+    return;
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Entry with copied = %zu referenced = %zu",
+         __func__, copied, referenced);
+  if (gs_throughput_event) {
+    gs_throughput_event->more_get_object_bytes(copied, referenced);
+  }
+}
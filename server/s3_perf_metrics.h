@@ -22,6 +22,8 @@
 
 #ifndef __S3_SERVER_S3_PERF_METRICS_H__
 
+#include <cstddef>
+
 #include "event_utils.h"
 
 int s3_perf_metrics_init(evbase_t *evbase);
@@ -30,4 +32,8 @@ void s3_perf_metrics_fini();
 void s3_perf_count_incoming_bytes(int byte_count);
 void s3_perf_count_outcoming_bytes(int byte_count);
 
+// GET object data sent to client, split into bytes memcpy'd on the way
+// and bytes handed to libevent by reference to the read buffers.
+void s3_perf_count_get_object_data_bytes(size_t copied, size_t referenced);
+
 #endif
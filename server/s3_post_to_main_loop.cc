@@ -27,7 +27,9 @@ void S3PostToMainLoop::operator()(user_event_on_main_loop callback,
   struct event *ev_user = NULL;
   struct user_event_context *user_context =
       (struct user_event_context *)context;
-  struct event_base *base = S3Option::get_instance()->get_eventbase();
+  if (base == NULL) {
+    base = S3Option::get_instance()->get_eventbase();
+  }
 
   if (base == NULL) {
     s3_log(S3_LOG_ERROR, request_id, "ERROR: event base is NULL\n");
@@ -42,3 +44,30 @@ void S3PostToMainLoop::operator()(user_event_on_main_loop callback,
   event_active(ev_user, EV_READ | EV_WRITE | EV_TIMEOUT, 1);
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
 }
+
+extern "C" void s3_run_handler_on_main_loop(evutil_socket_t, short,
+                                            void *user_data) {
+  struct user_event_context *user_context =
+      (struct user_event_context *)user_data;
+  auto handler = static_cast<std::function<void()> *>(user_context->app_ctx);
+
+  (*handler)();
+  delete handler;
+  event_free((struct event *)user_context->user_event);
+  free(user_data);
+}
+
+void s3_run_on_main_loop(std::function<void()> handler) {
+  S3Option *option_instance = S3Option::get_instance();
+  evbase_t *main_base = option_instance->get_main_eventbase();
+
+  if (main_base == NULL || option_instance->get_eventbase() == main_base) {
+    handler();
+    return;
+  }
+  struct user_event_context *user_ctx = (struct user_event_context *)calloc(
+      1, sizeof(struct user_event_context));
+  user_ctx->app_ctx = new std::function<void()>(std::move(handler));
+
+  S3PostToMainLoop((void *)user_ctx, main_base)(s3_run_handler_on_main_loop);
+}
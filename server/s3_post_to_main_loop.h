@@ -23,6 +23,8 @@
 #ifndef __S3_SERVER_S3_POST_TO_MAIN_LOOP_H__
 #define __S3_SERVER_S3_POST_TO_MAIN_LOOP_H__
 
+#include <functional>
+
 /* libevhtp */
 #include <evhtp.h>
 
@@ -40,9 +42,13 @@ extern "C" typedef void (*user_event_on_main_loop)(evutil_socket_t,
 
 class S3PostToMainLoop {
   void *context;
+  // Reactor to post to, NULL means the event base of the calling thread
+  // (main event base for non reactor threads).
+  struct event_base *base;
 
  public:
-  S3PostToMainLoop(void *ctx) : context(ctx) {
+  S3PostToMainLoop(void *ctx, struct event_base *evbase = NULL)
+      : context(ctx), base(evbase) {
     s3_log(S3_LOG_DEBUG, "", "%s Ctor\n", __func__);
   }
 
@@ -50,4 +56,9 @@ class S3PostToMainLoop {
                   const std::string &request_id = "");
 };
 
+// Runs handler on the main event base: right away when called on the main
+// loop (or a non reactor thread), posted to the main loop when called from
+// one of the additional reactors. Used by sinks bound to the main event base.
+void s3_run_on_main_loop(std::function<void()> handler);
+
 #endif
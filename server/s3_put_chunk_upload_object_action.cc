@@ -104,6 +104,12 @@ S3PutChunkUploadObjectAction::S3PutChunkUploadObjectAction(
   setup_steps();
 }
 
+S3PutChunkUploadObjectAction::~S3PutChunkUploadObjectAction() {
+  s3_log(S3_LOG_DEBUG, request_id, "%s\n", __func__);
+  // Chunk hashes still in S3HashWorkers may complete after the action is gone
+  request->set_chunk_detail_ready_callback(nullptr);
+}
+
 void S3PutChunkUploadObjectAction::setup_steps() {
   s3_log(S3_LOG_DEBUG, request_id, "Setting up the action\n");
 
@@ -470,6 +476,9 @@ void S3PutChunkUploadObjectAction::initiate_data_streaming() {
     auth_client->init_chunk_auth_cycle(
         std::bind(&S3PutChunkUploadObjectAction::chunk_auth_successful, this),
         std::bind(&S3PutChunkUploadObjectAction::chunk_auth_failed, this));
+    // Chunk hashes done by S3HashWorkers may be ready after the data write
+    request->set_chunk_detail_ready_callback(std::bind(
+        &S3PutChunkUploadObjectAction::send_chunk_details_if_any, this));
   }
 
   if (request->get_data_length() == 0) {
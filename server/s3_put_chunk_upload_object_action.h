@@ -107,6 +107,7 @@ class S3PutChunkUploadObjectAction : public S3ObjectAction {
       std::shared_ptr<MotrAPI> motr_api = nullptr,
       std::shared_ptr<S3PutTagsBodyFactory> put_tags_body_factory = nullptr,
       std::shared_ptr<S3MotrKVSWriterFactory> kv_writer_factory = nullptr);
+  virtual ~S3PutChunkUploadObjectAction();
 
   void setup_steps();
 
@@ -18,22 +18,57 @@
  *
  */
 
+#include <algorithm>
+
 #include "s3_put_multiobject_action.h"
+#include "s3_common_utilities.h"
 #include "s3_error_codes.h"
 #include "s3_log.h"
 #include "s3_option.h"
 #include "s3_perf_logger.h"
 #include "s3_perf_metrics.h"
 
+// Parses x-amz-copy-source-range, which is "bytes=first-last"
+static bool parse_copy_source_range(const std::string &range,
+                                    size_t &first_byte, size_t &last_byte) {
+  const std::string prefix = "bytes=";
+
+  if (range.compare(0, prefix.length(), prefix) != 0) {
+    return false;
+  }
+  const size_t dash_pos = range.find('-', prefix.length());
+  if (dash_pos == std::string::npos) {
+    return false;
+  }
+  const std::string first =
+      range.substr(prefix.length(), dash_pos - prefix.length());
+  const std::string last = range.substr(dash_pos + 1);
+  unsigned long first_value, last_value;
+
+  if (!S3CommonUtilities::string_has_only_digits(first) ||
+      !S3CommonUtilities::string_has_only_digits(last) ||
+      !S3CommonUtilities::stoul(first, first_value) ||
+      !S3CommonUtilities::stoul(last, last_value) || first_value > last_value) {
+    return false;
+  }
+  first_byte = first_value;
+  last_byte = last_value;
+  return true;
+}
+
 S3PutMultiObjectAction::S3PutMultiObjectAction(
     std::shared_ptr<S3RequestObject> req,
     std::shared_ptr<S3ObjectMultipartMetadataFactory> object_mp_meta_factory,
     std::shared_ptr<S3PartMetadataFactory> part_meta_factory,
     std::shared_ptr<S3MotrWriterFactory> motr_s3_writer_factory,
-    std::shared_ptr<S3AuthClientFactory> auth_factory)
+    std::shared_ptr<S3AuthClientFactory> auth_factory,
+    std::shared_ptr<S3MotrReaderFactory> motr_s3_reader_factory)
     : S3ObjectAction(std::move(req), nullptr, nullptr, true,
                      std::move(auth_factory)),
       total_data_to_stream(0),
+      has_copy_source_range(false),
+      copy_source_first_byte(0),
+      copy_source_last_byte(0),
       auth_failed(false),
       write_failed(false),
       motr_write_in_progress(false),
@@ -43,12 +78,17 @@ S3PutMultiObjectAction::S3PutMultiObjectAction(
   s3_log(S3_LOG_DEBUG, request_id, "%s Ctor\n", __func__);
   part_number = get_part_number();
   upload_id = request->get_query_string_value("uploadId");
+  is_copy_part = !request->get_headers_copysource().empty();
 
   s3_log(S3_LOG_INFO, stripped_request_id,
          "S3 API: Upload Part. Bucket[%s] Object[%s]\
          Part[%d] for UploadId[%s]\n",
          request->get_bucket_name().c_str(), request->get_object_name().c_str(),
          part_number, upload_id.c_str());
+  if (is_copy_part) {
+    s3_log(S3_LOG_INFO, stripped_request_id, "Part data source: [%s]\n",
+           request->get_headers_copysource().c_str());
+  }
 
   layout_id = -1;  // Loaded from multipart metadata
 
@@ -74,15 +114,35 @@ S3PutMultiObjectAction::S3PutMultiObjectAction(
   } else {
     motr_writer_factory = std::make_shared<S3MotrWriterFactory>();
   }
+
+  if (motr_s3_reader_factory) {
+    motr_reader_factory = std::move(motr_s3_reader_factory);
+  } else {
+    motr_reader_factory = std::make_shared<S3MotrReaderFactory>();
+  }
   is_first_write_part_request = true;
   setup_steps();
 }
 
+S3PutMultiObjectAction::~S3PutMultiObjectAction() {
+  s3_log(S3_LOG_DEBUG, request_id, "%s\n", __func__);
+  // Chunk hashes still in S3HashWorkers may complete after the action is gone
+  request->set_chunk_detail_ready_callback(nullptr);
+}
+
 void S3PutMultiObjectAction::setup_steps() {
   s3_log(S3_LOG_DEBUG, request_id, "Setting up the action\n");
 
   ACTION_TASK_ADD(S3PutMultiObjectAction::validate_multipart_request, this);
   ACTION_TASK_ADD(S3PutMultiObjectAction::check_part_details, this);
+  if (is_copy_part) {
+    ACTION_TASK_ADD(S3PutMultiObjectAction::fetch_copy_source, this);
+    ACTION_TASK_ADD(S3PutMultiObjectAction::validate_copy_source, this);
+    if (!S3Option::get_instance()->is_auth_disabled()) {
+      ACTION_TASK_ADD(S3PutMultiObjectAction::check_copy_source_authorization,
+                      this);
+    }
+  }
   ACTION_TASK_ADD(S3PutMultiObjectAction::fetch_multipart_metadata, this);
   if (part_number == 1) {
     // Save first part size to multipart metadata in case of non
@@ -102,7 +162,11 @@ void S3PutMultiObjectAction::setup_steps() {
     }
   }
   ACTION_TASK_ADD(S3PutMultiObjectAction::compute_part_offset, this);
-  ACTION_TASK_ADD(S3PutMultiObjectAction::initiate_data_streaming, this);
+  if (is_copy_part) {
+    ACTION_TASK_ADD(S3PutMultiObjectAction::copy_part_data, this);
+  } else {
+    ACTION_TASK_ADD(S3PutMultiObjectAction::initiate_data_streaming, this);
+  }
   ACTION_TASK_ADD(S3PutMultiObjectAction::save_metadata, this);
   ACTION_TASK_ADD(S3PutMultiObjectAction::send_response_to_s3_client, this);
   // ...
@@ -110,7 +174,36 @@ void S3PutMultiObjectAction::setup_steps() {
 
 void S3PutMultiObjectAction::validate_multipart_request() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
-  if (!request->is_chunked() && !request->is_header_present("Content-Length")) {
+  if (is_copy_part) {
+    const std::string copy_source_range =
+        request->get_header_value("x-amz-copy-source-range");
+
+    has_copy_source_range = !copy_source_range.empty();
+    if (has_copy_source_range &&
+        !parse_copy_source_range(copy_source_range, copy_source_first_byte,
+                                 copy_source_last_byte)) {
+      s3_log(S3_LOG_INFO, stripped_request_id,
+             "Invalid x-amz-copy-source-range [%s]\n",
+             copy_source_range.c_str());
+      set_s3_error("InvalidArgument");
+      send_response_to_s3_client();
+    } else if (request->is_header_present("x-amz-copy-source-if-match") ||
+               request->is_header_present("x-amz-copy-source-if-none-match") ||
+               request->is_header_present(
+                   "x-amz-copy-source-if-modified-since") ||
+               request->is_header_present(
+                   "x-amz-copy-source-if-unmodified-since")) {
+      // Conditional copy is not supported (same as CopyObject), reject
+      // rather than copy the part unconditionally
+      s3_log(S3_LOG_INFO, stripped_request_id,
+             "x-amz-copy-source-if-* headers are not supported");
+      set_s3_error("NotImplemented");
+      send_response_to_s3_client();
+    } else {
+      next();
+    }
+  } else if (!request->is_chunked() &&
+             !request->is_header_present("Content-Length")) {
     // For non-chunked upload, the Header 'Content-Length' is missing
     s3_log(S3_LOG_INFO, stripped_request_id, "Missing Content-Length header");
     set_s3_error("MissingContentLength");
@@ -142,6 +235,135 @@ void S3PutMultiObjectAction::check_part_details() {
   }
 }
 
+void S3PutMultiObjectAction::fetch_copy_source() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  get_source_bucket_and_object(request->get_headers_copysource());
+
+  if (additional_bucket_name.empty() || additional_object_name.empty()) {
+    set_s3_error("InvalidArgument");
+    send_response_to_s3_client();
+  } else {
+    fetch_additional_bucket_info();
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::fetch_additional_bucket_info_failed() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  switch (additional_bucket_metadata->get_state()) {
+    case S3BucketMetadataState::missing:
+      s3_log(S3_LOG_ERROR, request_id, "Source bucket [%s] not found\n",
+             additional_bucket_name.c_str());
+      set_s3_error("NoSuchBucket");
+      break;
+    case S3BucketMetadataState::failed_to_launch:
+      s3_log(S3_LOG_ERROR, request_id,
+             "Source bucket metadata load failed due to pre launch failure\n");
+      set_s3_error("ServiceUnavailable");
+      break;
+    default:
+      s3_log(S3_LOG_ERROR, request_id, "Source bucket metadata fetch failed\n");
+      set_s3_error("InternalError");
+  }
+  send_response_to_s3_client();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::fetch_additional_object_info_failed() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  // Object metadata isn't created if source bucket has no object list index
+  if (!additional_object_metadata ||
+      additional_object_metadata->get_state() ==
+          S3ObjectMetadataState::missing) {
+    s3_log(S3_LOG_ERROR, request_id, "Source object [%s] not found\n",
+           additional_object_name.c_str());
+    set_s3_error("NoSuchKey");
+  } else if (additional_object_metadata->get_state() ==
+             S3ObjectMetadataState::failed_to_launch) {
+    s3_log(S3_LOG_ERROR, request_id,
+           "Object metadata load operation failed due to pre launch failure\n");
+    set_s3_error("ServiceUnavailable");
+  } else {
+    s3_log(S3_LOG_ERROR, request_id, "Source object metadata fetch failed\n");
+    set_s3_error("InternalError");
+  }
+  send_response_to_s3_client();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::validate_copy_source() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  const size_t source_size = additional_object_metadata->get_content_length();
+
+  if (!has_copy_source_range) {
+    copy_source_first_byte = 0;
+    // Not used for an empty source
+    copy_source_last_byte = source_size ? source_size - 1 : 0;
+  }
+  const size_t part_size =
+      source_size ? copy_source_last_byte - copy_source_first_byte + 1 : 0;
+
+  if (has_copy_source_range && copy_source_last_byte >= source_size) {
+    s3_log(S3_LOG_ERROR, request_id,
+           "Copy source range [%zu, %zu] is beyond source of %zu bytes\n",
+           copy_source_first_byte, copy_source_last_byte, source_size);
+    set_s3_error("InvalidArgument");
+    send_response_to_s3_client();
+  } else if (part_size > MAXIMUM_ALLOWED_PART_SIZE) {
+    s3_log(S3_LOG_ERROR, request_id,
+           "Copy source of %zu bytes is too large for a part\n", part_size);
+    set_s3_error("InvalidRequest");
+    send_response_to_s3_client();
+  } else {
+    total_data_to_stream = part_size;
+    next();
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+// Requester must be allowed to read the source object as well
+void S3PutMultiObjectAction::check_copy_source_authorization() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  get_auth_client()->set_get_method = true;
+  get_auth_client()->set_entity_path("/" + additional_bucket_name + "/" +
+                                     additional_object_name);
+  get_auth_client()->set_acl_and_policy(
+      additional_object_metadata->get_encoded_object_acl(),
+      additional_bucket_metadata->get_policy_as_json());
+  request->set_action_str("GetObject");
+  request->reset_action_list();
+
+  get_auth_client()->check_authorization(
+      std::bind(
+          &S3PutMultiObjectAction::check_copy_source_authorization_success,
+          this),
+      std::bind(&S3PutMultiObjectAction::check_copy_source_authorization_failed,
+                this));
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::check_copy_source_authorization_success() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  request->set_action_str("PutMultiObject");
+  next();
+}
+
+void S3PutMultiObjectAction::check_copy_source_authorization_failed() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  std::string error_code = get_auth_client()->get_error_code();
+  s3_log(S3_LOG_ERROR, request_id, "Copy source authorization failure: %s\n",
+         error_code.c_str());
+  set_s3_error(error_code);
+  send_response_to_s3_client();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
 void S3PutMultiObjectAction::chunk_auth_successful() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   auth_in_progress = false;
@@ -256,7 +478,7 @@ void S3PutMultiObjectAction::save_multipart_metadata() {
   assert(part_number == 1);
   size_t part_one_size_in_multipart_metadata =
       object_multipart_metadata->get_part_one_size();
-  size_t current_part_one_size = request->get_data_length();
+  size_t current_part_one_size = get_part_size();
 
   if (part_one_size_in_multipart_metadata != 0) {
     s3_log(S3_LOG_WARN, request_id,
@@ -384,7 +606,7 @@ void S3PutMultiObjectAction::compute_part_offset() {
     // Reject during first part itself
     size_t unit_size =
         S3MotrLayoutMap::get_instance()->get_unit_size_for_layout(layout_id);
-    size_t part_size = request->get_data_length();
+    size_t part_size = get_part_size();
     s3_log(S3_LOG_DEBUG, request_id,
            "Check part size (%zu) and unit_size (%zu) compatibility\n",
            part_size, unit_size);
@@ -403,6 +625,123 @@ void S3PutMultiObjectAction::compute_part_offset() {
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+bool S3PutMultiObjectAction::copy_part_data_cb() {
+  return check_shutdown_and_rollback() || !request->client_connected();
+}
+
+// Copies data of the source object to the part's place in multipart object
+void S3PutMultiObjectAction::copy_part_data() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  if (!total_data_to_stream) {
+    s3_log(S3_LOG_DEBUG, stripped_request_id, "Source object is empty");
+    next();
+    return;
+  }
+  if (additional_object_metadata->has_inline_data()) {
+    // No Motr object to read from
+    copy_inline_part_data();
+    return;
+  }
+  // Checksum context of the part is initialised by its first write
+  motr_writer->first_write_part_request(true);
+
+  object_data_copier.reset(new S3ObjectDataCopier(
+      request, motr_writer, motr_reader_factory, nullptr));
+
+  object_data_copier->copy_range(
+      additional_object_metadata->get_oid(), copy_source_first_byte,
+      copy_source_last_byte, additional_object_metadata->get_layout_id(),
+      additional_object_metadata->get_pvid(),
+      std::bind(&S3PutMultiObjectAction::copy_part_data_cb, this),
+      std::bind(&S3PutMultiObjectAction::copy_part_data_success, this),
+      std::bind(&S3PutMultiObjectAction::copy_part_data_failed, this));
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::copy_part_data_success() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  object_data_copier.reset();
+  next();
+}
+
+void S3PutMultiObjectAction::copy_part_data_failed() {
+  s3_log(S3_LOG_ERROR, request_id, "Copy of part data failed\n");
+
+  set_s3_error(object_data_copier->get_s3_error());
+  object_data_copier.reset();
+  send_response_to_s3_client();
+}
+
+// Inline data is small, it is written at once
+void S3PutMultiObjectAction::copy_inline_part_data() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  const std::string &source_data =
+      additional_object_metadata->get_inline_data();
+  const char *data = source_data.data() + copy_source_first_byte;
+  const size_t data_length = total_data_to_stream;
+
+  inline_part_data = std::make_shared<S3AsyncBufferOptContainer>(
+      S3Option::get_instance()->get_libevent_pool_buffer_size());
+
+  const size_t buf_size = inline_part_data->size_of_each_evbuf;
+  size_t offset = 0;
+
+  // Motr writes whole buffers, so data is laid out in pool sized buffers
+  // like request body
+  while (offset < data_length) {
+    const size_t len = std::min(buf_size, data_length - offset);
+    evbuf_t *buf = evbuffer_new();
+
+    if (!buf || evbuffer_add(buf, data + offset, len) != 0 ||
+        !inline_part_data->add_content(buf, offset == 0,
+                                       offset + len == data_length, true)) {
+      s3_log(S3_LOG_ERROR, request_id, "Failed to buffer inline data\n");
+      if (buf) {
+        evbuffer_free(buf);
+      }
+      inline_part_data.reset();
+      set_s3_error("InternalError");
+      send_response_to_s3_client();
+      return;
+    }
+    offset += len;
+  }
+  motr_writer->first_write_part_request(true);
+  motr_writer->write_content(
+      std::bind(&S3PutMultiObjectAction::copy_inline_part_data_successful,
+                this),
+      std::bind(&S3PutMultiObjectAction::copy_inline_part_data_failed, this),
+      inline_part_data->get_buffers(data_length), buf_size);
+
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutMultiObjectAction::copy_inline_part_data_successful() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  motr_writer->first_write_part_request(false);
+  inline_part_data.reset();
+  next();
+}
+
+void S3PutMultiObjectAction::copy_inline_part_data_failed() {
+  s3_log(S3_LOG_ERROR, request_id, "Write of inline part data failed\n");
+
+  motr_writer->first_write_part_request(false);
+  inline_part_data.reset();
+
+  if (motr_writer->get_state() == S3MotrWiterOpState::failed_to_launch) {
+    set_s3_error("ServiceUnavailable");
+  } else {
+    set_s3_error("InternalError");
+  }
+  send_response_to_s3_client();
+}
+
 void S3PutMultiObjectAction::initiate_data_streaming() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
@@ -413,6 +752,9 @@ void S3PutMultiObjectAction::initiate_data_streaming() {
     get_auth_client()->init_chunk_auth_cycle(
         std::bind(&S3PutMultiObjectAction::chunk_auth_successful, this),
         std::bind(&S3PutMultiObjectAction::chunk_auth_failed, this));
+    // Chunk hashes done by S3HashWorkers may be ready after the data write
+    request->set_chunk_detail_ready_callback(
+        std::bind(&S3PutMultiObjectAction::send_chunk_details_if_any, this));
   }
 
   if (total_data_to_stream == 0) {
@@ -624,7 +966,9 @@ void S3PutMultiObjectAction::save_metadata() {
 
   // to rest Date and Last-Modfied time object metadata
   part_metadata->reset_date_time_to_current();
-  part_metadata->set_content_length(request->get_data_length_str());
+  part_metadata->set_content_length(
+      is_copy_part ? std::to_string(total_data_to_stream)
+                   : request->get_data_length_str());
   part_metadata->set_md5(motr_writer->get_content_md5());
   for (auto it : request->get_in_headers_copy()) {
     if (it.first.find("x-amz-meta-") != std::string::npos) {
@@ -700,9 +1044,18 @@ void S3PutMultiObjectAction::send_response_to_s3_client() {
     // AWS adds explicit quotes "" to etag values.
     std::string e_tag = "\"" + motr_writer->get_content_md5() + "\"";
 
-    request->set_out_header_value("ETag", e_tag);
+    if (is_copy_part) {
+      std::string response_xml = get_copy_part_response_xml();
+
+      request->set_out_header_value("Content-Type", "application/xml");
+      request->set_out_header_value("Content-Length",
+                                    std::to_string(response_xml.length()));
+      request->send_response(S3HttpSuccess200, response_xml);
+    } else {
+      request->set_out_header_value("ETag", e_tag);
 
-    request->send_response(S3HttpSuccess200);
+      request->send_response(S3HttpSuccess200);
+    }
   } else {
     set_s3_error("InternalError");
     S3Error error(get_s3_error_code(), request->get_request_id(),
@@ -721,6 +1074,20 @@ void S3PutMultiObjectAction::send_response_to_s3_client() {
   done();
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
+
+std::string S3PutMultiObjectAction::get_copy_part_response_xml() {
+  std::string response_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+
+  response_xml +=
+      "<CopyPartResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">\n";
+  response_xml += S3CommonUtilities::format_xml_string(
+      "LastModified", part_metadata->get_last_modified_iso());
+  response_xml += S3CommonUtilities::format_xml_string(
+      "ETag", motr_writer->get_content_md5(), true);
+  response_xml += "\n</CopyPartResult>";
+  return response_xml;
+}
+
 void S3PutMultiObjectAction::set_authorization_meta() {
   s3_log(S3_LOG_DEBUG, request_id, "%s Entry\n", __func__);
   auth_client->set_acl_and_policy(bucket_metadata->get_encoded_bucket_acl(),
@@ -29,6 +29,7 @@
 #include "s3_async_buffer.h"
 #include "s3_bucket_metadata.h"
 #include "s3_motr_writer.h"
+#include "s3_object_data_copier.h"
 #include "s3_object_metadata.h"
 #include "s3_part_metadata.h"
 #include "s3_timer.h"
@@ -61,15 +62,46 @@ class S3PutMultiObjectAction : public S3ObjectAction {
   bool auth_in_progress;
   bool auth_completed;  // all chunk auth
 
+  // UploadPartCopy, part data is copied from the x-amz-copy-source object
+  bool is_copy_part;
+  // x-amz-copy-source-range, the whole source if not given
+  bool has_copy_source_range;
+  size_t copy_source_first_byte;
+  size_t copy_source_last_byte;
+  std::unique_ptr<S3ObjectDataCopier> object_data_copier;
+  // Data of an inline source, written to the part as is
+  std::shared_ptr<S3AsyncBufferOptContainer> inline_part_data;
+
+  // Size of the part's data, taken from the copy source for UploadPartCopy
+  size_t get_part_size() {
+    return is_copy_part ? total_data_to_stream : request->get_data_length();
+  }
+
   void chunk_auth_successful();
   void chunk_auth_failed();
   void send_chunk_details_if_any();
   void validate_multipart_request();
   void check_part_details();
+  void fetch_copy_source();
+  void validate_copy_source();
+  void check_copy_source_authorization();
+  void check_copy_source_authorization_success();
+  void check_copy_source_authorization_failed();
+  void fetch_additional_bucket_info_failed() override;
+  void fetch_additional_object_info_failed() override;
+  void copy_part_data();
+  bool copy_part_data_cb();
+  void copy_part_data_success();
+  void copy_part_data_failed();
+  void copy_inline_part_data();
+  void copy_inline_part_data_successful();
+  void copy_inline_part_data_failed();
+  std::string get_copy_part_response_xml();
 
   std::shared_ptr<S3ObjectMultipartMetadataFactory> object_mp_metadata_factory;
   std::shared_ptr<S3PartMetadataFactory> part_metadata_factory;
   std::shared_ptr<S3MotrWriterFactory> motr_writer_factory;
+  std::shared_ptr<S3MotrReaderFactory> motr_reader_factory;
   std::shared_ptr<S3AuthClientFactory> auth_factory;
 
   // Used only for UT
@@ -83,7 +115,9 @@ class S3PutMultiObjectAction : public S3ObjectAction {
           nullptr,
       std::shared_ptr<S3PartMetadataFactory> part_meta_factory = nullptr,
       std::shared_ptr<S3MotrWriterFactory> motr_s3_factory = nullptr,
-      std::shared_ptr<S3AuthClientFactory> auth_factory = nullptr);
+      std::shared_ptr<S3AuthClientFactory> auth_factory = nullptr,
+      std::shared_ptr<S3MotrReaderFactory> motr_s3_reader_factory = nullptr);
+  virtual ~S3PutMultiObjectAction();
 
   void setup_steps();
   // void start();
@@ -206,6 +240,26 @@ class S3PutMultiObjectAction : public S3ObjectAction {
               ValidateUserMetadataLengthNegativeCase);
   FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
               ValidateMissingContentLength);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateCopySourceRange);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateMalformedCopySourceRange);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateSourceRangeBeyondSource);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateSourceRangeSetsPartSize);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateCopySourceConditional);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateSourceTooLarge);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartValidateSourceSetsPartSize);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              CopyPartSourceObjectMissing);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth, CopyPartEmptySource);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth, CopyPartInlineSource);
+  FRIEND_TEST(S3PutMultipartObjectActionTestNoMockAuth,
+              SendCopyPartSuccessResponse);
 };
 
 #endif
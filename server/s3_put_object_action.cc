@@ -24,6 +24,7 @@
 #include "s3_error_codes.h"
 #include "s3_iem.h"
 #include "s3_log.h"
+#include "s3_md5_hash.h"
 #include "s3_option.h"
 #include "s3_perf_logger.h"
 #include "s3_stats.h"
@@ -45,7 +46,9 @@ S3PutObjectAction::S3PutObjectAction(
     : S3ObjectAction(std::move(req), std::move(bucket_meta_factory),
                      std::move(object_meta_factory)),
       total_data_to_stream(0),
-      write_in_progress(false) {
+      write_in_progress(false),
+      writes_in_flight(0),
+      store_data_inline(false) {
   s3_log(S3_LOG_DEBUG, request_id, "%s Ctor\n", __func__);
 
   s3_log(S3_LOG_INFO, stripped_request_id,
@@ -73,6 +76,16 @@ S3PutObjectAction::S3PutObjectAction(
   tried_count = 0;
   salt = "uri_salt_";
 
+  motr_write_window = S3Option::get_instance()->get_motr_write_window();
+  if (motr_write_window == 0) {
+    motr_write_window = 1;
+  }
+  const size_t inline_data_max_size =
+      S3Option::get_instance()->get_object_inline_data_max_size();
+  store_data_inline = inline_data_max_size > 0 &&
+                      request->is_header_present("Content-Length") &&
+                      request->get_content_length() <= inline_data_max_size;
+
   if (motr_s3_factory) {
     motr_writer_factory = std::move(motr_s3_factory);
   } else {
@@ -100,8 +113,13 @@ void S3PutObjectAction::setup_steps() {
     ACTION_TASK_ADD(S3PutObjectAction::validate_x_amz_tagging_if_present, this);
   }
   ACTION_TASK_ADD(S3PutObjectAction::validate_put_request, this);
-  ACTION_TASK_ADD(S3PutObjectAction::create_object, this);
-  ACTION_TASK_ADD(S3PutObjectAction::initiate_data_streaming, this);
+  if (store_data_inline) {
+    ACTION_TASK_ADD(S3PutObjectAction::read_inline_data, this);
+    ACTION_TASK_ADD(S3PutObjectAction::create_inline_object, this);
+  } else {
+    ACTION_TASK_ADD(S3PutObjectAction::create_object, this);
+    ACTION_TASK_ADD(S3PutObjectAction::initiate_data_streaming, this);
+  }
   ACTION_TASK_ADD(S3PutObjectAction::save_metadata, this);
   ACTION_TASK_ADD(S3PutObjectAction::send_response_to_s3_client, this);
   // ...
@@ -413,6 +431,70 @@ void S3PutObjectAction::create_new_oid(struct m0_uint128 current_oid) {
   return;
 }
 
+void S3PutObjectAction::read_inline_data() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+  if (request->has_all_body_content()) {
+    next();
+  } else {
+    // Small body, we ask for all
+    request->listen_for_incoming_data(
+        std::bind(&S3PutObjectAction::consume_inline_data, this),
+        request->get_data_length());
+  }
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
+void S3PutObjectAction::consume_inline_data() {
+  s3_log(S3_LOG_DEBUG, request_id, "%s Entry\n", __func__);
+  if (request->is_s3_client_read_error()) {
+    client_read_error();
+  } else if (request->has_all_body_content()) {
+    next();
+  } else {
+    request->resume();
+  }
+}
+
+// No Motr object is made, so there is only the old object (if any) to add
+// to the probable delete list.
+void S3PutObjectAction::create_inline_object() {
+  s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
+
+  std::string& data = request->get_full_body_content_as_string();
+  s3_perf_count_incoming_bytes(data.length());
+
+  MD5hash calc_md5(NULL, true);
+  calc_md5.Update(data.c_str(), data.length());
+  calc_md5.Finalize();
+
+  std::string s_md5_got = request->get_header_value("content-md5");
+  if (!s_md5_got.empty() && s_md5_got != calc_md5.get_md5_base64enc_string()) {
+    s3_log(S3_LOG_ERROR, request_id, "Content MD5 mismatch\n");
+    s3_put_action_state = S3PutObjectActionState::md5ValidationFailed;
+
+    set_s3_error("BadDigest");
+    send_response_to_s3_client();
+    return;
+  }
+  inline_data_md5 = calc_md5.get_md5_string();
+  _set_layout_id(S3MotrLayoutMap::get_instance()->get_layout_for_object_size(
+      data.length()));
+
+  new_object_metadata = object_metadata_factory->create_object_metadata_obj(
+      request, bucket_metadata->get_object_list_index_layout(),
+      bucket_metadata->get_objects_version_list_index_layout());
+  // Still makes the key of old object probable delete record
+  new_oid_str = S3M0Uint128Helper::to_string(new_object_oid);
+
+  new_object_metadata->regenerate_version_id();
+  new_object_metadata->set_layout_id(layout_id);
+  new_object_metadata->set_inline_data(data);
+  s3_put_action_state = S3PutObjectActionState::writeComplete;
+
+  add_object_oid_to_probable_dead_oid_list();
+  s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+}
+
 void S3PutObjectAction::initiate_data_streaming() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   s3_timer.stop();
@@ -429,6 +511,7 @@ void S3PutObjectAction::initiate_data_streaming() {
       s3_log(S3_LOG_DEBUG, request_id,
              "We have all the data, so just write it.\n");
       write_object(request->get_buffered_input());
+      fill_write_window();
     } else {
       s3_log(S3_LOG_DEBUG, request_id,
              "We do not have all the data, start listening...\n");
@@ -464,6 +547,8 @@ void S3PutObjectAction::consume_incoming_content() {
             motr_write_payload_size) {
       write_object(request->get_buffered_input());
     }
+  } else {
+    fill_write_window();
   }
   if (!request->get_buffered_input()->is_freezed() &&
       request->get_buffered_input()->get_content_length() >=
@@ -486,22 +571,67 @@ void S3PutObjectAction::write_object(
   if (content_length > motr_write_payload_size) {
     content_length = motr_write_payload_size;
   }
+  // Buffers of writes still in flight must stay in use
   motr_writer->write_content(
       std::bind(&S3PutObjectAction::write_object_successful, this),
       std::bind(&S3PutObjectAction::write_object_failed, this),
-      buffer->get_buffers(content_length), buffer->size_of_each_evbuf);
+      writes_in_flight == 0 ? buffer->get_buffers(content_length)
+                            : buffer->get_more_buffers(content_length),
+      buffer->size_of_each_evbuf);
 
+  ++writes_in_flight;
   write_in_progress = true;
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+// Launch more writes while earlier ones are in flight, as long as there is a
+// full payload buffered (or the tail of the data) and memory permits.
+void S3PutObjectAction::fill_write_window() {
+  std::shared_ptr<S3AsyncBufferOptContainer> buffer =
+      request->get_buffered_input();
+
+  while (writes_in_flight > 0 && writes_in_flight < motr_write_window &&
+         motr_writer->can_pipeline_write() &&
+         mem_profile->free_memory_in_pool_above_threshold_limits()) {
+    size_t content_length = buffer->get_content_length();
+    if (content_length < motr_write_payload_size &&
+        !(buffer->is_freezed() && content_length > 0)) {
+      break;
+    }
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Pipelining write, writes in flight = %zu\n", writes_in_flight);
+    write_object(buffer);
+  }
+}
+
 void S3PutObjectAction::write_object_successful() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
   s3_log(S3_LOG_DEBUG, request_id, "Write to motr successful\n");
 
-  request->get_buffered_input()->flush_used_buffers();
-
-  write_in_progress = false;
+  // Writes complete in the order they were launched
+  request->get_buffered_input()->flush_oldest_used_buffers();
+  if (writes_in_flight > 0) {
+    --writes_in_flight;
+  }
+  write_in_progress = (writes_in_flight > 0);
+
+  if (write_in_progress) {
+    // Completion of the writes still in flight continues the data flow, or
+    // the last of them handles shutdown/client errors.
+    if (!S3Option::get_instance()->get_is_s3_shutting_down() &&
+        !request->is_s3_client_read_error()) {
+      fill_write_window();
+      if (!request->get_buffered_input()->is_freezed() &&
+          request->get_buffered_input()->get_content_length() <
+              (motr_write_payload_size *
+               S3Option::get_instance()->get_read_ahead_multiple()) &&
+          mem_profile->we_have_enough_memory_for_put_obj(layout_id)) {
+        request->resume();
+      }
+    }
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
 
   if (check_shutdown_and_rollback()) {
     s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
@@ -526,6 +656,9 @@ void S3PutObjectAction::write_object_successful() {
        request->get_buffered_input()->get_content_length() > 0)) {
 
     write_object(request->get_buffered_input());
+    if (is_memory_enough) {
+      fill_write_window();
+    }
 
     if (!is_memory_enough) {
       request->pause();
@@ -551,6 +684,8 @@ void S3PutObjectAction::write_object_successful() {
 void S3PutObjectAction::write_object_failed() {
   s3_log(S3_LOG_WARN, request_id, "Failed writing to motr.\n");
 
+  // motr_writer reports failure once all writes in flight are done
+  writes_in_flight = 0;
   write_in_progress = false;
   s3_put_action_state = S3PutObjectActionState::writeFailed;
 
@@ -574,7 +709,9 @@ void S3PutObjectAction::save_metadata() {
   s3_log(S3_LOG_INFO, stripped_request_id, "%s Entry\n", __func__);
 
   std::string s_md5_got = request->get_header_value("content-md5");
-  if (!s_md5_got.empty() && !motr_writer->content_md5_matches(s_md5_got)) {
+  // Inline data is checked by create_inline_object()
+  if (!store_data_inline && !s_md5_got.empty() &&
+      !motr_writer->content_md5_matches(s_md5_got)) {
     s3_log(S3_LOG_ERROR, request_id, "Content MD5 mismatch\n");
     s3_put_action_state = S3PutObjectActionState::md5ValidationFailed;
 
@@ -590,7 +727,9 @@ void S3PutObjectAction::save_metadata() {
   new_object_metadata->reset_date_time_to_current();
   new_object_metadata->set_content_length(request->get_data_length_str());
   new_object_metadata->set_content_type(request->get_content_type());
-  new_object_metadata->set_md5(motr_writer->get_content_md5());
+  new_object_metadata->set_md5(store_data_inline
+                                   ? inline_data_md5
+                                   : motr_writer->get_content_md5());
   new_object_metadata->set_tags(new_object_tags_map);
 
   for (auto it : request->get_in_headers_copy()) {
@@ -665,19 +804,26 @@ void S3PutObjectAction::add_object_oid_to_probable_dead_oid_list() {
   S3CommonUtilities::size_based_bucketing_of_objects(
       new_oid_str, request->get_content_length());
 
-  s3_log(S3_LOG_DEBUG, request_id,
-         "Adding new_probable_del_rec with key [%s]\n", new_oid_str.c_str());
-  new_probable_del_rec.reset(new S3ProbableDeleteRecord(
-      new_oid_str, old_object_oid, new_object_metadata->get_object_name(),
-      new_object_oid, layout_id, new_object_metadata->get_pvid_str(),
-      bucket_metadata->get_object_list_index_layout().oid,
-      bucket_metadata->get_objects_version_list_index_layout().oid,
-      new_object_metadata->get_version_key_in_index(),
-      false /* force_delete */));
-
-  // store new oid, key = newoid
-  probable_oid_list[new_oid_str] = new_probable_del_rec->to_json();
+  if (!store_data_inline) {
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Adding new_probable_del_rec with key [%s]\n", new_oid_str.c_str());
+    new_probable_del_rec.reset(new S3ProbableDeleteRecord(
+        new_oid_str, old_object_oid, new_object_metadata->get_object_name(),
+        new_object_oid, layout_id, new_object_metadata->get_pvid_str(),
+        bucket_metadata->get_object_list_index_layout().oid,
+        bucket_metadata->get_objects_version_list_index_layout().oid,
+        new_object_metadata->get_version_key_in_index(),
+        false /* force_delete */));
 
+    // store new oid, key = newoid
+    probable_oid_list[new_oid_str] = new_probable_del_rec->to_json();
+  }
+  if (probable_oid_list.empty()) {
+    // New inline object, nothing can leak
+    next();
+    s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
+    return;
+  }
   if (!motr_kv_writer) {
     motr_kv_writer =
         mote_kv_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
@@ -759,7 +905,10 @@ void S3PutObjectAction::send_response_to_s3_client() {
     s3_stats_timing("put_object_save_metadata", mss);
     // AWS adds explicit quotes "" to etag values.
     // https://docs.aws.amazon.com/AmazonS3/latest/API/API_PutObject.html
-    std::string e_tag = "\"" + motr_writer->get_content_md5() + "\"";
+    std::string e_tag =
+        "\"" +
+        (store_data_inline ? inline_data_md5 : motr_writer->get_content_md5()) +
+        "\"";
 
     request->set_out_header_value("ETag", e_tag);
 
@@ -789,13 +938,26 @@ void S3PutObjectAction::startcleanup() {
       // backgrounddelete decisions.
       ACTION_TASK_ADD(S3PutObjectAction::mark_old_oid_for_deletion, this);
     }
-    // remove new oid from probable delete list.
-    ACTION_TASK_ADD(S3PutObjectAction::remove_new_oid_probable_record, this);
+    if (!store_data_inline) {
+      // remove new oid from probable delete list.
+      ACTION_TASK_ADD(S3PutObjectAction::remove_new_oid_probable_record, this);
+    }
     if (old_object_oid.u_hi || old_object_oid.u_lo) {
       // Object overwrite case, old object exists, delete it.
       ACTION_TASK_ADD(S3PutObjectAction::delete_old_object, this);
       // If delete object is successful, attempt to delete old probable record
     }
+  } else if (store_data_inline) {
+    // Nothing was written to Motr, only the old object may be recorded
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Cleanup inline Object: s3_put_action_state[%d]\n",
+           s3_put_action_state);
+    if ((old_object_oid.u_hi || old_object_oid.u_lo) &&
+        (s3_put_action_state == S3PutObjectActionState::writeComplete ||
+         s3_put_action_state == S3PutObjectActionState::metadataSaveFailed)) {
+      // remove old oid from probable delete list.
+      ACTION_TASK_ADD(S3PutObjectAction::remove_old_oid_probable_record, this);
+    }
   } else if (s3_put_action_state == S3PutObjectActionState::newObjOidCreated ||
              s3_put_action_state == S3PutObjectActionState::writeFailed ||
              s3_put_action_state ==
@@ -923,6 +1085,10 @@ void S3PutObjectAction::delete_old_object() {
     next();
     return;
   }
+  if (!motr_writer) {
+    // Inline object was written
+    motr_writer = motr_writer_factory->create_motr_writer(request);
+  }
   motr_writer->delete_object(
       std::bind(&S3PutObjectAction::remove_old_object_version_metadata, this),
       std::bind(&S3PutObjectAction::next, this), old_object_oid, old_layout_id,
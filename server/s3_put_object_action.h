@@ -53,6 +53,14 @@ class S3PutObjectAction : public S3ObjectAction {
   size_t total_data_to_stream;
   S3Timer s3_timer;
   bool write_in_progress;
+  // Writes handed to motr_writer and not yet completed, at most
+  // motr_write_window (S3_MOTR_WRITE_WINDOW) of them.
+  size_t writes_in_flight;
+  size_t motr_write_window;
+  // Object data is saved in its metadata record instead of a Motr object,
+  // see S3_OBJECT_INLINE_DATA_MAX_SIZE
+  bool store_data_inline;
+  std::string inline_data_md5;
 
   std::shared_ptr<S3MotrWriterFactory> motr_writer_factory;
   std::shared_ptr<S3PutTagsBodyFactory> put_object_tag_body_factory;
@@ -103,9 +111,14 @@ class S3PutObjectAction : public S3ObjectAction {
   void add_object_oid_to_probable_dead_oid_list();
   void add_object_oid_to_probable_dead_oid_list_failed();
 
+  void read_inline_data();
+  void consume_inline_data();
+  void create_inline_object();
+
   void initiate_data_streaming();
   void consume_incoming_content();
   void write_object(std::shared_ptr<S3AsyncBufferOptContainer> buffer);
+  void fill_write_window();
 
   void write_object_successful();
   void write_object_failed();
@@ -184,7 +197,13 @@ class S3PutObjectAction : public S3ObjectAction {
               WriteObjectSuccessfulDoNextStepWhenAllIsWritten);
   FRIEND_TEST(S3PutObjectActionTest,
               WriteObjectSuccessfulShouldRestartReadingData);
+  FRIEND_TEST(S3PutObjectActionTest, ConsumeIncomingShouldFillWriteWindow);
+  FRIEND_TEST(S3PutObjectActionTest,
+              WriteObjectSuccessfulKeepsWindowFullWhileWritesInFlight);
   FRIEND_TEST(S3PutObjectActionTest, SaveMetadata);
+  FRIEND_TEST(S3PutObjectActionTest, CreateInlineObjectSavesDataInMetadata);
+  FRIEND_TEST(S3PutObjectActionTest, CreateInlineObjectWithBadDigest);
+  FRIEND_TEST(S3PutObjectActionTest, CleanupOfInlineObjectKeepsMotrAlone);
   FRIEND_TEST(S3PutObjectActionTest, SaveObjectMetadataFailed);
   FRIEND_TEST(S3PutObjectActionTest, SendResponseWhenShuttingDown);
   FRIEND_TEST(S3PutObjectActionTest, SendErrorResponse);
@@ -360,19 +360,26 @@ void S3PutObjectActionBase::add_object_oid_to_probable_dead_oid_list() {
     probable_oid_list[old_oid_rec_key] = old_probable_del_rec->to_json();
   }
 
-  s3_log(S3_LOG_DEBUG, request_id,
-         "Adding new_probable_del_rec with key [%s]\n", new_oid_str.c_str());
-  new_probable_del_rec.reset(new S3ProbableDeleteRecord(
-      new_oid_str, old_object_oid, new_object_metadata->get_object_name(),
-      new_object_oid, layout_id, new_object_metadata->get_pvid_str(),
-      bucket_metadata->get_object_list_index_layout().oid,
-      bucket_metadata->get_objects_version_list_index_layout().oid,
-      new_object_metadata->get_version_key_in_index(),
-      false /* force_delete */));
-
-  // store new oid, key = newoid
-  probable_oid_list[new_oid_str] = new_probable_del_rec->to_json();
+  if (!store_data_inline) {
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Adding new_probable_del_rec with key [%s]\n", new_oid_str.c_str());
+    new_probable_del_rec.reset(new S3ProbableDeleteRecord(
+        new_oid_str, old_object_oid, new_object_metadata->get_object_name(),
+        new_object_oid, layout_id, new_object_metadata->get_pvid_str(),
+        bucket_metadata->get_object_list_index_layout().oid,
+        bucket_metadata->get_objects_version_list_index_layout().oid,
+        new_object_metadata->get_version_key_in_index(),
+        false /* force_delete */));
 
+    // store new oid, key = newoid
+    probable_oid_list[new_oid_str] = new_probable_del_rec->to_json();
+  }
+  if (probable_oid_list.empty()) {
+    // New inline object, nothing can leak
+    next();
+    s3_log(S3_LOG_DEBUG, "", "Exiting\n");
+    return;
+  }
   if (!motr_kv_writer) {
     motr_kv_writer =
         mote_kv_writer_factory->create_motr_kvs_writer(request, s3_motr_api);
@@ -416,14 +423,28 @@ void S3PutObjectActionBase::startcleanup() {
       // backgrounddelete decisions.
       ACTION_TASK_ADD(S3PutObjectActionBase::mark_old_oid_for_deletion, this);
     }
-    // remove new oid from probable delete list.
-    ACTION_TASK_ADD(S3PutObjectActionBase::remove_new_oid_probable_record,
-                    this);
+    if (!store_data_inline) {
+      // remove new oid from probable delete list.
+      ACTION_TASK_ADD(S3PutObjectActionBase::remove_new_oid_probable_record,
+                      this);
+    }
     if (old_object_oid.u_hi || old_object_oid.u_lo) {
       // Object overwrite case, old object exists, delete it.
       ACTION_TASK_ADD(S3PutObjectActionBase::delete_old_object, this);
       // If delete object is successful, attempt to delete old probable record
     }
+  } else if (store_data_inline) {
+    // Nothing was written to Motr, only the old object may be recorded
+    s3_log(S3_LOG_DEBUG, request_id,
+           "Cleanup inline Object: s3_put_action_state[%d]\n",
+           s3_put_action_state);
+    if ((old_object_oid.u_hi || old_object_oid.u_lo) &&
+        (s3_put_action_state == S3PutObjectActionState::writeComplete ||
+         s3_put_action_state == S3PutObjectActionState::metadataSaveFailed)) {
+      // remove old oid from probable delete list.
+      ACTION_TASK_ADD(S3PutObjectActionBase::remove_old_oid_probable_record,
+                      this);
+    }
   } else if (s3_put_action_state == S3PutObjectActionState::newObjOidCreated ||
              s3_put_action_state == S3PutObjectActionState::writeFailed ||
              s3_put_action_state ==
@@ -539,6 +560,10 @@ void S3PutObjectActionBase::delete_old_object() {
   // If PUT is success, we delete old object if present
   assert(old_object_oid.u_hi != 0ULL || old_object_oid.u_lo != 0ULL);
 
+  if (!motr_writer) {
+    // Inline object was written
+    motr_writer = motr_writer_factory->create_motr_writer(request);
+  }
   motr_writer->delete_object(
       std::bind(&S3PutObjectActionBase::remove_old_object_version_metadata,
                 this),
@@ -125,4 +125,7 @@ class S3PutObjectActionBase : public S3ObjectAction {
 
   S3PutObjectActionState s3_put_action_state = S3PutObjectActionState::empty;
   bool write_in_progress = false;
+  // New object data is saved in its metadata record instead of a Motr
+  // object, see S3_OBJECT_INLINE_DATA_MAX_SIZE
+  bool store_data_inline = false;
 };
@@ -21,6 +21,7 @@
 #include <evhttp.h>
 #include <string>
 #include <algorithm>
+#include <utility>
 
 #include "s3_error_codes.h"
 #include "s3_factory.h"
@@ -127,9 +128,10 @@ const std::string& S3RequestObject::get_default_acl() { return default_acl; }
 
 void S3RequestObject::populate_and_log_audit_info() {
   s3_log(S3_LOG_DEBUG, request_id, "%s Entry", __func__);
-  if (S3Option::get_instance()->get_audit_logger_policy() == "disabled") {
-    s3_log(S3_LOG_DEBUG, request_id,
-           "Audit logger disabled by policy settings\n");
+  // Skip audit logs for health checks, and don't build a record no audit
+  // logger would take.
+  if (!S3AuditInfoLogger::is_enabled() || !audit_log_obj.get_publish_flag()) {
+    s3_log(S3_LOG_DEBUG, request_id, "Audit record is not logged\n");
     return;
   }
 
@@ -146,18 +148,25 @@ void S3RequestObject::populate_and_log_audit_info() {
     http_entry = "UNKNOWN";
   }
 
-  std::string audit_operation_str =
-      std::string("REST.") + http_entry + std::string(".") +
-      api_type_to_str(get_api_type()) + s3_operation_str;
+  std::string audit_operation_str("REST.");
+  audit_operation_str += http_entry;
+  audit_operation_str += '.';
+  audit_operation_str += api_type_to_str(get_api_type());
+  audit_operation_str += s3_operation_str;
 
-  std::string request_uri =
-      http_entry + std::string(" ") + full_path_decoded_uri;
+  std::string request_uri(http_entry);
+  request_uri.reserve(request_uri.size() + full_path_decoded_uri.size() +
+                      query_raw_decoded_uri.size() + http_version.size() + 3);
+  request_uri += ' ';
+  request_uri += full_path_decoded_uri;
 
   if (!query_raw_decoded_uri.empty()) {
-    request_uri = request_uri + std::string("?") + query_raw_decoded_uri;
+    request_uri += '?';
+    request_uri += query_raw_decoded_uri;
   }
 
-  request_uri = request_uri + std::string(" ") + http_version;
+  request_uri += ' ';
+  request_uri += http_version;
 
   audit_log_obj.set_turn_around_time(
       turn_around_time.elapsed_time_in_millisec());
@@ -173,9 +182,9 @@ void S3RequestObject::populate_and_log_audit_info() {
   audit_log_obj.set_bytes_received(get_content_length());
   audit_log_obj.set_requester(get_account_id());
   audit_log_obj.set_request_id(request_id);
-  audit_log_obj.set_operation(audit_operation_str);
+  audit_log_obj.set_operation(std::move(audit_operation_str));
   audit_log_obj.set_object_key(get_object_uri());
-  audit_log_obj.set_request_uri(request_uri);
+  audit_log_obj.set_request_uri(std::move(request_uri));
   audit_log_obj.set_http_status(http_status);
   audit_log_obj.set_signature_version(get_header_value("Authorization"));
   audit_log_obj.set_user_agent(get_header_value("User-Agent"));
@@ -186,12 +195,8 @@ void S3RequestObject::populate_and_log_audit_info() {
   }
   audit_log_obj.set_host_header(get_header_value("Host"));
 
-  // Skip audit logs for health checks.
-  if (audit_log_obj.get_publish_flag()) {
-    if (S3AuditInfoLogger::save_msg(request_id, audit_log_obj.to_string()) <
-        0) {
-      s3_log(S3_LOG_FATAL, request_id, "Audit Logger Error. STOP Server\n");
-    }
+  if (S3AuditInfoLogger::save_record(request_id, audit_log_obj) < 0) {
+    s3_log(S3_LOG_FATAL, request_id, "Audit Logger Error. STOP Server\n");
   }
   s3_log(S3_LOG_DEBUG, request_id, "%s Exit", __func__);
 }
@@ -19,7 +19,6 @@
  */
 
 #include "s3_service_list_response.h"
-#include "s3_common_utilities.h"
 #include "s3_log.h"
 
 S3ServiceListResponse::S3ServiceListResponse() {
@@ -40,29 +39,28 @@ void S3ServiceListResponse::add_bucket(
   bucket_list.push_back(bucket);
 }
 
-// clang-format off
 std::string& S3ServiceListResponse::get_xml() {
-  response_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-  response_xml +=
-      "<ListAllMyBucketsResult "
-      "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01\">";
-  response_xml += "<Owner>";
-  response_xml += S3CommonUtilities::format_xml_string("ID", owner_id);
-  response_xml +=
-      S3CommonUtilities::format_xml_string("DisplayName", owner_name);
-  response_xml += "</Owner>";
-  response_xml += "<Buckets>";
+  S3XmlWriter writer;
+  write_xml(writer);
+  response_xml = writer.to_string();
+  return response_xml;
+}
+
+void S3ServiceListResponse::write_xml(S3XmlWriter& writer) {
+  writer.declaration();
+  writer.start_element("ListAllMyBucketsResult",
+                       "http://s3.amazonaws.com/doc/2006-03-01");
+  writer.start_element("Owner");
+  writer.element("ID", owner_id);
+  writer.element("DisplayName", owner_name);
+  writer.end_element("Owner");
+  writer.start_element("Buckets");
   for (auto&& bucket : bucket_list) {
-    response_xml += "<Bucket>";
-    response_xml +=
-        S3CommonUtilities::format_xml_string("Name", bucket->get_bucket_name());
-    response_xml += S3CommonUtilities::format_xml_string(
-        "CreationDate", bucket->get_creation_time());
-    response_xml += "</Bucket>";
+    writer.start_element("Bucket");
+    writer.element("Name", bucket->get_bucket_name());
+    writer.element("CreationDate", bucket->get_creation_time());
+    writer.end_element("Bucket");
   }
-  response_xml += "</Buckets>";
-  response_xml += "</ListAllMyBucketsResult>";
-
-  return response_xml;
+  writer.end_element("Buckets");
+  writer.end_element("ListAllMyBucketsResult");
 }
-// clang-format on
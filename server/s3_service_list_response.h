@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "s3_bucket_metadata.h"
+#include "s3_xml_writer.h"
 
 class S3ServiceListResponse {
   std::string owner_name;
@@ -43,6 +44,7 @@ class S3ServiceListResponse {
   void set_owner_id(const std::string& id);
   void add_bucket(std::shared_ptr<S3BucketMetadata> bucket);
   std::string& get_xml();
+  void write_xml(S3XmlWriter& writer);
   int get_bucket_count() const { return bucket_list.size(); }
 };
 
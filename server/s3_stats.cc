@@ -21,6 +21,8 @@
 #include "s3_stats.h"
 #include <string.h>
 #include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -28,6 +30,11 @@
 S3Stats* g_stats_instance = NULL;
 S3Stats* S3Stats::stats_instance = NULL;
 
+const size_t S3Stats::timing_buckets;
+std::atomic<uint64_t> S3Stats::last_generation(0);
+thread_local uint64_t S3Stats::thread_generation;
+thread_local S3Stats::ThreadMetrics* S3Stats::p_thread_metrics;
+
 S3Stats* S3Stats::get_instance(SocketInterface* socket_obj) {
   if (!stats_instance) {
     stats_instance =
@@ -49,15 +56,62 @@ void S3Stats::delete_instance() {
   }
 }
 
+size_t S3Stats::get_timing_bucket(size_t time_ms) {
+  if (time_ms < 8) {
+    return time_ms;
+  }
+  if (time_ms >> 32) {
+    return timing_buckets - 1;
+  }
+  size_t exp = 63 - __builtin_clzll(time_ms);
+  return 8 + (exp - 3) * 4 + ((time_ms >> (exp - 2)) & 3);
+}
+
+size_t S3Stats::get_timing_bucket_value(size_t bucket) {
+  if (bucket < 8) {
+    return bucket;
+  }
+  size_t exp = 3 + (bucket - 8) / 4;
+  size_t sub = (bucket - 8) % 4;
+  return ((4 + sub) << (exp - 2)) + ((size_t)1 << (exp - 2)) / 2;
+}
+
 int S3Stats::count(const std::string& key, int64_t value, int retry,
                    float sample_rate) {
-  return form_and_send_msg(key, "c", std::to_string(value), retry, sample_rate);
+  size_t id;
+
+  if (!aggregate || !is_fequal(sample_rate, 1.0)) {
+    return form_and_send_msg(key, "c", std::to_string(value), retry,
+                             sample_rate);
+  }
+  if (find_metric(key, id)) {
+    get_thread_metrics()->counters[id].fetch_add(value,
+                                                 std::memory_order_relaxed);
+  }
+  return 0;
 }
 
 int S3Stats::timing(const std::string& key, size_t time_ms, int retry,
                     float sample_rate) {
-  return form_and_send_msg(key, "ms", std::to_string(time_ms), retry,
-                           sample_rate);
+  size_t id;
+
+  if (!aggregate || !is_fequal(sample_rate, 1.0)) {
+    return form_and_send_msg(key, "ms", std::to_string(time_ms), retry,
+                             sample_rate);
+  }
+  if (find_metric(key, id)) {
+    std::atomic<ThreadMetrics::Timing*>& slot =
+        get_thread_metrics()->timings[id];
+    ThreadMetrics::Timing* timing = slot.load(std::memory_order_relaxed);
+
+    if (!timing) {
+      timing = new ThreadMetrics::Timing();
+      slot.store(timing, std::memory_order_release);
+    }
+    timing->buckets[get_timing_bucket(time_ms)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  return 0;
 }
 
 int S3Stats::set_gauge(const std::string& key, int value, int retry) {
@@ -74,6 +128,15 @@ int S3Stats::set_gauge(const std::string& key, int value, int retry) {
 }
 
 int S3Stats::update_gauge(const std::string& key, int value, int retry) {
+  size_t id;
+
+  if (aggregate) {
+    if (find_metric(key, id)) {
+      get_thread_metrics()->gauges[id].fetch_add(value,
+                                                 std::memory_order_relaxed);
+    }
+    return 0;
+  }
   std::string value_str;
   if (value >= 0) {
     value_str = "+" + std::to_string(value);
@@ -139,6 +202,16 @@ int S3Stats::init() {
            g_option_instance->get_stats_allowlist_filename().c_str());
     return -1;
   }
+  for (const auto& key : metrics_allowlist) {
+    if (!is_keyname_valid(key)) {
+      s3_log(S3_LOG_ERROR, "", "Invalid metric name in allowlist: [%s]\n",
+             key.c_str());
+      continue;
+    }
+    metric_ids[key] = metric_keys.size();
+    metric_keys.push_back(key);
+  }
+  aggregate = g_option_instance->get_stats_flush_interval_msec() > 0;
   sock = socket_obj->socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
   if (sock == -1) {
     s3_log(S3_LOG_ERROR, "", "socket call failed: %s\n", strerror(errno));
@@ -170,6 +243,10 @@ int S3Stats::init() {
 
 void S3Stats::finish() {
   s3_log(S3_LOG_DEBUG, "", "%s Entry\n", __func__);
+  flush_event.reset();
+  if (aggregate && sock != -1) {
+    flush();
+  }
   if (sock != -1) {
     socket_obj->close(sock);
     sock = -1;
@@ -177,6 +254,118 @@ void S3Stats::finish() {
   s3_log(S3_LOG_DEBUG, "", "%s Exit", __func__);
 }
 
+int S3Stats::start_flush_timer(evbase_t* evbase) {
+  if (!aggregate) {
+    return 0;
+  }
+  uint32_t interval_msec = g_option_instance->get_stats_flush_interval_msec();
+  struct timeval tv;
+  tv.tv_sec = interval_msec / 1000;
+  tv.tv_usec = 1000 * (interval_msec % 1000);
+
+  flush_event.reset(new FlushEvent(this, evbase));
+  int rc = flush_event->add_evtimer(tv);
+  if (rc != 0) {
+    s3_log(S3_LOG_ERROR, "",
+           "Failed to start stats flush timer, sending metrics unaggregated\n");
+    flush_event.reset();
+    flush();
+    aggregate = false;
+  }
+  return rc;
+}
+
+S3Stats::ThreadMetrics* S3Stats::get_thread_metrics() {
+  if (thread_generation != generation) {
+    std::unique_ptr<ThreadMetrics> metrics(
+        new ThreadMetrics(metric_keys.size()));
+    std::lock_guard<std::mutex> lock(thread_metrics_mutex);
+
+    p_thread_metrics = metrics.get();
+    thread_generation = generation;
+    thread_metrics.push_back(std::move(metrics));
+  }
+  return p_thread_metrics;
+}
+
+void S3Stats::add_to_packet(std::string& packet, const std::string& line) {
+  if (!packet.empty() &&
+      packet.length() + 1 + line.length() >
+          g_option_instance->get_statsd_max_packet_size()) {
+    send(packet, g_option_instance->get_statsd_max_send_retry());
+    packet.clear();
+  }
+  if (!packet.empty()) {
+    packet += '\n';
+  }
+  packet += line;
+}
+
+void S3Stats::flush() {
+  std::lock_guard<std::mutex> lock(thread_metrics_mutex);
+  std::vector<uint64_t> hits(timing_buckets);
+  std::string packet;
+  const size_t max_packet_size =
+      g_option_instance->get_statsd_max_packet_size();
+
+  if (thread_metrics.empty()) {
+    return;
+  }
+  for (size_t id = 0; id < metric_keys.size(); ++id) {
+    const std::string& key = metric_keys[id];
+    int64_t counter = 0;
+    int64_t gauge = 0;
+
+    std::fill(hits.begin(), hits.end(), 0);
+    for (auto& metrics : thread_metrics) {
+      counter += metrics->counters[id].exchange(0, std::memory_order_relaxed);
+      gauge += metrics->gauges[id].exchange(0, std::memory_order_relaxed);
+
+      ThreadMetrics::Timing* timing =
+          metrics->timings[id].load(std::memory_order_acquire);
+      if (timing) {
+        for (size_t i = 0; i < timing_buckets; ++i) {
+          hits[i] += timing->buckets[i].exchange(0, std::memory_order_relaxed);
+        }
+      }
+    }
+    if (counter != 0) {
+      add_to_packet(packet, key + ":" + std::to_string(counter) + "|c");
+    }
+    if (gauge != 0) {
+      add_to_packet(packet, key + ":" + (gauge > 0 ? "+" : "") +
+                                std::to_string(gauge) + "|g");
+    }
+    // Each hit is a value of its own, so that percentiles and averages
+    // are weighted right. Lines are split to fit in a packet.
+    std::string line;
+    for (size_t i = 0; i < timing_buckets; ++i) {
+      if (hits[i] == 0) {
+        continue;
+      }
+      const std::string value =
+          ":" + std::to_string(get_timing_bucket_value(i));
+      for (uint64_t n = 0; n < hits[i]; ++n) {
+        if (!line.empty() &&
+            line.length() + value.length() + 3 > max_packet_size) {
+          add_to_packet(packet, line + "|ms");
+          line.clear();
+        }
+        if (line.empty()) {
+          line = key;
+        }
+        line += value;
+      }
+    }
+    if (!line.empty()) {
+      add_to_packet(packet, line + "|ms");
+    }
+  }
+  if (!packet.empty()) {
+    send(packet, g_option_instance->get_statsd_max_send_retry());
+  }
+}
+
 int S3Stats::send(const std::string& msg, int retry) {
   s3_log(S3_LOG_DEBUG, "", "msg: %s\n", msg.c_str());
   if (retry > g_option_instance->get_statsd_max_send_retry()) {
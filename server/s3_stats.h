@@ -25,19 +25,52 @@
 
 #include <gtest/gtest_prod.h>
 #include <math.h>
+#include <atomic>
 #include <limits>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+#include "event_utils.h"
 #include "s3_log.h"
 #include "s3_option.h"
 #include "socket_wrapper.h"
 
+// Metrics are aggregated in process when S3_STATS_FLUSH_INTERVAL_MSEC > 0.
+// Each thread updates its own counters, gauge deltas and timing histograms
+// with relaxed atomics, and a timer on the main event base sums them up and
+// sends the totals packed into few StatsD datagrams. Only allowlisted metrics
+// get slots, when the allowlist is loaded, so other keys cost a failed lookup.
+//
+// Timings are kept in buckets, the mid value of a bucket is within 12.5% of
+// the values in it. A bucket hit n times is sent as n values of its mid
+// value, packed as key:v1:v2:...|ms lines.
+//
+// Sets, initial gauge values and sampled metrics are sent when they come.
 class S3Stats {
  public:
+  // 8 exact values, then 4 buckets per power of 2 up to 2^31 ms
+  static const size_t timing_buckets = 124;
+
   static S3Stats* get_instance(SocketInterface* socket_obj = NULL);
   static void delete_instance();
 
+  static size_t get_timing_bucket(size_t time_ms);
+  // Mid value of the bucket
+  static size_t get_timing_bucket_value(size_t bucket);
+
+  bool is_aggregating() const { return aggregate; }
+
+  // Sends metrics aggregated since last flush
+  void flush();
+
+  // Flushes every S3_STATS_FLUSH_INTERVAL_MSEC on evbase. If the timer can't
+  // be started, metrics are sent when they come.
+  int start_flush_timer(evbase_t* evbase);
+
   // Increase/decrease count for `key` by `value`
   int count(const std::string& key, int64_t value, int retry = 1,
             float sample_rate = 1.0);
@@ -59,7 +92,10 @@ class S3Stats {
  private:
   S3Stats(const std::string& host_addr, const unsigned short port_num,
           SocketInterface* socket_obj_ptr = NULL)
-      : host(host_addr), port(port_num), sock(-1) {
+      : host(host_addr),
+        port(port_num),
+        sock(-1),
+        generation(++last_generation) {
     s3_log(S3_LOG_DEBUG, "", "%s Ctor\n", __func__);
     metrics_allowlist.clear();
     if (socket_obj_ptr) {
@@ -80,6 +116,56 @@ class S3Stats {
     return metrics_allowlist.find(key) != metrics_allowlist.end();
   }
 
+  // Slot of an allowlisted metric
+  bool find_metric(const std::string& key, size_t& id) const {
+    auto it = metric_ids.find(key);
+    if (it == metric_ids.end()) {
+      return false;
+    }
+    id = it->second;
+    return true;
+  }
+
+  // Updated by the owning thread only, flush() takes the values
+  struct ThreadMetrics {
+    struct Timing {
+      std::atomic<uint64_t> buckets[timing_buckets];
+    };
+
+    size_t n_metrics;
+    std::unique_ptr<std::atomic<int64_t>[]> counters;
+    std::unique_ptr<std::atomic<int64_t>[]> gauges;
+    // Made on first timing of the metric
+    std::unique_ptr<std::atomic<Timing*>[]> timings;
+
+    explicit ThreadMetrics(size_t n_metrics)
+        : n_metrics(n_metrics),
+          counters(new std::atomic<int64_t>[n_metrics]()),
+          gauges(new std::atomic<int64_t>[n_metrics]()),
+          timings(new std::atomic<Timing*>[n_metrics]()) {}
+
+    ~ThreadMetrics() {
+      for (size_t i = 0; i < n_metrics; ++i) {
+        delete timings[i].load();
+      }
+    }
+  };
+
+  // Metrics of the calling thread, made on first use
+  ThreadMetrics* get_thread_metrics();
+  // Appends a StatsD line to packet, sends the packet first if it is full
+  void add_to_packet(std::string& packet, const std::string& line);
+
+  class FlushEvent : public RecurringEventBase {
+    S3Stats* stats;
+
+   public:
+    FlushEvent(S3Stats* stats, evbase_t* evbase)
+        : RecurringEventBase(std::make_shared<EventWrapper>(), evbase),
+          stats(stats) {}
+    void action_callback(void) noexcept override { stats->flush(); }
+  };
+
   // Send message to server
   int send(const std::string& msg, int retry = 1);
 
@@ -111,10 +197,28 @@ class S3Stats {
   // metrics allowlist
   std::unordered_set<std::string> metrics_allowlist;
 
+  // Aggregation state, one slot per allowlisted metric
+  bool aggregate = false;
+  std::unordered_map<std::string, size_t> metric_ids;
+  std::vector<std::string> metric_keys;
+  std::mutex thread_metrics_mutex;
+  std::vector<std::unique_ptr<ThreadMetrics>> thread_metrics;
+  std::unique_ptr<FlushEvent> flush_event;
+
+  // Tells threads their metrics belong to a deleted instance
+  const uint64_t generation;
+  static std::atomic<uint64_t> last_generation;
+  static thread_local uint64_t thread_generation;
+  static thread_local ThreadMetrics* p_thread_metrics;
+
   FRIEND_TEST(S3StatsTest, Init);
   FRIEND_TEST(S3StatsTest, Allowlist);
   FRIEND_TEST(S3StatsTest, S3StatsSendMustSucceedIfSocketSendToSucceeds);
   FRIEND_TEST(S3StatsTest, S3StatsSendMustRetryAndFailIfRetriesFail);
+  FRIEND_TEST(S3StatsTest, AggregatesOnlyAllowlistedMetrics);
+  FRIEND_TEST(S3StatsTest, FlushPacksMetricsOfAllThreads);
+  FRIEND_TEST(S3StatsTest, FlushSplitsPacketsAtMaxSize);
+  friend class S3StatsTest;
 };
 
 extern S3Option* g_option_instance;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "s3_xml_writer.h"
+
+S3XmlWriter::S3XmlWriter() {
+  p_evbuf = evbuffer_new();
+  assert(p_evbuf != nullptr);
+}
+
+S3XmlWriter::~S3XmlWriter() { evbuffer_free(p_evbuf); }
+
+void S3XmlWriter::add(const char* str, size_t len) {
+  evbuffer_add(p_evbuf, str, len);
+}
+
+// Same set of characters as xmlEncodeSpecialChars() of libxml2
+void S3XmlWriter::add_escaped(const std::string& value) {
+  const char* run = value.data();
+  const char* const end = run + value.length();
+
+  for (const char* p = run; p != end; ++p) {
+    const char* entity;
+
+    switch (*p) {
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '&':
+        entity = "&amp;";
+        break;
+      case '"':
+        entity = "&quot;";
+        break;
+      case '\r':
+        entity = "&#13;";
+        break;
+      default:
+        continue;
+    }
+    if (p != run) {
+      add(run, p - run);
+    }
+    add(entity, strlen(entity));
+    run = p + 1;
+  }
+  if (run != end) {
+    add(run, end - run);
+  }
+}
+
+void S3XmlWriter::declaration() {
+  static const char decl[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+  add(decl, sizeof(decl) - 1);
+}
+
+void S3XmlWriter::start_element(const char* tag, const char* xmlns) {
+  add("<", 1);
+  add(tag, strlen(tag));
+  if (xmlns) {
+    add(" xmlns=\"", 8);
+    add(xmlns, strlen(xmlns));
+    add("\"", 1);
+  }
+  add(">", 1);
+}
+
+void S3XmlWriter::end_element(const char* tag) {
+  add("</", 2);
+  add(tag, strlen(tag));
+  add(">", 1);
+}
+
+void S3XmlWriter::element(const char* tag, const std::string& value,
+                          bool append_quotes) {
+  if (value.empty()) {
+    add("<", 1);
+    add(tag, strlen(tag));
+    add("/>", 2);
+    return;
+  }
+  start_element(tag);
+  if (append_quotes) {
+    add("\"", 1);
+  }
+  add_escaped(value);
+  if (append_quotes) {
+    add("\"", 1);
+  }
+  end_element(tag);
+}
+
+size_t S3XmlWriter::length() const { return evbuffer_get_length(p_evbuf); }
+
+std::string S3XmlWriter::to_string() const {
+  std::string content(length(), '\0');
+
+  if (!content.empty()) {
+    evbuffer_copyout(p_evbuf, &content[0], content.length());
+  }
+  return content;
+}
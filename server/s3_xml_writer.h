@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#pragma once
+
+#ifndef __S3_SERVER_S3_XML_WRITER_H__
+#define __S3_SERVER_S3_XML_WRITER_H__
+
+#include <string>
+
+#include "s3_common.h"
+
+EXTERN_C_BLOCK_BEGIN
+#include <event2/buffer.h>
+EXTERN_C_BLOCK_END
+
+// Serializes XML response straight into evbuffer, so that a large listing
+// isn't assembled in std::string with a temporary per element and then
+// copied into the reply. Chains of the evbuffer come from libevent memory
+// pool. The content is handed over to the reply with
+// RequestObject::send_response_buffer(), which moves the chains.
+//
+// Output of element() is the same as of S3CommonUtilities::format_xml_string().
+class S3XmlWriter {
+  struct evbuffer* p_evbuf;
+
+  void add(const char* str, size_t len);
+  void add_escaped(const std::string& value);
+
+ public:
+  S3XmlWriter();
+
+  S3XmlWriter(const S3XmlWriter&) = delete;
+  S3XmlWriter& operator=(const S3XmlWriter&) = delete;
+
+  ~S3XmlWriter();
+
+  // <?xml version="1.0" encoding="UTF-8"?>
+  void declaration();
+  // <tag> or <tag xmlns="...">
+  void start_element(const char* tag, const char* xmlns = nullptr);
+  void end_element(const char* tag);
+  // <tag>value</tag> with special characters of value escaped, <tag/> for
+  // empty value. Non-empty value can be enclosed in quotes (ETag).
+  void element(const char* tag, const std::string& value,
+               bool append_quotes = false);
+
+  size_t length() const;
+  struct evbuffer* get_buffer() { return p_evbuf; }
+  // Copies the content, for logging and tests
+  std::string to_string() const;
+};
+
+#endif  // __S3_SERVER_S3_XML_WRITER_H__
@@ -32,14 +32,18 @@
 #include "evhtp_wrapper.h"
 #include "fid/fid.h"
 #include "murmur3_hash.h"
+#include "s3_auth_cache.h"
+#include "s3_auth_conn_pool.h"
 #include "s3_bucket_metadata_cache.h"
 #include "s3_motr_layout.h"
 #include "s3_common_utilities.h"
 #include "s3_daemonize_server.h"
 #include "s3_error_codes.h"
 #include "s3_fi_common.h"
+#include "s3_hash_workers.h"
 #include "s3_log.h"
 #include "s3_mem_pool_manager.h"
+#include "s3_object_metadata_cache.h"
 #include "s3_option.h"
 #include "s3_perf_logger.h"
 #include "s3_request_object.h"
@@ -53,6 +57,7 @@
 #include "s3_motr_wrapper.h"
 #include "s3_m0_uint128_helper.h"
 #include "s3_perf_metrics.h"
+#include "s3_post_to_main_loop.h"
 #include "s3_iem.h"
 
 #define FOUR_KB 4096
@@ -69,6 +74,7 @@
 #define BUCKET_METADATA_LIST_INDEX_OID_U_LO 2
 #define OBJECT_PROBABLE_DEAD_OID_LIST_INDEX_OID_U_LO 3
 #define GLOBAL_INSTANCE_INDEX_U_LO 4
+#define OBJECT_DATA_REF_INDEX_OID_U_LO 5
 
 extern "C" void mem_log_msg_func(int mempool_log_level, const char *msg) {
   if (mempool_log_level == MEMPOOL_LOG_INFO) {
@@ -98,6 +104,8 @@ struct s3_motr_idx_layout bucket_metadata_list_index_layout;
 struct s3_motr_idx_layout global_instance_list_index_layout;
 // objects listed in this index are probable delete candidates and not absolute.
 struct s3_motr_idx_layout global_probable_dead_object_list_index_layout;
+// index will have objects sharing data of copied objects
+struct s3_motr_idx_layout global_object_data_ref_index_layout;
 
 int global_shutdown_in_progress;
 pthread_t global_tid_indexop;
@@ -110,6 +118,19 @@ std::set<struct s3_motr_idx_op_context *> global_motr_idx_ops_list;
 std::set<struct s3_motr_idx_context *> global_motr_idx;
 std::set<struct s3_motr_obj_context *> global_motr_obj;
 
+// Additional reactors, used when S3_REACTOR_THREADS > 1. Reactor 0 is
+// global_evbase_handle which runs on the main thread. Every reactor has its
+// own event base, router and listeners bound with SO_REUSEPORT, so kernel
+// spreads incoming connections across the reactors.
+struct s3_reactor {
+  evbase_t *evbase;
+  Router *s3_router;
+  evhtp_t *htp_ipv4;
+  evhtp_t *htp_ipv6;
+  pthread_t tid;
+};
+std::vector<struct s3_reactor *> global_reactors;
+
 void s3_motr_init_timeout_cb(evutil_socket_t fd, short event, void *arg) {
   // s3_iem(LOG_ALERT, S3_IEM_MOTR_CONN_FAIL, S3_IEM_MOTR_CONN_FAIL_STR,
   //     S3_IEM_MOTR_CONN_FAIL_JSON);
@@ -124,6 +145,58 @@ void *base_loop_thread(void *arg) {
   return NULL;
 }
 
+// Entries of absent buckets are not shared between reactors, a bucket
+// created through one reactor would look missing to the others until their
+// entries expire. With several reactors such entries are not cached.
+static unsigned bucket_metadata_cache_missing_sec() {
+  if (g_option_instance->get_reactor_threads() > 1) {
+    return 0;
+  }
+  return g_option_instance->get_bucket_metadata_cache_missing_sec();
+}
+
+// Object metadata cache is per reactor, and an object changed through one
+// reactor is invalidated only in that reactor's cache. Others would keep
+// serving the old metadata until their entries expire, so with several
+// reactors the cache is disabled.
+static unsigned object_metadata_cache_size() {
+  if (g_option_instance->get_reactor_threads() > 1) {
+    return 0;
+  }
+  return g_option_instance->get_object_metadata_cache_size();
+}
+
+void *reactor_loop_thread(void *arg) {
+  struct s3_reactor *reactor = (struct s3_reactor *)arg;
+  // Timers, auth requests and Motr completions started on this thread
+  // will be served by this reactor.
+  g_option_instance->set_reactor_eventbase(reactor->evbase);
+  std::unique_ptr<S3BucketMetadataCache> sptr_bucket_metadata_cache(
+      new S3BucketMetadataCache(
+          g_option_instance->get_bucket_metadata_cache_max_size(),
+          g_option_instance->get_bucket_metadata_cache_expire_sec(),
+          g_option_instance->get_bucket_metadata_cache_refresh_sec(),
+          bucket_metadata_cache_missing_sec()));
+  std::unique_ptr<S3AuthConnPool> sptr_auth_conn_pool(new S3AuthConnPool(
+      reactor->evbase, g_option_instance->get_auth_conn_pool_size(),
+      g_option_instance->get_auth_conn_pool_idle_timeout_sec()));
+  std::unique_ptr<S3AuthCache> sptr_auth_cache(
+      new S3AuthCache(g_option_instance->get_auth_cache_size(),
+                      g_option_instance->get_auth_cache_ttl_sec()));
+  std::unique_ptr<S3ObjectMetadataCache> sptr_object_metadata_cache(
+      new S3ObjectMetadataCache(
+          object_metadata_cache_size(),
+          g_option_instance->get_object_metadata_cache_ttl_sec()));
+  int rc = event_base_loop(reactor->evbase, EVLOOP_NO_EXIT_ON_EMPTY);
+  if (rc != 0) {
+    s3_log(S3_LOG_ERROR, "",
+           "Reactor event base loop exited due to unhandled exception in "
+           "libevent's backend\n");
+  }
+  g_option_instance->set_reactor_eventbase(NULL);
+  return NULL;
+}
+
 extern "C" void s3_handler(evhtp_request_t *req, void *a) {
   // placeholder, required to complete the request processing.
   s3_log(S3_LOG_DEBUG, "", "Request Completed.\n");
@@ -668,13 +741,15 @@ void log_resource_limits() {
 
 evhtp_t *create_evhtp_handle(evbase_t *evbase_handle, Router *router,
                              void *arg) {
-  evhtp_t *htp = evhtp_new(global_evbase_handle, NULL);
+  evhtp_t *htp = evhtp_new(evbase_handle, NULL);
 #if defined SO_REUSEPORT
-  if (g_option_instance->is_s3_reuseport_enabled()) {
+  if (g_option_instance->is_s3_reuseport_enabled() ||
+      g_option_instance->get_reactor_threads() > 1) {
     htp->enable_reuseport = 1;
   }
 #else
-  if (g_option_instance->is_s3_reuseport_enabled()) {
+  if (g_option_instance->is_s3_reuseport_enabled() ||
+      g_option_instance->get_reactor_threads() > 1) {
     s3_log(
         S3_LOG_ERROR, "",
         "Option --reuseport is true however OS Doesn't support SO_REUSEPORT\n");
@@ -697,7 +772,7 @@ evhtp_t *create_evhtp_handle(evbase_t *evbase_handle, Router *router,
 
 evhtp_t *create_evhtp_handle_for_motr(evbase_t *evbase_handle,
                                       Router *motr_router, void *arg) {
-  evhtp_t *htp = evhtp_new(global_evbase_handle, NULL);
+  evhtp_t *htp = evhtp_new(evbase_handle, NULL);
 #if defined SO_REUSEPORT
   if (g_option_instance->is_motr_http_reuseport_enabled()) {
     htp->enable_reuseport = 1;
@@ -732,6 +807,136 @@ void free_evhtp_handle(evhtp_t *htp) {
   }
 }
 
+// Creates event base, router and S3 listeners for reactors 1..N-1.
+// Listeners are bound later by start_reactors(), after Motr is ready.
+bool create_reactors() {
+  unsigned reactor_threads = g_option_instance->get_reactor_threads();
+  for (unsigned i = 1; i < reactor_threads; ++i) {
+    struct s3_reactor *reactor = new s3_reactor();
+    global_reactors.push_back(reactor);
+
+    reactor->evbase = event_base_new();
+    if (reactor->evbase == NULL ||
+        evthread_make_base_notifiable(reactor->evbase) < 0) {
+      s3_log(S3_LOG_ERROR, "", "Couldn't create event base for reactor %u\n",
+             i);
+      return false;
+    }
+    reactor->s3_router =
+        new S3Router(new S3APIHandlerFactory(), new S3UriFactory());
+    if (!g_option_instance->get_ipv4_bind_addr().empty()) {
+      reactor->htp_ipv4 =
+          create_evhtp_handle(reactor->evbase, reactor->s3_router, NULL);
+      if (reactor->htp_ipv4 == NULL) {
+        return false;
+      }
+    }
+    if (!g_option_instance->get_ipv6_bind_addr().empty()) {
+      reactor->htp_ipv6 =
+          create_evhtp_handle(reactor->evbase, reactor->s3_router, NULL);
+      if (reactor->htp_ipv6 == NULL) {
+        return false;
+      }
+    }
+    if (g_option_instance->is_s3server_ssl_enabled()) {
+      if ((reactor->htp_ipv4 && !init_ssl(reactor->htp_ipv4)) ||
+          (reactor->htp_ipv6 && !init_ssl(reactor->htp_ipv6))) {
+        s3_log(S3_LOG_ERROR, "", "SSL initialization failed for reactor %u\n",
+               i);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Binds listeners of reactors 1..N-1 and starts their event loops.
+bool start_reactors(const std::string &ipv4_bind_addr,
+                    const std::string &ipv6_bind_addr, uint16_t bind_port) {
+  for (auto reactor : global_reactors) {
+    if (reactor->htp_ipv4 &&
+        evhtp_bind_socket(reactor->htp_ipv4, ipv4_bind_addr.c_str(),
+                          bind_port, 1024) < 0) {
+      s3_log(S3_LOG_ERROR, "", "Reactor could not bind socket: %s\n",
+             strerror(errno));
+      return false;
+    }
+    if (reactor->htp_ipv6 &&
+        evhtp_bind_socket(reactor->htp_ipv6, ipv6_bind_addr.c_str(),
+                          bind_port, 1024) < 0) {
+      s3_log(S3_LOG_ERROR, "", "Reactor could not bind socket: %s\n",
+             strerror(errno));
+      return false;
+    }
+    if (pthread_create(&reactor->tid, NULL, &reactor_loop_thread, reactor) !=
+        0) {
+      s3_log(S3_LOG_ERROR, "", "Failed to create reactor thread\n");
+      reactor->tid = 0;
+      return false;
+    }
+  }
+  s3_log(S3_LOG_INFO, "", "Started %zu additional S3 reactor(s)\n",
+         global_reactors.size());
+  return true;
+}
+
+extern "C" void unbind_reactor_listeners(evutil_socket_t, short,
+                                         void *user_data) {
+  struct user_event_context *user_context =
+      (struct user_event_context *)user_data;
+  struct s3_reactor *reactor = (struct s3_reactor *)user_context->app_ctx;
+
+  // Unbound sockets leave the SO_REUSEPORT group, so kernel hands new
+  // connections to the listeners still bound.
+  if (reactor->htp_ipv4) {
+    evhtp_unbind_socket(reactor->htp_ipv4);
+  }
+  if (reactor->htp_ipv6) {
+    evhtp_unbind_socket(reactor->htp_ipv6);
+  }
+  event_free((struct event *)user_context->user_event);
+  free(user_data);
+}
+
+// Graceful shutdown hook: reactors 1..N-1 stop accepting connections, the
+// ones already accepted are served until the reactors are stopped.
+void stop_reactors_accepting() {
+  for (auto reactor : global_reactors) {
+    if (reactor->tid) {
+      struct user_event_context *user_ctx =
+          (struct user_event_context *)calloc(
+              1, sizeof(struct user_event_context));
+      user_ctx->app_ctx = reactor;
+      S3PostToMainLoop((void *)user_ctx,
+                       reactor->evbase)(unbind_reactor_listeners);
+    }
+  }
+}
+
+// Stops loops of reactors 1..N-1, waits for them and frees their resources.
+void stop_reactors() {
+  s3_graceful_shutdown_hook = nullptr;
+  for (auto reactor : global_reactors) {
+    if (reactor->tid) {
+      event_base_loopexit(reactor->evbase, NULL);
+      pthread_join(reactor->tid, NULL);
+    }
+  }
+  // Nothing submits hash jobs anymore, but workers may still post to
+  // reactors' event bases
+  S3HashWorkers::destroy_instance();
+  for (auto reactor : global_reactors) {
+    free_evhtp_handle(reactor->htp_ipv4);
+    free_evhtp_handle(reactor->htp_ipv6);
+    delete reactor->s3_router;
+    if (reactor->evbase) {
+      event_base_free(reactor->evbase);
+    }
+    delete reactor;
+  }
+  global_reactors.clear();
+}
+
 int main(int argc, char **argv) {
   int rc = 0;
   pthread_t tid;
@@ -781,6 +986,8 @@ int main(int argc, char **argv) {
   }
   s3daemon.change_work_dir();
   s3daemon.write_to_pidfile();
+  // Log thread would not survive daemonizing
+  init_async_log();
 #if 0
   s3daemon.register_signals();
 #endif
@@ -809,6 +1016,12 @@ int main(int argc, char **argv) {
   if (g_option_instance->get_libevent_mempool_zeroed_buffer()) {
     libevent_mempool_flags = libevent_mempool_flags | ZEROED_BUFFER;
   }
+  // Pools are shared by all reactors, per-thread magazines keep most
+  // buffer get/release calls off the pool lock
+  if (g_option_instance->get_reactor_threads() > 1) {
+    libevent_mempool_flags =
+        libevent_mempool_flags | ENABLE_LOCKING | ENABLE_THREAD_CACHE;
+  }
 
   // Call this function at starting as we need to make use of our own
   // memory allocation/deallocation functions
@@ -914,6 +1127,14 @@ int main(int argc, char **argv) {
     }
   }
 
+  if (!create_reactors()) {
+    s3daemon.delete_pidfile();
+    stop_reactors();
+    fini_log();
+    finalize_cli_options();
+    return 1;
+  }
+
   if (g_option_instance->is_s3server_ssl_enabled()) {
     if (htp_ipv4 != NULL) {
       if (!init_ssl(htp_ipv4)) {
@@ -937,6 +1158,10 @@ int main(int argc, char **argv) {
   if (g_option_instance->get_motr_read_mempool_zeroed_buffer()) {
     motr_read_mempool_flags = motr_read_mempool_flags | ZEROED_BUFFER;
   }
+  if (g_option_instance->get_reactor_threads() > 1) {
+    motr_read_mempool_flags =
+        motr_read_mempool_flags | ENABLE_LOCKING | ENABLE_THREAD_CACHE;
+  }
 
   // Create memory pool for motr read operations.
   rc = S3MempoolManager::create_pool(
@@ -944,7 +1169,8 @@ int main(int argc, char **argv) {
       g_option_instance->get_motr_unit_sizes_for_mem_pool(),
       g_option_instance->get_motr_read_pool_initial_buffer_count(),
       g_option_instance->get_motr_read_pool_expandable_count(),
-      motr_read_mempool_flags);
+      motr_read_mempool_flags,
+      g_option_instance->is_motr_read_pool_numa_aware());
 
   if (rc != 0) {
     s3daemon.delete_pidfile();
@@ -1093,6 +1319,27 @@ int main(int argc, char **argv) {
          global_instance_list_index_layout.pver.f_key,
          global_instance_list_index_layout.layout_type);
 
+  // global_object_data_ref_index_layout - will have objects which share
+  // data of one motr object, see S3ObjectDataRefs
+  rc = create_global_index(global_object_data_ref_index_layout,
+                           OBJECT_DATA_REF_INDEX_OID_U_LO);
+  if (rc < 0) {
+    s3daemon.delete_pidfile();
+    fini_auth_ssl();
+    fini_motr();
+    finalize_cli_options();
+    s3_log(S3_LOG_FATAL, "",
+           "Failed to create global object data ref index\n");
+  }
+  s3_log(S3_LOG_DEBUG, nullptr,
+         "Global object data ref index OID: %08zx-%08zx, PVer: %08zx-%08zx, "
+         "layout_type: 0x%x",
+         global_object_data_ref_index_layout.oid.u_hi,
+         global_object_data_ref_index_layout.oid.u_lo,
+         global_object_data_ref_index_layout.pver.f_container,
+         global_object_data_ref_index_layout.pver.f_key,
+         global_object_data_ref_index_layout.layout_type);
+
   extern struct m0_config motr_conf;
 
   std::string s3server_fid = motr_conf.mc_process_fid;
@@ -1207,6 +1454,10 @@ int main(int argc, char **argv) {
     s3_log(S3_LOG_FATAL, "", "Could not init perf metrics: %s\n",
            strerror(-rc));
   }
+  if (g_stats_instance) {
+    // Falls back to sending each metric on failure
+    g_stats_instance->start_flush_timer(global_evbase_handle);
+  }
 
   signal_sigint_event = evsignal_new(global_evbase_handle, SIGINT, s3_signal_cb,
                                      (void *)global_evbase_handle);
@@ -1234,7 +1485,31 @@ int main(int argc, char **argv) {
       new S3BucketMetadataCache(
           g_option_instance->get_bucket_metadata_cache_max_size(),
           g_option_instance->get_bucket_metadata_cache_expire_sec(),
-          g_option_instance->get_bucket_metadata_cache_refresh_sec()));
+          g_option_instance->get_bucket_metadata_cache_refresh_sec(),
+          bucket_metadata_cache_missing_sec()));
+  std::unique_ptr<S3AuthConnPool> sptr_auth_conn_pool(new S3AuthConnPool(
+      global_evbase_handle, g_option_instance->get_auth_conn_pool_size(),
+      g_option_instance->get_auth_conn_pool_idle_timeout_sec()));
+  std::unique_ptr<S3AuthCache> sptr_auth_cache(
+      new S3AuthCache(g_option_instance->get_auth_cache_size(),
+                      g_option_instance->get_auth_cache_ttl_sec()));
+  std::unique_ptr<S3ObjectMetadataCache> sptr_object_metadata_cache(
+      new S3ObjectMetadataCache(
+          object_metadata_cache_size(),
+          g_option_instance->get_object_metadata_cache_ttl_sec()));
+  S3HashWorkers::create_instance(
+      g_option_instance->get_hash_worker_threads(),
+      g_option_instance->get_hash_worker_batch_size(),
+      g_option_instance->get_hash_worker_queue_size());
+
+  if (!start_reactors(ipv4_bind_addr, ipv6_bind_addr, bind_port)) {
+    s3daemon.delete_pidfile();
+    fini_auth_ssl();
+    fini_motr();
+    finalize_cli_options();
+    s3_log(S3_LOG_FATAL, "", "Could not start S3 reactors\n");
+  }
+  s3_graceful_shutdown_hook = stop_reactors_accepting;
 
   // new flag in Libevent 2.1
   // EVLOOP_NO_EXIT_ON_EMPTY tells event_base_loop()
@@ -1249,6 +1524,12 @@ int main(int argc, char **argv) {
            "backend\n");
   }
 
+  // Reactors leave their loops only after the grace period of main loop,
+  // so in-flight requests on them had the same time to finish.
+  stop_reactors();
+  // Idle Auth server connections may use g_ssl_auth_ctx
+  sptr_auth_conn_pool.reset();
+
   shutdown_motr_teardown_called = 1;
   global_motr_teardown();
   s3_perf_metrics_fini();
@@ -1276,6 +1557,8 @@ int main(int argc, char **argv) {
   S3MotrLayoutMap::destroy_instance();
   S3Option::destroy_instance();
   event_destroy_mempool();
+  // Motr threads are gone with fini_motr() and hash workers with
+  // stop_reactors(), nothing logs from other threads anymore
   fini_log();
   event_free(signal_sigint_event);
   event_free(signal_sigterm_event);
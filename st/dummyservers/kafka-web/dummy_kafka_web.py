@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# For any questions about this software or licensing,
+# please email opensource@seagate.com or cortx-questions@seagate.com.
+#
+
+
+# Dummy Kafka REST proxy for benchmarking the kafka-web audit logger.
+# Accepts produce requests ({"records": [...]}) on any path, answers like
+# the proxy does and prints requests, records and bytes received per second.
+
+import argparse
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+_lock = threading.Lock()
+_stats = {"requests": 0, "records": 0, "bytes": 0, "errors": 0}
+
+
+class KafkaWebHandler(BaseHTTPRequestHandler):
+    # Keep connections open, s3server reuses them
+    protocol_version = "HTTP/1.1"
+    delay_sec = 0.0
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        body = self.rfile.read(length)
+        try:
+            n_records = len(json.loads(body)["records"])
+        except (ValueError, KeyError, TypeError):
+            with _lock:
+                _stats["errors"] += 1
+            self.reply(422, {"error_code": 42201,
+                             "message": "Unrecognized request body"})
+            return
+        if self.delay_sec:
+            time.sleep(self.delay_sec)
+        with _lock:
+            _stats["requests"] += 1
+            _stats["records"] += n_records
+            _stats["bytes"] += length
+        self.reply(200, {"offsets": [{"partition": 0, "offset": 0}] *
+                         n_records})
+
+    def reply(self, status, response):
+        data = json.dumps(response).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/vnd.kafka.v2+json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, format, *args):
+        pass
+
+
+def report(interval):
+    last = dict(_stats)
+    while True:
+        time.sleep(interval)
+        with _lock:
+            now = dict(_stats)
+        print("requests/s: %.1f records/s: %.1f MB/s: %.2f errors: %d" % (
+            (now["requests"] - last["requests"]) / interval,
+            (now["records"] - last["records"]) / interval,
+            (now["bytes"] - last["bytes"]) / interval / (1 << 20),
+            now["errors"]), flush=True)
+        last = now
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Dummy Kafka REST proxy for audit log benchmarks")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8082)
+    parser.add_argument("--delay-ms", type=float, default=0,
+                        help="time taken by each request, to mimic a slow sink")
+    parser.add_argument("--interval", type=float, default=5,
+                        help="seconds between reports")
+    args = parser.parse_args()
+
+    KafkaWebHandler.delay_sec = args.delay_ms / 1000
+    server = ThreadingHTTPServer((args.host, args.port), KafkaWebHandler)
+    server.daemon_threads = True
+    threading.Thread(target=report, args=(args.interval,), daemon=True).start()
+    print("Listening on %s:%d" % (args.host, args.port), flush=True)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
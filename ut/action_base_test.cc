@@ -161,6 +161,43 @@ TEST_F(ActionTest, TasklistRun) {
   EXPECT_TRUE(call_count_two == 1);
 }
 
+TEST_F(ActionTest, TasksAreChargedToTheirLatencyPhase) {
+  const uint32_t object_metadata_bit =
+      1U << (unsigned)S3LatencyPhase::object_metadata;
+  const uint32_t data_io_bit = 1U << (unsigned)S3LatencyPhase::data_io;
+
+  ptr_Actionobject->set_defaults();
+  ACTION_TASK_ADD_OBJPTR(ptr_Actionobject, ActionTest::func_callback_one, this);
+  ACTION_TASK_ADD_OBJPTR(ptr_Actionobject, ActionTest::func_callback_two, this);
+  ASSERT_EQ(2U, ptr_Actionobject->task_latency_phase_list.size());
+  EXPECT_EQ(S3LatencyPhase::object_metadata,
+            ptr_Actionobject->task_latency_phase_list[0]);
+
+  ptr_Actionobject->start();
+  EXPECT_EQ(object_metadata_bit, ptr_Actionobject->latency_sample.phases_seen);
+
+  ptr_Actionobject->set_latency_phase(S3LatencyPhase::data_io);
+  ptr_Actionobject->next();
+  EXPECT_EQ(S3LatencyPhase::object_metadata, ptr_Actionobject->latency_phase);
+  EXPECT_EQ(object_metadata_bit | data_io_bit,
+            ptr_Actionobject->latency_sample.phases_seen);
+  EXPECT_FALSE(ptr_Actionobject->latency_recorded);
+
+  ptr_Actionobject->done();
+  EXPECT_TRUE(ptr_Actionobject->latency_recorded);
+
+  const S3LatencySample &sample = ptr_Actionobject->latency_sample;
+  uint64_t phases_usec = 0;
+  for (unsigned i = 0; i < S3_LATENCY_PHASES; ++i) {
+    phases_usec += sample.phase_usec[i];
+  }
+  EXPECT_LE(phases_usec, sample.total_usec);
+
+  // Nothing is charged once recorded
+  ptr_Actionobject->set_latency_phase(S3LatencyPhase::auth);
+  EXPECT_EQ(object_metadata_bit | data_io_bit, sample.phases_seen);
+}
+
 TEST_F(ActionTest, RollbacklistRun) {
   ptr_Actionobject->set_defaults();
   ptr_Actionobject->add_task_rollback(
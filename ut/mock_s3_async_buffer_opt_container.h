@@ -37,6 +37,7 @@ class MockS3AsyncBufferOptContainer : public S3AsyncBufferOptContainer {
   MOCK_CONST_METHOD0(is_freezed, bool());
   MOCK_CONST_METHOD0(get_content_length, size_t());
   MOCK_METHOD1(get_buffers, S3BufferSequence(size_t));
+  MOCK_METHOD1(get_more_buffers, S3BufferSequence(size_t));
 };
 
 #endif
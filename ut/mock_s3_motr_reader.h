@@ -43,6 +43,10 @@ class MockS3MotrReader : public S3MotrReader {
   MOCK_METHOD3(read_object_data,
                bool(size_t num_of_blocks, std::function<void(void)> on_success,
                     std::function<void(void)> on_failed));
+  MOCK_METHOD1(read_ahead_object_data, bool(size_t num_of_blocks));
+  MOCK_CONST_METHOD0(get_read_ahead_in_flight, size_t());
+  MOCK_METHOD1(discard_read_ahead,
+               void(std::function<void(void)> on_drained));
   MOCK_METHOD1(get_first_block, size_t(char** data));
   MOCK_METHOD1(get_next_block, size_t(char** data));
   MOCK_METHOD0(extract_blocks_read, S3BufferSequence());
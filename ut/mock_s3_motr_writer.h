@@ -47,6 +47,8 @@ class MockS3MotrWiter : public S3MotrWiter {
   MOCK_METHOD0(get_content_md5, std::string());
   MOCK_METHOD1(get_op_ret_code_for, int(int));
   MOCK_METHOD1(get_op_ret_code_for_delete_op, int(int));
+  MOCK_CONST_METHOD0(get_writes_in_flight, size_t());
+  MOCK_CONST_METHOD0(can_pipeline_write, bool());
   MOCK_METHOD4(create_object, void(std::function<void(void)> on_success,
                                    std::function<void(void)> on_failed,
                                    const struct m0_uint128&, int layout_id));
@@ -79,6 +79,7 @@ class MockS3ObjectMetadata : public S3ObjectMetadata {
   MOCK_METHOD2(save_metadata, void(std::function<void(void)> on_success,
                                    std::function<void(void)> on_failed));
   MOCK_METHOD1(from_json, int(std::string content));
+  MOCK_METHOD1(from_json_for_listing, int(const std::string& content));
 };
 
 #endif
@@ -158,3 +158,28 @@ TEST_F(S3AsyncBufferOptContainerTest,
 
   EXPECT_EQ(0, strncmp("Seagate", (const char *)ret[1].first, 7));
 }
+
+TEST_F(S3AsyncBufferOptContainerTest, GetMoreBuffersKeepsBatchesInUse) {
+  buffer->add_content(get_evbuf_t_with_data(nfourk_buffer), false, false, true);
+  buffer->add_content(get_evbuf_t_with_data(nfourk_buffer), false, false, true);
+  buffer->add_content(get_evbuf_t_with_data(nfourk_buffer), false, false, true);
+
+  auto first = buffer->get_buffers(nfourk_buffer.length());
+  auto second = buffer->get_more_buffers(2 * nfourk_buffer.length());
+  EXPECT_EQ(1, first.size());
+  EXPECT_EQ(2, second.size());
+  EXPECT_EQ(0, buffer->get_content_length());
+  EXPECT_EQ(3, buffer->processing_q.size());
+  EXPECT_EQ(3, buffer->count_bufs_shared_for_read);
+
+  // Completing the first write frees only its buffers
+  buffer->flush_oldest_used_buffers();
+  EXPECT_EQ(2, buffer->processing_q.size());
+  EXPECT_EQ(0, strncmp(nfourk_buffer.c_str(), (const char *)second[1].first,
+                       nfourk_buffer.length()));
+
+  buffer->flush_oldest_used_buffers();
+  EXPECT_TRUE(buffer->processing_q.empty());
+  EXPECT_TRUE(buffer->processing_batches.empty());
+  EXPECT_EQ(0, buffer->count_bufs_shared_for_read);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "s3_async_log.h"
+#include "s3_log.h"
+
+static std::vector<std::string> pop_messages(S3LogRing &ring) {
+  std::vector<std::string> messages;
+
+  ring.pop_all([&](const S3LogRecord &record) {
+    EXPECT_STREQ(__FILE__, record.file);
+    messages.push_back(std::string(record.get_msg(), record.msg_len));
+  });
+  return messages;
+}
+
+TEST(S3LogRingTest, KeepsRecordsInOrderAcrossTheEnd) {
+  S3LogRing ring(1024);
+  std::string msg(100, 'x');
+
+  for (int round = 0; round < 20; ++round) {
+    std::string first = std::to_string(round) + msg;
+    std::string second = msg + std::to_string(round);
+
+    ASSERT_TRUE(ring.push(S3_LOG_INFO, __FILE__, __LINE__, first.c_str(),
+                          first.length()));
+    ASSERT_TRUE(ring.push(S3_LOG_WARN, __FILE__, __LINE__, second.c_str(),
+                          second.length()));
+    EXPECT_EQ(std::vector<std::string>({first, second}), pop_messages(ring));
+  }
+  EXPECT_TRUE(pop_messages(ring).empty());
+}
+
+TEST(S3LogRingTest, RejectsRecordsWhenFull) {
+  S3LogRing ring(1024);
+  std::string msg(100, 'x');
+  size_t pushed = 0;
+
+  while (ring.push(S3_LOG_INFO, __FILE__, __LINE__, msg.c_str(),
+                   msg.length())) {
+    ++pushed;
+  }
+  EXPECT_LT(0U, pushed);
+  EXPECT_EQ(pushed, pop_messages(ring).size());
+  EXPECT_TRUE(ring.push(S3_LOG_INFO, __FILE__, __LINE__, msg.c_str(),
+                        msg.length()));
+}
+
+TEST(S3LogRingTest, CutsLongMessages) {
+  S3LogRing ring(1024);
+  std::string msg(2048, 'x');
+
+  ASSERT_TRUE(
+      ring.push(S3_LOG_INFO, __FILE__, __LINE__, msg.c_str(), msg.length()));
+
+  std::vector<std::string> messages = pop_messages(ring);
+  ASSERT_EQ(1U, messages.size());
+  EXPECT_EQ(msg.substr(0, ring.get_max_msg_len()), messages[0]);
+}
+
+TEST(S3LogRingTest, KeepsTimeAndThreadOfRecords) {
+  S3LogRing ring(1024);
+  std::string msg("msg");
+  const int32_t tid = (int32_t)syscall(SYS_gettid);
+  const time_t before = time(NULL);
+
+  ASSERT_TRUE(
+      ring.push(S3_LOG_INFO, __FILE__, __LINE__, msg.c_str(), msg.length()));
+  std::thread other([&]() {
+    EXPECT_TRUE(ring.push(S3_LOG_INFO, __FILE__, __LINE__, msg.c_str(),
+                          msg.length()));
+  });
+  other.join();
+  const time_t after = time(NULL);
+
+  std::vector<int32_t> tids;
+  ring.pop_all([&](const S3LogRecord &record) {
+    EXPECT_LE(before, record.time_sec);
+    EXPECT_GE(after, record.time_sec);
+    EXPECT_GT(1000000, record.time_usec);
+    tids.push_back(record.tid);
+  });
+  ASSERT_EQ(2U, tids.size());
+  EXPECT_EQ(tid, tids[0]);
+  EXPECT_NE(tid, tids[1]);
+}
+
+TEST(S3AsyncLogTest, QueuesAllButFatalRecords) {
+  S3AsyncLog async_log(4096);
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(async_log.write(S3_LOG_DEBUG, __FILE__, __LINE__, "debug\n"));
+  }
+  async_log.flush();
+  EXPECT_TRUE(async_log.write(S3_LOG_ERROR, __FILE__, __LINE__, "error\n"));
+  EXPECT_FALSE(async_log.write(S3_LOG_FATAL, __FILE__, __LINE__, "fatal\n"));
+  EXPECT_GT(1000U, async_log.get_dropped_count());
+}
+
+TEST(S3AsyncLogTest, NewInstanceGivesThreadsNewRings) {
+  {
+    S3AsyncLog first_log(4096);
+    EXPECT_TRUE(first_log.write(S3_LOG_INFO, __FILE__, __LINE__, "first\n"));
+  }
+  // The ring of this thread was freed with first_log
+  S3AsyncLog second_log(4096);
+  EXPECT_TRUE(second_log.write(S3_LOG_INFO, __FILE__, __LINE__, "second\n"));
+  second_log.flush();
+  EXPECT_EQ(0U, second_log.get_dropped_count());
+}
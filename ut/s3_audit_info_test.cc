@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include <time.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "s3_audit_info.h"
+
+static std::string format_time(time_t request_time) {
+  char buf[REQUEST_TIME_SIZE];
+  struct tm tm;
+
+  localtime_r(&request_time, &tm);
+  strftime(buf, sizeof(buf), "[%d/%b/%Y:%H:%M:%S %z]", &tm);
+  return buf;
+}
+
+class S3AuditInfoTest : public testing::Test {
+ protected:
+  S3AuditInfo audit_info;
+  time_t request_time = 1600000000;
+
+  void SetUp() override {
+    audit_info.set_bucket_owner_canonical_id("owner-id");
+    audit_info.set_bucket_name("bucket");
+    audit_info.set_time_of_request_arrival(request_time);
+    audit_info.set_remote_ip("10.0.0.1");
+    audit_info.set_requester("requester-id");
+    audit_info.set_request_id("1234-5678");
+    audit_info.set_operation("REST.PUT.OBJECT");
+    audit_info.set_object_key("dir/\"quoted\" \\ key\n\t");
+    audit_info.set_request_uri("PUT /bucket/dir/key?x=1 HTTP/1.1");
+    audit_info.set_http_status(404);
+    audit_info.set_error_code("NoSuchKey");
+    audit_info.set_bytes_sent(123);
+    audit_info.set_object_size(1ULL << 40);
+    audit_info.set_bytes_received(4096);
+    audit_info.set_total_time(15);
+    audit_info.set_turn_around_time(7);
+    audit_info.set_user_agent("agent\b\f\r");
+    audit_info.set_signature_version("AWS4-HMAC-SHA256 Credential=x");
+    audit_info.set_authentication_type("AuthHeader");
+    audit_info.set_host_header("s3.seagate.com");
+  }
+};
+
+TEST_F(S3AuditInfoTest, JsonIsWhatJsonCppWrites) {
+  Json::Value audit;
+
+  audit["bucket_owner"] = "owner-id";
+  audit["bucket"] = "bucket";
+  audit["time"] = format_time(request_time);
+  audit["remote_ip"] = "10.0.0.1";
+  audit["requester"] = "requester-id";
+  audit["request_id"] = "1234-5678";
+  audit["operation"] = "REST.PUT.OBJECT";
+  audit["key"] = "dir/\"quoted\" \\ key\n\t";
+  audit["request_uri"] = "PUT /bucket/dir/key?x=1 HTTP/1.1";
+  audit["http_status"] = 404;
+  audit["error_code"] = "NoSuchKey";
+  audit["bytes_sent"] = (Json::UInt64)123;
+  audit["object_size"] = (Json::UInt64)(1ULL << 40);
+  audit["bytes_received"] = (Json::UInt64)4096;
+  audit["total_time"] = (Json::UInt64)15;
+  audit["turn_around_time"] = (Json::UInt64)7;
+  audit["referrer"] = "-";
+  audit["user_agent"] = "agent\b\f\r";
+  audit["version_id"] = "-";
+  audit["host_id"] = "-";
+  audit["signature_version"] = "SigV4";
+  audit["cipher_suite"] = "-";
+  audit["authentication_type"] = "AuthHeader";
+  audit["host_header"] = "s3.seagate.com";
+
+  Json::FastWriter writer;
+  EXPECT_EQ(writer.write(audit), audit_info.to_string(AuditFormatType::JSON));
+}
+
+// Same as jsoncpp 1.6.5, later versions escape UTF-8 too
+TEST_F(S3AuditInfoTest, JsonEscapesControlCharacters) {
+  audit_info.set_object_key("a\x01\x1f\x7f\xc3\xa9");
+
+  EXPECT_NE(std::string::npos,
+            audit_info.to_string(AuditFormatType::JSON)
+                .find("\"key\":\"a\\u0001\\u001F\x7f\xc3\xa9\","));
+}
+
+TEST_F(S3AuditInfoTest, S3Format) {
+  audit_info.set_object_key("dir/key");
+  audit_info.set_user_agent("agent");
+
+  EXPECT_EQ("owner-id bucket " + format_time(request_time) +
+                " 10.0.0.1 requester-id 1234-5678 REST.PUT.OBJECT dir/key "
+                "\"PUT /bucket/dir/key?x=1 HTTP/1.1\" 404 NoSuchKey 123 "
+                "1099511627776 4096 15 7 \"-\" \"agent\" - - SigV4 - "
+                "AuthHeader s3.seagate.com",
+            audit_info.to_string(AuditFormatType::S3_FORMAT));
+}
+
+TEST(S3AuditInfoDefaultTest, UnsetFieldsAreDashes) {
+  S3AuditInfo audit_info;
+
+  EXPECT_EQ("- - - - - - - - \"-\" 200 - 0 0 0 0 0 \"-\" \"-\" - - - - - -",
+            audit_info.to_string(AuditFormatType::S3_FORMAT));
+}
+
+TEST_F(S3AuditInfoTest, FormatAppendsToBuffer) {
+  std::string out = "prefix:";
+
+  audit_info.format(AuditFormatType::JSON, out);
+  EXPECT_EQ("prefix:" + audit_info.to_string(AuditFormatType::JSON), out);
+  EXPECT_LE(out.size(), audit_info.get_formatted_size_hint() + 16);
+}
+
+TEST(S3AuditInfoDefaultTest, SignatureVersion) {
+  S3AuditInfo audit_info;
+  std::string out;
+
+  audit_info.set_signature_version("AWS access:signature");
+  audit_info.format(AuditFormatType::S3_FORMAT, out);
+  EXPECT_NE(std::string::npos, out.find(" SigV2 "));
+
+  out.clear();
+  audit_info.set_signature_version("AWS4-HMAC-SHA256 Credential=x");
+  audit_info.format(AuditFormatType::S3_FORMAT, out);
+  EXPECT_NE(std::string::npos, out.find(" SigV4 "));
+
+  // No Authorization header keeps what was set
+  out.clear();
+  audit_info.set_signature_version("");
+  audit_info.format(AuditFormatType::S3_FORMAT, out);
+  EXPECT_NE(std::string::npos, out.find(" SigV4 "));
+
+  out.clear();
+  audit_info.set_signature_version("Bearer token");
+  audit_info.format(AuditFormatType::S3_FORMAT, out);
+  EXPECT_NE(std::string::npos, out.find(" Unknown_Signature "));
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "s3_auth_cache.h"
+
+TEST(S3AuthCacheTest, InstanceIsSetForLifetime) {
+  EXPECT_EQ(nullptr, S3AuthCache::get_instance());
+  {
+    S3AuthCache auth_cache(4, 30);
+    EXPECT_EQ(&auth_cache, S3AuthCache::get_instance());
+  }
+  EXPECT_EQ(nullptr, S3AuthCache::get_instance());
+}
+
+TEST(S3AuthCacheTest, DisabledCacheKeepsNothing) {
+  S3AuthCache auth_cache(0, 30);
+  std::string response;
+
+  EXPECT_FALSE(auth_cache.is_enabled());
+  auth_cache.put("key", "bucket", "<xml/>");
+  EXPECT_EQ(0u, auth_cache.size());
+  EXPECT_FALSE(auth_cache.get("key", response));
+}
+
+TEST(S3AuthCacheTest, GetReturnsCachedResponse) {
+  S3AuthCache auth_cache(4, 30);
+  std::string response;
+
+  EXPECT_FALSE(auth_cache.get("key", response));
+  auth_cache.put("key", "bucket", "<xml/>");
+  EXPECT_TRUE(auth_cache.get("key", response));
+  EXPECT_EQ("<xml/>", response);
+
+  auth_cache.put("key", "bucket", "<xml>new</xml>");
+  EXPECT_EQ(1u, auth_cache.size());
+  EXPECT_TRUE(auth_cache.get("key", response));
+  EXPECT_EQ("<xml>new</xml>", response);
+}
+
+TEST(S3AuthCacheTest, ExpiredEntryIsDropped) {
+  S3AuthCache auth_cache(4, 0);
+  std::string response;
+
+  auth_cache.put("key", "bucket", "<xml/>");
+  EXPECT_FALSE(auth_cache.get("key", response));
+  EXPECT_EQ(0u, auth_cache.size());
+}
+
+TEST(S3AuthCacheTest, LeastRecentlyUsedIsEvicted) {
+  S3AuthCache auth_cache(2, 30);
+  std::string response;
+
+  auth_cache.put("key1", "bucket", "1");
+  auth_cache.put("key2", "bucket", "2");
+  EXPECT_TRUE(auth_cache.get("key1", response));
+  auth_cache.put("key3", "bucket", "3");
+
+  EXPECT_EQ(2u, auth_cache.size());
+  EXPECT_TRUE(auth_cache.get("key1", response));
+  EXPECT_FALSE(auth_cache.get("key2", response));
+  EXPECT_TRUE(auth_cache.get("key3", response));
+}
+
+TEST(S3AuthCacheTest, InvalidateBucketDropsItsEntries) {
+  S3AuthCache auth_cache(4, 30);
+  std::string response;
+
+  auth_cache.put("key1", "bucket1", "1");
+  auth_cache.put("key2", "bucket2", "2");
+  auth_cache.put("key3", "bucket1", "3");
+  auth_cache.put("key4", "", "4");
+
+  auth_cache.invalidate_bucket("bucket1");
+  EXPECT_EQ(2u, auth_cache.size());
+  EXPECT_FALSE(auth_cache.get("key1", response));
+  EXPECT_TRUE(auth_cache.get("key2", response));
+  EXPECT_FALSE(auth_cache.get("key3", response));
+  EXPECT_TRUE(auth_cache.get("key4", response));
+}
@@ -613,3 +613,65 @@ TEST_F(S3AuthClientTest, SetUpAuthRequestBodyForChunkedAuth2) {
 
   free(mybuff);
 }
+
+TEST_F(S3AuthClientTest, AuthCacheKeyNotForAuthentication) {
+  p_authclienttest->add_key_val_to_body("Method", "PUT");
+  p_authclienttest->add_key_val_to_body("Authorization", "AWS4-HMAC-SHA256");
+  EXPECT_TRUE(p_authclienttest->get_auth_cache_key().empty());
+
+  p_authclienttest->op_type = S3AuthClientOpType::combo_auth;
+  EXPECT_TRUE(p_authclienttest->get_auth_cache_key().empty());
+}
+
+TEST_F(S3AuthClientTest, AuthorizationCacheKeyIgnoresRequestId) {
+  p_authclienttest->op_type = S3AuthClientOpType::authorization;
+  p_authclienttest->add_key_val_to_body("S3Action", "GetObject");
+  p_authclienttest->add_key_val_to_body("RequestorUserId", "123");
+  p_authclienttest->add_key_val_to_body("Request_id", "123");
+  std::string key = p_authclienttest->get_auth_cache_key();
+  EXPECT_FALSE(key.empty());
+
+  p_authclienttest->add_key_val_to_body("Request_id", "456");
+  EXPECT_EQ(key, p_authclienttest->get_auth_cache_key());
+}
+
+TEST_F(S3AuthClientTest, AuthorizationCacheKeyDependsOnPrincipal) {
+  p_authclienttest->op_type = S3AuthClientOpType::authorization;
+  p_authclienttest->add_key_val_to_body("S3Action", "GetObject");
+  p_authclienttest->add_key_val_to_body("RequestorAccountId", "12345");
+  p_authclienttest->add_key_val_to_body("RequestorUserId", "123");
+  std::string key = p_authclienttest->get_auth_cache_key();
+
+  p_authclienttest->add_key_val_to_body("RequestorUserId", "456");
+  EXPECT_NE(key, p_authclienttest->get_auth_cache_key());
+}
+
+TEST_F(S3AuthClientTest, AuthorizationCacheKeyDependsOnPathWithPolicy) {
+  p_authclienttest->op_type = S3AuthClientOpType::authorization;
+  p_authclienttest->add_key_val_to_body("S3Action", "GetObject");
+  p_authclienttest->add_key_val_to_body("RequestorUserId", "123");
+  p_authclienttest->add_key_val_to_body("ClientAbsoluteUri", "/bucket/obj1");
+  std::string key = p_authclienttest->get_auth_cache_key();
+  EXPECT_FALSE(key.empty());
+
+  // Without policy only ACLs decide, the same for every object
+  p_authclienttest->add_key_val_to_body("ClientAbsoluteUri", "/bucket/obj2");
+  EXPECT_EQ(key, p_authclienttest->get_auth_cache_key());
+
+  p_authclienttest->set_acl_and_policy("", "{\"Statement\":[]}");
+  p_authclienttest->add_key_val_to_body("Policy", "{\"Statement\":[]}");
+  std::string key_with_policy = p_authclienttest->get_auth_cache_key();
+  EXPECT_NE(key, key_with_policy);
+
+  p_authclienttest->add_key_val_to_body("ClientAbsoluteUri", "/bucket/obj1");
+  EXPECT_NE(key_with_policy, p_authclienttest->get_auth_cache_key());
+}
+
+TEST_F(S3AuthClientTest, AuthorizationCacheKeyNotForRequestACL) {
+  p_authclienttest->op_type = S3AuthClientOpType::authorization;
+  p_authclienttest->add_key_val_to_body("S3Action", "PutObject");
+  EXPECT_FALSE(p_authclienttest->get_auth_cache_key().empty());
+
+  p_authclienttest->add_key_val_to_body("Request-ACL", "true");
+  EXPECT_TRUE(p_authclienttest->get_auth_cache_key().empty());
+}
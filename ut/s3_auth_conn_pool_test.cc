@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "s3_auth_conn_pool.h"
+
+class S3AuthConnPoolTest : public testing::Test {
+ protected:
+  void SetUp() override { p_evbase = event_base_new(); }
+
+  void TearDown() override {
+    conn_pool.reset();
+    event_base_free(p_evbase);
+  }
+
+  void create_pool(unsigned max_idle_conns) {
+    conn_pool.reset(new S3AuthConnPool(p_evbase, max_idle_conns, 30));
+  }
+
+  evbase_t *p_evbase;
+  std::unique_ptr<S3AuthConnPool> conn_pool;
+};
+
+TEST_F(S3AuthConnPoolTest, InstanceIsSetForLifetime) {
+  EXPECT_EQ(nullptr, S3AuthConnPool::get_instance());
+  create_pool(4);
+  EXPECT_EQ(conn_pool.get(), S3AuthConnPool::get_instance());
+  conn_pool.reset();
+  EXPECT_EQ(nullptr, S3AuthConnPool::get_instance());
+}
+
+TEST_F(S3AuthConnPoolTest, DisabledPoolOpensNewConnections) {
+  create_pool(0);
+  EXPECT_FALSE(conn_pool->is_enabled());
+
+  evhtp_connection_t *p_conn1 = conn_pool->get_connection();
+  evhtp_connection_t *p_conn2 = conn_pool->get_connection();
+  ASSERT_TRUE(p_conn1 != nullptr);
+  ASSERT_TRUE(p_conn2 != nullptr);
+  EXPECT_NE(p_conn1, p_conn2);
+  EXPECT_EQ(0u, conn_pool->get_idle_count());
+
+  evhtp_connection_free(p_conn1);
+  evhtp_connection_free(p_conn2);
+}
+
+TEST_F(S3AuthConnPoolTest, IdleConnectionIsReused) {
+  create_pool(4);
+  EXPECT_TRUE(conn_pool->is_enabled());
+
+  evhtp_connection_t *p_conn = conn_pool->get_connection();
+  ASSERT_TRUE(p_conn != nullptr);
+  conn_pool->put_connection(p_conn);
+  EXPECT_EQ(1u, conn_pool->get_idle_count());
+
+  EXPECT_EQ(p_conn, conn_pool->get_connection());
+  EXPECT_EQ(0u, conn_pool->get_idle_count());
+  conn_pool->put_connection(p_conn);
+}
+
+TEST_F(S3AuthConnPoolTest, PoolSizeIsBounded) {
+  create_pool(1);
+
+  evhtp_connection_t *p_conn1 = conn_pool->get_connection();
+  evhtp_connection_t *p_conn2 = conn_pool->get_connection();
+  ASSERT_NE(p_conn1, p_conn2);
+
+  conn_pool->put_connection(p_conn1);
+  // Least recently used p_conn1 gets closed
+  conn_pool->put_connection(p_conn2);
+  EXPECT_EQ(1u, conn_pool->get_idle_count());
+  EXPECT_EQ(p_conn2, conn_pool->get_connection());
+  conn_pool->put_connection(p_conn2);
+}
+
+TEST_F(S3AuthConnPoolTest, IdleConnectionClosedByServerIsForgotten) {
+  create_pool(4);
+
+  evhtp_connection_t *p_conn = conn_pool->get_connection();
+  conn_pool->put_connection(p_conn);
+  EXPECT_EQ(1u, conn_pool->get_idle_count());
+
+  S3AuthConnPool::on_conn_fini_cb(p_conn, conn_pool.get());
+  EXPECT_EQ(0u, conn_pool->get_idle_count());
+  evhtp_connection_free(p_conn);
+}
+
+TEST_F(S3AuthConnPoolTest, ResponseCompleteReturnsConnectionToPool) {
+  create_pool(4);
+
+  evhtp_connection_t *p_conn = conn_pool->get_connection();
+  evhtp_request_t *p_req =
+      evhtp_request_new(S3AuthConnPool::on_response_complete, p_evbase);
+  p_req->conn = p_conn;
+
+  S3AuthConnPool::on_response_complete(p_req, p_evbase);
+  EXPECT_EQ(1u, conn_pool->get_idle_count());
+}
+
+TEST_F(S3AuthConnPoolTest, ResponseWithConnectionCloseIsNotPooled) {
+  create_pool(4);
+
+  evhtp_connection_t *p_conn = conn_pool->get_connection();
+  evhtp_request_t *p_req =
+      evhtp_request_new(S3AuthConnPool::on_response_complete, p_evbase);
+  p_req->conn = p_conn;
+  evhtp_headers_add_header(p_req->headers_in,
+                           evhtp_header_new("Connection", "close", 0, 0));
+
+  S3AuthConnPool::on_response_complete(p_req, p_evbase);
+  EXPECT_EQ(0u, conn_pool->get_idle_count());
+  evhtp_connection_free(p_conn);
+}
@@ -139,6 +139,7 @@ class S3BucketMetadataCacheTest : public testing::Test {
 #define MAX_CACHE_SIZE 2
 #define EXPIRE_SEC 2
 #define REFRESH_SEC 1
+#define MISSING_SEC 1
 
 S3BucketMetadataCacheTest::S3BucketMetadataCacheTest() {
 
@@ -158,7 +159,7 @@ S3BucketMetadataCacheTest::S3BucketMetadataCacheTest() {
 
   ptr_bucket_metadata_cache.reset(
       new S3BucketMetadataCache(MAX_CACHE_SIZE, EXPIRE_SEC, REFRESH_SEC,
-                                ptr_motr_bucket_metadata_factory));
+                                MISSING_SEC, ptr_motr_bucket_metadata_factory));
 }
 
 void S3BucketMetadataCacheTest::TearDown() {
@@ -397,3 +398,191 @@ TEST_F(S3BucketMetadataCacheTest, CacheSize) {
   }
   EXPECT_EQ(get_cache_size(), MAX_CACHE_SIZE);
 }
+
+TEST_F(S3BucketMetadataCacheTest, MissingBucketIsCached) {
+  ASSERT_EQ(get_cache_size(), 0);
+  std::string bucket_name = "seagatebucket";
+
+  auto ptr_metadata_proxy_1 = create_proxy(bucket_name);
+  ptr_metadata_proxy_1->load(success_handler, failed_handler);
+
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::missing);
+
+  EXPECT_TRUE(f_fail);
+  f_fail = false;
+  ptr_metadata_proxy_1.reset();
+
+  // The cache MUST return "missing" without Motr request
+  auto ptr_metadata_proxy_2 = create_proxy(bucket_name);
+  ptr_metadata_proxy_2->load(success_handler, failed_handler);
+
+  EXPECT_FALSE(p_s3_bucket_metadata_v1_test);
+  EXPECT_EQ(S3BucketMetadataV1Mock::n_called, 1);
+  EXPECT_EQ(ptr_metadata_proxy_2->get_state(), S3BucketMetadataState::missing);
+  EXPECT_TRUE(f_fail);
+  f_fail = false;
+  ptr_metadata_proxy_2.reset();
+
+  std::cout << "Waining for " << MISSING_SEC << " seconds... " << std::flush;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(MISSING_SEC * 1000 + 10));
+  std::cout << "Done" << std::endl;
+
+  auto ptr_metadata_proxy_3 = create_proxy(bucket_name);
+  ptr_metadata_proxy_3->load(success_handler, failed_handler);
+
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  EXPECT_EQ(S3BucketMetadataV1Mock::n_called, 2);
+
+  // The bucket has been created meanwhile
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+
+  EXPECT_TRUE(f_success);
+  EXPECT_EQ(ptr_metadata_proxy_3->get_state(), S3BucketMetadataState::present);
+}
+
+TEST_F(S3BucketMetadataCacheTest, BackgroundRefresh) {
+  ASSERT_EQ(get_cache_size(), 0);
+  std::string bucket_name = "seagatebucket";
+
+  auto ptr_metadata_proxy_1 = create_proxy(bucket_name);
+  ptr_metadata_proxy_1->load(success_handler, failed_handler);
+
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+
+  EXPECT_TRUE(f_success);
+  f_success = false;
+  ptr_metadata_proxy_1.reset();
+
+  std::cout << "Waining for " << REFRESH_SEC << " seconds... " << std::flush;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(REFRESH_SEC * 1000 + 10));
+  std::cout << "Done" << std::endl;
+
+  // The request is served from the cache, reload goes in background
+  auto ptr_metadata_proxy_2 = create_proxy(bucket_name);
+  ptr_metadata_proxy_2->load(success_handler, failed_handler);
+
+  EXPECT_TRUE(f_success);
+  f_success = false;
+  EXPECT_EQ(ptr_metadata_proxy_2->get_state(), S3BucketMetadataState::present);
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  EXPECT_EQ(S3BucketMetadataV1Mock::n_called, 2);
+  EXPECT_EQ(get_current_op(bucket_name), CurrentOp::fetching);
+
+  // Refresh is already in progress
+  auto ptr_metadata_proxy_3 = create_proxy(bucket_name);
+  ptr_metadata_proxy_3->load(success_handler, failed_handler);
+
+  EXPECT_TRUE(f_success);
+  f_success = false;
+  EXPECT_EQ(S3BucketMetadataV1Mock::n_called, 2);
+
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+
+  EXPECT_FALSE(p_s3_bucket_metadata_v1_test);
+  EXPECT_FALSE(f_success);
+  EXPECT_EQ(get_current_op(bucket_name), CurrentOp::none);
+  EXPECT_EQ(get_cache_size(), 1);
+}
+
+TEST_F(S3BucketMetadataCacheTest, RemoveDuringBackgroundRefresh) {
+  ASSERT_EQ(get_cache_size(), 0);
+  std::string bucket_name = "seagatebucket";
+
+  auto ptr_metadata_proxy_1 = create_proxy(bucket_name);
+  ptr_metadata_proxy_1->load(success_handler, failed_handler);
+
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+  ptr_metadata_proxy_1.reset();
+
+  std::cout << "Waining for " << REFRESH_SEC << " seconds... " << std::flush;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(REFRESH_SEC * 1000 + 10));
+  std::cout << "Done" << std::endl;
+
+  auto ptr_metadata_proxy_2 = create_proxy(bucket_name);
+  ptr_metadata_proxy_2->load(success_handler, failed_handler);
+
+  auto* p_load_engine = p_s3_bucket_metadata_v1_test;
+  ASSERT_TRUE(p_load_engine);
+  f_success = false;
+
+  ptr_metadata_proxy_2->remove(success_handler, failed_handler);
+
+  ASSERT_NE(p_s3_bucket_metadata_v1_test, p_load_engine);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::missing);
+
+  EXPECT_TRUE(f_success);
+  // The entry is kept until Motr operation has finished
+  EXPECT_EQ(get_cache_size(), 1);
+
+  p_load_engine->done(S3BucketMetadataState::present);
+
+  EXPECT_EQ(get_cache_size(), 0);
+  EXPECT_EQ(ptr_metadata_proxy_2->get_state(), S3BucketMetadataState::missing);
+}
+
+TEST_F(S3BucketMetadataCacheTest, SaveCancelsPendingRemove) {
+  ASSERT_EQ(get_cache_size(), 0);
+  std::string bucket_name = "seagatebucket";
+
+  auto ptr_metadata_proxy_1 = create_proxy(bucket_name);
+  ptr_metadata_proxy_1->load(success_handler, failed_handler);
+
+  ASSERT_TRUE(p_s3_bucket_metadata_v1_test);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+  ptr_metadata_proxy_1.reset();
+
+  std::cout << "Waining for " << REFRESH_SEC << " seconds... " << std::flush;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(REFRESH_SEC * 1000 + 10));
+  std::cout << "Done" << std::endl;
+
+  // Bucket is deleted while being refreshed, removal of the entry is
+  // postponed until the refresh has finished
+  auto ptr_metadata_proxy_2 = create_proxy(bucket_name);
+  ptr_metadata_proxy_2->load(success_handler, failed_handler);
+
+  auto* p_load_engine = p_s3_bucket_metadata_v1_test;
+  ASSERT_TRUE(p_load_engine);
+
+  ptr_metadata_proxy_2->remove(success_handler, failed_handler);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::missing);
+  EXPECT_EQ(get_cache_size(), 1);
+
+  // ...and created again before that
+  auto ptr_metadata_proxy_3 = create_proxy(bucket_name);
+  ptr_metadata_proxy_3->save(success_handler, failed_handler);
+
+  auto* p_save_engine = p_s3_bucket_metadata_v1_test;
+  ASSERT_NE(p_save_engine, p_load_engine);
+
+  p_load_engine->done(S3BucketMetadataState::present);
+  p_save_engine->done(S3BucketMetadataState::present);
+  EXPECT_EQ(get_cache_size(), 1);
+
+  std::cout << "Waining for " << REFRESH_SEC << " seconds... " << std::flush;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(REFRESH_SEC * 1000 + 10));
+  std::cout << "Done" << std::endl;
+
+  // Update finishes during the next background refresh, the entry stays
+  auto ptr_metadata_proxy_4 = create_proxy(bucket_name);
+  ptr_metadata_proxy_4->load(success_handler, failed_handler);
+
+  p_load_engine = p_s3_bucket_metadata_v1_test;
+  ASSERT_TRUE(p_load_engine);
+
+  ptr_metadata_proxy_4->update(success_handler, failed_handler);
+  ASSERT_NE(p_s3_bucket_metadata_v1_test, p_load_engine);
+  p_s3_bucket_metadata_v1_test->done(S3BucketMetadataState::present);
+
+  p_load_engine->done(S3BucketMetadataState::present);
+
+  EXPECT_EQ(get_cache_size(), 1);
+  EXPECT_EQ(get_current_op(bucket_name), CurrentOp::none);
+}
@@ -31,6 +31,7 @@
 #include "s3_ut_common.h"
 #include "s3_test_utils.h"
 
+using ::testing::An;
 using ::testing::AtLeast;
 using ::testing::Eq;
 using ::testing::Invoke;
@@ -526,6 +527,102 @@ TEST_F(S3CopyObjectActionTest, ZeroSizeObject) {
   EXPECT_EQ(1, call_count_one);
 }
 
+TEST_F(S3CopyObjectActionTest, CanCopyByReference) {
+  create_src_object_metadata();
+  action_under_test->total_data_to_stream = 1024;
+  const int layout_for_size =
+      S3MotrLayoutMap::get_instance()->get_layout_for_object_size(1024);
+
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata,
+              get_layout_id())
+      .WillRepeatedly(Return(layout_for_size));
+  EXPECT_FALSE(action_under_test->can_copy_by_reference());
+
+  S3Option::get_instance()->set_copy_object_by_reference(true);
+  EXPECT_TRUE(action_under_test->can_copy_by_reference());
+
+  action_under_test->total_data_to_stream = 0;
+  EXPECT_FALSE(action_under_test->can_copy_by_reference());
+
+  action_under_test->total_data_to_stream = 1024;
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata,
+              get_layout_id())
+      .WillRepeatedly(Return(layout_for_size + 1));
+  EXPECT_FALSE(action_under_test->can_copy_by_reference());
+
+  S3Option::get_instance()->set_copy_object_by_reference(false);
+}
+
+TEST_F(S3CopyObjectActionTest, CopyObjectSkippedWhenCopyByReference) {
+  action_under_test->total_data_to_stream = 1024;
+  action_under_test->copy_by_reference = true;
+  action_under_test->clear_tasks();
+
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3CopyObjectActionTest::func_callback_one, this);
+  action_under_test->copy_object();
+
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_FALSE(action_under_test->object_data_copier);
+  EXPECT_EQ(S3PutObjectActionState::writeComplete,
+            action_under_test->s3_put_action_state);
+}
+
+TEST_F(S3CopyObjectActionTest, AddDataRefPutsRefs) {
+  create_src_object_metadata();
+  create_dst_object_metadata();
+
+  EXPECT_CALL(*ptr_mock_request, get_object_name())
+      .WillRepeatedly(ReturnRef(destination_object_name));
+
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata, get_oid())
+      .WillRepeatedly(Return(oid));
+  EXPECT_CALL(*ptr_mock_motr_kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const std::map<std::string, std::string> &>(),
+                         _, _))
+      .Times(1);
+
+  action_under_test->add_data_ref();
+
+  EXPECT_TRUE(action_under_test->motr_writer);
+  EXPECT_TRUE(action_under_test->new_object_metadata);
+  EXPECT_TRUE(action_under_test->data_refs);
+}
+
+TEST_F(S3CopyObjectActionTest, AddDataRefSuccessful) {
+  create_src_object_metadata();
+  create_dst_object_metadata();
+
+  action_under_test->new_object_metadata =
+      ptr_mock_object_meta_factory->mock_object_metadata;
+
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata, get_oid())
+      .WillRepeatedly(Return(oid));
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata,
+              get_layout_id())
+      .WillRepeatedly(Return(layout_id));
+  EXPECT_CALL(*ptr_mock_object_meta_factory->mock_object_metadata,
+              set_oid(_)).Times(1);
+  // Probable delete record of the destination
+  EXPECT_CALL(*ptr_mock_motr_kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const std::map<std::string, std::string> &>(),
+                         _, _))
+      .Times(1);
+
+  const std::string copy_oid_str =
+      S3M0Uint128Helper::to_string(action_under_test->new_object_oid);
+  action_under_test->add_data_ref_successful();
+
+  EXPECT_EQ(oid.u_hi, action_under_test->new_object_oid.u_hi);
+  EXPECT_EQ(oid.u_lo, action_under_test->new_object_oid.u_lo);
+  EXPECT_EQ(layout_id, action_under_test->layout_id);
+  // Not the key of the source's own probable delete record
+  EXPECT_EQ(S3M0Uint128Helper::to_string(oid) + '-' + copy_oid_str,
+            action_under_test->new_oid_str);
+  EXPECT_EQ(S3PutObjectActionState::newObjOidCreated,
+            action_under_test->s3_put_action_state);
+}
+
 TEST_F(S3CopyObjectActionTest, SaveMetadata) {
   action_under_test->total_data_to_stream = 1024;
 
@@ -153,6 +153,19 @@ class S3DeleteMultipleObjectsActionTest : public testing::Test {
   int call_count_one;
   int layout_id;
 
+  // Batch in flight, using mock KVS reader and writer
+  S3DeleteMultipleObjectsAction::DeleteBatch *add_batch(
+      std::vector<std::string> batch_keys = {}) {
+    std::unique_ptr<S3DeleteMultipleObjectsAction::DeleteBatch> batch(
+        new S3DeleteMultipleObjectsAction::DeleteBatch());
+    batch->keys = std::move(batch_keys);
+    batch->motr_kv_reader = motr_kvs_reader_factory->mock_motr_kvs_reader;
+    batch->motr_kv_writer = motr_kvs_writer_factory->mock_motr_kvs_writer;
+    action_under_test->batches.push_back(std::move(batch));
+    ++action_under_test->batches_in_flight;
+    return action_under_test->batches.back().get();
+  }
+
  public:
   void func_callback_one() { call_count_one += 1; }
 };
@@ -305,13 +318,66 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   action_under_test->validate_request_body(SAMPLE_DELETE_REQUEST);
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-              get_keyval(_, keys, _, _)).Times(AtLeast(1));
+              get_keyval(_, keys, _, _)).Times(1);
   action_under_test->fetch_objects_info();
   EXPECT_EQ(2, action_under_test->delete_index_in_req);
+  EXPECT_EQ(1, action_under_test->batches_in_flight);
+}
+
+TEST_F(S3DeleteMultipleObjectsActionTest, FetchObjectInfoLaunchesWindow) {
+  const int fetch_count = S3Option::get_instance()->get_motr_idx_fetch_count();
+  S3Option::get_instance()->set_motr_idx_fetch_count(1);
+  CREATE_BUCKET_METADATA;
+  bucket_meta_factory->mock_bucket_metadata->set_object_list_index_layout(
+      index_layout);
+  std::string request_body = SAMPLE_DELETE_REQUEST;
+  action_under_test->delete_request.initialize(mock_request, request_body);
+  action_under_test->delete_objects_window = 4;
+
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
+              get_keyval(_, std::vector<std::string>{keys[0]}, _, _))
+      .Times(1);
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
+              get_keyval(_, std::vector<std::string>{keys[1]}, _, _))
+      .Times(1);
+  action_under_test->fetch_objects_info();
+  S3Option::get_instance()->set_motr_idx_fetch_count(fetch_count);
+
+  EXPECT_EQ(2, action_under_test->delete_index_in_req);
+  EXPECT_EQ(2, action_under_test->batches_in_flight);
+}
+
+TEST_F(S3DeleteMultipleObjectsActionTest, BatchKeysFitInRpcMessage) {
+  const int fetch_count = S3Option::get_instance()->get_motr_idx_fetch_count();
+  S3Option::get_instance()->set_motr_idx_fetch_count(1000);
+  const std::string long_key(1000, 'k');
+  std::string request_body = "<Delete>";
+  for (int i = 0; i < 1000; ++i) {
+    request_body +=
+        "<Object><Key>" + long_key + std::to_string(i) + "</Key></Object>";
+  }
+  request_body += "</Delete>";
+  action_under_test->delete_request.initialize(mock_request, request_body);
+  ASSERT_EQ(1000, action_under_test->delete_request.get_count());
+
+  std::vector<std::string> batch_keys =
+      action_under_test->get_next_batch_keys();
+  S3Option::get_instance()->set_motr_idx_fetch_count(fetch_count);
+
+  size_t batch_size = 0;
+  for (const auto &key : batch_keys) {
+    batch_size += key.length();
+  }
+  ASSERT_FALSE(batch_keys.empty());
+  EXPECT_GT(1000, batch_keys.size());
+  EXPECT_GE(S3Option::get_instance()->get_motr_max_rpc_msg_size(),
+            batch_size);
+  EXPECT_EQ(long_key + "0", batch_keys.front());
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest, FetchObjectInfoFailed) {
   CREATE_BUCKET_METADATA;
+  auto batch = add_batch(keys);
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
       .Times(AtLeast(1))
@@ -320,21 +386,37 @@ TEST_F(S3DeleteMultipleObjectsActionTest, FetchObjectInfoFailed) {
   EXPECT_CALL(*mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
   EXPECT_CALL(*mock_request, send_response(S3HttpFailed500, _)).Times(1);
   EXPECT_CALL(*mock_request, resume(_)).Times(1);
-  action_under_test->fetch_objects_info_failed();
+  action_under_test->fetch_objects_info_failed(batch);
 
   EXPECT_STREQ("InternalError", action_under_test->get_s3_error_code().c_str());
 }
 
+TEST_F(S3DeleteMultipleObjectsActionTest, FailedBatchWaitsForBatchesInFlight) {
+  CREATE_BUCKET_METADATA;
+  auto batch1 = add_batch({keys[0]});
+  auto batch2 = add_batch({keys[1]});
+
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
+      .WillOnce(Return(S3MotrKVSReaderOpState::failed))
+      .WillOnce(Return(S3MotrKVSReaderOpState::missing));
+
+  // Single response once both batches are done
+  EXPECT_CALL(*mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*mock_request, send_response(S3HttpFailed500, _)).Times(1);
+  EXPECT_CALL(*mock_request, resume(_)).Times(1);
+  action_under_test->fetch_objects_info_failed(batch1);
+  EXPECT_EQ(1, action_under_test->batches_in_flight);
+  action_under_test->fetch_objects_info_failed(batch2);
+
+  EXPECT_EQ(0, action_under_test->batches_in_flight);
+  EXPECT_STREQ("InternalError", action_under_test->get_s3_error_code().c_str());
+}
+
 TEST_F(S3DeleteMultipleObjectsActionTest,
        FetchObjectInfoFailedWithMissingAndMoreToProcess) {
   std::vector<std::string> missing_key = {"SampleDocument2.txt"};
   CREATE_BUCKET_METADATA;
 
-  EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata),
-              get_object_list_index_layout())
-      .Times(1)
-      .WillOnce(ReturnRef(index_layout));
-
   EXPECT_CALL(*mock_request, get_header_value(_))
       .WillOnce(Return("vxQpICn70jvA6+9R0/d5iA=="));
   // Clear tasks so validate_request_body calls mocked next
@@ -343,15 +425,18 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
                          S3DeleteMultipleObjectsActionTest::func_callback_one,
                          this);
   action_under_test->validate_request_body(SAMPLE_DELETE_REQUEST);
-  action_under_test->keys_to_delete.push_back("SampleDocument1.txt");
+  auto batch = add_batch({"SampleDocument1.txt"});
   action_under_test->delete_index_in_req = 1;
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
       .Times(AtLeast(1))
       .WillOnce(Return(S3MotrKVSReaderOpState::missing));
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-              get_keyval(_, missing_key, _, _)).Times(AtLeast(1));
-  action_under_test->fetch_objects_info_failed();
+              get_keyval(_, missing_key, _, _)).Times(1);
+  action_under_test->fetch_objects_info_failed(batch);
+
+  EXPECT_EQ(1, action_under_test->delete_objects_response.get_success_count());
+  EXPECT_EQ(1, action_under_test->batches_in_flight);
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
@@ -368,8 +453,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
                          S3DeleteMultipleObjectsActionTest::func_callback_one,
                          this);
   action_under_test->validate_request_body(SAMPLE_DELETE_REQUEST);
-  action_under_test->keys_to_delete.push_back("SampleDocument1.txt");
-  action_under_test->keys_to_delete.push_back("SampleDocument1.txt");
+  auto batch = add_batch(keys);
   action_under_test->delete_index_in_req = 2;
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
@@ -379,7 +463,9 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   EXPECT_CALL(*mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
   EXPECT_CALL(*mock_request, send_response(S3HttpSuccess200, _)).Times(1);
   EXPECT_CALL(*mock_request, resume(_)).Times(1);
-  action_under_test->fetch_objects_info_failed();
+  action_under_test->fetch_objects_info_failed(batch);
+
+  EXPECT_EQ(2, action_under_test->delete_objects_response.get_success_count());
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
@@ -404,13 +490,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
       .Times(AtLeast(1))
       .WillRepeatedly(ReturnRef(index_layout));
 
-  // mock kv reader/writer
-  action_under_test->motr_kv_reader =
-      action_under_test->motr_kvs_reader_factory->create_motr_kvs_reader(
-          mock_request);
-  action_under_test->motr_kv_writer =
-      action_under_test->motr_kvs_writer_factory->create_motr_kvs_writer(
-          mock_request);
+  auto batch = add_batch();
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
               get_key_values()).WillRepeatedly(ReturnRef(result_keys_values));
@@ -438,9 +518,9 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   std::string sdrf = "<Delete><Object><Key>objname</Key></Object></Delete>";
   action_under_test->delete_request.initialize(mock_request, sdrf);
 
-  action_under_test->fetch_objects_info_successful();
+  action_under_test->fetch_objects_info_successful(batch);
 
-  EXPECT_EQ(1, action_under_test->objects_metadata.size());
+  EXPECT_EQ(1, batch->objects_metadata.size());
   EXPECT_EQ(2, action_under_test->delete_objects_response.get_success_count());
   EXPECT_EQ(0, action_under_test->delete_objects_response.get_failure_count());
 }
@@ -465,13 +545,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest, FetchObjectsInfoSuccessful) {
       .Times(AtLeast(1))
       .WillRepeatedly(ReturnRef(index_layout));
 
-  // mock kv reader/writer
-  action_under_test->motr_kv_reader =
-      action_under_test->motr_kvs_reader_factory->create_motr_kvs_reader(
-          mock_request);
-  action_under_test->motr_kv_writer =
-      action_under_test->motr_kvs_writer_factory->create_motr_kvs_writer(
-          mock_request);
+  auto batch = add_batch();
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
               get_key_values()).WillRepeatedly(ReturnRef(result_keys_values));
@@ -499,9 +573,9 @@ TEST_F(S3DeleteMultipleObjectsActionTest, FetchObjectsInfoSuccessful) {
   std::string sdrf = "<Delete><Object><Key>objname</Key></Object></Delete>";
   action_under_test->delete_request.initialize(mock_request, sdrf);
 
-  action_under_test->fetch_objects_info_successful();
+  action_under_test->fetch_objects_info_successful(batch);
 
-  EXPECT_EQ(3, action_under_test->objects_metadata.size());
+  EXPECT_EQ(3, batch->objects_metadata.size());
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
@@ -521,13 +595,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   bucket_meta_factory->mock_bucket_metadata
       ->set_objects_version_list_index_layout(index_layout);
 
-  // mock kv reader/writer
-  action_under_test->motr_kv_reader =
-      action_under_test->motr_kvs_reader_factory->create_motr_kvs_reader(
-          mock_request);
-  action_under_test->motr_kv_writer =
-      action_under_test->motr_kvs_writer_factory->create_motr_kvs_writer(
-          mock_request);
+  auto batch = add_batch();
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
               get_key_values()).WillRepeatedly(ReturnRef(result_keys_values));
@@ -542,23 +610,25 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
       .Times(AtLeast(1));
   EXPECT_CALL(*mock_request, resume(_)).Times(1);
 
-  action_under_test->fetch_objects_info_successful();
+  action_under_test->fetch_objects_info_successful(batch);
 
   EXPECT_EQ(0, action_under_test->oids_to_delete.size());
-  EXPECT_EQ(0, action_under_test->objects_metadata.size());
+  EXPECT_EQ(0, batch->objects_metadata.size());
   EXPECT_EQ(0, action_under_test->delete_objects_response.get_success_count());
   EXPECT_EQ(3, action_under_test->delete_objects_response.get_failure_count());
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadata) {
+  auto batch = add_batch();
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
               delete_keyval(_, _, _, _)).Times(1);
 
-  action_under_test->delete_objects_metadata();
+  action_under_test->delete_objects_metadata(batch);
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadataSucceeded) {
-  action_under_test->objects_metadata.push_back(
+  auto batch = add_batch();
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
 
   action_under_test->oids_to_delete.push_back(oid);
@@ -567,7 +637,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadataSucceeded) {
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_object_name())
       .WillOnce(Return("objname"));
 
-  action_under_test->delete_objects_metadata_successful();
+  action_under_test->delete_objects_metadata_successful(batch);
 
   EXPECT_TRUE(action_under_test->at_least_one_delete_successful);
   EXPECT_EQ(1, action_under_test->delete_objects_response.get_success_count());
@@ -575,14 +645,19 @@ TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadataSucceeded) {
 }
 
 TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadataFailedToLaunch) {
+  auto batch = add_batch();
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer), get_state())
       .Times(1)
-      .WillRepeatedly(Return(S3MotrKVSWriterOpState::failed));
+      .WillRepeatedly(Return(S3MotrKVSWriterOpState::failed_to_launch));
   EXPECT_CALL(*mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*mock_request, send_response(500, _)).Times(AtLeast(1));
+  EXPECT_CALL(*mock_request, send_response(S3HttpFailed503, _))
+      .Times(AtLeast(1));
   EXPECT_CALL(*mock_request, resume(_)).Times(1);
 
-  action_under_test->delete_objects_metadata_failed();
+  action_under_test->delete_objects_metadata_failed(batch);
+
+  EXPECT_STREQ("ServiceUnavailable",
+               action_under_test->get_s3_error_code().c_str());
 
   EXPECT_FALSE(action_under_test->at_least_one_delete_successful);
   EXPECT_EQ(0, action_under_test->delete_objects_response.get_success_count());
@@ -591,9 +666,10 @@ TEST_F(S3DeleteMultipleObjectsActionTest, DeleteObjectMetadataFailedToLaunch) {
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
        DeleteObjectMetadataFailedWithMissing) {
-  action_under_test->objects_metadata.push_back(
+  auto batch = add_batch();
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
-  action_under_test->objects_metadata.push_back(
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
 
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
@@ -610,7 +686,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_object_name())
       .WillRepeatedly(Return("objname"));
 
-  action_under_test->delete_objects_metadata_failed();
+  action_under_test->delete_objects_metadata_failed(batch);
 
   EXPECT_TRUE(action_under_test->at_least_one_delete_successful);
   EXPECT_EQ(2, action_under_test->delete_objects_response.get_success_count());
@@ -619,9 +695,10 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
        DeleteObjectMetadataFailedWithErrors) {
-  action_under_test->objects_metadata.push_back(
+  auto batch = add_batch();
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
-  action_under_test->objects_metadata.push_back(
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
 
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
@@ -638,7 +715,7 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_object_name())
       .WillRepeatedly(Return("objname"));
 
-  action_under_test->delete_objects_metadata_failed();
+  action_under_test->delete_objects_metadata_failed(batch);
 
   EXPECT_STREQ("InternalError", action_under_test->get_s3_error_code().c_str());
   EXPECT_FALSE(action_under_test->at_least_one_delete_successful);
@@ -648,15 +725,9 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
 
 TEST_F(S3DeleteMultipleObjectsActionTest,
        DeleteObjectMetadataFailedMoreToProcess) {
-  std::vector<std::string> my_keys;
-  my_keys.clear();
+  std::vector<std::string> my_keys = {"SampleDocument2.txt"};
   CREATE_BUCKET_METADATA;
 
-  EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata),
-              get_object_list_index_layout())
-      .Times(AtLeast(1))
-      .WillRepeatedly(ReturnRef(index_layout));
-
   EXPECT_CALL(*mock_request, get_header_value(_))
       .WillOnce(Return("vxQpICn70jvA6+9R0/d5iA=="));
   // Clear tasks so validate_request_body calls mocked next
@@ -667,14 +738,15 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   action_under_test->validate_request_body(SAMPLE_DELETE_REQUEST);
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-              get_keyval(_, my_keys, _, _)).Times(AtLeast(1));
+              get_keyval(_, my_keys, _, _)).Times(1);
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer), get_state())
       .Times(1)
       .WillRepeatedly(Return(S3MotrKVSWriterOpState::failed));
 
-  action_under_test->objects_metadata.push_back(
+  auto batch = add_batch();
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
-  action_under_test->objects_metadata.push_back(
+  batch->objects_metadata.push_back(
       object_meta_factory->create_object_metadata_obj(mock_request));
 
   EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
@@ -684,8 +756,8 @@ TEST_F(S3DeleteMultipleObjectsActionTest,
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_object_name())
       .WillRepeatedly(Return("objname"));
 
-  action_under_test->delete_index_in_req = -1;  // simulate
-  action_under_test->delete_objects_metadata_failed();
+  action_under_test->delete_index_in_req = 1;
+  action_under_test->delete_objects_metadata_failed(batch);
 
   EXPECT_TRUE(action_under_test->at_least_one_delete_successful);
   EXPECT_EQ(2, action_under_test->delete_objects_response.get_success_count());
@@ -53,14 +53,15 @@ using ::testing::InSequence;
     EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),             \
                 get_key_values())                                             \
         .WillRepeatedly(ReturnRef(result_keys_values));                       \
-    EXPECT_CALL(*(object_meta_factory->mock_object_metadata), from_json(_))   \
-        .WillRepeatedly(Return(0));                                           \
+    EXPECT_CALL(*(object_meta_factory->mock_object_metadata),                 \
+                from_json_for_listing(_)).WillRepeatedly(Return(0));          \
     EXPECT_CALL(*(object_meta_factory->mock_object_metadata),                 \
                 get_content_length_str()).WillRepeatedly(Return("0"));        \
     EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())    \
         .WillRepeatedly(Return(S3BucketMetadataState::present));              \
     EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1)); \
-    EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));      \
+    EXPECT_CALL(*request_mock, send_response_buffer(200, _))                  \
+        .Times(AtLeast(1));                                                   \
   } while (0)
 
 #define OBJ_METADATA_EXPECTATIONS                                              \
@@ -209,7 +210,7 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsWithZeroObjects) {
       .WillRepeatedly(Return(S3BucketMetadataState::present));
 
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->get_next_objects();
 }
 
@@ -222,7 +223,7 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsFailedNoEntries) {
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
 
   action_under_test_ptr->get_next_objects_failed();
 }
@@ -259,8 +260,8 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsSuccessful) {
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
               get_key_values()).WillRepeatedly(ReturnRef(result_keys_values));
-  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), from_json(_))
-      .WillRepeatedly(Return(0));
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              from_json_for_listing(_)).WillRepeatedly(Return(0));
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
               get_content_length_str())
       .WillRepeatedly(Return("0"));
@@ -274,7 +275,7 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsSuccessful) {
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->max_record_count =
       S3Option::get_instance()->get_motr_idx_fetch_count();
   action_under_test_ptr->get_next_objects_successful();
@@ -297,15 +298,15 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsSuccessfulJsonError) {
 
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
               get_key_values()).WillRepeatedly(ReturnRef(result_keys_values));
-  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), from_json(_))
-      .WillRepeatedly(Return(-1));
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              from_json_for_listing(_)).WillRepeatedly(Return(-1));
   EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
               get_content_length_str())
       .WillRepeatedly(Return("0"));
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->max_record_count =
       S3Option::get_instance()->get_motr_idx_fetch_count();
   action_under_test_ptr->get_next_objects_successful();
@@ -414,11 +415,9 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsSuccessfulMultiComponentKey) {
   CREATE_KVS_READER_OBJ;
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
       .WillRepeatedly(Return(S3MotrKVSReaderOpState::present));
+  // Keys after "boo/" are already fetched, no further Motr reads needed
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-              next_keyval(_, _, _, _, _, _))
-      .Times(AtLeast(1))
-      .WillRepeatedly(InvokeWithoutArgs(
-           this, &S3GetBucketActionTest::call_next_keyval_successful));
+              next_keyval(_, _, _, _, _, _)).Times(0);
   EXPECT_CALL(*bucket_meta_factory->mock_bucket_metadata,
               get_object_list_index_layout())
       .WillRepeatedly(ReturnRef(index_layout));
@@ -435,41 +434,84 @@ TEST_F(S3GetBucketActionTest, GetNextObjectsSuccessfulMultiComponentKey) {
       std::make_pair("cquux/thud", std::make_pair(0, "keyval")));
   result_keys_values.insert(
       std::make_pair("cquux/bla", std::make_pair(0, "keyval")));
-  // last_key:= boo/\xff
-  std::map<std::string, std::pair<int, std::string>> result_next_keys_values;
-  result_next_keys_values.insert(
-      std::make_pair("cquux/thud", std::make_pair(0, "keyval")));
-  result_next_keys_values.insert(
-      std::make_pair("cquux/bla", std::make_pair(0, "keyval")));
-  // last_key:= cquux/\xff
-  std::map<std::string, std::pair<int, std::string>>
-      result_next_keys_values_empty;
 
   OBJ_METADATA_EXPECTATIONS;
   SET_NEXT_OBJ_SUCCESSFUL_EXPECTATIONS;
-  // Override get_key_values(), as below:
-  {
-    InSequence s;
-    EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-                get_key_values()).WillOnce(ReturnRef(result_keys_values));
-    EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-                get_key_values()).WillOnce(ReturnRef(result_next_keys_values));
-    EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
-                get_key_values())
-        .WillOnce(ReturnRef(result_next_keys_values_empty));
-  }
 
   action_under_test_ptr->max_record_count =
       S3Option::get_instance()->get_motr_idx_fetch_count();
   action_under_test_ptr->get_next_objects_successful();
   EXPECT_EQ(0, action_under_test_ptr->object_list->size());
   EXPECT_EQ(1, action_under_test_ptr->object_list->common_prefixes_size());
+  EXPECT_FALSE(action_under_test_ptr->object_list->is_response_truncated());
   // Ensure that common prefixes contain "cquux/"
   std::set<std::string> common_prexes =
       action_under_test_ptr->object_list->get_common_prefixes();
   EXPECT_STREQ((*(common_prexes.begin())).c_str(), "cquux/");
 }
 
+// Several common prefixes within one batch of keys
+TEST_F(S3GetBucketActionTest,
+       GetNextObjectsSuccessfulDelimiterSkipsWithinBatch) {
+  CREATE_BUCKET_METADATA_OBJ;
+  CREATE_KVS_READER_OBJ;
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
+              next_keyval(_, _, _, _, _, _)).Times(0);
+
+  action_under_test_ptr->request_delimiter.assign("/");
+  result_keys_values.insert(
+      std::make_pair("a/key1", std::make_pair(0, "keyval")));
+  result_keys_values.insert(
+      std::make_pair("a/key2", std::make_pair(0, "keyval")));
+  result_keys_values.insert(
+      std::make_pair("b/key1", std::make_pair(0, "keyval")));
+  result_keys_values.insert(
+      std::make_pair("b/key2", std::make_pair(0, "keyval")));
+  result_keys_values.insert(std::make_pair("c", std::make_pair(0, "keyval")));
+
+  OBJ_METADATA_EXPECTATIONS;
+  SET_NEXT_OBJ_SUCCESSFUL_EXPECTATIONS;
+
+  action_under_test_ptr->max_record_count =
+      S3Option::get_instance()->get_motr_idx_fetch_count();
+  action_under_test_ptr->get_next_objects_successful();
+  EXPECT_EQ(1, action_under_test_ptr->object_list->size());
+  EXPECT_EQ(2, action_under_test_ptr->object_list->common_prefixes_size());
+  EXPECT_EQ(5u, action_under_test_ptr->total_keys_visited);
+  EXPECT_FALSE(action_under_test_ptr->object_list->is_response_truncated());
+}
+
+// Full batch ending with a common prefix, keys after it are read from Motr
+TEST_F(S3GetBucketActionTest,
+       GetNextObjectsSuccessfulDelimiterFetchesAfterFullBatch) {
+  CREATE_BUCKET_METADATA_OBJ;
+  CREATE_KVS_READER_OBJ;
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::present));
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
+              next_keyval(_, std::string("b/\xff"), _, _, _, _))
+      .WillOnce(InvokeWithoutArgs([this]() {
+        result_keys_values.clear();
+        call_next_keyval_successful();
+      }));
+
+  action_under_test_ptr->request_delimiter.assign("/");
+  result_keys_values.insert(
+      std::make_pair("a/key1", std::make_pair(0, "keyval")));
+  result_keys_values.insert(
+      std::make_pair("a/key2", std::make_pair(0, "keyval")));
+  result_keys_values.insert(
+      std::make_pair("b/key1", std::make_pair(0, "keyval")));
+
+  OBJ_METADATA_EXPECTATIONS;
+  SET_NEXT_OBJ_SUCCESSFUL_EXPECTATIONS;
+
+  action_under_test_ptr->max_record_count = result_keys_values.size();
+  action_under_test_ptr->get_next_objects_successful();
+  EXPECT_EQ(0, action_under_test_ptr->object_list->size());
+  EXPECT_EQ(2, action_under_test_ptr->object_list->common_prefixes_size());
+}
+
 // Prefix in multi-component object names, with both prefix and delimiter string
 TEST_F(S3GetBucketActionTest,
        GetNextObjectsSuccessfulPrefixDelimMultiComponentKey) {
@@ -674,7 +716,7 @@ TEST_F(S3GetBucketActionTest, SendResponseToClientSuccess) {
 
   action_under_test_ptr->fetch_successful = true;
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->send_response_to_s3_client();
 }
 
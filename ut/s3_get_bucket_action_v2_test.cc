@@ -66,14 +66,15 @@ using ::testing::_;
     EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),             \
                 get_key_values())                                             \
         .WillRepeatedly(ReturnRef(result_keys_values));                       \
-    EXPECT_CALL(*(object_meta_factory->mock_object_metadata), from_json(_))   \
-        .WillRepeatedly(Return(0));                                           \
+    EXPECT_CALL(*(object_meta_factory->mock_object_metadata),                 \
+                from_json_for_listing(_)).WillRepeatedly(Return(0));          \
     EXPECT_CALL(*(object_meta_factory->mock_object_metadata),                 \
                 get_content_length_str()).WillRepeatedly(Return("0"));        \
     EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())    \
         .WillRepeatedly(Return(S3BucketMetadataState::present));              \
     EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1)); \
-    EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));      \
+    EXPECT_CALL(*request_mock, send_response_buffer(200, _))                  \
+        .Times(AtLeast(1));                                                   \
   } while (0)
 
 #define OBJ_METADATA_EXPECTATIONS                                              \
@@ -246,7 +247,7 @@ TEST_F(S3GetBucketActionV2Test, SendResponseToClientSuccess) {
 
   action_under_test_ptr->fetch_successful = true;
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->send_response_to_s3_client();
 }
 
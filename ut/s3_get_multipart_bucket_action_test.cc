@@ -88,7 +88,8 @@ using ::testing::_;
     EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())    \
         .WillRepeatedly(Return(S3BucketMetadataState::present));              \
     EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1)); \
-    EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));      \
+    EXPECT_CALL(*request_mock, send_response_buffer(200, _))                  \
+        .Times(AtLeast(1));                                                   \
   } while (0)
 
 #define OBJ_METADATA_EXPECTATIONS                                              \
@@ -200,7 +201,7 @@ TEST_F(S3GetMultipartBucketActionTest, GetNextObjectsWithZeroObjects) {
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->get_next_objects();
 }
 
@@ -211,7 +212,7 @@ TEST_F(S3GetMultipartBucketActionTest, GetNextObjectsFailedNoEntries) {
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
       .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
 
   action_under_test_ptr->get_next_objects_failed();
 }
@@ -260,7 +261,7 @@ TEST_F(S3GetMultipartBucketActionTest, GetNextObjectsSuccessful) {
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
 
   action_under_test_ptr->get_next_objects_successful();
   EXPECT_EQ(3, action_under_test_ptr->multipart_object_list.size());
@@ -290,7 +291,7 @@ TEST_F(S3GetMultipartBucketActionTest, GetNextObjectsSuccessfulJsonError) {
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), get_state())
       .WillRepeatedly(Return(S3BucketMetadataState::present));
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
 
   action_under_test_ptr->get_next_objects_successful();
   EXPECT_EQ(0, action_under_test_ptr->multipart_object_list.size());
@@ -399,7 +400,7 @@ TEST_F(S3GetMultipartBucketActionTest, SendResponseToClientSuccess) {
 
   action_under_test_ptr->fetch_successful = true;
   EXPECT_CALL(*request_mock, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*request_mock, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*request_mock, send_response_buffer(200, _)).Times(AtLeast(1));
   action_under_test_ptr->send_response_to_s3_client();
 }
 
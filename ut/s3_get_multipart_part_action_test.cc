@@ -287,7 +287,7 @@ TEST_F(S3GetMultipartPartActionTest,
       .WillRepeatedly(Return(0));
   action_under_test->return_list_size = action_under_test->max_parts - 1;
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _)).Times(1);
   action_under_test->get_key_object_successful();
   EXPECT_EQ(2, action_under_test->return_list_size);
   EXPECT_TRUE(action_under_test->multipart_part_list.response_is_truncated);
@@ -444,7 +444,7 @@ TEST_F(S3GetMultipartPartActionTest,
   EXPECT_CALL(*(part_meta_factory->mock_part_metadata), from_json(_))
       .WillRepeatedly(Return(0));
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _)).Times(1);
 
   action_under_test->get_next_objects_successful();
 
@@ -488,7 +488,7 @@ TEST_F(S3GetMultipartPartActionTest, GetNextObjectsSuccessfulListNotTruncated) {
   EXPECT_CALL(*(part_meta_factory->mock_part_metadata),
               get_content_length_str()).WillRepeatedly(Return("1024"));
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _)).Times(1);
 
   action_under_test->max_parts = 7;
   int old_idx_fetch_count =
@@ -579,7 +579,7 @@ TEST_F(S3GetMultipartPartActionTest, SendNoSuchUploadErrorResponse) {
 TEST_F(S3GetMultipartPartActionTest, SendSuccessResponse) {
   action_under_test->fetch_successful = true;
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _)).Times(1);
 
   action_under_test->send_response_to_s3_client();
 }
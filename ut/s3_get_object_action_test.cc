@@ -1242,8 +1242,119 @@ TEST_F(S3GetObjectActionTest, SendErrorResponseForErrorReadingObject) {
   action_under_test->send_response_to_s3_client();
 }
 
+TEST_F(S3GetObjectActionTest, ReadAheadStopsAtLastBlock) {
+  action_under_test->motr_reader = motr_reader_factory->mock_motr_reader;
+  action_under_test->object_metadata =
+      object_meta_factory->create_object_metadata_obj(ptr_mock_request,
+                                                      index_layout);
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_layout_id())
+      .WillRepeatedly(Return(layout_id));
+
+  size_t blocks_per_read =
+      S3Option::get_instance()->get_motr_units_per_request();
+  // Window allows 3 reads ahead, object has only 2 more reads
+  action_under_test->read_ahead_depth = 4;
+  action_under_test->motr_read_window = 4;
+  action_under_test->blocks_launched = blocks_per_read;
+  action_under_test->total_blocks_to_read = blocks_per_read * 3;
+
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              read_ahead_object_data(blocks_per_read))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  action_under_test->read_ahead();
+
+  EXPECT_EQ(2u, action_under_test->read_ahead_blocks.size());
+  EXPECT_EQ(blocks_per_read * 3, action_under_test->blocks_launched);
+  EXPECT_EQ(4u, action_under_test->read_ahead_depth);
+}
+
+TEST_F(S3GetObjectActionTest, ReadObjectDataTakesReadAheadFirst) {
+  action_under_test->motr_reader = motr_reader_factory->mock_motr_reader;
+  action_under_test->object_metadata =
+      object_meta_factory->create_object_metadata_obj(ptr_mock_request,
+                                                      index_layout);
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_layout_id())
+      .WillRepeatedly(Return(layout_id));
+
+  // Last of two reads was launched ahead of the first one
+  action_under_test->read_ahead_depth = 2;
+  action_under_test->motr_read_window = 4;
+  action_under_test->blocks_already_read = 1;
+  action_under_test->blocks_launched = 2;
+  action_under_test->total_blocks_to_read = 2;
+  action_under_test->read_ahead_blocks.push_back(1);
+
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              read_ahead_object_data(_)).Times(0);
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              read_object_data(1, _, _))
+      .Times(1)
+      .WillOnce(Return(true));
+
+  action_under_test->read_object_data();
+
+  EXPECT_TRUE(action_under_test->read_ahead_blocks.empty());
+  EXPECT_EQ(1u, action_under_test->blocks_to_read);
+  EXPECT_EQ(3u, action_under_test->read_ahead_depth);
+}
+
+TEST_F(S3GetObjectActionTest, SendResponseWaitsForReadAhead) {
+  action_under_test->motr_reader = motr_reader_factory->mock_motr_reader;
+  action_under_test->read_object_reply_started = true;
+  action_under_test->read_ahead_blocks.push_back(1);
+
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              get_read_ahead_in_flight()).WillRepeatedly(Return(1));
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              discard_read_ahead(_)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, send_reply_end()).Times(0);
+  EXPECT_CALL(*ptr_mock_request, send_response(_, _)).Times(0);
+
+  action_under_test->send_response_to_s3_client();
+
+  EXPECT_TRUE(action_under_test->read_ahead_blocks.empty());
+}
+
 TEST_F(S3GetObjectActionTest, RangeHeaderContainsSpacesOnly) {
   std::string range_value(" \t\n");
   EXPECT_TRUE(action_under_test->validate_range_header_and_set_read_options(
       range_value));
 }
+
+TEST_F(S3GetObjectActionTest, ReadObjectSendsInlineDataRange) {
+  CREATE_OBJECT_METADATA;
+  std::string data = "hello world";
+  std::map<std::string, std::string> meta_map;
+
+  object_meta_factory->mock_object_metadata->set_inline_data(data);
+  action_under_test->content_length = data.length();
+  action_under_test->first_byte_offset_to_read = 3;
+  action_under_test->last_byte_offset_to_read = 8;
+
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), get_md5())
+      .WillRepeatedly(Return("abcd1234abcd"));
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_last_modified_gmt())
+      .WillOnce(Return("Sunday, 29 January 2017 08:05:01 GMT"));
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_user_attributes()).WillOnce(ReturnRef(meta_map));
+  EXPECT_CALL(*ptr_mock_request, get_header_value("Range"))
+      .WillRepeatedly(Return("bytes=3-8"));
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_reply_start(Eq(S3HttpSuccess206)))
+      .Times(1);
+  // Nothing is read from Motr
+  EXPECT_CALL(*(motr_reader_factory->mock_motr_reader),
+              read_object_data(_, _, _)).Times(0);
+  EXPECT_CALL(*ptr_mock_request, send_reply_body(_, Eq(6)))
+      .WillOnce(Invoke([](const char *body, int length) {
+        EXPECT_EQ("lo wor", std::string(body, length));
+      }));
+  EXPECT_CALL(*ptr_mock_request, send_reply_end()).Times(1);
+
+  action_under_test->read_object();
+
+  EXPECT_EQ(6U, action_under_test->data_sent_to_client);
+}
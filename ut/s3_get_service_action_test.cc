@@ -114,7 +114,8 @@ TEST_F(S3GetServiceActionTest, GetNextBucketSuccessful) {
   action_under_test->motr_kv_reader =
       motr_kvs_reader_factory->mock_motr_kvs_reader;
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _))
+      .Times(AtLeast(1));
 
   EXPECT_CALL(*(bucket_meta_factory->mock_bucket_metadata), from_json(_))
       .WillRepeatedly(Return(0));
@@ -132,7 +133,8 @@ TEST_F(S3GetServiceActionTest, GetNextBucketFailedMotrReaderStateMissing) {
   EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_state())
       .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _))
+      .Times(AtLeast(1));
 
   // Perform action on test object.
   action_under_test->motr_kv_reader =
@@ -177,7 +179,8 @@ TEST_F(S3GetServiceActionTest, SendResponseToClientServiceUnavailable) {
 TEST_F(S3GetServiceActionTest, SendResponseToClientSuccess) {
   action_under_test->fetch_successful = true;
   EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
-  EXPECT_CALL(*ptr_mock_request, send_response(200, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response_buffer(200, _))
+      .Times(AtLeast(1));
   action_under_test->send_response_to_s3_client();
 }
 
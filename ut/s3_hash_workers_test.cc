@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <event2/thread.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "s3_chunk_payload_parser.h"
+#include "s3_hash_workers.h"
+#include "s3_option.h"
+
+class S3HashWorkersTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // Workers post completions from their own threads
+    evthread_use_pthreads();
+    p_evbase = event_base_new();
+    p_other_evbase = event_base_new();
+  }
+
+  void TearDown() override {
+    workers.reset();
+    S3HashWorkers::destroy_instance();
+    event_base_free(p_evbase);
+    event_base_free(p_other_evbase);
+  }
+
+  // Runs the event loop until done_count reaches expected_count
+  void wait_for_done(evbase_t *evbase, unsigned expected_count) {
+    while (done_count < expected_count) {
+      event_base_loop(evbase, EVLOOP_ONCE);
+    }
+  }
+
+  evbase_t *p_evbase;
+  evbase_t *p_other_evbase;
+  std::unique_ptr<S3HashWorkers> workers;
+  unsigned done_count = 0;
+};
+
+TEST_F(S3HashWorkersTest, InstanceIsCreatedOnlyWithThreads) {
+  S3HashWorkers::create_instance(0, 16, 1024);
+  EXPECT_EQ(nullptr, S3HashWorkers::get_instance());
+
+  S3HashWorkers::create_instance(2, 16, 1024);
+  ASSERT_NE(nullptr, S3HashWorkers::get_instance());
+  EXPECT_EQ(2u, S3HashWorkers::get_instance()->get_thread_count());
+
+  S3HashWorkers::destroy_instance();
+  EXPECT_EQ(nullptr, S3HashWorkers::get_instance());
+}
+
+TEST_F(S3HashWorkersTest, DoneRunsOnSubmittingEventBase) {
+  workers.reset(new S3HashWorkers(2, 4, 1024));
+  std::atomic<unsigned> work_count(0);
+
+  for (unsigned i = 0; i < 10; ++i) {
+    ASSERT_TRUE(workers->submit([&work_count]() { ++work_count; },
+                                [this]() { ++done_count; }, p_evbase));
+  }
+  wait_for_done(p_evbase, 10);
+  EXPECT_EQ(10u, work_count);
+}
+
+TEST_F(S3HashWorkersTest, BatchIsPostedToEachEventBase) {
+  workers.reset(new S3HashWorkers(1, 16, 1024));
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future());
+  unsigned other_done_count = 0;
+
+  // Keep the worker busy so the next jobs end up in one batch
+  ASSERT_TRUE(workers->submit([released]() { released.wait(); },
+                              [this]() { ++done_count; }, p_evbase));
+  for (unsigned i = 0; i < 3; ++i) {
+    ASSERT_TRUE(workers->submit([]() {}, [this]() { ++done_count; },
+                                p_evbase));
+    ASSERT_TRUE(workers->submit([]() {},
+                                [&other_done_count]() { ++other_done_count; },
+                                p_other_evbase));
+  }
+  release.set_value();
+
+  wait_for_done(p_evbase, 4);
+  while (other_done_count < 3) {
+    event_base_loop(p_other_evbase, EVLOOP_ONCE);
+  }
+  EXPECT_EQ(4u, done_count);
+}
+
+TEST_F(S3HashWorkersTest, SubmitFailsWhenQueueIsFull) {
+  workers.reset(new S3HashWorkers(1, 1, 1));
+  std::promise<void> started;
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future());
+
+  ASSERT_TRUE(workers->submit([&started, released]() {
+                                started.set_value();
+                                released.wait();
+                              },
+                              [this]() { ++done_count; }, p_evbase));
+  started.get_future().wait();
+
+  EXPECT_TRUE(workers->submit([]() {}, [this]() { ++done_count; }, p_evbase));
+  EXPECT_FALSE(workers->submit([]() {}, [this]() { ++done_count; }, p_evbase));
+
+  release.set_value();
+  wait_for_done(p_evbase, 2);
+}
+
+TEST_F(S3HashWorkersTest, ChunkDetailIsReadyOnceHashed) {
+  S3HashWorkers::create_instance(1, 16, 1024);
+  S3Option::get_instance()->set_reactor_eventbase(p_evbase);
+
+  S3ChunkDetail detail;
+  detail.add_size(3);
+  EXPECT_TRUE(detail.update_hash("abc", 3));
+  EXPECT_TRUE(detail.fini_hash([this]() { ++done_count; }));
+
+  wait_for_done(p_evbase, 1);
+  S3Option::get_instance()->set_reactor_eventbase(NULL);
+
+  EXPECT_TRUE(detail.is_ready());
+  EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            detail.get_payload_hash());
+}
+
+TEST_F(S3HashWorkersTest, ChunkDetailIsHashedInlineWithoutWorkers) {
+  S3ChunkDetail detail;
+  detail.add_size(3);
+  EXPECT_TRUE(detail.update_hash("abc", 3));
+  EXPECT_TRUE(detail.fini_hash([this]() { ++done_count; }));
+
+  EXPECT_TRUE(detail.is_ready());
+  EXPECT_EQ(0u, done_count);
+  EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            detail.get_payload_hash());
+}
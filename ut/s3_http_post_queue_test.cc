@@ -66,31 +66,41 @@ TEST_F(S3HttpPostQueueTest, Basic) {
   EXPECT_FALSE(object->post(""));
 
   EXPECT_TRUE(object->post(msg));
-  EXPECT_EQ(1, object->msg_queue.size());
-
-  object->on_msg_sent();
   EXPECT_TRUE(object->msg_queue.empty());
+  EXPECT_EQ(msg, object->senders[0].body);
+  EXPECT_EQ(sizeof(msg) - 1, object->queued_bytes);
+
+  object->on_msg_sent(0);
+  EXPECT_EQ(0, object->queued_bytes);
 }
 
 TEST_F(S3HttpPostQueueTest, InProgress) {
   EXPECT_TRUE(object->post(msg));
-  EXPECT_TRUE(object->msg_in_progress);
+  EXPECT_TRUE(object->senders[0].in_progress);
 
-  object->on_error();
-  EXPECT_TRUE(object->msg_in_progress);
+  EXPECT_TRUE(object->post(msg));
+  EXPECT_EQ(1, object->msg_queue.size());
+
+  object->on_error(0);
+  EXPECT_TRUE(object->senders[0].in_progress);
+  EXPECT_EQ(1, object->msg_queue.size());
+
+  object->on_msg_sent(0);
+  EXPECT_TRUE(object->senders[0].in_progress);
+  EXPECT_TRUE(object->msg_queue.empty());
 
-  object->on_msg_sent();
-  EXPECT_FALSE(object->msg_in_progress);
+  object->on_msg_sent(0);
+  EXPECT_FALSE(object->senders[0].in_progress);
 }
 
 TEST_F(S3HttpPostQueueTest, ErrorCount) {
   EXPECT_TRUE(object->post(msg));
 
   for (unsigned i = 0; i < S3HttpPostQueueImpl::MAX_ERR;) {
-    object->on_error();
+    object->on_error(0);
     EXPECT_EQ(++i, object->n_err);
   }
-  object->on_msg_sent();
+  object->on_msg_sent(0);
   EXPECT_EQ(0, object->n_err);
 }
 
@@ -101,11 +111,87 @@ TEST_F(S3HttpPostQueueTest, Thresholds) {
   --object->n_err;
   EXPECT_TRUE(object->post(msg));
 
-  object->on_msg_sent();
+  object->on_msg_sent(0);
 
-  for (unsigned i = 0; i < S3HttpPostQueueImpl::MAX_MSG_IN_QUEUE - 1; ++i) {
-    object->msg_queue.push(std::string());
-  }
+  object->queued_bytes =
+      object->config.max_queued_bytes - 2 * (sizeof(msg) - 1);
+  EXPECT_TRUE(object->post(msg));
   EXPECT_TRUE(object->post(msg));
   EXPECT_FALSE(object->post(msg));
+  EXPECT_EQ(1, object->get_dropped_count());
+}
+
+class S3HttpPostQueueBatchTest : public testing::Test {
+ protected:
+  S3HttpPostQueueBatchTest();
+
+  MockS3HttpPostEngine *engines[2];
+  std::unique_ptr<S3HttpPostQueueImpl> object;
+};
+
+S3HttpPostQueueBatchTest::S3HttpPostQueueBatchTest() {
+  S3HttpPostQueueConfig config;
+
+  config.batch_prefix = "[";
+  config.batch_separator = ",";
+  config.batch_suffix = "]";
+  config.max_batch_size = 3;
+  config.max_batch_bytes = 16;
+
+  for (auto &engine : engines) {
+    engine = new MockS3HttpPostEngine();
+    EXPECT_CALL(*engine, set_callbacks(_, _)).Times(1);
+  }
+  object.reset(new S3HttpPostQueueImpl(
+      std::vector<S3HttpPostEngine *>(engines, engines + 2), config));
+}
+
+TEST_F(S3HttpPostQueueBatchTest, PacksMessagesWhileEnginesAreBusy) {
+  EXPECT_CALL(*engines[0], post("[a]")).WillOnce(Return(true));
+  EXPECT_CALL(*engines[1], post("[b]")).WillOnce(Return(true));
+
+  EXPECT_TRUE(object->post("a"));
+  EXPECT_TRUE(object->post("b"));
+  EXPECT_TRUE(object->post("c"));
+  EXPECT_TRUE(object->post("d"));
+  EXPECT_EQ(2, object->msg_queue.size());
+
+  EXPECT_CALL(*engines[1], post("[c,d]")).WillOnce(Return(true));
+  object->on_msg_sent(1);
+  EXPECT_TRUE(object->msg_queue.empty());
+  EXPECT_EQ(3, object->queued_bytes);
+}
+
+TEST_F(S3HttpPostQueueBatchTest, LimitsBatchSize) {
+  EXPECT_CALL(*engines[0], post(_)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*engines[1], post(_)).WillRepeatedly(Return(true));
+  EXPECT_TRUE(object->post("a"));
+  EXPECT_TRUE(object->post("b"));
+
+  for (const char *m : {"1", "2", "3", "4", "0123456789abcdefghij", "5"}) {
+    EXPECT_TRUE(object->post(m));
+  }
+  // Three messages at most
+  EXPECT_CALL(*engines[0], post("[1,2,3]")).WillOnce(Return(true));
+  object->on_msg_sent(0);
+  // 16 bytes at most
+  EXPECT_CALL(*engines[0], post("[4]")).WillOnce(Return(true));
+  object->on_msg_sent(0);
+  // Unless the message is alone
+  EXPECT_CALL(*engines[0], post("[0123456789abcdefghij]"))
+      .WillOnce(Return(true));
+  object->on_msg_sent(0);
+  EXPECT_CALL(*engines[0], post("[5]")).WillOnce(Return(true));
+  object->on_msg_sent(0);
+}
+
+TEST_F(S3HttpPostQueueBatchTest, RetriesFailedBatch) {
+  EXPECT_CALL(*engines[0], post("[a]")).Times(2).WillRepeatedly(Return(true));
+  EXPECT_CALL(*engines[1], post("[b]")).WillOnce(Return(true));
+  EXPECT_TRUE(object->post("a"));
+  EXPECT_TRUE(object->post("b"));
+  EXPECT_TRUE(object->post("c"));
+
+  object->on_error(0);
+  EXPECT_EQ(1, object->msg_queue.size());
 }
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "s3_json_scanner.h"
+
+TEST(S3JsonScannerTest, ReadsWantedMembers) {
+  const std::string json =
+      "{\"ACL\":\"PD94bWw=\",\"Bucket-Name\":\"bucket\",\"Object-Name\":"
+      "\"obj\",\"System-Defined\":{\"Content-Length\":\"42\",\"Owner-"
+      "Account\":\"s3account\"},\"layout_id\":9}\n";
+  S3JsonScanner scanner(json);
+  std::string key, value;
+  std::string object_name, content_length, layout_id;
+
+  ASSERT_TRUE(scanner.enter_object());
+  while (scanner.next_member(key)) {
+    if (key == "Object-Name") {
+      EXPECT_TRUE(scanner.read_string(object_name));
+    } else if (key == "layout_id") {
+      EXPECT_TRUE(scanner.read_string(layout_id));
+    } else if (key == "System-Defined") {
+      ASSERT_TRUE(scanner.enter_object());
+      while (scanner.next_member(key)) {
+        if (key == "Content-Length") {
+          EXPECT_TRUE(scanner.read_string(content_length));
+        } else {
+          EXPECT_TRUE(scanner.skip_value());
+        }
+      }
+    } else {
+      EXPECT_TRUE(scanner.skip_value());
+    }
+  }
+  EXPECT_FALSE(scanner.failed());
+  EXPECT_EQ("obj", object_name);
+  EXPECT_EQ("42", content_length);
+  EXPECT_EQ("9", layout_id);
+}
+
+TEST(S3JsonScannerTest, SkipsNestedValues) {
+  const std::string json =
+      "{ \"a\" : {\"b\":[1,{\"c\":\"}]\"}],\"d\":null} ,\n"
+      "  \"e\" : [] , \"f\" : \"x\" }";
+  S3JsonScanner scanner(json);
+  std::string key, value;
+
+  ASSERT_TRUE(scanner.enter_object());
+  ASSERT_TRUE(scanner.next_member(key));
+  EXPECT_EQ("a", key);
+  EXPECT_TRUE(scanner.skip_value());
+  ASSERT_TRUE(scanner.next_member(key));
+  EXPECT_EQ("e", key);
+  EXPECT_TRUE(scanner.skip_value());
+  ASSERT_TRUE(scanner.next_member(key));
+  EXPECT_EQ("f", key);
+  EXPECT_TRUE(scanner.read_string(value));
+  EXPECT_EQ("x", value);
+  EXPECT_FALSE(scanner.next_member(key));
+  EXPECT_FALSE(scanner.failed());
+}
+
+TEST(S3JsonScannerTest, UnescapesStrings) {
+  const std::string json =
+      "{\"k\":\"a\\\"b\\\\c\\/d\\n\\u00e9\\u20ac\\ud83d\\ude00\"}";
+  S3JsonScanner scanner(json);
+  std::string key, value;
+
+  ASSERT_TRUE(scanner.enter_object());
+  ASSERT_TRUE(scanner.next_member(key));
+  ASSERT_TRUE(scanner.read_string(value));
+  EXPECT_EQ("a\"b\\c/d\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", value);
+  EXPECT_FALSE(scanner.next_member(key));
+  EXPECT_FALSE(scanner.failed());
+}
+
+TEST(S3JsonScannerTest, NullIsEmptyString) {
+  S3JsonScanner scanner(std::string("{\"k\":null}"));
+  std::string key, value = "x";
+
+  ASSERT_TRUE(scanner.enter_object());
+  ASSERT_TRUE(scanner.next_member(key));
+  EXPECT_TRUE(scanner.read_string(value));
+  EXPECT_EQ("", value);
+}
+
+TEST(S3JsonScannerTest, MalformedDocumentFails) {
+  const char* docs[] = {"",
+                        "[]",
+                        "{\"k\"",
+                        "{\"k\":\"v",
+                        "{\"k\" \"v\"}",
+                        "{\"k\":{\"n\":1}",
+                        "{\"k\":\"\\q\"}",
+                        "{\"k\":\"\\u12\"}",
+                        "{\"k\":\"\\ud83d\"}"};
+
+  for (const char* doc : docs) {
+    S3JsonScanner scanner(doc, strlen(doc));
+    std::string key, value;
+
+    while (scanner.enter_object() && scanner.next_member(key)) {
+      if (!scanner.read_string(value)) {
+        scanner.skip_value();
+      }
+    }
+    EXPECT_TRUE(scanner.failed()) << doc;
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <json/json.h>
+
+#include "gtest/gtest.h"
+
+#include "s3_latency_histograms.h"
+
+TEST(S3LatencyHistogramTest, SmallValuesAreExact) {
+  for (uint64_t value = 0; value < 32; ++value) {
+    size_t bucket = S3LatencyHistogram::get_bucket(value);
+    EXPECT_EQ(value, S3LatencyHistogram::get_bucket_max(bucket));
+  }
+}
+
+TEST(S3LatencyHistogramTest, BucketsAreWithinOneSixteenth) {
+  uint64_t value = 32;
+
+  while (value <= S3LatencyHistogram::max_value) {
+    size_t bucket = S3LatencyHistogram::get_bucket(value);
+    uint64_t bucket_max = S3LatencyHistogram::get_bucket_max(bucket);
+
+    ASSERT_LT(bucket, S3LatencyHistogram::buckets);
+    EXPECT_GE(bucket_max, value);
+    EXPECT_LE(bucket_max - value, value / 16) << value;
+    EXPECT_EQ(bucket, S3LatencyHistogram::get_bucket(bucket_max));
+    value = value * 3 / 2 + 1;
+  }
+  EXPECT_EQ(S3LatencyHistogram::buckets - 1,
+            S3LatencyHistogram::get_bucket(UINT64_MAX));
+}
+
+TEST(S3LatencyHistogramTest, Percentiles) {
+  S3LatencyHistogram histogram;
+
+  EXPECT_EQ(0U, histogram.get_percentile(0.5));
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(1000U, histogram.get_count());
+  EXPECT_EQ(1000U, histogram.get_max());
+
+  uint64_t p50 = histogram.get_percentile(0.5);
+  EXPECT_GE(p50, 500U);
+  EXPECT_LE(p50, 500U + 500 / 16);
+
+  uint64_t p99 = histogram.get_percentile(0.99);
+  EXPECT_GE(p99, 990U);
+  EXPECT_LE(p99, 1000U);
+  EXPECT_EQ(1000U, histogram.get_percentile(0.999));
+}
+
+TEST(S3LatencyHistogramsTest, TaskPhases) {
+  EXPECT_EQ(S3LatencyPhase::auth, S3LatencyHistograms::get_task_phase(
+                                      "Action::check_authentication"));
+  EXPECT_EQ(S3LatencyPhase::auth, S3LatencyHistograms::get_task_phase(
+                                      "S3Action::check_authorization"));
+  EXPECT_EQ(S3LatencyPhase::bucket_metadata,
+            S3LatencyHistograms::get_task_phase("S3Action::load_metadata"));
+  EXPECT_EQ(S3LatencyPhase::bucket_metadata,
+            S3LatencyHistograms::get_task_phase(
+                "S3PutBucketAction::save_metadata_of_bucket"));
+  EXPECT_EQ(S3LatencyPhase::object_metadata,
+            S3LatencyHistograms::get_task_phase(
+                "S3PutObjectAction::save_metadata"));
+  EXPECT_EQ(S3LatencyPhase::data_io,
+            S3LatencyHistograms::get_task_phase(
+                "S3PutObjectAction::initiate_data_streaming"));
+  EXPECT_EQ(S3LatencyPhase::data_io, S3LatencyHistograms::get_task_phase(
+                                         "S3GetObjectAction::read_object"));
+  EXPECT_EQ(S3LatencyPhase::client_send,
+            S3LatencyHistograms::get_task_phase(
+                "S3GetObjectAction::send_response_to_s3_client"));
+  EXPECT_EQ(S3LatencyPhase::other,
+            S3LatencyHistograms::get_task_phase(
+                "S3PutObjectAction::validate_put_request"));
+}
+
+TEST(S3LatencyHistogramsTest, RecordsSeenPhasesOnly) {
+  S3LatencySample sample;
+
+  sample.total_usec = 300;
+  sample.phase_usec[(unsigned)S3LatencyPhase::auth] = 100;
+  sample.phase_usec[(unsigned)S3LatencyPhase::data_io] = 200;
+  sample.phases_seen = (1U << (unsigned)S3LatencyPhase::auth) |
+                       (1U << (unsigned)S3LatencyPhase::data_io);
+  S3LatencyHistograms::record("TestRecordsSeenPhasesOnly", sample);
+  S3LatencyHistograms::record("", sample);
+
+  Json::Value root;
+  Json::Reader reader;
+  ASSERT_TRUE(reader.parse(S3LatencyHistograms::to_json(), root));
+  ASSERT_FALSE(root.isMember(""));
+
+  const Json::Value& api = root["TestRecordsSeenPhasesOnly"];
+  EXPECT_EQ(1U, api["total"]["count"].asUInt64());
+  EXPECT_EQ(300U, api["total"]["max"].asUInt64());
+  EXPECT_EQ(100U, api["auth"]["p50"].asUInt64());
+  EXPECT_EQ(200U, api["data_io"]["p999"].asUInt64());
+  EXPECT_FALSE(api.isMember("bucket_metadata"));
+  EXPECT_FALSE(api.isMember("client_send"));
+}
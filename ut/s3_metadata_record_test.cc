@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "base64.h"
+#include "s3_metadata_record.h"
+#include "s3_option.h"
+
+class S3MetadataRecordTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    root["Bucket-Name"] = "seagatebucket";
+    root["Object-Name"] = "dir/object";
+    root["layout_id"] = 9;
+    root["motr_oid"] = "AAAAAAAAAAA=-AAAAAAAAAAA=";
+    root["System-Defined"]["Content-Length"] = "1024";
+    root["System-Defined"]["Content-MD5"] = "c99a";
+    root["User-Defined"]["x-amz-meta-color"] = "blue";
+    const std::string acl_xml =
+        "<AccessControlPolicy><Owner><ID>id</ID></Owner>"
+        "<AccessControlList/></AccessControlPolicy>";
+    root["ACL"] = base64_encode((const unsigned char*)acl_xml.c_str(),
+                                acl_xml.length());
+  }
+
+  void TearDown() override {
+    S3Option::get_instance()->set_metadata_binary_format(false);
+  }
+
+  Json::Value root;
+};
+
+TEST_F(S3MetadataRecordTest, EncodeDecode) {
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+  EXPECT_TRUE(S3MetadataRecord::is_binary(record));
+
+  Json::FastWriter fastWriter;
+  EXPECT_LT(record.length(), fastWriter.write(root).length());
+
+  Json::Value decoded;
+  ASSERT_TRUE(S3MetadataRecord::decode(record, decoded));
+  EXPECT_EQ(root, decoded);
+}
+
+TEST_F(S3MetadataRecordTest, OtherKeysAndTypes) {
+  root["custom-key"] = "value";
+  root["negative"] = -5;
+  root["big"] = Json::UInt64(1) << 63;
+  root["flag"] = true;
+  root["nothing"] = Json::Value();
+  root["Nested"]["Deeper"]["key"] = "";
+  root["Empty"] = Json::Value(Json::objectValue);
+
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+  Json::Value decoded;
+  ASSERT_TRUE(S3MetadataRecord::decode(record, decoded));
+  EXPECT_EQ(root, decoded);
+}
+
+TEST_F(S3MetadataRecordTest, NonCanonicalBase64KeptAsIs) {
+  root["ACL"] = "not base64!";
+  root["Policy"] = "";
+
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+  Json::Value decoded;
+  ASSERT_TRUE(S3MetadataRecord::decode(record, decoded));
+  EXPECT_EQ("not base64!", decoded["ACL"].asString());
+  EXPECT_EQ("", decoded["Policy"].asString());
+}
+
+TEST_F(S3MetadataRecordTest, CorruptedRecordRejected) {
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+  Json::Value decoded;
+
+  for (size_t len = 1; len < record.length(); ++len) {
+    EXPECT_FALSE(S3MetadataRecord::decode(record.substr(0, len), decoded));
+  }
+  EXPECT_FALSE(S3MetadataRecord::decode(record + "x", decoded));
+  // Key index beyond the table
+  std::string unknown_key = {(char)S3MetadataRecord::format_tag_v1, 1,
+                             (char)0x7F, 0};
+  EXPECT_FALSE(S3MetadataRecord::decode(unknown_key, decoded));
+}
+
+TEST_F(S3MetadataRecordTest, ReadFields) {
+  root["layout_id"] = -9;
+  root["User-Defined"]["Bucket-Name"] = "not this one";
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+
+  std::string bucket_name, content_length, layout_id, acl;
+  auto select = [&](const std::string* p_object_key,
+                    const std::string& key) -> std::string* {
+    if (!p_object_key) {
+      if (key == "Bucket-Name") {
+        return &bucket_name;
+      } else if (key == "layout_id") {
+        return &layout_id;
+      } else if (key == "ACL") {
+        return &acl;
+      }
+    } else if (*p_object_key == "System-Defined" && key == "Content-Length") {
+      return &content_length;
+    }
+    return nullptr;
+  };
+  ASSERT_TRUE(S3MetadataRecord::read_fields(record, select));
+  EXPECT_EQ("seagatebucket", bucket_name);
+  EXPECT_EQ("1024", content_length);
+  EXPECT_EQ("-9", layout_id);
+  EXPECT_EQ(root["ACL"].asString(), acl);
+
+  for (size_t len = 1; len < record.length(); ++len) {
+    EXPECT_FALSE(S3MetadataRecord::read_fields(record.substr(0, len), select));
+  }
+  EXPECT_FALSE(S3MetadataRecord::read_fields(record + "x", select));
+}
+
+TEST_F(S3MetadataRecordTest, SerializeFollowsOption) {
+  Json::FastWriter fastWriter;
+  EXPECT_EQ(fastWriter.write(root), S3MetadataRecord::serialize(root));
+
+  S3Option::get_instance()->set_metadata_binary_format(true);
+  EXPECT_TRUE(S3MetadataRecord::is_binary(S3MetadataRecord::serialize(root)));
+
+  // Arrays are not supported by the binary format
+  root["list"].append("item");
+  EXPECT_EQ(fastWriter.write(root), S3MetadataRecord::serialize(root));
+}
+
+TEST_F(S3MetadataRecordTest, ParseBothFormats) {
+  Json::FastWriter fastWriter;
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+
+  Json::Value parsed;
+  ASSERT_TRUE(S3MetadataRecord::parse(fastWriter.write(root), parsed));
+  EXPECT_EQ(root, parsed);
+  ASSERT_TRUE(S3MetadataRecord::parse(record, parsed));
+  EXPECT_EQ(root, parsed);
+  EXPECT_FALSE(S3MetadataRecord::parse("{\"Bucket-Name\":", parsed));
+}
+
+TEST_F(S3MetadataRecordTest, ToJson) {
+  Json::FastWriter fastWriter;
+  const std::string json = fastWriter.write(root);
+  std::string record;
+  ASSERT_TRUE(S3MetadataRecord::encode(root, record));
+
+  EXPECT_EQ(json, S3MetadataRecord::to_json(record));
+  EXPECT_EQ(json, S3MetadataRecord::to_json(json));
+  const std::string truncated = record.substr(0, 5);
+  EXPECT_EQ(truncated, S3MetadataRecord::to_json(truncated));
+}
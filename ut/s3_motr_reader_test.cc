@@ -503,3 +503,50 @@ TEST_F(S3MotrReaderTest, OpenObjectSuccessTest) {
   motr_reader_ptr->open_object_successful();
   EXPECT_TRUE(motr_reader_ptr->is_object_opened);
 }
+
+TEST_F(S3MotrReaderTest, ReadAheadObjectDataHandedOutInOrder) {
+  S3CallBack s3motrreader_callbackobj;
+  size_t motr_unit_size =
+      S3MotrLayoutMap::get_instance()->get_unit_size_for_layout(layout_id);
+
+  motr_reader_ptr->obj_ctx = (struct s3_motr_obj_context *)calloc(
+      1, sizeof(struct s3_motr_obj_context));
+  motr_reader_ptr->obj_ctx->objs =
+      (struct m0_obj *)calloc(1, sizeof(struct m0_obj));
+  motr_reader_ptr->obj_ctx->obj_count = 1;
+  motr_reader_ptr->obj_ctx->n_initialized_contexts = 1;
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_op(_, _, _, _, _, _, _, _))
+      .WillRepeatedly(Invoke(s3_test_motr_obj_op));
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_fini(_)).Times(1);
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_setup(_, _, _)).Times(2);
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_launch(_, _, _, _))
+      .WillRepeatedly(Invoke(s3_test_motr_op_launch));
+
+  // Not opened yet, nothing to read ahead of
+  EXPECT_FALSE(motr_reader_ptr->read_ahead_object_data(1));
+  motr_reader_ptr->is_object_opened = true;
+
+  // Completes right away, kept until asked for
+  EXPECT_TRUE(motr_reader_ptr->read_ahead_object_data(1));
+  EXPECT_EQ(0u, motr_reader_ptr->get_read_ahead_in_flight());
+  EXPECT_EQ(1u, motr_reader_ptr->reads_ahead.size());
+  EXPECT_EQ(motr_unit_size, motr_reader_ptr->get_last_index());
+
+  motr_reader_ptr->read_object_data(
+      1, std::bind(&S3CallBack::on_success, &s3motrreader_callbackobj),
+      std::bind(&S3CallBack::on_failed, &s3motrreader_callbackobj));
+
+  EXPECT_TRUE(s3motrreader_callbackobj.success_called);
+  EXPECT_FALSE(s3motrreader_callbackobj.fail_called);
+  EXPECT_TRUE(motr_reader_ptr->reads_ahead.empty());
+  EXPECT_TRUE(motr_reader_ptr->get_state() == S3MotrReaderOpState::success);
+
+  // No read ahead left, next read is launched as usual
+  s3motrreader_callbackobj.success_called = false;
+  motr_reader_ptr->read_object_data(
+      1, std::bind(&S3CallBack::on_success, &s3motrreader_callbackobj),
+      std::bind(&S3CallBack::on_failed, &s3motrreader_callbackobj));
+
+  EXPECT_TRUE(s3motrreader_callbackobj.success_called);
+  EXPECT_EQ(2 * motr_unit_size, motr_reader_ptr->get_last_index());
+}
@@ -18,20 +18,26 @@
  *
  */
 
+#include <event2/thread.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "mock_s3_factory.h"
 #include "mock_s3_motr_wrapper.h"
 #include "mock_s3_request_object.h"
 #include "s3_async_buffer_opt.h"
 #include "s3_callback_test_helpers.h"
+#include "s3_hash_workers.h"
 #include "s3_motr_layout.h"
 #include "s3_motr_writer.h"
 
 using ::testing::_;
+using ::testing::An;
+using ::testing::InvokeArgument;
 using ::testing::Return;
 using ::testing::Invoke;
 using ::testing::AtLeast;
+using ::testing::AtMost;
 using ::testing::StrNe;
 
 extern S3Option *g_option_instance;
@@ -117,6 +123,17 @@ class S3MotrWiterTest : public testing::Test {
     obj_oid = {0xffff, 0xffff};
     layout_id =
         S3MotrLayoutMap::get_instance()->get_best_layout_for_object_size();
+    kvs_reader_factory = std::make_shared<MockS3MotrKVSReaderFactory>(
+        request_mock, s3_motr_api_mock);
+  }
+
+  // Deletion looks up data refs first, none of the objects is shared
+  void expect_no_shared_data() {
+    EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+                get_keyval(_, An<const std::vector<std::string> &>(), _, _))
+        .WillOnce(InvokeArgument<3>());
+    EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+        .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
   }
 
   ~S3MotrWiterTest() { event_base_free(evbase); }
@@ -142,6 +159,7 @@ class S3MotrWiterTest : public testing::Test {
   std::shared_ptr<MockS3RequestObject> request_mock;
   std::shared_ptr<MockS3Motr> s3_motr_api_mock;
   std::shared_ptr<S3MotrWiter> motr_writer_ptr;
+  std::shared_ptr<MockS3MotrKVSReaderFactory> kvs_reader_factory;
 
   std::shared_ptr<S3AsyncBufferOptContainer> buffer;
   std::string fourk_buffer;
@@ -245,6 +263,8 @@ TEST_F(S3MotrWiterTest, DeleteObjectSuccessfulTest) {
 
   motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
                                                   0, s3_motr_api_mock);
+  motr_writer_ptr->motr_kvs_reader_factory = kvs_reader_factory;
+  expect_no_shared_data();
 
   EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _));
   EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
@@ -272,6 +292,8 @@ TEST_F(S3MotrWiterTest, DeleteObjectFailedTest) {
 
   motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
                                                   0, s3_motr_api_mock);
+  motr_writer_ptr->motr_kvs_reader_factory = kvs_reader_factory;
+  expect_no_shared_data();
 
   EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _));
   EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
@@ -306,6 +328,8 @@ TEST_F(S3MotrWiterTest, DeleteObjectmotrEntityDeleteFailedTest) {
 
   motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
                                                   0, s3_motr_api_mock);
+  motr_writer_ptr->motr_kvs_reader_factory = kvs_reader_factory;
+  expect_no_shared_data();
 
   EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _)).Times(oids.size());
   EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
@@ -344,6 +368,8 @@ TEST_F(S3MotrWiterTest, DeleteObjectsSuccessfulTest) {
 
   motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
                                                   0, s3_motr_api_mock);
+  motr_writer_ptr->motr_kvs_reader_factory = kvs_reader_factory;
+  expect_no_shared_data();
 
   EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _)).Times(oids.size());
   EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
@@ -382,6 +408,8 @@ TEST_F(S3MotrWiterTest, DeleteObjectsFailedTest) {
 
   motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
                                                   0, s3_motr_api_mock);
+  motr_writer_ptr->motr_kvs_reader_factory = kvs_reader_factory;
+  expect_no_shared_data();
 
   EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _)).Times(oids.size());
   EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
@@ -932,6 +960,119 @@ TEST_F(S3MotrWiterTest, WriteContentSuccessfulTest1M) {
   EXPECT_FALSE(S3MotrWiter_callbackobj.fail_called);
 }
 
+TEST_F(S3MotrWiterTest, WriteContentCalculatesPiOnHashWorkers) {
+  S3CallBack S3MotrWiter_callbackobj;
+  int no_of_fourkbuffs =
+      1048576 / g_option_instance->get_libevent_pool_buffer_size();
+
+  // Workers post completions from their own threads
+  evthread_use_pthreads();
+  evbase_t *pi_evbase = event_base_new();
+  S3HashWorkers::create_instance(1, 16, 1024);
+  S3Option::get_instance()->set_reactor_eventbase(pi_evbase);
+
+  motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
+                                                  0, s3_motr_api_mock);
+  motr_writer_ptr->set_layout_id(layout_id);
+
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _));
+  EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
+      .WillOnce(Invoke(s3_test_allocate_op));
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_op(_, _, _, _, _, _, _, _))
+      .WillOnce(Invoke(s3_test_motr_obj_op));
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_setup(_, _, _)).Times(2);
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_launch(_, _, _, _))
+      .WillRepeatedly(Invoke(s3_test_motr_op_launch));
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_fini(_)).Times(1);
+  EXPECT_CALL(*s3_motr_api_mock, motr_client_calculate_pi(_, _, _, _, _, _))
+      .WillOnce(Return(0));
+
+  S3Option::get_instance()->set_eventbase(evbase);
+
+  for (int i = 0; i < no_of_fourkbuffs; i++) {
+    buffer->add_content(get_evbuf_t_with_data(fourk_buffer), false,
+                        i == no_of_fourkbuffs - 1, true);
+  }
+  buffer->freeze();
+
+  motr_writer_ptr->write_content(
+      std::bind(&S3CallBack::on_success, &S3MotrWiter_callbackobj),
+      std::bind(&S3CallBack::on_failed, &S3MotrWiter_callbackobj),
+      buffer->get_buffers(buffer->get_content_length()),
+      buffer->size_of_each_evbuf);
+
+  // Write is launched once PI is posted back to the event loop
+  EXPECT_EQ(1u, motr_writer_ptr->get_writes_in_flight());
+  while (!S3MotrWiter_callbackobj.success_called &&
+         !S3MotrWiter_callbackobj.fail_called) {
+    event_base_loop(pi_evbase, EVLOOP_ONCE);
+  }
+  S3Option::get_instance()->set_reactor_eventbase(NULL);
+  S3HashWorkers::destroy_instance();
+  event_base_free(pi_evbase);
+
+  EXPECT_TRUE(motr_writer_ptr->get_state() == S3MotrWiterOpState::saved);
+  EXPECT_EQ(1048576u, motr_writer_ptr->size_in_current_write);
+  EXPECT_TRUE(S3MotrWiter_callbackobj.success_called);
+  EXPECT_FALSE(S3MotrWiter_callbackobj.fail_called);
+}
+
+TEST_F(S3MotrWiterTest, WriterGoneWhilePiIsCalculated) {
+  S3CallBack S3MotrWiter_callbackobj;
+  int no_of_fourkbuffs =
+      1048576 / g_option_instance->get_libevent_pool_buffer_size();
+  bool released = false;
+
+  evthread_use_pthreads();
+  evbase_t *pi_evbase = event_base_new();
+  S3HashWorkers::create_instance(1, 16, 1024);
+  S3Option::get_instance()->set_reactor_eventbase(pi_evbase);
+
+  motr_writer_ptr = std::make_shared<S3MotrWiter>(request_mock, obj_oid, pv_id,
+                                                  0, s3_motr_api_mock);
+  motr_writer_ptr->set_layout_id(layout_id);
+
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_init(_, _, _, _));
+  EXPECT_CALL(*s3_motr_api_mock, motr_entity_open(_, _))
+      .WillOnce(Invoke(s3_test_allocate_op));
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_op(_, _, _, _, _, _, _, _)).Times(0);
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_setup(_, _, _)).Times(1);
+  EXPECT_CALL(*s3_motr_api_mock, motr_op_launch(_, _, _, _))
+      .WillRepeatedly(Invoke(s3_test_motr_op_launch));
+  EXPECT_CALL(*s3_motr_api_mock, motr_obj_fini(_)).Times(1);
+  EXPECT_CALL(*s3_motr_api_mock, motr_client_calculate_pi(_, _, _, _, _, _))
+      .Times(AtMost(1))
+      .WillRepeatedly(Return(0));
+
+  S3Option::get_instance()->set_eventbase(evbase);
+
+  for (int i = 0; i < no_of_fourkbuffs; i++) {
+    buffer->add_content(get_evbuf_t_with_data(fourk_buffer), false,
+                        i == no_of_fourkbuffs - 1, true);
+  }
+  buffer->freeze();
+
+  motr_writer_ptr->write_content(
+      std::bind(&S3CallBack::on_success, &S3MotrWiter_callbackobj),
+      std::bind(&S3CallBack::on_failed, &S3MotrWiter_callbackobj),
+      buffer->get_buffers(buffer->get_content_length()),
+      buffer->size_of_each_evbuf);
+  motr_writer_ptr->release_after_pi([&released]() { released = true; });
+  EXPECT_FALSE(released);
+
+  // Doesn't wait for the worker
+  motr_writer_ptr.reset();
+  while (!released) {
+    event_base_loop(pi_evbase, EVLOOP_ONCE);
+  }
+  S3Option::get_instance()->set_reactor_eventbase(NULL);
+  S3HashWorkers::destroy_instance();
+  event_base_free(pi_evbase);
+
+  EXPECT_FALSE(S3MotrWiter_callbackobj.success_called);
+  EXPECT_FALSE(S3MotrWiter_callbackobj.fail_called);
+}
+
 TEST_F(S3MotrWiterTest, WriteContentFailedTest) {
   S3CallBack S3MotrWiter_callbackobj;
   bool is_last_buf = true;
@@ -189,18 +189,29 @@ TEST_F(S3ObjectAPIHandlerTest, ShouldCreateS3PostMultipartObjectAction) {
   S3Option::get_instance()->disable_murmurhash_oid();
 }
 
-TEST_F(S3ObjectAPIHandlerTest, DoesNotSupportCopyPart) {
+TEST_F(S3ObjectAPIHandlerTest, ShouldCreateS3PutMultiObjectActionForCopyPart) {
   // Creation handler per test as it will be specific
+  std::map<std::string, std::string> input_headers;
+  input_headers["Authorization"] = "1";
+  EXPECT_CALL(*mock_request, get_in_headers_copy()).Times(1).WillOnce(
+      ReturnRef(input_headers));
   handler_under_test.reset(
       new S3ObjectAPIHandler(mock_request, S3OperationCode::multipart));
 
   EXPECT_CALL(*(mock_request), http_verb()).WillOnce(Return(S3HttpVerb::PUT));
   EXPECT_CALL(*(mock_request), get_header_value(StrEq("x-amz-copy-source")))
       .WillOnce(Return("someobj"));
+  EXPECT_CALL(*(mock_request), get_headers_copysource())
+      .WillRepeatedly(Return("/srcbucket/someobj"));
+  EXPECT_CALL(*(mock_request), get_query_string_value(_))
+      .WillRepeatedly(Return("123"));
+  EXPECT_CALL(*(mock_request), is_chunked()).WillRepeatedly(Return(false));
 
   handler_under_test->create_action();
 
-  EXPECT_TRUE(handler_under_test->_get_action() == nullptr);
+  EXPECT_FALSE((dynamic_cast<S3PutMultiObjectAction *>(
+                   handler_under_test->_get_action().get())) == nullptr);
+  handler_under_test->_get_action()->i_am_done();
 }
 
 TEST_F(S3ObjectAPIHandlerTest, ShouldCreateS3PutMultiObjectAction) {
@@ -54,6 +54,8 @@ class S3ObjectDataCopierTest : public testing::Test {
   bool f_success;
   bool f_failed;
 
+  void add_data_read();
+
  public:
   void on_success_cb();
   void on_failed_cb();
@@ -104,14 +106,125 @@ void S3ObjectDataCopierTest::SetUp() {
   entity_under_test->check_shutdown_and_rollback = &fn_false_cb;
 
   entity_under_test->bytes_left_to_read = 1024;
+  entity_under_test->bytes_left_to_launch = 1024;
+  entity_under_test->bytes_to_skip = 0;
+  entity_under_test->bytes_left_to_write = 1024;
+  entity_under_test->data_shift = 0;
+  entity_under_test->copy_window = 2;
   entity_under_test->copy_failed = false;
   entity_under_test->read_in_progress = false;
-  entity_under_test->write_in_progress = false;
+  entity_under_test->read_ahead_draining = false;
+  entity_under_test->in_continue_copy = false;
+  entity_under_test->continue_copy_again = false;
 
   f_success = false;
   f_failed = false;
 }
 
+void S3ObjectDataCopierTest::add_data_read() {
+  S3ObjectDataCopier::DataRead chunk;
+  chunk.blocks.emplace_back(nullptr, entity_under_test->size_of_ev_buffer);
+  chunk.p_evbuffer = evbuffer_new();
+  entity_under_test->data_read.push_back(std::move(chunk));
+}
+
+TEST_F(S3ObjectDataCopierTest, CopyStartsWithOneRead) {
+  const size_t chunk_size =
+      S3Option::get_instance()->get_motr_units_per_request() *
+      entity_under_test->motr_unit_size;
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              set_last_index(0)).Times(1);
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_object_data(_, _, _))
+      .Times(1)
+      .WillOnce(Return(true));
+  // Object is not open until the first read completes
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_ahead_object_data(_))
+      .Times(1)
+      .WillOnce(Return(false));
+
+  entity_under_test->copy(oid, chunk_size * 3, 1, {}, &fn_false_cb,
+                          std::bind(&S3ObjectDataCopierTest::on_success_cb,
+                                    this),
+                          std::bind(&S3ObjectDataCopierTest::on_failed_cb,
+                                    this));
+
+  EXPECT_TRUE(entity_under_test->read_in_progress);
+  EXPECT_TRUE(entity_under_test->read_ahead_blocks.empty());
+  EXPECT_EQ(chunk_size * 2, entity_under_test->bytes_left_to_launch);
+  EXPECT_FALSE(f_success);
+  EXPECT_FALSE(f_failed);
+}
+
+TEST_F(S3ObjectDataCopierTest, CopyRangeStartsAtUnitOfFirstByte) {
+  const size_t unit_size = entity_under_test->motr_unit_size;
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              set_last_index(unit_size)).Times(1);
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_object_data(_, _, _))
+      .Times(1)
+      .WillOnce(Return(true));
+
+  entity_under_test->copy_range(
+      oid, unit_size + 10, unit_size * 3 - 1, 1, {}, &fn_false_cb,
+      std::bind(&S3ObjectDataCopierTest::on_success_cb, this),
+      std::bind(&S3ObjectDataCopierTest::on_failed_cb, this));
+
+  EXPECT_TRUE(entity_under_test->read_in_progress);
+  EXPECT_EQ(unit_size * 2, entity_under_test->bytes_left_to_read);
+  EXPECT_EQ(10u, entity_under_test->bytes_to_skip);
+  EXPECT_EQ(unit_size * 2 - 10, entity_under_test->bytes_left_to_write);
+}
+
+TEST_F(S3ObjectDataCopierTest, TakeRangeDataDropsWholeBuffers) {
+  std::string data = "abcdefghijkl";
+  S3BufferSequence blocks = {
+      {&data[0], 4}, {&data[4], 4}, {&data[8], 4}};
+
+  entity_under_test->size_of_ev_buffer = 4;
+  entity_under_test->bytes_to_skip = 4;
+  entity_under_test->bytes_left_to_write = 5;
+
+  entity_under_test->take_range_data(blocks, false);
+
+  ASSERT_EQ(2u, blocks.size());
+  EXPECT_EQ(&data[4], blocks[0].first);
+  EXPECT_EQ(4u, blocks[0].second);
+  EXPECT_EQ(&data[8], blocks[1].first);
+  EXPECT_EQ(1u, blocks[1].second);
+  EXPECT_EQ(0u, entity_under_test->data_shift);
+  EXPECT_EQ(0u, entity_under_test->bytes_left_to_write);
+}
+
+TEST_F(S3ObjectDataCopierTest, TakeRangeDataShiftsData) {
+  std::string chunk1 = "abcdefgh";
+  std::string chunk2 = "ijklmnop";
+  S3BufferSequence blocks1 = {{&chunk1[0], 4}, {&chunk1[4], 4}};
+  S3BufferSequence blocks2 = {{&chunk2[0], 4}, {&chunk2[4], 4}};
+
+  entity_under_test->size_of_ev_buffer = 4;
+  entity_under_test->bytes_to_skip = 5;
+  entity_under_test->bytes_left_to_write = 9;
+
+  // Range starts in the last buffer of the first chunk
+  entity_under_test->take_range_data(blocks1, false);
+  EXPECT_TRUE(blocks1.empty());
+  EXPECT_EQ(1u, entity_under_test->data_shift);
+
+  entity_under_test->take_range_data(blocks2, true);
+  std::string written;
+  for (const auto& block : blocks2) {
+    written.append((const char*)block.first, block.second);
+  }
+  EXPECT_EQ("fghijklmn", written);
+  ASSERT_EQ(3u, blocks2.size());
+  EXPECT_EQ(4u, blocks2[1].second);
+  EXPECT_EQ(0u, entity_under_test->bytes_left_to_write);
+}
+
 TEST_F(S3ObjectDataCopierTest, ReadDataBlockStarted) {
 
   EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
@@ -122,6 +235,23 @@ TEST_F(S3ObjectDataCopierTest, ReadDataBlockStarted) {
   entity_under_test->read_data_block();
 
   EXPECT_TRUE(entity_under_test->read_in_progress);
+  EXPECT_EQ(0u, entity_under_test->bytes_left_to_launch);
+}
+
+TEST_F(S3ObjectDataCopierTest, ReadDataBlockTakesReadAhead) {
+
+  entity_under_test->bytes_left_to_launch = 0;
+  entity_under_test->read_ahead_blocks.push_back(3);
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_object_data(3, _, _))
+      .Times(1)
+      .WillOnce(Return(true));
+
+  entity_under_test->read_data_block();
+
+  EXPECT_TRUE(entity_under_test->read_in_progress);
+  EXPECT_TRUE(entity_under_test->read_ahead_blocks.empty());
 }
 
 TEST_F(S3ObjectDataCopierTest, ReadDataBlockFailedToStart) {
@@ -166,6 +296,7 @@ TEST_F(S3ObjectDataCopierTest, ReadDataBlockSuccessCopyFailed) {
 
 TEST_F(S3ObjectDataCopierTest, ReadDataBlockSuccessShouldStartWrite) {
   entity_under_test->read_in_progress = true;
+  entity_under_test->bytes_left_to_launch = 0;
 
   S3BufferSequence data_blocks_read;
   data_blocks_read.emplace_back(nullptr, entity_under_test->size_of_ev_buffer);
@@ -187,7 +318,70 @@ TEST_F(S3ObjectDataCopierTest, ReadDataBlockSuccessShouldStartWrite) {
 
   entity_under_test->read_data_block_success();
 
-  EXPECT_TRUE(entity_under_test->write_in_progress);
+  EXPECT_EQ(1u, entity_under_test->evbuffers_written.size());
+  EXPECT_TRUE(entity_under_test->data_read.empty());
+  EXPECT_FALSE(f_success);
+}
+
+TEST_F(S3ObjectDataCopierTest, ReadDataBlockSuccessReadsAheadInWindow) {
+  const size_t blocks_per_read =
+      S3Option::get_instance()->get_motr_units_per_request();
+  const size_t chunk_size =
+      blocks_per_read * entity_under_test->motr_unit_size;
+
+  entity_under_test->copy_window = 4;
+  entity_under_test->read_in_progress = true;
+  entity_under_test->bytes_left_to_read = chunk_size * 10;
+  entity_under_test->bytes_left_to_launch = chunk_size * 9;
+
+  S3BufferSequence data_blocks_read;
+  data_blocks_read.emplace_back(nullptr, entity_under_test->size_of_ev_buffer);
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              extract_blocks_read())
+      .Times(1)
+      .WillOnce(Return(data_blocks_read));
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              get_evbuffer_ownership())
+      .Times(1)
+      .WillOnce(Return(evbuffer_new()));
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer,
+              write_content(_, _, _, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer, get_state())
+      .WillRepeatedly(Return(S3MotrWiterOpState::writing));
+  // One write and one read are in flight, the rest of the window is read
+  // ahead
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_object_data(blocks_per_read, _, _))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_ahead_object_data(blocks_per_read))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  entity_under_test->read_data_block_success();
+
+  EXPECT_TRUE(entity_under_test->read_in_progress);
+  EXPECT_EQ(2u, entity_under_test->read_ahead_blocks.size());
+  EXPECT_EQ(1u, entity_under_test->evbuffers_written.size());
+  EXPECT_EQ(chunk_size * 6, entity_under_test->bytes_left_to_launch);
+  EXPECT_EQ(4u, entity_under_test->get_chunks_in_flight());
+}
+
+TEST_F(S3ObjectDataCopierTest, ReadAheadStopsWhenReaderRefuses) {
+  entity_under_test->copy_window = 4;
+  entity_under_test->read_in_progress = true;
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              read_ahead_object_data(_))
+      .Times(1)
+      .WillOnce(Return(false));
+
+  entity_under_test->read_ahead();
+
+  EXPECT_TRUE(entity_under_test->read_ahead_blocks.empty());
+  EXPECT_EQ(1024u, entity_under_test->bytes_left_to_launch);
 }
 
 TEST_F(S3ObjectDataCopierTest, ReadDataBlockFailed) {
@@ -205,10 +399,33 @@ TEST_F(S3ObjectDataCopierTest, ReadDataBlockFailed) {
   EXPECT_TRUE(f_failed);
 }
 
+TEST_F(S3ObjectDataCopierTest, ReadDataBlockFailedDrainsReadAhead) {
+
+  entity_under_test->read_in_progress = true;
+  entity_under_test->read_ahead_blocks.push_back(1);
+  entity_under_test->read_ahead_blocks.push_back(1);
+
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader, get_state())
+      .Times(1)
+      .WillOnce(Return(S3MotrReaderOpState::failed));
+  EXPECT_CALL(*ptr_mock_motr_reader_factory->mock_motr_reader,
+              discard_read_ahead(_)).Times(1);
+
+  entity_under_test->read_data_block_failed();
+
+  EXPECT_TRUE(entity_under_test->read_ahead_draining);
+  EXPECT_TRUE(entity_under_test->read_ahead_blocks.empty());
+  EXPECT_FALSE(f_failed);
+
+  entity_under_test->read_ahead_drained();
+
+  EXPECT_STREQ("InternalError", entity_under_test->get_s3_error().c_str());
+  EXPECT_TRUE(f_failed);
+}
+
 TEST_F(S3ObjectDataCopierTest, WriteObjectStarted) {
 
-  entity_under_test->data_blocks_read.emplace_back(nullptr, 0);
-  entity_under_test->p_evbuffer_read = evbuffer_new();
+  add_data_read();
 
   EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer,
               write_content(_, _, _, _)).Times(1);
@@ -218,13 +435,35 @@ TEST_F(S3ObjectDataCopierTest, WriteObjectStarted) {
 
   entity_under_test->write_data_block();
 
-  EXPECT_TRUE(entity_under_test->write_in_progress);
-  EXPECT_TRUE(entity_under_test->data_blocks_read.empty());
+  EXPECT_EQ(1u, entity_under_test->evbuffers_written.size());
+  EXPECT_TRUE(entity_under_test->data_read.empty());
+}
+
+TEST_F(S3ObjectDataCopierTest, WritesArePipelinedWhileWriterAllows) {
+
+  entity_under_test->bytes_left_to_launch = 0;
+  add_data_read();
+  add_data_read();
+
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer,
+              write_content(_, _, _, _)).Times(2);
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer, get_state())
+      .WillRepeatedly(Return(S3MotrWiterOpState::writing));
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer,
+              can_pipeline_write())
+      .Times(1)
+      .WillOnce(Return(true));
+
+  entity_under_test->continue_copy();
+
+  EXPECT_EQ(2u, entity_under_test->evbuffers_written.size());
+  EXPECT_TRUE(entity_under_test->data_read.empty());
+  EXPECT_FALSE(f_success);
 }
 
 TEST_F(S3ObjectDataCopierTest, WriteObjectFailedShouldUndoMarkProgress) {
 
-  entity_under_test->write_in_progress = true;
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
 
   EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer, get_state())
       .Times(1)
@@ -233,13 +472,13 @@ TEST_F(S3ObjectDataCopierTest, WriteObjectFailedShouldUndoMarkProgress) {
   entity_under_test->write_data_block_failed();
 
   EXPECT_STREQ("InternalError", entity_under_test->get_s3_error().c_str());
-  EXPECT_FALSE(entity_under_test->write_in_progress);
+  EXPECT_TRUE(entity_under_test->evbuffers_written.empty());
   EXPECT_TRUE(f_failed);
 }
 
 TEST_F(S3ObjectDataCopierTest, WriteObjectFailedDuetoEntityOpenFailure) {
 
-  entity_under_test->write_in_progress = true;
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
 
   EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer, get_state())
       .Times(1)
@@ -247,28 +486,46 @@ TEST_F(S3ObjectDataCopierTest, WriteObjectFailedDuetoEntityOpenFailure) {
 
   entity_under_test->write_data_block_failed();
 
-  EXPECT_FALSE(entity_under_test->write_in_progress);
+  EXPECT_TRUE(entity_under_test->evbuffers_written.empty());
   EXPECT_STREQ("ServiceUnavailable", entity_under_test->get_s3_error().c_str());
   EXPECT_TRUE(f_failed);
 }
 
+TEST_F(S3ObjectDataCopierTest, WriteFailedWaitsForReadInFlight) {
+
+  entity_under_test->read_in_progress = true;
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
+
+  EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer, get_state())
+      .Times(1)
+      .WillOnce(Return(S3MotrWiterOpState::failed));
+
+  entity_under_test->write_data_block_failed();
+
+  EXPECT_TRUE(entity_under_test->copy_failed);
+  EXPECT_FALSE(f_failed);
+
+  entity_under_test->read_data_block_success();
+
+  EXPECT_TRUE(f_failed);
+}
+
 TEST_F(S3ObjectDataCopierTest, WriteObjectSuccessfulWhileShuttingDown) {
 
   entity_under_test->check_shutdown_and_rollback = &fn_true_cb;
-  entity_under_test->write_in_progress = true;
-  entity_under_test->p_evbuffer_write = evbuffer_new();
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
 
   entity_under_test->write_data_block_success();
 
-  EXPECT_FALSE(entity_under_test->write_in_progress);
+  EXPECT_TRUE(entity_under_test->evbuffers_written.empty());
+  EXPECT_FALSE(f_success);
 }
 
 TEST_F(S3ObjectDataCopierTest, WriteObjectSuccessfulShouldRestartWritingData) {
 
-  entity_under_test->write_in_progress = true;
-  entity_under_test->data_blocks_read.emplace_back(nullptr, 0);
-  entity_under_test->p_evbuffer_read = evbuffer_new();
-  entity_under_test->p_evbuffer_write = evbuffer_new();
+  entity_under_test->bytes_left_to_launch = 0;
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
+  add_data_read();
 
   EXPECT_CALL(*ptr_mock_motr_writer_factory->mock_motr_writer,
               write_content(_, _, _, _)).Times(1);
@@ -278,18 +535,19 @@ TEST_F(S3ObjectDataCopierTest, WriteObjectSuccessfulShouldRestartWritingData) {
 
   entity_under_test->write_data_block_success();
 
-  EXPECT_TRUE(entity_under_test->write_in_progress);
+  EXPECT_EQ(1u, entity_under_test->evbuffers_written.size());
+  EXPECT_TRUE(entity_under_test->data_read.empty());
 }
 
 TEST_F(S3ObjectDataCopierTest,
        WriteObjectSuccessfulDoNextStepWhenAllIsWritten) {
 
-  entity_under_test->write_in_progress = true;
   entity_under_test->bytes_left_to_read = 0;
-  entity_under_test->p_evbuffer_write = evbuffer_new();
+  entity_under_test->bytes_left_to_launch = 0;
+  entity_under_test->evbuffers_written.push_back(evbuffer_new());
 
   entity_under_test->write_data_block_success();
 
-  EXPECT_FALSE(entity_under_test->write_in_progress);
+  EXPECT_TRUE(entity_under_test->evbuffers_written.empty());
   EXPECT_TRUE(f_success);
 }
@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "mock_s3_factory.h"
+#include "mock_s3_motr_wrapper.h"
+#include "mock_s3_request_object.h"
+#include "s3_callback_test_helpers.h"
+#include "s3_m0_uint128_helper.h"
+#include "s3_object_data_refs.h"
+
+using ::testing::_;
+using ::testing::An;
+using ::testing::Matcher;
+using ::testing::Return;
+using ::testing::ReturnRef;
+using ::testing::SaveArg;
+using ::testing::UnorderedElementsAre;
+
+typedef std::map<std::string, std::string> KVMap;
+typedef std::map<std::string, std::pair<int, std::string>> KVResultMap;
+
+class S3ObjectDataRefsTest : public testing::Test {
+ protected:
+  S3ObjectDataRefsTest() {
+    evhtp_request_t *req = NULL;
+    EvhtpInterface *evhtp_obj_ptr = new EvhtpWrapper();
+    ptr_mock_request =
+        std::make_shared<MockS3RequestObject>(req, evhtp_obj_ptr);
+    ptr_mock_s3_motr_api = std::make_shared<MockS3Motr>();
+
+    kvs_reader_factory = std::make_shared<MockS3MotrKVSReaderFactory>(
+        ptr_mock_request, ptr_mock_s3_motr_api);
+    kvs_writer_factory = std::make_shared<MockS3MotrKVSWriterFactory>(
+        ptr_mock_request, ptr_mock_s3_motr_api);
+
+    data_oid = {0x1ffff, 0x1ffff};
+    other_oid = {0x2ffff, 0x2ffff};
+
+    source.object_list_index_layout.oid = {0x11ff, 0x11ff};
+    source.object_name = "source";
+    source.version_id = "source-version";
+    copy.object_list_index_layout.oid = {0x22ff, 0x22ff};
+    copy.object_name = "dir/copy";
+    copy.version_id = "copy-version";
+
+    data_refs.reset(new S3ObjectDataRefs(ptr_mock_request,
+                                         ptr_mock_s3_motr_api,
+                                         kvs_reader_factory,
+                                         kvs_writer_factory));
+  }
+
+  static std::string metadata_of(const struct m0_uint128 &oid,
+                                 const std::string &version_id) {
+    Json::Value root;
+    root["motr_oid"] = S3M0Uint128Helper::to_string(oid);
+    root["System-Defined"]["x-amz-version-id"] = version_id;
+
+    Json::FastWriter fastWriter;
+    return fastWriter.write(root);
+  }
+
+  void add() {
+    data_refs->add(data_oid, source, copy,
+                   std::bind(&S3CallBack::on_success, &callback),
+                   std::bind(&S3CallBack::on_failed, &callback));
+  }
+
+  void check(std::vector<struct m0_uint128> oids) {
+    data_refs->check(std::move(oids),
+                     std::bind(&S3CallBack::on_success, &callback));
+  }
+
+  std::shared_ptr<MockS3RequestObject> ptr_mock_request;
+  std::shared_ptr<MockS3Motr> ptr_mock_s3_motr_api;
+  std::shared_ptr<MockS3MotrKVSReaderFactory> kvs_reader_factory;
+  std::shared_ptr<MockS3MotrKVSWriterFactory> kvs_writer_factory;
+  std::unique_ptr<S3ObjectDataRefs> data_refs;
+
+  struct m0_uint128 data_oid;
+  struct m0_uint128 other_oid;
+  S3ObjectDataRefs::Ref source;
+  S3ObjectDataRefs::Ref copy;
+  S3CallBack callback;
+};
+
+TEST_F(S3ObjectDataRefsTest, RefKeysArePrefixedWithMarker) {
+  const std::string marker = S3ObjectDataRefs::get_marker_key(data_oid);
+  const std::string key = S3ObjectDataRefs::get_ref_key(data_oid, copy);
+
+  EXPECT_EQ(0, key.compare(0, marker.length() + 1, marker + '/'));
+  EXPECT_NE(key, S3ObjectDataRefs::get_ref_key(data_oid, source));
+  EXPECT_NE(key, S3ObjectDataRefs::get_ref_key(other_oid, copy));
+}
+
+TEST_F(S3ObjectDataRefsTest, RefToJsonAndBack) {
+  S3ObjectDataRefs::Ref ref;
+  time_t create_time = 0;
+
+  ASSERT_TRUE(S3ObjectDataRefs::ref_from_json(
+      S3ObjectDataRefs::ref_to_json(copy, 1600000000), ref, create_time));
+  EXPECT_EQ(copy.object_name, ref.object_name);
+  EXPECT_EQ(copy.version_id, ref.version_id);
+  EXPECT_EQ(copy.object_list_index_layout.oid.u_hi,
+            ref.object_list_index_layout.oid.u_hi);
+  EXPECT_EQ(copy.object_list_index_layout.oid.u_lo,
+            ref.object_list_index_layout.oid.u_lo);
+  EXPECT_EQ(1600000000, create_time);
+
+  EXPECT_FALSE(S3ObjectDataRefs::ref_from_json("not json", ref, create_time));
+  EXPECT_FALSE(S3ObjectDataRefs::ref_from_json("{}", ref, create_time));
+}
+
+TEST_F(S3ObjectDataRefsTest, IsRefLive) {
+  EXPECT_TRUE(S3ObjectDataRefs::is_ref_live(
+      metadata_of(data_oid, "copy-version"), data_oid, copy));
+  // Overwritten object
+  EXPECT_FALSE(S3ObjectDataRefs::is_ref_live(
+      metadata_of(other_oid, "new-version"), data_oid, copy));
+  // Same data copied again onto the same name
+  EXPECT_FALSE(S3ObjectDataRefs::is_ref_live(
+      metadata_of(data_oid, "new-version"), data_oid, copy));
+  EXPECT_FALSE(S3ObjectDataRefs::is_ref_live("garbage", data_oid, copy));
+}
+
+TEST_F(S3ObjectDataRefsTest, AddPutsMarkerAndBothRefs) {
+  KVMap kvs;
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const KVMap &>(), _, _))
+      .WillOnce(SaveArg<1>(&kvs));
+  add();
+
+  EXPECT_EQ(3u, kvs.size());
+  EXPECT_EQ(1u, kvs.count(S3ObjectDataRefs::get_marker_key(data_oid)));
+  EXPECT_EQ(1u, kvs.count(S3ObjectDataRefs::get_ref_key(data_oid, source)));
+  EXPECT_EQ(1u, kvs.count(S3ObjectDataRefs::get_ref_key(data_oid, copy)));
+  EXPECT_FALSE(callback.success_called);
+  EXPECT_FALSE(callback.fail_called);
+}
+
+TEST_F(S3ObjectDataRefsTest, AddSucceedsWhenSourceIsUnchanged) {
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const KVMap &>(), _, _))
+      .Times(1);
+  add();
+
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::string &>(), _, _))
+      .Times(1);
+  data_refs->add_refs_successful();
+
+  const std::string metadata = metadata_of(data_oid, "source-version");
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_value())
+      .WillOnce(ReturnRef(metadata));
+  data_refs->verify_source_successful();
+
+  EXPECT_EQ(S3ObjectDataRefsOpState::added, data_refs->get_state());
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_FALSE(callback.fail_called);
+}
+
+TEST_F(S3ObjectDataRefsTest, AddFailsWhenSourceChanged) {
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const KVMap &>(), _, _))
+      .Times(1);
+  add();
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::string &>(), _, _))
+      .Times(1);
+  data_refs->add_refs_successful();
+
+  std::vector<std::string> keys;
+  const std::string metadata = metadata_of(other_oid, "new-version");
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_value())
+      .WillOnce(ReturnRef(metadata));
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              delete_keyval(_, _, _, _))
+      .WillOnce(SaveArg<1>(&keys));
+  data_refs->verify_source_successful();
+
+  // Both refs which were added are removed, the marker stays
+  EXPECT_THAT(keys,
+              UnorderedElementsAre(
+                  S3ObjectDataRefs::get_ref_key(data_oid, source),
+                  S3ObjectDataRefs::get_ref_key(data_oid, copy)));
+  EXPECT_FALSE(callback.fail_called);
+  data_refs->added_refs_removed();
+
+  EXPECT_EQ(S3ObjectDataRefsOpState::source_changed, data_refs->get_state());
+  EXPECT_FALSE(callback.success_called);
+  EXPECT_TRUE(callback.fail_called);
+}
+
+TEST_F(S3ObjectDataRefsTest, AddFailsWhenSourceMissing) {
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const KVMap &>(), _, _))
+      .Times(1);
+  add();
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::string &>(), _, _))
+      .Times(1);
+  data_refs->add_refs_successful();
+
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              delete_keyval(_, _, _, _))
+      .Times(1);
+  data_refs->verify_source_failed();
+  data_refs->added_refs_removed();
+
+  EXPECT_EQ(S3ObjectDataRefsOpState::source_missing, data_refs->get_state());
+  EXPECT_TRUE(callback.fail_called);
+}
+
+TEST_F(S3ObjectDataRefsTest, AddFailureKeepsRefsOnLookupError) {
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              put_keyval(_, An<const KVMap &>(), _, _))
+      .Times(1);
+  add();
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::string &>(), _, _))
+      .Times(1);
+  data_refs->add_refs_successful();
+
+  // Source may still be live, its ref must stay
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::failed));
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              delete_keyval(_, _, _, _))
+      .Times(0);
+  data_refs->verify_source_failed();
+
+  EXPECT_EQ(S3ObjectDataRefsOpState::failed, data_refs->get_state());
+  EXPECT_TRUE(callback.fail_called);
+}
+
+TEST_F(S3ObjectDataRefsTest, CheckWithoutMarkersAllowsDeletion) {
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::vector<std::string> &>(), _, _))
+      .Times(1);
+  check({data_oid, other_oid});
+
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
+  data_refs->get_markers_failed();
+
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_EQ(S3ObjectDataState::unreferenced, data_refs->get_data_state(0));
+  EXPECT_EQ(S3ObjectDataState::unreferenced, data_refs->get_data_state(1));
+}
+
+TEST_F(S3ObjectDataRefsTest, CheckFailureKeepsAllData) {
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::vector<std::string> &>(), _, _))
+      .Times(1);
+  check({data_oid, other_oid});
+
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::failed));
+  data_refs->get_markers_failed();
+
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_EQ(S3ObjectDataState::unknown, data_refs->get_data_state(0));
+  EXPECT_EQ(S3ObjectDataState::unknown, data_refs->get_data_state(1));
+}
+
+TEST_F(S3ObjectDataRefsTest, CheckListsRefsOfSharedDataOnly) {
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::vector<std::string> &>(), _, _))
+      .Times(1);
+  check({other_oid, data_oid});
+
+  // Only data_oid is shared
+  KVResultMap markers;
+  markers[S3ObjectDataRefs::get_marker_key(other_oid)] =
+      std::make_pair(-ENOENT, "");
+  markers[S3ObjectDataRefs::get_marker_key(data_oid)] =
+      std::make_pair(0, "{}");
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_key_values())
+      .WillOnce(ReturnRef(markers));
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              next_keyval(_, S3ObjectDataRefs::get_marker_key(data_oid) + '/',
+                          _, _, _, _))
+      .Times(1);
+  data_refs->get_markers_successful();
+  EXPECT_EQ(1u, data_refs->check_index);
+
+  // Listing goes past references of data_oid
+  KVResultMap refs;
+  refs[S3ObjectDataRefs::get_ref_key(data_oid, copy)] =
+      std::make_pair(0, S3ObjectDataRefs::ref_to_json(copy, 0));
+  refs[S3ObjectDataRefs::get_marker_key(data_oid) + "0"] =
+      std::make_pair(0, S3ObjectDataRefs::ref_to_json(source, 0));
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_key_values())
+      .WillOnce(ReturnRef(refs));
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, Matcher<const std::string &>(copy.object_name),
+                         _, _))
+      .Times(1);
+  data_refs->list_refs_successful();
+  ASSERT_EQ(1u, data_refs->refs_found.size());
+
+  const std::string metadata = metadata_of(data_oid, "copy-version");
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_value())
+      .WillOnce(ReturnRef(metadata));
+  data_refs->verify_ref_successful();
+
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_EQ(S3ObjectDataState::unreferenced, data_refs->get_data_state(0));
+  EXPECT_EQ(S3ObjectDataState::referenced, data_refs->get_data_state(1));
+}
+
+TEST_F(S3ObjectDataRefsTest, CheckKeepsPendingRefs) {
+  data_refs->handler_on_success =
+      std::bind(&S3CallBack::on_success, &callback);
+  data_refs->oids_to_check = {data_oid};
+  data_refs->data_states = {S3ObjectDataState::referenced};
+
+  S3ObjectDataRefs::RefRecord stale = {
+      S3ObjectDataRefs::get_ref_key(data_oid, source), source,
+      time(nullptr) - S3ObjectDataRefs::pending_ref_timeout_sec - 1};
+  S3ObjectDataRefs::RefRecord pending = {
+      S3ObjectDataRefs::get_ref_key(data_oid, copy), copy, time(nullptr)};
+  data_refs->refs_found = {stale, pending};
+
+  // Neither object points to the data
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader,
+              get_keyval(_, An<const std::string &>(), _, _))
+      .Times(2);
+  EXPECT_CALL(*kvs_reader_factory->mock_motr_kvs_reader, get_state())
+      .WillRepeatedly(Return(S3MotrKVSReaderOpState::missing));
+  data_refs->verify_next_ref();
+  data_refs->verify_ref_failed();
+
+  // Only the stale reference is dropped, the marker stays
+  std::vector<std::string> dropped;
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              delete_keyval(_, _, _, _))
+      .WillOnce(SaveArg<1>(&dropped));
+  data_refs->verify_ref_failed();
+  ASSERT_EQ(1u, dropped.size());
+  EXPECT_EQ(stale.key, dropped[0]);
+  EXPECT_FALSE(callback.success_called);
+
+  data_refs->stale_refs_dropped();
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_EQ(S3ObjectDataState::unknown, data_refs->get_data_state(0));
+}
+
+TEST_F(S3ObjectDataRefsTest, CheckDropsMarkerOfUnreferencedData) {
+  data_refs->handler_on_success =
+      std::bind(&S3CallBack::on_success, &callback);
+  data_refs->oids_to_check = {data_oid};
+  data_refs->data_states = {S3ObjectDataState::referenced};
+
+  std::vector<std::string> dropped;
+  EXPECT_CALL(*kvs_writer_factory->mock_motr_kvs_writer,
+              delete_keyval(_, _, _, _))
+      .WillOnce(SaveArg<1>(&dropped));
+  // All references are gone
+  data_refs->verify_next_ref();
+  ASSERT_EQ(1u, dropped.size());
+  EXPECT_EQ(S3ObjectDataRefs::get_marker_key(data_oid), dropped[0]);
+
+  data_refs->stale_refs_dropped();
+  EXPECT_TRUE(callback.success_called);
+  EXPECT_EQ(S3ObjectDataState::unreferenced, data_refs->get_data_state(0));
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "s3_object_metadata_cache.h"
+
+TEST(S3ObjectMetadataCacheTest, InstanceIsSetForLifetime) {
+  EXPECT_EQ(nullptr, S3ObjectMetadataCache::get_instance());
+  {
+    S3ObjectMetadataCache object_metadata_cache(4, 30);
+    EXPECT_EQ(&object_metadata_cache, S3ObjectMetadataCache::get_instance());
+  }
+  EXPECT_EQ(nullptr, S3ObjectMetadataCache::get_instance());
+}
+
+TEST(S3ObjectMetadataCacheTest, KeyDependsOnIndexAndObject) {
+  EXPECT_NE(S3ObjectMetadataCache::make_key("index1", "obj"),
+            S3ObjectMetadataCache::make_key("index2", "obj"));
+  EXPECT_NE(S3ObjectMetadataCache::make_key("index", "a/b"),
+            S3ObjectMetadataCache::make_key("index/a", "b"));
+}
+
+TEST(S3ObjectMetadataCacheTest, DisabledCacheKeepsNothing) {
+  S3ObjectMetadataCache object_metadata_cache(0, 30);
+  std::string json;
+
+  EXPECT_FALSE(object_metadata_cache.is_enabled());
+  object_metadata_cache.put("key", "{}",
+                            object_metadata_cache.get_generation());
+  EXPECT_EQ(0u, object_metadata_cache.size());
+  EXPECT_FALSE(object_metadata_cache.get("key", json));
+}
+
+TEST(S3ObjectMetadataCacheTest, GetReturnsCachedJson) {
+  S3ObjectMetadataCache object_metadata_cache(4, 30);
+  std::string json;
+
+  EXPECT_FALSE(object_metadata_cache.get("key", json));
+  object_metadata_cache.put("key", "{}",
+                            object_metadata_cache.get_generation());
+  EXPECT_TRUE(object_metadata_cache.get("key", json));
+  EXPECT_EQ("{}", json);
+}
+
+TEST(S3ObjectMetadataCacheTest, ExpiredEntryIsDropped) {
+  S3ObjectMetadataCache object_metadata_cache(4, 0);
+  std::string json;
+
+  object_metadata_cache.put("key", "{}",
+                            object_metadata_cache.get_generation());
+  EXPECT_FALSE(object_metadata_cache.get("key", json));
+  EXPECT_EQ(0u, object_metadata_cache.size());
+}
+
+TEST(S3ObjectMetadataCacheTest, LeastRecentlyUsedIsEvicted) {
+  S3ObjectMetadataCache object_metadata_cache(2, 30);
+  const uint64_t generation = object_metadata_cache.get_generation();
+  std::string json;
+
+  object_metadata_cache.put("key1", "1", generation);
+  object_metadata_cache.put("key2", "2", generation);
+  EXPECT_TRUE(object_metadata_cache.get("key1", json));
+  object_metadata_cache.put("key3", "3", generation);
+
+  EXPECT_EQ(2u, object_metadata_cache.size());
+  EXPECT_TRUE(object_metadata_cache.get("key1", json));
+  EXPECT_FALSE(object_metadata_cache.get("key2", json));
+  EXPECT_TRUE(object_metadata_cache.get("key3", json));
+}
+
+TEST(S3ObjectMetadataCacheTest, InvalidateDropsEntry) {
+  S3ObjectMetadataCache object_metadata_cache(4, 30);
+  const uint64_t generation = object_metadata_cache.get_generation();
+  std::string json;
+
+  object_metadata_cache.put("key1", "1", generation);
+  object_metadata_cache.put("key2", "2", generation);
+
+  object_metadata_cache.invalidate("key1");
+  EXPECT_FALSE(object_metadata_cache.get("key1", json));
+  EXPECT_TRUE(object_metadata_cache.get("key2", json));
+}
+
+TEST(S3ObjectMetadataCacheTest, LoadRacingWithWriteIsNotCached) {
+  S3ObjectMetadataCache object_metadata_cache(4, 30);
+  std::string json;
+
+  // Load starts, the object is overwritten before the load has finished
+  const uint64_t generation = object_metadata_cache.get_generation();
+  object_metadata_cache.invalidate("key");
+
+  object_metadata_cache.put("key", "old", generation);
+  EXPECT_FALSE(object_metadata_cache.get("key", json));
+
+  object_metadata_cache.put("key", "new",
+                            object_metadata_cache.get_generation());
+  EXPECT_TRUE(object_metadata_cache.get("key", json));
+  EXPECT_EQ("new", json);
+}
@@ -25,7 +25,10 @@
 #include "mock_s3_request_object.h"
 #include "s3_callback_test_helpers.h"
 #include "s3_common.h"
+#include "s3_m0_uint128_helper.h"
+#include "s3_metadata_record.h"
 #include "s3_object_metadata.h"
+#include "s3_object_metadata_cache.h"
 #include "s3_test_utils.h"
 #include "s3_ut_common.h"
 
@@ -349,6 +352,54 @@ TEST_F(S3ObjectMetadataTest, LoadSuccessful) {
   EXPECT_TRUE(s3objectmetadata_callbackobj.success_called);
 }
 
+TEST_F(S3ObjectMetadataTest, LoadSuccessfulFillsCache) {
+  S3ObjectMetadataCache object_metadata_cache(4, 30);
+
+  metadata_obj_under_test->set_object_list_index_layout(
+      object_list_index_layout);
+  metadata_obj_under_test->motr_kv_reader =
+      motr_kvs_reader_factory->mock_motr_kvs_reader;
+  metadata_obj_under_test->handler_on_success =
+      std::bind(&S3CallBack::on_success, &s3objectmetadata_callbackobj);
+
+  std::string s_retval =
+      "{\"Bucket-Name\":\"seagate_bucket\",\"Object-Name\":\"objectname\"}";
+
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader), get_value())
+      .WillRepeatedly(ReturnRef(s_retval));
+  metadata_obj_under_test->requested_bucket_name = "seagate_bucket";
+  metadata_obj_under_test->requested_object_name = "objectname";
+
+  metadata_obj_under_test->load_successful();
+  EXPECT_TRUE(s3objectmetadata_callbackobj.success_called);
+
+  std::string json;
+  EXPECT_TRUE(object_metadata_cache.get(
+      metadata_obj_under_test->get_cache_key(), json));
+  EXPECT_EQ(s_retval, json);
+}
+
+TEST_F(S3ObjectMetadataTest, LoadFromCache) {
+  S3ObjectMetadataCache object_metadata_cache(4, 30);
+
+  EXPECT_CALL(*(motr_kvs_reader_factory->mock_motr_kvs_reader),
+              get_keyval(_, _, _, _)).Times(0);
+  metadata_obj_under_test->set_object_list_index_layout(
+      object_list_index_layout);
+
+  object_metadata_cache.put(
+      metadata_obj_under_test->get_cache_key(),
+      "{\"Bucket-Name\":\"seagate_bucket\",\"Object-Name\":\"objectname\"}",
+      object_metadata_cache.get_generation());
+
+  metadata_obj_under_test->load(
+      std::bind(&S3CallBack::on_success, &s3objectmetadata_callbackobj),
+      std::bind(&S3CallBack::on_failed, &s3objectmetadata_callbackobj));
+
+  EXPECT_EQ(metadata_obj_under_test->state, S3ObjectMetadataState::present);
+  EXPECT_TRUE(s3objectmetadata_callbackobj.success_called);
+}
+
 TEST_F(S3ObjectMetadataTest, LoadMetadataFail) {
   const std::string file = "3kfile@@corrupted";
   EXPECT_CALL(*ptr_mock_request, get_object_name())
@@ -635,6 +686,114 @@ TEST_F(S3ObjectMetadataTest, FromJson) {
   EXPECT_TRUE(ret_status == 0);
 }
 
+TEST_F(S3ObjectMetadataTest, FromJsonForListing) {
+  metadata_obj_under_test->set_md5("abcd");
+  metadata_obj_under_test->set_content_length("1024");
+  metadata_obj_under_test->add_user_defined_attribute("x-amz-meta-key", "v");
+  metadata_obj_under_test->setacl("PD94bg==");
+  metadata_obj_under_test->system_defined_attribute["Owner-Canonical-id"] =
+      "owner-canonical-id";
+  metadata_obj_under_test->reset_date_time_to_current();
+  std::string json_str = metadata_obj_under_test->to_json();
+
+  S3ObjectMetadata full(ptr_mock_request);
+  S3ObjectMetadata listed(ptr_mock_request);
+  ASSERT_EQ(0, full.from_json(json_str));
+  ASSERT_EQ(0, listed.from_json_for_listing(json_str));
+
+  EXPECT_EQ(full.get_object_name(), listed.get_object_name());
+  EXPECT_EQ(full.get_bucket_name(), listed.get_bucket_name());
+  EXPECT_EQ(full.get_md5(), listed.get_md5());
+  EXPECT_EQ(full.get_content_length_str(), listed.get_content_length_str());
+  EXPECT_EQ(full.get_last_modified_iso(), listed.get_last_modified_iso());
+  EXPECT_EQ(full.get_storage_class(), listed.get_storage_class());
+  EXPECT_EQ(full.get_canonical_id(), listed.get_canonical_id());
+  EXPECT_EQ(full.get_account_name(), listed.get_account_name());
+  EXPECT_EQ("owner-canonical-id", listed.get_canonical_id());
+  EXPECT_EQ("abcd", listed.get_md5());
+
+  EXPECT_EQ(-1, listed.from_json_for_listing("{\"Bucket-Name\":"));
+}
+
+TEST_F(S3ObjectMetadataTest, BinaryRecordRoundTrip) {
+  metadata_obj_under_test->set_md5("abcd");
+  metadata_obj_under_test->set_content_length("1024");
+  metadata_obj_under_test->add_user_defined_attribute("x-amz-meta-key", "v");
+  metadata_obj_under_test->setacl("PD94bg==");
+  metadata_obj_under_test->reset_date_time_to_current();
+
+  S3Option::get_instance()->set_metadata_binary_format(true);
+  std::string record = metadata_obj_under_test->to_json();
+  S3Option::get_instance()->set_metadata_binary_format(false);
+  ASSERT_TRUE(S3MetadataRecord::is_binary(record));
+
+  S3ObjectMetadata full(ptr_mock_request);
+  S3ObjectMetadata listed(ptr_mock_request);
+  ASSERT_EQ(0, full.from_json(record));
+  ASSERT_EQ(0, listed.from_json_for_listing(record));
+
+  EXPECT_EQ(metadata_obj_under_test->get_object_name(),
+            full.get_object_name());
+  EXPECT_EQ("abcd", full.get_md5());
+  EXPECT_EQ("1024", full.get_content_length_str());
+  EXPECT_EQ("v", full.get_user_defined_attribute("x-amz-meta-key"));
+  EXPECT_EQ(metadata_obj_under_test->get_object_name(),
+            listed.get_object_name());
+  EXPECT_EQ("abcd", listed.get_md5());
+  EXPECT_EQ(full.get_last_modified_iso(), listed.get_last_modified_iso());
+
+  EXPECT_EQ(-1, listed.from_json_for_listing(record.substr(0, 5)));
+}
+
+TEST_F(S3ObjectMetadataTest, InlineDataRoundTrip) {
+  std::string data("ab\0cd", 5);
+  metadata_obj_under_test->set_content_length("5");
+  metadata_obj_under_test->set_inline_data(data);
+  metadata_obj_under_test->reset_date_time_to_current();
+
+  for (bool binary_format : {false, true}) {
+    S3Option::get_instance()->set_metadata_binary_format(binary_format);
+    std::string record = metadata_obj_under_test->to_json();
+    S3Option::get_instance()->set_metadata_binary_format(false);
+
+    S3ObjectMetadata loaded(ptr_mock_request);
+    ASSERT_EQ(0, loaded.from_json(record));
+    EXPECT_TRUE(loaded.has_inline_data());
+    EXPECT_EQ(data, loaded.get_inline_data());
+    EXPECT_EQ(0ULL, loaded.get_oid().u_hi);
+    EXPECT_EQ(0ULL, loaded.get_oid().u_lo);
+  }
+
+  S3ObjectMetadata plain(ptr_mock_request);
+  metadata_obj_under_test->f_inline_data = false;
+  ASSERT_EQ(0, plain.from_json(metadata_obj_under_test->to_json()));
+  EXPECT_FALSE(plain.has_inline_data());
+}
+
+TEST_F(S3ObjectMetadataTest, ProbableDeleteKeyOfCopy) {
+  struct m0_uint128 data_oid = {0x1ffff, 0x1fff0};
+  struct m0_uint128 copy_oid = {0x2ffff, 0x2fff0};
+  const std::string data_oid_str = S3M0Uint128Helper::to_string(data_oid);
+  metadata_obj_under_test->set_oid(data_oid);
+  metadata_obj_under_test->reset_date_time_to_current();
+  EXPECT_EQ(data_oid_str, metadata_obj_under_test->get_probable_delete_key());
+
+  metadata_obj_under_test->set_copy_oid(copy_oid);
+  const std::string key =
+      data_oid_str + '-' + S3M0Uint128Helper::to_string(copy_oid);
+  EXPECT_EQ(key, metadata_obj_under_test->get_probable_delete_key());
+
+  for (bool binary_format : {false, true}) {
+    S3Option::get_instance()->set_metadata_binary_format(binary_format);
+    std::string record = metadata_obj_under_test->to_json();
+    S3Option::get_instance()->set_metadata_binary_format(false);
+
+    S3ObjectMetadata loaded(ptr_mock_request);
+    ASSERT_EQ(0, loaded.from_json(record));
+    EXPECT_EQ(key, loaded.get_probable_delete_key());
+  }
+}
+
 TEST_F(S3MultipartObjectMetadataTest, FromJson) {
   int ret_status;
   std::string json_str =
@@ -23,6 +23,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <thread>
 #include "gtest/gtest.h"
 
 extern S3Option *g_option_instance;
@@ -131,6 +132,27 @@ TEST_F(S3OptionsTest, GetOptionsfromFile) {
   EXPECT_TRUE(instance->is_s3server_addb_dump_enabled());
   EXPECT_EQ("s3stats-allowlist-test.yaml",
             instance->get_stats_allowlist_filename());
+  EXPECT_EQ(1, instance->get_reactor_threads());
+}
+
+TEST_F(S3OptionsTest, ReactorEventBaseIsPerThread) {
+  evbase_t *main_base = event_base_new();
+  evbase_t *reactor_base = event_base_new();
+  instance->set_eventbase(main_base);
+  EXPECT_EQ(main_base, instance->get_eventbase());
+
+  std::thread reactor([&]() {
+    instance->set_reactor_eventbase(reactor_base);
+    EXPECT_EQ(reactor_base, instance->get_eventbase());
+    instance->set_reactor_eventbase(NULL);
+    EXPECT_EQ(main_base, instance->get_eventbase());
+  });
+  reactor.join();
+  EXPECT_EQ(main_base, instance->get_eventbase());
+
+  instance->set_eventbase(NULL);
+  event_base_free(reactor_base);
+  event_base_free(main_base);
 }
 
 TEST_F(S3OptionsTest, TestOverrideOptions) {
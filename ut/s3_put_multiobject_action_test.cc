@@ -34,6 +34,7 @@ using ::testing::ReturnRef;
 using ::testing::AtLeast;
 using ::testing::DefaultValue;
 using ::testing::HasSubstr;
+using ::testing::StrEq;
 
 //++
 // Many of the test cases here taken directly from
@@ -1130,3 +1131,214 @@ TEST_F(S3PutMultipartObjectActionTestNoMockAuth, ValidateMissingContentLength) {
   EXPECT_STREQ("MissingContentLength",
                action_under_test->get_s3_error_code().c_str());
 }
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateCopySourceRange) {
+  action_under_test->is_copy_part = true;
+  EXPECT_CALL(*ptr_mock_request,
+              get_header_value(StrEq("x-amz-copy-source-range")))
+      .WillOnce(Return("bytes=5-10"));
+  EXPECT_CALL(*ptr_mock_request, is_header_present(_))
+      .WillRepeatedly(Return(false));
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutMultipartObjectActionTest::func_callback_one,
+                         this);
+  action_under_test->validate_multipart_request();
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_TRUE(action_under_test->has_copy_source_range);
+  EXPECT_EQ(5U, action_under_test->copy_source_first_byte);
+  EXPECT_EQ(10U, action_under_test->copy_source_last_byte);
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateMalformedCopySourceRange) {
+  action_under_test->is_copy_part = true;
+  EXPECT_CALL(*ptr_mock_request,
+              get_header_value(StrEq("x-amz-copy-source-range")))
+      .WillOnce(Return("bytes=10-5"))
+      .WillOnce(Return("bytes=-5"))
+      .WillOnce(Return("5-10"));
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(400, _)).Times(3);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(3);
+  for (int i = 0; i < 3; ++i) {
+    action_under_test->validate_multipart_request();
+    EXPECT_STREQ("InvalidArgument",
+                 action_under_test->get_s3_error_code().c_str());
+  }
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateSourceRangeBeyondSource) {
+  auto object_meta_factory =
+      std::make_shared<MockS3ObjectMetadataFactory>(ptr_mock_request);
+  action_under_test->additional_object_metadata =
+      object_meta_factory->mock_object_metadata;
+  action_under_test->is_copy_part = true;
+  action_under_test->has_copy_source_range = true;
+  action_under_test->copy_source_first_byte = 0;
+  action_under_test->copy_source_last_byte = 1024;
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_content_length())
+      .WillRepeatedly(Return(1024));
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(400, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+  action_under_test->validate_copy_source();
+  EXPECT_STREQ("InvalidArgument",
+               action_under_test->get_s3_error_code().c_str());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateSourceRangeSetsPartSize) {
+  auto object_meta_factory =
+      std::make_shared<MockS3ObjectMetadataFactory>(ptr_mock_request);
+  action_under_test->additional_object_metadata =
+      object_meta_factory->mock_object_metadata;
+  action_under_test->is_copy_part = true;
+  action_under_test->has_copy_source_range = true;
+  action_under_test->copy_source_first_byte = 1000;
+  action_under_test->copy_source_last_byte = 1999;
+  // Source too large for a part, the range is not
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_content_length())
+      .WillRepeatedly(Return(MAXIMUM_ALLOWED_PART_SIZE + 1));
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutMultipartObjectActionTest::func_callback_one,
+                         this);
+  action_under_test->validate_copy_source();
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_EQ(1000U, action_under_test->get_part_size());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateCopySourceConditional) {
+  action_under_test->is_copy_part = true;
+  EXPECT_CALL(*ptr_mock_request,
+              get_header_value(StrEq("x-amz-copy-source-range")))
+      .WillOnce(Return(""));
+  EXPECT_CALL(*ptr_mock_request,
+              is_header_present(StrEq("x-amz-copy-source-if-match")))
+      .WillOnce(Return(true));
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(501, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+  action_under_test->validate_multipart_request();
+  EXPECT_STREQ("NotImplemented",
+               action_under_test->get_s3_error_code().c_str());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateSourceTooLarge) {
+  auto object_meta_factory =
+      std::make_shared<MockS3ObjectMetadataFactory>(ptr_mock_request);
+  action_under_test->additional_object_metadata =
+      object_meta_factory->mock_object_metadata;
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_content_length())
+      .WillRepeatedly(Return(MAXIMUM_ALLOWED_PART_SIZE + 1));
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(400, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+  action_under_test->validate_copy_source();
+  EXPECT_STREQ("InvalidRequest",
+               action_under_test->get_s3_error_code().c_str());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth,
+       CopyPartValidateSourceSetsPartSize) {
+  auto object_meta_factory =
+      std::make_shared<MockS3ObjectMetadataFactory>(ptr_mock_request);
+  action_under_test->additional_object_metadata =
+      object_meta_factory->mock_object_metadata;
+  action_under_test->is_copy_part = true;
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata),
+              get_content_length())
+      .WillRepeatedly(Return(1024 * 1024));
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutMultipartObjectActionTest::func_callback_one,
+                         this);
+  action_under_test->validate_copy_source();
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_EQ(1024 * 1024U, action_under_test->total_data_to_stream);
+  EXPECT_EQ(1024 * 1024U, action_under_test->get_part_size());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth, CopyPartSourceObjectMissing) {
+  action_under_test->additional_object_metadata = nullptr;
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(404, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+  action_under_test->fetch_additional_object_info_failed();
+  EXPECT_STREQ("NoSuchKey", action_under_test->get_s3_error_code().c_str());
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth, CopyPartEmptySource) {
+  action_under_test->is_copy_part = true;
+  action_under_test->total_data_to_stream = 0;
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutMultipartObjectActionTest::func_callback_one,
+                         this);
+  action_under_test->copy_part_data();
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_TRUE(action_under_test->object_data_copier == nullptr);
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth, CopyPartInlineSource) {
+  const std::string data(100, 'A');
+  auto object_meta_factory =
+      std::make_shared<MockS3ObjectMetadataFactory>(ptr_mock_request);
+  object_meta_factory->mock_object_metadata->set_inline_data(data);
+  action_under_test->additional_object_metadata =
+      object_meta_factory->mock_object_metadata;
+  action_under_test->is_copy_part = true;
+  action_under_test->total_data_to_stream = data.length();
+  action_under_test->motr_writer = motr_writer_factory->mock_motr_writer;
+
+  // Written from the metadata, there is no source object to read
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer),
+              write_content(_, _, _, _)).Times(1);
+  action_under_test->copy_part_data();
+  EXPECT_TRUE(action_under_test->object_data_copier == nullptr);
+  ASSERT_TRUE(action_under_test->inline_part_data != nullptr);
+  EXPECT_EQ(data.length(),
+            action_under_test->inline_part_data->get_content_length());
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutMultipartObjectActionTest::func_callback_one,
+                         this);
+  action_under_test->copy_inline_part_data_successful();
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_TRUE(action_under_test->inline_part_data == nullptr);
+}
+
+TEST_F(S3PutMultipartObjectActionTestNoMockAuth, SendCopyPartSuccessResponse) {
+  action_under_test->is_copy_part = true;
+  action_under_test->motr_writer = motr_writer_factory->mock_motr_writer;
+  action_under_test->part_metadata = part_meta_factory->mock_part_metadata;
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer), get_content_md5())
+      .WillRepeatedly(Return("abcd1234"));
+  EXPECT_CALL(*(part_meta_factory->mock_part_metadata),
+              get_last_modified_iso())
+      .WillRepeatedly(Return("2020-01-01T00:00:00.000Z"));
+
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request,
+              send_response(200, HasSubstr("<CopyPartResult"))).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+  action_under_test->send_response_to_s3_client();
+}
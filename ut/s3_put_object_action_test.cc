@@ -1031,6 +1031,74 @@ TEST_F(S3PutObjectActionTest, WriteObjectSuccessfulShouldRestartReadingData) {
   EXPECT_FALSE(action_under_test->write_in_progress);
 }
 
+// Writes in flight, window not full and full payloads buffered
+TEST_F(S3PutObjectActionTest, ConsumeIncomingShouldFillWriteWindow) {
+  action_under_test->motr_writer = motr_writer_factory->mock_motr_writer;
+  action_under_test->_set_layout_id(layout_id);
+
+  // mock one write in flight
+  action_under_test->write_in_progress = true;
+  action_under_test->writes_in_flight = 1;
+  action_under_test->motr_write_window = 3;
+
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), is_freezed())
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), get_content_length())
+      .WillRepeatedly(Return(
+           S3Option::get_instance()->get_motr_write_payload_size(layout_id) *
+           2));
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer), can_pipeline_write())
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), get_buffers(_))
+      .Times(0);
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), get_more_buffers(_))
+      .Times(2);
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer),
+              write_content(_, _, _, _)).Times(2);
+  EXPECT_CALL(*ptr_mock_request, pause()).Times(1);
+
+  action_under_test->consume_incoming_content();
+
+  EXPECT_EQ(3u, action_under_test->writes_in_flight);
+  EXPECT_TRUE(action_under_test->write_in_progress);
+}
+
+// One of several writes in flight completed, next one takes its slot
+TEST_F(S3PutObjectActionTest,
+       WriteObjectSuccessfulKeepsWindowFullWhileWritesInFlight) {
+  action_under_test->motr_writer = motr_writer_factory->mock_motr_writer;
+  action_under_test->_set_layout_id(layout_id);
+
+  // mock full window
+  action_under_test->write_in_progress = true;
+  action_under_test->writes_in_flight = 3;
+  action_under_test->motr_write_window = 3;
+
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), is_freezed())
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), get_content_length())
+      .WillRepeatedly(Return(
+           S3Option::get_instance()->get_motr_write_payload_size(layout_id)));
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer), can_pipeline_write())
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*async_buffer_factory->get_mock_buffer(), get_more_buffers(_))
+      .Times(1);
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer),
+              write_content(_, _, _, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(0);
+
+  // Mock out the next calls on action.
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutObjectActionTest::func_callback_one, this);
+
+  action_under_test->write_object_successful();
+
+  EXPECT_EQ(0, call_count_one);
+  EXPECT_EQ(3u, action_under_test->writes_in_flight);
+  EXPECT_TRUE(action_under_test->write_in_progress);
+}
+
 TEST_F(S3PutObjectActionTest, SaveMetadata) {
   CREATE_BUCKET_METADATA;
   bucket_meta_factory->mock_bucket_metadata->set_object_list_index_layout(
@@ -1192,3 +1260,76 @@ TEST_F(S3PutObjectActionTest, ValidateMissingContentLength) {
   EXPECT_STREQ("MissingContentLength",
                action_under_test->get_s3_error_code().c_str());
 }
+
+TEST_F(S3PutObjectActionTest, CreateInlineObjectSavesDataInMetadata) {
+  CREATE_OBJECT_METADATA;
+  std::string data = "hello";
+
+  action_under_test->store_data_inline = true;
+
+  EXPECT_CALL(*ptr_mock_request, get_full_body_content_as_string())
+      .WillRepeatedly(ReturnRef(data));
+  EXPECT_CALL(*ptr_mock_request, get_header_value("content-md5"))
+      .WillOnce(Return(""));
+  EXPECT_CALL(*ptr_mock_request, get_content_length())
+      .WillRepeatedly(Return(data.length()));
+  EXPECT_CALL(*(object_meta_factory->mock_object_metadata), set_oid(_))
+      .Times(AtLeast(1));
+  // No old object and no Motr object, so no probable delete records
+  EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
+              put_keyval(_, _, _, _)).Times(0);
+
+  action_under_test->clear_tasks();
+  ACTION_TASK_ADD_OBJPTR(action_under_test,
+                         S3PutObjectActionTest::func_callback_one, this);
+
+  action_under_test->create_inline_object();
+
+  EXPECT_EQ(1, call_count_one);
+  EXPECT_EQ(S3PutObjectActionState::writeComplete,
+            action_under_test->s3_put_action_state);
+  EXPECT_TRUE(action_under_test->new_object_metadata->has_inline_data());
+  EXPECT_EQ("hello", action_under_test->new_object_metadata->get_inline_data());
+  EXPECT_EQ("5d41402abc4b2a76b9719d911017c592",
+            action_under_test->inline_data_md5);
+}
+
+TEST_F(S3PutObjectActionTest, CreateInlineObjectWithBadDigest) {
+  CREATE_OBJECT_METADATA;
+  std::string data = "hello";
+
+  action_under_test->store_data_inline = true;
+
+  EXPECT_CALL(*ptr_mock_request, get_full_body_content_as_string())
+      .WillRepeatedly(ReturnRef(data));
+  EXPECT_CALL(*ptr_mock_request, get_header_value("content-md5"))
+      .WillOnce(Return("1B2M2Y8AsgTpgAmY7PhCfg=="));
+  EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
+              put_keyval(_, _, _, _)).Times(0);
+  EXPECT_CALL(*ptr_mock_request, set_out_header_value(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(*ptr_mock_request, send_response(400, _)).Times(1);
+  EXPECT_CALL(*ptr_mock_request, resume(_)).Times(1);
+
+  action_under_test->clear_tasks();
+  action_under_test->create_inline_object();
+
+  EXPECT_EQ(S3PutObjectActionState::md5ValidationFailed,
+            action_under_test->s3_put_action_state);
+  EXPECT_STREQ("BadDigest", action_under_test->get_s3_error_code().c_str());
+}
+
+TEST_F(S3PutObjectActionTest, CleanupOfInlineObjectKeepsMotrAlone) {
+  action_under_test->store_data_inline = true;
+  action_under_test->s3_put_action_state =
+      S3PutObjectActionState::metadataSaveFailed;
+  action_under_test->new_oid_str = S3M0Uint128Helper::to_string(oid);
+
+  // Neither old nor new Motr object, no probable delete records to drop
+  EXPECT_CALL(*(motr_kvs_writer_factory->mock_motr_kvs_writer),
+              delete_keyval(_, _, _, _)).Times(0);
+  EXPECT_CALL(*(motr_writer_factory->mock_motr_writer),
+              delete_object(_, _, _, _, _)).Times(0);
+
+  action_under_test->startcleanup();
+  EXPECT_EQ(0, action_under_test->number_of_tasks());
+}
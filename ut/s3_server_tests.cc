@@ -48,6 +48,7 @@ extern int s3log_level;
 struct s3_motr_idx_layout global_bucket_list_index_layout;
 struct s3_motr_idx_layout bucket_metadata_list_index_layout;
 struct s3_motr_idx_layout global_probable_dead_object_list_index_layout;
+struct s3_motr_idx_layout global_object_data_ref_index_layout;
 struct m0_uint128 global_instance_id;
 S3Option *g_option_instance = NULL;
 evhtp_ssl_ctx_t *g_ssl_auth_ctx;
@@ -19,7 +19,11 @@
  */
 
 #include "s3_stats.h"
+#include <algorithm>
 #include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "mock_socket_interface.h"
@@ -29,6 +33,7 @@ using ::testing::AtLeast;
 using ::testing::Return;
 using ::testing::_;
 using ::testing::InSequence;
+using ::testing::Invoke;
 using testing::SetErrnoAndReturn;
 
 extern S3Option* g_option_instance;
@@ -69,9 +74,30 @@ class S3StatsTest : public testing::Test {
     s3_stats_under_test = g_stats_instance = S3Stats::get_instance(mock_socket);
     if (g_stats_instance == nullptr) {
       std::cout << "Error initializing g_stats_instance..\n";
+    } else {
+      // Most tests check what a single call sends
+      s3_stats_under_test->aggregate = false;
     }
   }
 
+  // Collects lines of the datagrams sent
+  void expect_packets(std::vector<std::string>& lines,
+                      const ::testing::Cardinality& times) {
+    EXPECT_CALL(*mock_socket, sendto(_, _, _, _, _, _))
+        .Times(times)
+        .WillRepeatedly(Invoke([&lines](int, const void* buf, size_t len, int,
+                                        const struct sockaddr*, socklen_t) {
+          EXPECT_LE(len, g_option_instance->get_statsd_max_packet_size());
+          std::istringstream packet(
+              std::string(static_cast<const char*>(buf), len));
+          std::string line;
+          while (std::getline(packet, line)) {
+            lines.push_back(line);
+          }
+          return (ssize_t)len;
+        }));
+  }
+
   void TearDown() { s3_stats_fini(); }
 
   static void TearDownTestCase() {
@@ -281,3 +307,99 @@ TEST_F(S3StatsTest, S3StatsCountUniqueCallMustNotFailForValidSocketCalls) {
   // again calls send.
   EXPECT_NE(s3_stats_under_test->count_unique("internal_error_count", "1"), -1);
 }
+
+TEST_F(S3StatsTest, AggregatesOnlyAllowlistedMetrics) {
+  std::vector<std::string> lines;
+  s3_stats_under_test->aggregate = true;
+
+  EXPECT_EQ(0, s3_stats_under_test->count("internal_error_count", 1));
+  EXPECT_EQ(0, s3_stats_under_test->count("internal_error_count", 2));
+  EXPECT_EQ(0, s3_stats_under_test->count("xyz", 5));
+  EXPECT_EQ(0, s3_stats_under_test->timing("xyz", 5));
+
+  size_t id;
+  EXPECT_TRUE(s3_stats_under_test->find_metric("internal_error_count", id));
+  EXPECT_FALSE(s3_stats_under_test->find_metric("xyz", id));
+
+  expect_packets(lines, ::testing::Exactly(1));
+  s3_stats_under_test->flush();
+  // Nothing left to send
+  s3_stats_under_test->flush();
+
+  ASSERT_EQ(1U, lines.size());
+  EXPECT_EQ("internal_error_count:3|c", lines[0]);
+}
+
+TEST_F(S3StatsTest, FlushPacksMetricsOfAllThreads) {
+  std::vector<std::string> lines;
+  s3_stats_under_test->aggregate = true;
+
+  auto update = [this]() {
+    s3_stats_under_test->count("internal_error_count", 2);
+    s3_stats_under_test->timing("total_request_time", 5);
+    s3_stats_under_test->update_gauge("uri_to_motr_oid", -3);
+  };
+  update();
+  std::thread other(update);
+  other.join();
+  s3_stats_under_test->timing("total_request_time", 100);
+
+  expect_packets(lines, ::testing::Exactly(1));
+  s3_stats_under_test->flush();
+
+  std::set<std::string> got(lines.begin(), lines.end());
+  std::set<std::string> expected{"internal_error_count:4|c",
+                                 "uri_to_motr_oid:-6|g",
+                                 "total_request_time:5:5:104|ms"};
+  EXPECT_EQ(expected, got);
+}
+
+TEST_F(S3StatsTest, FlushSplitsTimingValuesAtMaxSize) {
+  std::vector<std::string> lines;
+  const size_t hits = 1000;
+  s3_stats_under_test->aggregate = true;
+
+  for (size_t i = 0; i < hits; ++i) {
+    s3_stats_under_test->timing("total_request_time", 5);
+  }
+  expect_packets(lines, AtLeast(2));
+  s3_stats_under_test->flush();
+
+  size_t values = 0;
+  for (const auto& line : lines) {
+    ASSERT_EQ(0U, line.find("total_request_time:5:"));
+    ASSERT_EQ(line.length() - 3, line.rfind("|ms"));
+    values += std::count(line.begin(), line.end(), ':');
+  }
+  EXPECT_EQ(hits, values);
+}
+
+TEST_F(S3StatsTest, FlushSplitsPacketsAtMaxSize) {
+  std::vector<std::string> lines;
+  s3_stats_under_test->aggregate = true;
+
+  for (const auto& key : s3_stats_under_test->metric_keys) {
+    s3_stats_under_test->count(key, 1);
+  }
+  expect_packets(lines, AtLeast(2));
+  s3_stats_under_test->flush();
+
+  EXPECT_EQ(s3_stats_under_test->metric_keys.size(), lines.size());
+}
+
+TEST_F(S3StatsTest, TimingBucketValuesAreClose) {
+  size_t last_bucket = 0;
+
+  for (size_t time_ms = 0; time_ms < 1000000; time_ms += 1 + time_ms / 64) {
+    size_t bucket = S3Stats::get_timing_bucket(time_ms);
+    size_t value = S3Stats::get_timing_bucket_value(bucket);
+
+    ASSERT_LT(bucket, S3Stats::timing_buckets);
+    ASSERT_GE(bucket, last_bucket);
+    ASSERT_LE(value > time_ms ? value - time_ms : time_ms - value,
+              time_ms / 8);
+    last_bucket = bucket;
+  }
+  EXPECT_EQ(S3Stats::timing_buckets - 1,
+            S3Stats::get_timing_bucket((size_t)1 << 40));
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "s3_common_utilities.h"
+#include "s3_xml_writer.h"
+
+TEST(S3XmlWriterTest, EmptyWriter) {
+  S3XmlWriter writer;
+  EXPECT_EQ(0u, writer.length());
+  EXPECT_EQ("", writer.to_string());
+}
+
+TEST(S3XmlWriterTest, Document) {
+  S3XmlWriter writer;
+  writer.declaration();
+  writer.start_element("ListBucketResult",
+                       "http://s3.amazonaws.com/doc/2006-03-01/");
+  writer.element("Name", "bucket");
+  writer.element("Prefix", "");
+  writer.start_element("Contents");
+  writer.element("ETag", "c99a", true);
+  writer.end_element("Contents");
+  writer.end_element("ListBucketResult");
+
+  const std::string expected =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Name>bucket</Name><Prefix/>"
+      "<Contents><ETag>\"c99a\"</ETag></Contents>"
+      "</ListBucketResult>";
+  EXPECT_EQ(expected, writer.to_string());
+  EXPECT_EQ(expected.length(), writer.length());
+}
+
+TEST(S3XmlWriterTest, SpecialCharactersEscaped) {
+  S3XmlWriter writer;
+  writer.element("Key", "<a&b>\"c\"\r");
+  EXPECT_EQ("<Key>&lt;a&amp;b&gt;&quot;c&quot;&#13;</Key>",
+            writer.to_string());
+}
+
+TEST(S3XmlWriterTest, SameAsFormatXmlString) {
+  const char* values[] = {"", "plain", "&", "a<b", "x>", "'q'\"", "\r\n\t",
+                          "\xc3\xa9t\xc3\xa9 & <more>"};
+  for (const char* value : values) {
+    S3XmlWriter writer;
+    writer.element("Key", value);
+    writer.element("ETag", value, true);
+    EXPECT_EQ(S3CommonUtilities::format_xml_string("Key", value) +
+                  S3CommonUtilities::format_xml_string("ETag", value, true),
+              writer.to_string());
+  }
+}
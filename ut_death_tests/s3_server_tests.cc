@@ -40,6 +40,7 @@ extern int s3log_level;
 struct s3_motr_idx_layout global_bucket_list_index_layout;
 struct s3_motr_idx_layout bucket_metadata_list_index_layout;
 struct s3_motr_idx_layout global_probable_dead_object_list_index_layout;
+struct s3_motr_idx_layout global_object_data_ref_index_layout;
 struct m0_uint128 global_instance_id;
 pthread_t global_tid_indexop;
 pthread_t global_tid_objop;